@@ -0,0 +1,368 @@
+#include <memory>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <optional>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <unordered_map>
+
+#include <getopt.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "types.h"
+#include "BlobDiff.h"
+#include "BlobPack.h"
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/util/Parallel.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const int SAME { EXIT_SUCCESS };
+    const int DIFFERENT { 1 };
+    const int TROUBLE { 2 };
+
+    void
+    usage (const char * name_) {
+        std::cerr
+            << "usage: " << name_ << " [options] <from> <to>" << std::endl
+            << std::endl
+            << "Each of <from> and <to> is a blob, a pack of them or a directory of" << std::endl
+            << "them. Exits 0 when they hold the same, 1 when they don't and 2 on error" << std::endl
+            << std::endl
+            << "  --key <path>   pair the blobs of <from> and <to> by the value at <path>" << std::endl
+            << "                 rather than their content, and list how each pair differs" << std::endl
+            << "  --threads <n>  decode the blobs across <n> threads" << std::endl;
+    }
+
+    /**************************************************************************/
+
+    /**
+     * A blob on its own or one of those in a pack
+     */
+    struct Input {
+        std::string      path;
+        const BlobPack * pack;
+        size_t           index;
+    };
+
+    struct Corpus {
+        std::vector<Input>         inputs;
+        std::vector<uPtr<BlobPack>> packs;
+    };
+
+    bool
+    directory (const std::string & path_) {
+        struct stat results { };
+
+        return stat (path_.c_str(), &results) == 0 && S_ISDIR (results.st_mode);
+    }
+
+    void
+    add (Corpus & corpus_, const std::string & path_) {
+        if (BlobPack::isPack (path_)) {
+            corpus_.packs.push_back (std::make_unique<BlobPack> (path_));
+
+            const auto & pack = *corpus_.packs.back();
+            for (size_t i { 0 } ; i < pack.size() ; ++i) {
+                corpus_.inputs.push_back ({ path_ + "[" + std::to_string (i) + "]", &pack, i });
+            }
+        } else {
+            corpus_.inputs.push_back ({ path_, nullptr, 0 });
+        }
+    }
+
+    /**
+     * A directory's regular files in name order, so two snapshots of
+     * the same directory list their blobs the same way
+     */
+    Corpus
+    corpus (const std::string & path_) {
+        Corpus rtn;
+
+        if (!directory (path_)) {
+            add (rtn, path_);
+            return rtn;
+        }
+
+        auto dir = opendir (path_.c_str());
+        if (!dir) {
+            throw std::runtime_error (path_ + ": can't read directory");
+        }
+
+        std::vector<std::string> names;
+        while (auto entry = readdir (dir)) {
+            std::string name (entry->d_name);
+            struct stat results { };
+
+            if (stat ((path_ + "/" + name).c_str(), &results) == 0 && S_ISREG (results.st_mode)) {
+                names.push_back (std::move (name));
+            }
+        }
+
+        closedir (dir);
+
+        std::sort (names.begin(), names.end());
+
+        for (const auto & name : names) {
+            add (rtn, path_ + "/" + name);
+        }
+
+        return rtn;
+    }
+
+    /**************************************************************************/
+
+    template<typename T>
+    T
+    inspect (const Input & input_, const std::function<T (BlobInspector &)> & f_) {
+        if (input_.pack) {
+            auto bytes = input_.pack->bytes (input_.index);
+
+            BlobInspector blobInspector (*bytes);
+            blobInspector.adopt (input_.pack->envelope (input_.index));
+
+            return f_ (blobInspector);
+        }
+
+        CordaBytes bytes (input_.path);
+        BlobInspector blobInspector (bytes);
+
+        return f_ (blobInspector);
+    }
+
+    /**************************************************************************/
+
+    void
+    print (const BlobDiff & diff_, std::ostream & out_, const char * indent_ = "") {
+        for (const auto & difference : diff_.differences()) {
+            out_ << indent_ << difference << std::endl;
+        }
+    }
+
+    int
+    single (const Input & from_, const Input & to_) {
+        auto tree = [](BlobInspector & bi_) { return BlobTree (bi_); };
+
+        BlobDiff diff (
+            inspect<BlobTree> (from_, tree),
+            inspect<BlobTree> (to_, tree));
+
+        print (diff, std::cout);
+
+        return diff.empty() ? SAME : DIFFERENT;
+    }
+
+    /**************************************************************************/
+
+    /**
+     * What the first pass keeps of each blob, the tree itself is
+     * thrown away and only built again for pairs that differ
+     */
+    struct Entry {
+        std::optional<std::string> key;
+        BlobTree::Digest           hash { };
+        std::string                error;
+    };
+
+    std::vector<Entry>
+    entries (const Corpus & corpus_, const std::string & key_, size_t threads_) {
+        std::vector<Entry> rtn (corpus_.inputs.size());
+
+        amqp::util::parallel (rtn.size(), threads_, [&](size_t, size_t begin_, size_t end_) {
+            for (auto i = begin_ ; i < end_ ; ++i) {
+                try {
+                    inspect<void> (corpus_.inputs[i], [&](BlobInspector & bi_) {
+                        BlobTree tree (bi_);
+
+                        rtn[i].hash = tree.hash();
+                        rtn[i].key = key_.empty()
+                            ? BlobTree::hex (tree.hash())
+                            : bi_.values ({ key_ })[0];
+                    });
+                } catch (const std::runtime_error & e) {
+                    rtn[i].error = e.what();
+                }
+            }
+        });
+
+        return rtn;
+    }
+
+    /**
+     * Pairs the blobs of the two corpora by key and diffs those pairs
+     * whose hashes differ. Blobs with the same content hash the same so
+     * without a key pairing them is all there is to do
+     */
+    int
+    corpora (const Corpus & from_, const Corpus & to_, const std::string & key_, size_t threads_) {
+        int rtn { SAME };
+
+        auto from = entries (from_, key_, threads_);
+        auto to = entries (to_, key_, threads_);
+
+        auto usable = [&rtn](const Input & input_, const Entry & entry_) {
+            if (!entry_.error.empty()) {
+                std::cerr << input_.path << ": " << entry_.error << std::endl;
+                rtn = TROUBLE;
+                return false;
+            }
+
+            if (!entry_.key) {
+                std::cerr << input_.path << ": no key, skipped" << std::endl;
+                return false;
+            }
+
+            return true;
+        };
+
+        std::unordered_map<std::string, size_t> keyed;
+        std::vector<bool> indexed (to.size(), false);
+
+        for (size_t i { 0 } ; i < to.size() ; ++i) {
+            if (!usable (to_.inputs[i], to[i])) {
+                continue;
+            }
+
+            if (keyed.emplace (*to[i].key, i).second) {
+                indexed[i] = true;
+            } else {
+                std::cerr << to_.inputs[i].path << ": duplicate key " << *to[i].key
+                          << ", skipped" << std::endl;
+            }
+        }
+
+        std::vector<std::pair<size_t, size_t>> pairs;
+        std::vector<bool> paired (to.size(), false);
+        std::vector<size_t> removed;
+        size_t same { 0 };
+
+        for (size_t i { 0 } ; i < from.size() ; ++i) {
+            if (!usable (from_.inputs[i], from[i])) {
+                continue;
+            }
+
+            auto other = keyed.find (*from[i].key);
+
+            if (other == keyed.end() || paired[other->second]) {
+                removed.push_back (i);
+                continue;
+            }
+
+            paired[other->second] = true;
+
+            if (from[i].hash == to[other->second].hash) {
+                ++same;
+            } else {
+                pairs.emplace_back (i, other->second);
+            }
+        }
+
+        std::vector<std::string> diffs (pairs.size());
+
+        amqp::util::parallel (pairs.size(), threads_, [&](size_t, size_t begin_, size_t end_) {
+            for (auto i = begin_ ; i < end_ ; ++i) {
+                const auto & a = from_.inputs[pairs[i].first];
+                const auto & b = to_.inputs[pairs[i].second];
+
+                std::stringstream ss;
+                ss << "~ " << *from[pairs[i].first].key << " " << a.path << " " << b.path << std::endl;
+
+                try {
+                    auto tree = [](BlobInspector & bi_) { return BlobTree (bi_); };
+
+                    print (BlobDiff (inspect<BlobTree> (a, tree), inspect<BlobTree> (b, tree)), ss, "    ");
+                } catch (const std::runtime_error & e) {
+                    ss << "    " << e.what() << std::endl;
+                }
+
+                diffs[i] = ss.str();
+            }
+        });
+
+        for (auto i : removed) {
+            std::cout << "- " << *from[i].key << " " << from_.inputs[i].path << std::endl;
+        }
+
+        for (const auto & diff : diffs) {
+            std::cout << diff;
+        }
+
+        size_t added { 0 };
+        for (size_t i { 0 } ; i < to.size() ; ++i) {
+            if (indexed[i] && !paired[i]) {
+                std::cout << "+ " << *to[i].key << " " << to_.inputs[i].path << std::endl;
+                ++added;
+            }
+        }
+
+        std::cout << same << " same, " << pairs.size() << " changed, "
+                  << removed.size() << " removed, " << added << " added" << std::endl;
+
+        if (rtn == SAME && (!pairs.empty() || !removed.empty() || added)) {
+            rtn = DIFFERENT;
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * Compares two blobs field by field, or two sets of them blob by blob,
+ * passing over whatever hashes the same on both sides without looking
+ * into it
+ */
+int
+main (int argc, char **argv) {
+    static const option options[] = {
+        { "key",     required_argument, nullptr, 'k' },
+        { "threads", required_argument, nullptr, 't' },
+        { "help",    no_argument,       nullptr, 'h' },
+        { nullptr,   0,                 nullptr, 0 }
+    };
+
+    std::string key;
+    size_t threads { 1 };
+
+    int opt;
+    while ((opt = getopt_long (argc, argv, "k:t:h", options, nullptr)) != -1) {
+        switch (opt) {
+            case 'k' : key = optarg; break;
+            case 't' : threads = std::max (1, atoi (optarg)); break;
+            default  : usage (argv[0]); return TROUBLE;
+        }
+    }
+
+    if (argc - optind != 2) {
+        usage (argv[0]);
+        return TROUBLE;
+    }
+
+    try {
+        auto from = corpus (argv[optind]);
+        auto to = corpus (argv[optind + 1]);
+
+        if (key.empty() && from.packs.empty() && to.packs.empty()
+            && !directory (argv[optind]) && !directory (argv[optind + 1]))
+        {
+            return single (from.inputs.front(), to.inputs.front());
+        }
+
+        return corpora (from, to, key, threads);
+    } catch (const std::runtime_error & e) {
+        std::cerr << e.what() << std::endl;
+        return TROUBLE;
+    }
+}
+
+/******************************************************************************/
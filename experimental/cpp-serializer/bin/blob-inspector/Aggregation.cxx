@@ -0,0 +1,375 @@
+#include "Aggregation.h"
+
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "amqp/util/Json.h"
+#include "amqp/util/Parallel.h"
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * What the property readers read, as text for a group key
+     */
+    std::optional<std::string>
+    text (const std::any & value_) {
+        if (!value_.has_value()) {
+            return std::nullopt;
+        }
+
+        if (auto s = std::any_cast<std::string> (&value_)) return *s;
+        if (auto i = std::any_cast<int> (&value_)) return std::to_string (*i);
+        if (auto l = std::any_cast<long> (&value_)) return std::to_string (*l);
+        if (auto b = std::any_cast<bool> (&value_)) return std::string (*b ? "true" : "false");
+
+        if (auto d = std::any_cast<double> (&value_)) {
+            Aggregation::Number n;
+            n.real = true;
+            n.value = *d;
+            return n.str();
+        }
+
+        throw std::runtime_error ("Can't group by a value of this type");
+    }
+
+    /**************************************************************************/
+
+    Aggregation::Number
+    number (const std::any & value_, const std::string & path_) {
+        Aggregation::Number rtn;
+
+        if (auto i = std::any_cast<int> (&value_)) {
+            rtn.integer = *i;
+        } else if (auto l = std::any_cast<long> (&value_)) {
+            rtn.integer = *l;
+        } else if (auto d = std::any_cast<double> (&value_)) {
+            rtn.real = true;
+            rtn.value = *d;
+        } else {
+            throw std::runtime_error (path_ + " isn't a number");
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * Aggregation::Number
+ *
+ ******************************************************************************/
+
+bool
+Aggregation::Number::operator < (const Number & rhs_) const {
+    if (!real && !rhs_.real) {
+        return integer < rhs_.integer;
+    }
+
+    return asReal() < rhs_.asReal();
+}
+
+/******************************************************************************/
+
+Aggregation::Number &
+Aggregation::Number::operator += (const Number & rhs_) {
+    int64_t sum;
+
+    if (!real && !rhs_.real && !__builtin_add_overflow (integer, rhs_.integer, &sum)) {
+        integer = sum;
+    } else {
+        value = asReal() + rhs_.asReal();
+        real = true;
+    }
+
+    return *this;
+}
+
+/******************************************************************************/
+
+std::string
+Aggregation::Number::str() const {
+    if (!real) {
+        return std::to_string (integer);
+    }
+
+    if (!std::isfinite (value)) {
+        return "null";
+    }
+
+    char buf[32];
+    snprintf (buf, sizeof (buf), "%.17g", value);
+
+    return buf;
+}
+
+/******************************************************************************
+ *
+ * Aggregation
+ *
+ ******************************************************************************/
+
+Aggregation::Aggregation (
+    std::vector<std::string> groupBy_,
+    std::vector<Measure> measures_
+) : m_groupBy (std::move (groupBy_))
+  , m_measures (std::move (measures_))
+  , m_paths (m_groupBy)
+{
+    if (m_measures.empty()) {
+        throw std::runtime_error ("Nothing to aggregate");
+    }
+
+    for (const auto & measure : m_measures) {
+        if (measure.op != count_t) {
+            m_paths.push_back (measure.path);
+        }
+    }
+}
+
+/******************************************************************************/
+
+std::string
+Aggregation::heading (const Measure & measure_) const {
+    switch (measure_.op) {
+        case count_t : return "count";
+        case sum_t   : return "sum(" + measure_.path + ")";
+        case min_t   : return "min(" + measure_.path + ")";
+        case max_t   : return "max(" + measure_.path + ")";
+    }
+
+    return "";
+}
+
+/******************************************************************************/
+
+/**
+ * [values_] are those at each of [m_paths] for a single blob
+ */
+void
+Aggregation::fold (Table & table_, const std::vector<std::any> & values_) const {
+    std::vector<std::optional<std::string>> group;
+    group.reserve (m_groupBy.size());
+
+    // each value length prefixed so no two groups can share a key
+    std::string key;
+
+    for (size_t i { 0 } ; i < m_groupBy.size() ; ++i) {
+        group.push_back (text (values_[i]));
+
+        key += group.back()
+            ? std::to_string (group.back()->size()) + ":" + *group.back()
+            : "-";
+    }
+
+    auto row = table_.find (key);
+    if (row == table_.end()) {
+        row = table_.emplace (key, Row { std::move (group), std::vector<Cell> (m_measures.size()) }).first;
+    }
+
+    auto value = m_groupBy.size();
+
+    for (size_t i { 0 } ; i < m_measures.size() ; ++i) {
+        auto & cell = row->second.cells[i];
+
+        if (m_measures[i].op == count_t) {
+            ++cell.count;
+            continue;
+        }
+
+        const auto & v = values_[value++];
+
+        if (!v.has_value()) {
+            continue;
+        }
+
+        auto n = number (v, m_measures[i].path);
+
+        if (cell.count == 0) {
+            cell.number = n;
+        } else if (m_measures[i].op == sum_t) {
+            cell.number += n;
+        } else if (m_measures[i].op == min_t ? n < cell.number : cell.number < n) {
+            cell.number = n;
+        }
+
+        ++cell.count;
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Fold everything in [from_] into [into_]
+ */
+void
+Aggregation::merge (Table & into_, Table & from_) const {
+    for (auto & entry : from_) {
+        auto row = into_.find (entry.first);
+
+        if (row == into_.end()) {
+            into_.emplace (entry.first, std::move (entry.second));
+            continue;
+        }
+
+        for (size_t i { 0 } ; i < m_measures.size() ; ++i) {
+            auto & cell = row->second.cells[i];
+            const auto & other = entry.second.cells[i];
+
+            if (other.count == 0) {
+                continue;
+            }
+
+            if (m_measures[i].op == count_t) {
+                cell.count += other.count;
+                continue;
+            }
+
+            if (cell.count == 0) {
+                cell.number = other.number;
+            } else if (m_measures[i].op == sum_t) {
+                cell.number += other.number;
+            } else if (m_measures[i].op == min_t
+                    ? other.number < cell.number
+                    : cell.number < other.number)
+            {
+                cell.number = other.number;
+            }
+
+            cell.count += other.count;
+        }
+    }
+
+    Table().swap (from_);
+}
+
+/******************************************************************************/
+
+std::vector<Aggregation::Row>
+Aggregation::run (size_t blobs_, const Source & source_, size_t threads_) const {
+    auto chunks = amqp::util::chunks (blobs_, threads_);
+
+    std::vector<Table> tables (chunks);
+
+    amqp::util::parallel (blobs_, threads_, [&](size_t chunk_, size_t begin_, size_t end_) {
+        for (auto j = begin_ ; j < end_ ; ++j) {
+            fold (tables[chunk_], source_ (j));
+        }
+    });
+
+    for (size_t i { 1 } ; i < chunks ; ++i) {
+        merge (tables[0], tables[i]);
+    }
+
+    std::vector<Row> rtn;
+    rtn.reserve (tables[0].size());
+
+    for (auto & entry : tables[0]) {
+        rtn.push_back (std::move (entry.second));
+    }
+
+    std::sort (rtn.begin(), rtn.end(), [](const Row & a_, const Row & b_) {
+        return a_.group < b_.group;
+    });
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * Tab separated with a heading, nulls left empty
+ */
+void
+Aggregation::tsv (std::ostream & out_, const std::vector<Row> & rows_) const {
+    const char * sep = "";
+
+    for (const auto & path : m_groupBy) {
+        out_ << sep << path;
+        sep = "\t";
+    }
+
+    for (const auto & measure : m_measures) {
+        out_ << sep << heading (measure);
+        sep = "\t";
+    }
+
+    out_ << std::endl;
+
+    for (const auto & row : rows_) {
+        sep = "";
+
+        for (const auto & value : row.group) {
+            out_ << sep << (value ? *value : "");
+            sep = "\t";
+        }
+
+        for (size_t i { 0 } ; i < m_measures.size() ; ++i) {
+            const auto & cell = row.cells[i];
+
+            out_ << sep;
+            if (m_measures[i].op == count_t) {
+                out_ << cell.count;
+            } else if (cell.count) {
+                out_ << cell.number.str();
+            }
+            sep = "\t";
+        }
+
+        out_ << std::endl;
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * A JSON object per row, group values are always strings
+ */
+void
+Aggregation::ndjson (std::ostream & out_, const std::vector<Row> & rows_) const {
+    for (const auto & row : rows_) {
+        const char * sep = "";
+        out_ << "{";
+
+        for (size_t i { 0 } ; i < m_groupBy.size() ; ++i) {
+            out_ << sep;
+            amqp::util::jsonString (m_groupBy[i], out_);
+            out_ << ":";
+
+            if (row.group[i]) {
+                amqp::util::jsonString (*row.group[i], out_);
+            } else {
+                out_ << "null";
+            }
+
+            sep = ",";
+        }
+
+        for (size_t i { 0 } ; i < m_measures.size() ; ++i) {
+            const auto & cell = row.cells[i];
+
+            out_ << sep;
+            amqp::util::jsonString (heading (m_measures[i]), out_);
+            out_ << ":";
+
+            if (m_measures[i].op == count_t) {
+                out_ << cell.count;
+            } else if (cell.count) {
+                out_ << cell.number.str();
+            } else {
+                out_ << "null";
+            }
+
+            sep = ",";
+        }
+
+        out_ << "}" << std::endl;
+    }
+}
+
+/******************************************************************************/
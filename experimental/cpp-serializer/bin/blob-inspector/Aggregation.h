@@ -0,0 +1,120 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <any>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+
+/******************************************************************************/
+
+/**
+ * Group-by aggregates over the fields of many blobs, the way a position
+ * report wants them
+ *
+ *   Aggregation agg ({ "tokenType" }, {
+ *       { Aggregation::count_t, "" },
+ *       { Aggregation::sum_t, "amount.quantity" } });
+ *
+ * Each worker folds the values of the blobs it's given into a table of
+ * its own, keyed on the group, and the tables are merged once they're
+ * all done. Values come straight from the readers as the types they
+ * read them as, nothing is rendered to text but the group keys.
+ *
+ * As in SQL nulls, and blobs without the field at all, are left out of
+ * sums, minimums and maximums but still counted.
+ */
+class Aggregation {
+    public :
+        enum op_t { count_t, sum_t, min_t, max_t };
+
+        struct Measure {
+            op_t        op;
+            std::string path;
+        };
+
+        /**
+         * Integers are kept as such until a real number turns up amongst
+         * them, or until their sum no longer fits in 64 bits, after which
+         * it carries on as a real number rather than wrapping
+         */
+        struct Number {
+            bool    real { false };
+            int64_t integer { 0 };
+            double  value { 0 };
+
+            double asReal() const { return real ? value : static_cast<double>(integer); }
+
+            bool operator < (const Number &) const;
+            Number & operator += (const Number &);
+
+            std::string str() const;
+        };
+
+        struct Cell {
+            uint64_t count { 0 };
+            Number   number;
+        };
+
+        /**
+         * Groups are told apart by the text of their values, a null
+         * being a group of its own
+         */
+        struct Row {
+            std::vector<std::optional<std::string>> group;
+            std::vector<Cell>                       cells;
+        };
+
+        /**
+         * The rows of one worker, or of all of them once merged
+         */
+        using Table = std::unordered_map<std::string, Row>;
+
+        /**
+         * Given a blob's ordinal the values at each of [paths] as its
+         * readers read them, called from several threads at once
+         */
+        using Source = std::function<std::vector<std::any> (size_t)>;
+
+    private :
+        std::vector<std::string> m_groupBy;
+        std::vector<Measure>     m_measures;
+
+        /**
+         * The group by paths followed by those being measured
+         */
+        std::vector<std::string> m_paths;
+
+        void fold (Table &, const std::vector<std::any> &) const;
+        void merge (Table &, Table &) const;
+
+    public :
+        /**
+         * @throws std::runtime_error if there's nothing to work out
+         */
+        Aggregation (std::vector<std::string> groupBy_, std::vector<Measure> measures_);
+
+        const std::vector<std::string> & paths() const { return m_paths; }
+
+        /**
+         * Aggregate [blobs_] blobs across [threads_] workers
+         *
+         * @return the rows, ordered by group with nulls first
+         */
+        std::vector<Row> run (size_t blobs_, const Source &, size_t threads_ = 1) const;
+
+        /**
+         * "count", "sum(amount.quantity)" and so on
+         */
+        std::string heading (const Measure &) const;
+
+        void tsv (std::ostream &, const std::vector<Row> &) const;
+        void ndjson (std::ostream &, const std::vector<Row> &) const;
+};
+
+/******************************************************************************/
@@ -0,0 +1,518 @@
+#include "ArrowStream.h"
+
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Values from Arrow's Schema.fbs and Message.fbs
+     */
+    namespace arrow {
+
+        const int16_t V5 = 4;
+
+        const uint8_t Schema          = 1;
+        const uint8_t DictionaryBatch = 2;
+        const uint8_t RecordBatch     = 3;
+
+        const uint8_t Int           = 2;
+        const uint8_t FloatingPoint = 3;
+        const uint8_t Utf8          = 5;
+        const uint8_t Bool          = 6;
+        const uint8_t List          = 12;
+        const uint8_t Struct        = 13;
+        const uint8_t Map           = 17;
+
+        const int16_t Double = 2;
+
+    }
+
+    /**
+     * Just enough of a flatbuffer builder to write Arrow's metadata. Like
+     * the real thing the buffer is built back to front so everything an
+     * object refers to is written before it, offsets are measured from
+     * the end of the buffer.
+     *
+     * Every field is written, defaults included, and vtables aren't
+     * shared, neither matter for the few hundred bytes a message needs.
+     */
+    class FlatBuilder {
+        private :
+            std::string m_buf;
+            size_t      m_minAlign { 1 };
+
+            size_t m_tableStart { 0 };
+            std::vector<std::pair<uint16_t, size_t>> m_slots;
+
+            void
+            align (size_t size_, size_t alignment_) {
+                m_minAlign = std::max (m_minAlign, alignment_);
+                auto pad = (alignment_ - ((m_buf.size() + size_) % alignment_)) % alignment_;
+                m_buf.insert (0, pad, '\0');
+            }
+
+            template<typename T>
+            void
+            scalar (T val_) {
+                align (sizeof (T), sizeof (T));
+
+                char bytes[sizeof (T)];
+                auto bits = static_cast<uint64_t>(val_);
+                for (auto & byte : bytes) {
+                    byte = static_cast<char>(bits & 0xFFU);
+                    bits >>= 8U;
+                }
+
+                m_buf.insert (0, bytes, sizeof (T));
+            }
+
+            void
+            uoffset (uint32_t off_) {
+                align (4, 4);
+                scalar<uint32_t> (static_cast<uint32_t>(m_buf.size() + 4 - off_));
+            }
+
+        public :
+            uint32_t
+            string (const std::string & str_) {
+                align (str_.size() + 1, 4);
+                m_buf.insert (0, 1, '\0');
+                m_buf.insert (0, str_);
+                scalar<uint32_t> (static_cast<uint32_t>(str_.size()));
+
+                return static_cast<uint32_t>(m_buf.size());
+            }
+
+            uint32_t
+            offsets (const std::vector<uint32_t> & offsets_) {
+                align (4 * offsets_.size(), 4);
+                for (auto it = offsets_.rbegin() ; it != offsets_.rend() ; ++it) {
+                    uoffset (*it);
+                }
+                scalar<uint32_t> (static_cast<uint32_t>(offsets_.size()));
+
+                return static_cast<uint32_t>(m_buf.size());
+            }
+
+            /**
+             * A vector of structs made of a pair of longs, which is both
+             * FieldNode and Buffer
+             */
+            uint32_t
+            pairs (const std::vector<int64_t> & longs_) {
+                align (8 * longs_.size(), 8);
+                for (auto it = longs_.rbegin() ; it != longs_.rend() ; ++it) {
+                    scalar<int64_t> (*it);
+                }
+                scalar<uint32_t> (static_cast<uint32_t>(longs_.size() / 2));
+
+                return static_cast<uint32_t>(m_buf.size());
+            }
+
+            void
+            start() {
+                m_tableStart = m_buf.size();
+                m_slots.clear();
+            }
+
+            template<typename T>
+            void
+            add (uint16_t slot_, T val_) {
+                scalar<T> (val_);
+                m_slots.emplace_back (slot_, m_buf.size());
+            }
+
+            void
+            addOffset (uint16_t slot_, uint32_t off_) {
+                uoffset (off_);
+                m_slots.emplace_back (slot_, m_buf.size());
+            }
+
+            uint32_t
+            end() {
+                scalar<int32_t> (0);
+                auto table = m_buf.size();
+
+                uint16_t count { 0 };
+                for (const auto & slot : m_slots) {
+                    count = std::max (count, static_cast<uint16_t>(slot.first + 1));
+                }
+
+                std::vector<uint16_t> vtable (count + 2, 0);
+                vtable[0] = static_cast<uint16_t>(2 * vtable.size());
+                vtable[1] = static_cast<uint16_t>(table - m_tableStart);
+                for (const auto & slot : m_slots) {
+                    vtable[2 + slot.first] = static_cast<uint16_t>(table - slot.second);
+                }
+
+                for (auto it = vtable.rbegin() ; it != vtable.rend() ; ++it) {
+                    scalar<uint16_t> (*it);
+                }
+
+                // the vtable sits in front of the table, point the table at it
+                auto soffset = static_cast<uint32_t>(m_buf.size() - table);
+                auto at = m_buf.size() - table;
+                for (int i { 0 } ; i < 4 ; ++i) {
+                    m_buf[at + i] = static_cast<char>((soffset >> (8U * i)) & 0xFFU);
+                }
+
+                return static_cast<uint32_t>(table);
+            }
+
+            std::string
+            finish (uint32_t root_) {
+                align (4, m_minAlign);
+                uoffset (root_);
+
+                return m_buf;
+            }
+    };
+
+    /**************************************************************************/
+
+    uint32_t
+    intType (FlatBuilder & fb_, int32_t bits_) {
+        fb_.start();
+        fb_.add<int32_t> (0, bits_);
+        fb_.add<uint8_t> (1, 1);
+        return fb_.end();
+    }
+
+    /**************************************************************************/
+
+    uint32_t
+    field (FlatBuilder & fb_, const Column & column_) {
+        std::vector<uint32_t> children;
+        children.reserve (column_.children.size());
+        for (const auto & child : column_.children) {
+            children.push_back (field (fb_, child));
+        }
+
+        auto childOffsets = fb_.offsets (children);
+        auto name = fb_.string (column_.name);
+
+        uint8_t type;
+        uint32_t typeOffset;
+        uint32_t dictionary { 0 };
+
+        switch (column_.kind) {
+            case AvroSchema::boolean_t : {
+                type = arrow::Bool;
+                fb_.start();
+                typeOffset = fb_.end();
+                break;
+            }
+            case AvroSchema::int_t : {
+                type = arrow::Int;
+                typeOffset = intType (fb_, 32);
+                break;
+            }
+            case AvroSchema::long_t : {
+                type = arrow::Int;
+                typeOffset = intType (fb_, 64);
+                break;
+            }
+            case AvroSchema::double_t : {
+                type = arrow::FloatingPoint;
+                fb_.start();
+                fb_.add<int16_t> (0, arrow::Double);
+                typeOffset = fb_.end();
+                break;
+            }
+            case AvroSchema::string_t : {
+                type = arrow::Utf8;
+                fb_.start();
+                typeOffset = fb_.end();
+                break;
+            }
+            case AvroSchema::enum_t : {
+                // the column holds indices into a dictionary of strings
+                auto index = intType (fb_, 32);
+                fb_.start();
+                fb_.add<int64_t> (0, static_cast<int64_t>(column_.node));
+                fb_.addOffset (1, index);
+                fb_.add<uint8_t> (2, 0);
+                dictionary = fb_.end();
+
+                type = arrow::Utf8;
+                fb_.start();
+                typeOffset = fb_.end();
+                break;
+            }
+            case AvroSchema::record_t : {
+                type = arrow::Struct;
+                fb_.start();
+                typeOffset = fb_.end();
+                break;
+            }
+            case AvroSchema::array_t : {
+                type = arrow::List;
+                fb_.start();
+                typeOffset = fb_.end();
+                break;
+            }
+            case AvroSchema::map_t :
+            case AvroSchema::pairs_t : {
+                type = arrow::Map;
+                fb_.start();
+                fb_.add<uint8_t> (0, 0);
+                typeOffset = fb_.end();
+                break;
+            }
+            default :
+                throw std::runtime_error ("Unexpected column type");
+        }
+
+        fb_.start();
+        fb_.addOffset (0, name);
+        fb_.add<uint8_t> (1, column_.nullable ? 1 : 0);
+        fb_.add<uint8_t> (2, type);
+        fb_.addOffset (3, typeOffset);
+        if (dictionary) fb_.addOffset (4, dictionary);
+        fb_.addOffset (5, childOffsets);
+        return fb_.end();
+    }
+
+    /**************************************************************************/
+
+    /**
+     * The field nodes, buffer locations and body of a record batch
+     */
+    struct Batch {
+        std::vector<int64_t> nodes;
+        std::vector<int64_t> buffers;
+        std::string          body;
+
+        void
+        buffer (const char * bytes_, size_t size_) {
+            buffers.push_back (static_cast<int64_t>(body.size()));
+            buffers.push_back (static_cast<int64_t>(size_));
+
+            body.append (bytes_, size_);
+            body.append ((8 - (body.size() % 8)) % 8, '\0');
+        }
+
+        template<typename T>
+        void
+        buffer (const std::vector<T> & values_) {
+            buffer (reinterpret_cast<const char *>(values_.data()), sizeof (T) * values_.size());
+        }
+
+        void
+        column (const Column & column_) {
+            nodes.push_back (column_.length);
+            nodes.push_back (column_.nulls);
+
+            // without any nulls the validity bitmap can be left out
+            if (column_.nulls) {
+                buffer (column_.validity.data(), column_.validity.size());
+            } else {
+                buffer (nullptr, 0);
+            }
+
+            switch (column_.kind) {
+                case AvroSchema::string_t :
+                    buffer (column_.offsets);
+                    buffer (column_.data.data(), column_.data.size());
+                    break;
+                case AvroSchema::array_t :
+                case AvroSchema::map_t :
+                case AvroSchema::pairs_t :
+                    buffer (column_.offsets);
+                    break;
+                case AvroSchema::record_t :
+                    break;
+                default :
+                    buffer (column_.data.data(), column_.data.size());
+                    break;
+            }
+
+            for (const auto & child : column_.children) {
+                this->column (child);
+            }
+        }
+    };
+
+    /**************************************************************************/
+
+    uint32_t
+    recordBatch (FlatBuilder & fb_, int64_t length_, const Batch & batch_) {
+        auto nodes = fb_.pairs (batch_.nodes);
+        auto buffers = fb_.pairs (batch_.buffers);
+
+        fb_.start();
+        fb_.add<int64_t> (0, length_);
+        fb_.addOffset (1, nodes);
+        fb_.addOffset (2, buffers);
+        return fb_.end();
+    }
+
+    /**************************************************************************/
+
+    std::string
+    finishMessage (FlatBuilder & fb_, uint8_t type_, uint32_t header_, size_t bodyLength_) {
+        fb_.start();
+        fb_.add<int16_t> (0, arrow::V5);
+        fb_.add<uint8_t> (1, type_);
+        fb_.addOffset (2, header_);
+        fb_.add<int64_t> (3, static_cast<int64_t>(bodyLength_));
+        return fb_.finish (fb_.end());
+    }
+
+    /**************************************************************************/
+
+    void
+    enums (const Column & column_, std::set<size_t> & seen_, std::vector<size_t> & out_) {
+        if (column_.kind == AvroSchema::enum_t && seen_.insert (column_.node).second) {
+            out_.push_back (column_.node);
+        }
+
+        for (const auto & child : column_.children) {
+            enums (child, seen_, out_);
+        }
+    }
+
+    /**************************************************************************/
+
+    void
+    writeInt (std::ofstream & out_, uint32_t val_) {
+        char bytes[4];
+        for (auto & byte : bytes) {
+            byte = static_cast<char>(val_ & 0xFFU);
+            val_ >>= 8U;
+        }
+        out_.write (bytes, sizeof (bytes));
+    }
+
+}
+
+/******************************************************************************/
+
+ArrowStream::ArrowStream (
+    const std::string & path_,
+    const Columns & columns_
+) : m_out (path_, std::ios::binary | std::ios::trunc)
+  , m_closed (false)
+{
+    if (!m_out) {
+        throw std::runtime_error ("Can't open " + path_ + " for writing");
+    }
+
+    {
+        FlatBuilder fb;
+
+        std::vector<uint32_t> fields;
+        for (const auto & column : columns_.columns()) {
+            fields.push_back (field (fb, column));
+        }
+
+        auto fieldOffsets = fb.offsets (fields);
+
+        fb.start();
+        fb.add<int16_t> (0, 0); // little endian
+        fb.addOffset (1, fieldOffsets);
+        auto schema = fb.end();
+
+        message (finishMessage (fb, arrow::Schema, schema, 0), "");
+    }
+
+    std::set<size_t> seen;
+    std::vector<size_t> dictionaries;
+    for (const auto & column : columns_.columns()) {
+        enums (column, seen, dictionaries);
+    }
+
+    for (auto id : dictionaries) {
+        Column constants ("", AvroSchema::string_t, id, false);
+        for (const auto & symbol : columns_.schema().nodes()[id].symbols) {
+            constants.data += symbol;
+            constants.offsets.push_back (static_cast<int32_t>(constants.data.size()));
+            ++constants.length;
+        }
+
+        Batch batch;
+        batch.column (constants);
+
+        FlatBuilder fb;
+        auto data = recordBatch (fb, constants.length, batch);
+
+        fb.start();
+        fb.add<int64_t> (0, static_cast<int64_t>(id));
+        fb.addOffset (1, data);
+        fb.add<uint8_t> (2, 0);
+        auto header = fb.end();
+
+        message (finishMessage (fb, arrow::DictionaryBatch, header, batch.body.size()), batch.body);
+    }
+}
+
+/******************************************************************************/
+
+ArrowStream::~ArrowStream() {
+    try {
+        close();
+    } catch (...) {
+        // nothing sensible to be done
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * An encapsulated message is a continuation marker, the length of the
+ * metadata padded so the body starts on an 8 byte boundary, the metadata
+ * and then the body
+ */
+void
+ArrowStream::message (const std::string & metadata_, const std::string & body_) {
+    auto padding = (8 - ((8 + metadata_.size()) % 8)) % 8;
+
+    writeInt (m_out, 0xFFFFFFFF);
+    writeInt (m_out, static_cast<uint32_t>(metadata_.size() + padding));
+    m_out.write (metadata_.data(), metadata_.size());
+    m_out.write ("\0\0\0\0\0\0\0", padding);
+    m_out.write (body_.data(), body_.size());
+
+    if (!m_out) {
+        throw std::runtime_error ("Failed writing Arrow stream");
+    }
+}
+
+/******************************************************************************/
+
+void
+ArrowStream::write (const Columns & columns_) {
+    if (!columns_.rows()) {
+        return;
+    }
+
+    Batch batch;
+    for (const auto & column : columns_.columns()) {
+        batch.column (column);
+    }
+
+    FlatBuilder fb;
+    auto header = recordBatch (fb, columns_.rows(), batch);
+
+    message (finishMessage (fb, arrow::RecordBatch, header, batch.body.size()), batch.body);
+}
+
+/******************************************************************************/
+
+void
+ArrowStream::close() {
+    if (m_closed) {
+        return;
+    }
+    m_closed = true;
+
+    writeInt (m_out, 0xFFFFFFFF);
+    writeInt (m_out, 0);
+    m_out.close();
+}
+
+/******************************************************************************/
@@ -0,0 +1,48 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <fstream>
+
+#include "Columns.h"
+
+/******************************************************************************/
+
+/**
+ * Writes Arrow IPC stream files
+ *
+ *   schema message
+ *   a dictionary batch per enum, holding its constants
+ *   record batch ...
+ *   end of stream marker
+ *
+ * The flatbuffer metadata is built by hand rather than pulling in the
+ * flatbuffers and Arrow libraries for the handful of tables we need.
+ */
+class ArrowStream {
+    private :
+        std::ofstream m_out;
+        bool          m_closed;
+
+        void message (const std::string &, const std::string &);
+
+    public :
+        /**
+         * Opens the file and writes the schema and dictionaries of the
+         * columns
+         */
+        ArrowStream (const std::string &, const Columns &);
+        ~ArrowStream();
+
+        ArrowStream (const ArrowStream &) = delete;
+
+        /**
+         * Write every row currently held by the columns as a record batch
+         */
+        void write (const Columns &);
+
+        void close();
+};
+
+/******************************************************************************/
@@ -0,0 +1,184 @@
+#include "AvroContainer.h"
+#include "AvroSchema.h"
+
+#include <random>
+#include <stdexcept>
+
+#ifdef BLOB_INSPECTOR_ZLIB
+#include <zlib.h>
+#endif
+
+/******************************************************************************/
+
+namespace {
+
+    const std::array<char, 4> MAGIC { { 'O', 'b', 'j', 1 } };
+
+#ifdef BLOB_INSPECTOR_ZLIB
+
+    /**
+     * Avro's deflate codec is raw RFC 1951 data, no zlib header or
+     * checksum, hence the negative window size
+     */
+    std::string
+    deflate (const std::string & in_) {
+        z_stream zs { };
+
+        if (deflateInit2 (&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+                Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw std::runtime_error ("Failed to initialise deflate");
+        }
+
+        std::string out (deflateBound (&zs, in_.size()), '\0');
+
+        zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in_.data()));
+        zs.avail_in = static_cast<uInt>(in_.size());
+        zs.next_out = reinterpret_cast<Bytef *>(&out[0]);
+        zs.avail_out = static_cast<uInt>(out.size());
+
+        auto rtn = ::deflate (&zs, Z_FINISH);
+        out.resize (zs.total_out);
+        deflateEnd (&zs);
+
+        if (rtn != Z_STREAM_END) {
+            throw std::runtime_error ("Failed to deflate block");
+        }
+
+        return out;
+    }
+
+#endif
+
+}
+
+/******************************************************************************
+ *
+ * AvroContainer statics
+ *
+ ******************************************************************************/
+
+bool
+AvroContainer::deflateSupported() {
+#ifdef BLOB_INSPECTOR_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+/******************************************************************************
+ *
+ * AvroContainer
+ *
+ ******************************************************************************/
+
+AvroContainer::AvroContainer (
+    const std::string & path_,
+    const std::string & schema_,
+    bool deflate_
+) : m_file (path_, std::ios::out | std::ios::binary | std::ios::trunc)
+  , m_sync { }
+  , m_count { 0 }
+  , m_deflate { deflate_ }
+{
+    if (!m_file) {
+        throw std::runtime_error ("Cannot open " + path_);
+    }
+
+    if (m_deflate && !deflateSupported()) {
+        throw std::runtime_error ("Built without zlib, cannot deflate");
+    }
+
+    std::random_device rd;
+    for (auto & c : m_sync) {
+        c = static_cast<char>(rd());
+    }
+
+    m_block.reserve (BLOCK_SIZE * 2);
+
+    writeHeader (schema_);
+}
+
+/******************************************************************************/
+
+AvroContainer::~AvroContainer() {
+    try {
+        flush();
+    } catch (...) {
+        // nothing sensible to do with a failure this late
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * The header is the magic, the file metadata as an Avro map of string
+ * to bytes, and the sync marker.
+ */
+void
+AvroContainer::writeHeader (const std::string & schema_) {
+    const std::string codec { m_deflate ? "deflate" : "null" };
+    const std::string schemaKey { "avro.schema" };
+    const std::string codecKey { "avro.codec" };
+
+    std::string header (MAGIC.begin(), MAGIC.end());
+
+    AvroSchema::writeLong (2, header);
+    AvroSchema::writeBytes (schemaKey.data(), schemaKey.size(), header);
+    AvroSchema::writeBytes (schema_.data(), schema_.size(), header);
+    AvroSchema::writeBytes (codecKey.data(), codecKey.size(), header);
+    AvroSchema::writeBytes (codec.data(), codec.size(), header);
+    AvroSchema::writeLong (0, header);
+
+    header.append (m_sync.begin(), m_sync.end());
+
+    m_file.write (header.data(), header.size());
+}
+
+/******************************************************************************/
+
+void
+AvroContainer::append (const std::string & record_) {
+    m_block += record_;
+    ++m_count;
+
+    if (m_block.size() >= BLOCK_SIZE) {
+        flush();
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * A block is the number of records it holds, the size in bytes of
+ * those records once the codec has been applied, the records, and then
+ * the sync marker.
+ */
+void
+AvroContainer::flush() {
+    if (!m_count) return;
+
+    std::string deflated;
+#ifdef BLOB_INSPECTOR_ZLIB
+    if (m_deflate) deflated = deflate (m_block);
+#endif
+    const auto & body = m_deflate ? deflated : m_block;
+
+    std::string prefix;
+    AvroSchema::writeLong (static_cast<int64_t>(m_count), prefix);
+    AvroSchema::writeLong (static_cast<int64_t>(body.size()), prefix);
+
+    m_file.write (prefix.data(), prefix.size());
+    m_file.write (body.data(), body.size());
+    m_file.write (m_sync.data(), m_sync.size());
+
+    if (!m_file) {
+        throw std::runtime_error ("Failed writing Avro block");
+    }
+
+    m_block.clear();
+    m_count = 0;
+}
+
+/******************************************************************************/
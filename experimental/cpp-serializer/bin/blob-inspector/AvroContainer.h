@@ -0,0 +1,53 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <array>
+#include <string>
+#include <fstream>
+
+/******************************************************************************/
+
+/**
+ * Writes an Avro object container file: the schema once in the header
+ * followed by blocks of encoded records separated by a sync marker.
+ *
+ * Blocks are optionally deflated when built against zlib.
+ */
+class AvroContainer {
+    public :
+        /**
+         * Once a block has accumulated this many bytes of encoded records
+         * it's written out
+         */
+        static constexpr size_t BLOCK_SIZE { 64 * 1024 };
+
+        static bool deflateSupported();
+
+    private :
+        std::ofstream m_file;
+
+        std::array<char, 16> m_sync;
+
+        std::string m_block;
+        size_t      m_count;
+        bool        m_deflate;
+
+        void writeHeader (const std::string &);
+
+    public :
+        AvroContainer (const std::string &, const std::string &, bool);
+        ~AvroContainer();
+
+        AvroContainer (const AvroContainer &) = delete;
+
+        /**
+         * Add a single record, already Avro binary encoded against the
+         * schema the container was created with
+         */
+        void append (const std::string &);
+
+        void flush();
+};
+
+/******************************************************************************/
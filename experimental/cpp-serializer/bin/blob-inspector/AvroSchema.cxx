@@ -0,0 +1,586 @@
+#include "AvroSchema.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Map.h"
+#include "amqp/schema/restricted-types/List.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Array.h"
+#include "amqp/util/Json.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::map<std::string, AvroSchema::Kind> primitives = { // NOLINT
+        { "boolean", AvroSchema::boolean_t },
+        { "bool",    AvroSchema::boolean_t },
+        { "int",     AvroSchema::int_t },
+        { "long",    AvroSchema::long_t },
+        { "double",  AvroSchema::double_t },
+        { "string",  AvroSchema::string_t }
+    };
+
+    /**
+     * doubles are written as 8 little endian bytes regardless of the host
+     */
+    void
+    writeDouble (double val_, std::string & out_) {
+        uint64_t bits;
+        memcpy (&bits, &val_, sizeof (bits));
+
+        for (int i { 0 } ; i < 8 ; ++i) {
+            out_.push_back (static_cast<char>(bits & 0xFFU));
+            bits >>= 8U;
+        }
+    }
+
+    void
+    jsonDouble (double val_, std::string & out_) {
+        if (!std::isfinite (val_)) {
+            out_ += "null";
+            return;
+        }
+
+        char buf[32];
+        snprintf (buf, sizeof (buf), "%.17g", val_);
+        out_ += buf;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * AvroSchema statics
+ *
+ ******************************************************************************/
+
+/**
+ * Avro names are [A-Za-z_][A-Za-z0-9_]* joined by dots, Java names
+ * can contain $ (inner classes) and our restricted types carry their
+ * generic parameters in theirs
+ */
+std::string
+AvroSchema::sanitise (const std::string & name_) {
+    std::string rtn;
+    rtn.reserve (name_.size() + 1);
+
+    bool start { true };
+    for (auto c : name_) {
+        if (c == '.') {
+            rtn.push_back (c);
+            start = true;
+            continue;
+        }
+
+        if (start && isdigit (c)) rtn.push_back ('_');
+        rtn.push_back ((isalnum (c) || c == '_') ? c : '_');
+        start = false;
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+std::string
+AvroSchema::symbol (const std::string & name_) {
+    auto rtn = sanitise (name_);
+    std::replace (rtn.begin(), rtn.end(), '.', '_');
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * Avro ints and longs are zig-zag encoded variable length integers
+ */
+void
+AvroSchema::writeLong (int64_t val_, std::string & out_) {
+    auto n = (static_cast<uint64_t>(val_) << 1U) ^ static_cast<uint64_t>(val_ >> 63);
+
+    while (n & ~0x7FUL) {
+        out_.push_back (static_cast<char>((n & 0x7FU) | 0x80U));
+        n >>= 7U;
+    }
+    out_.push_back (static_cast<char>(n));
+}
+
+/******************************************************************************/
+
+void
+AvroSchema::writeBytes (const char * bytes_, size_t size_, std::string & out_) {
+    writeLong (static_cast<int64_t>(size_), out_);
+    out_.append (bytes_, size_);
+}
+
+/******************************************************************************/
+
+pn_bytes_t
+AvroSchema::readString (pn_data_t * data_) {
+    switch (pn_data_type (data_)) {
+        case PN_STRING : return pn_data_get_string (data_);
+        case PN_SYMBOL : return pn_data_get_symbol (data_);
+        default : throw std::runtime_error ("Expected a String");
+    }
+}
+
+/******************************************************************************/
+
+int64_t
+AvroSchema::readSymbol (pn_data_t * data_, const Node & node_) {
+    auto bytes = readString (data_);
+    std::string name (bytes.start, bytes.size);
+
+    auto it = std::find (node_.symbols.begin(), node_.symbols.end(), symbol (name));
+
+    if (it == node_.symbols.end()) {
+        throw std::runtime_error ("Unknown enum constant " + name);
+    }
+
+    return static_cast<int64_t>(it - node_.symbols.begin());
+}
+
+/******************************************************************************
+ *
+ * AvroSchema
+ *
+ ******************************************************************************/
+
+AvroSchema::AvroSchema (
+    const amqp::internal::schema::Schema & schema_,
+    const std::string & descriptor_
+) {
+    TypeMap types;
+    const amqp::internal::schema::AMQPTypeNotation * root { nullptr };
+
+    for (const auto & level : schema_) {
+        for (const auto & type : level) {
+            types[type->name()] = type.get();
+            if (type->descriptor() == descriptor_) root = type.get();
+        }
+    }
+
+    if (!root) {
+        throw std::runtime_error ("No type with descriptor " + descriptor_);
+    }
+
+    m_root = node (root->name(), types);
+
+    std::vector<bool> emitted (m_nodes.size(), false);
+    json (m_root, emitted, m_json);
+}
+
+/******************************************************************************/
+
+size_t
+AvroSchema::node (
+    const std::string & type_,
+    const TypeMap & types_
+) {
+    auto known = m_byType.find (type_);
+    if (known != m_byType.end()) {
+        return known->second;
+    }
+
+    auto prim = primitives.find (type_);
+    if (prim != primitives.end()) {
+        m_nodes.push_back ({ prim->second, type_, { }, { }, 0 });
+        return m_byType[type_] = m_nodes.size() - 1;
+    }
+
+    auto it = types_.find (type_);
+    if (it == types_.end()) {
+        throw std::runtime_error ("Unknown type " + type_);
+    }
+
+    switch (it->second->type()) {
+        case amqp::internal::schema::AMQPTypeNotation::composite_t :
+            return composite (*it->second, types_);
+        case amqp::internal::schema::AMQPTypeNotation::restricted_t :
+            return restricted (*it->second, types_);
+    }
+
+    throw std::runtime_error ("Unknown type notation for " + type_);
+}
+
+/******************************************************************************/
+
+size_t
+AvroSchema::composite (
+    const amqp::internal::schema::AMQPTypeNotation & type_,
+    const TypeMap & types_
+) {
+    // register ourselves before looking at our fields so a type that
+    // refers back to itself finds us rather than recursing forever
+    m_nodes.push_back ({ record_t, sanitise (type_.name()), { }, { }, 0 });
+    auto idx = m_byType[type_.name()] = m_nodes.size() - 1;
+
+    const auto & composite = dynamic_cast<const amqp::internal::schema::Composite &>(type_);
+
+    std::vector<Field> fields;
+    fields.reserve (composite.fields().size());
+
+    for (const auto & field : composite.fields()) {
+        fields.push_back ({
+            sanitise (field->name()),
+            node (field->resolvedType(), types_),
+            !field->mandatory() });
+    }
+
+    m_nodes[idx].fields = std::move (fields);
+
+    return idx;
+}
+
+/******************************************************************************/
+
+size_t
+AvroSchema::restricted (
+    const amqp::internal::schema::AMQPTypeNotation & type_,
+    const TypeMap & types_
+) {
+    using namespace amqp::internal::schema;
+
+    const auto & restricted = dynamic_cast<const Restricted &>(type_);
+
+    Node n { array_t, sanitise (type_.name()), { }, { }, 0 };
+
+    switch (restricted.restrictedType()) {
+        case Restricted::RestrictedTypes::list_t : {
+            n.items = node (dynamic_cast<const List &>(restricted).listOf(), types_);
+            break;
+        }
+        case Restricted::RestrictedTypes::array_t : {
+            n.items = node (dynamic_cast<const Array &>(restricted).arrayOf(), types_);
+            break;
+        }
+        case Restricted::RestrictedTypes::enum_t : {
+            n.kind = enum_t;
+            for (const auto & choice : dynamic_cast<const Enum &>(restricted).makeChoices()) {
+                n.symbols.emplace_back (symbol (choice));
+            }
+            break;
+        }
+        case Restricted::RestrictedTypes::map_t : {
+            auto types = dynamic_cast<const Map &>(restricted).mapOf();
+            auto key = node (types.first, types_);
+            auto value = node (types.second, types_);
+
+            if (m_nodes[key].kind == string_t) {
+                n.kind = map_t;
+                n.items = value;
+            } else {
+                m_nodes.push_back ({
+                    record_t, n.name, { { "key", key, false }, { "value", value, false } }, { }, 0 });
+                n.kind = pairs_t;
+                n.items = m_nodes.size() - 1;
+            }
+            break;
+        }
+    }
+
+    m_nodes.emplace_back (std::move (n));
+    return m_byType[type_.name()] = m_nodes.size() - 1;
+}
+
+/******************************************************************************/
+
+void
+AvroSchema::json (
+    size_t idx_,
+    std::vector<bool> & emitted_,
+    std::string & out_
+) const {
+    const auto & n = m_nodes[idx_];
+
+    switch (n.kind) {
+        case boolean_t : out_ += "\"boolean\""; return;
+        case int_t     : out_ += "\"int\""; return;
+        case long_t    : out_ += "\"long\""; return;
+        case double_t  : out_ += "\"double\""; return;
+        case string_t  : out_ += "\"string\""; return;
+        case array_t   :
+        case pairs_t   : {
+            out_ += R"({"type":"array","items":)";
+            json (n.items, emitted_, out_);
+            out_ += "}";
+            return;
+        }
+        case map_t : {
+            out_ += R"({"type":"map","values":)";
+            json (n.items, emitted_, out_);
+            out_ += "}";
+            return;
+        }
+        default : break;
+    }
+
+    // named types are only ever defined once, after that we refer to them
+    if (emitted_[idx_]) {
+        out_ += "\"" + n.name + "\"";
+        return;
+    }
+    emitted_[idx_] = true;
+
+    if (n.kind == enum_t) {
+        out_ += R"({"type":"enum","name":")" + n.name + R"(","symbols":[)";
+        for (auto it = n.symbols.begin() ; it != n.symbols.end() ; ++it) {
+            if (it != n.symbols.begin()) out_ += ",";
+            out_ += "\"" + *it + "\"";
+        }
+        out_ += "]}";
+        return;
+    }
+
+    out_ += R"({"type":"record","name":")" + n.name + R"(","fields":[)";
+    for (auto it = n.fields.begin() ; it != n.fields.end() ; ++it) {
+        if (it != n.fields.begin()) out_ += ",";
+        out_ += R"({"name":")" + it->name + R"(","type":)";
+        if (it->nullable) {
+            out_ += R"(["null",)";
+            json (it->node, emitted_, out_);
+            out_ += "]";
+        } else {
+            json (it->node, emitted_, out_);
+        }
+        out_ += "}";
+    }
+    out_ += "]}";
+}
+
+/******************************************************************************/
+
+void
+AvroSchema::encode (pn_data_t * data_, std::string & out_) const {
+    encode (m_root, data_, out_);
+}
+
+/******************************************************************************/
+
+void
+AvroSchema::encode (size_t idx_, pn_data_t * data_, std::string & out_) const {
+    const auto & n = m_nodes[idx_];
+
+    proton::auto_next an (data_);
+
+    switch (n.kind) {
+        case boolean_t : {
+            out_.push_back (pn_data_get_bool (data_) ? 1 : 0);
+            break;
+        }
+        case int_t : {
+            writeLong (pn_data_get_int (data_), out_);
+            break;
+        }
+        case long_t : {
+            writeLong (pn_data_get_long (data_), out_);
+            break;
+        }
+        case double_t : {
+            writeDouble (pn_data_get_double (data_), out_);
+            break;
+        }
+        case string_t : {
+            auto str = readString (data_);
+            writeBytes (str.start, str.size, out_);
+            break;
+        }
+        case record_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::is_list (data_);
+
+            proton::auto_list_enter ale (data_, true);
+
+            for (const auto & field : n.fields) {
+                if (field.nullable) {
+                    if (pn_data_type (data_) == PN_NULL) {
+                        writeLong (0, out_);
+                        pn_data_next (data_);
+                        continue;
+                    }
+                    writeLong (1, out_);
+                }
+                encode (field.node, data_, out_);
+            }
+            break;
+        }
+        case enum_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_list_enter ale (data_, true);
+
+            writeLong (readSymbol (data_, n), out_);
+            break;
+        }
+        case array_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_list_enter ale (data_, true);
+
+            if (ale.elements()) {
+                writeLong (static_cast<int64_t>(ale.elements()), out_);
+                for (size_t i { 0 } ; i < ale.elements() ; ++i) {
+                    encode (n.items, data_, out_);
+                }
+            }
+            writeLong (0, out_);
+            break;
+        }
+        case map_t :
+        case pairs_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_map_enter am (data_, true);
+
+            auto key = (n.kind == map_t) ? 0 : m_nodes[n.items].fields[0].node;
+            auto value = (n.kind == map_t) ? n.items : m_nodes[n.items].fields[1].node;
+
+            if (am.elements()) {
+                writeLong (static_cast<int64_t>(am.elements() / 2), out_);
+                for (size_t i { 0 } ; i < am.elements() ; i += 2) {
+                    if (n.kind == map_t) {
+                        auto str = readString (data_);
+                        writeBytes (str.start, str.size, out_);
+                        pn_data_next (data_);
+                    } else {
+                        encode (key, data_, out_);
+                    }
+                    encode (value, data_, out_);
+                }
+            }
+            writeLong (0, out_);
+            break;
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+AvroSchema::encodeJson (pn_data_t * data_, std::string & out_, bool named_) const {
+    encodeJson (m_root, data_, out_, named_);
+}
+
+/******************************************************************************/
+
+void
+AvroSchema::encodeJson (
+    size_t idx_,
+    pn_data_t * data_,
+    std::string & out_,
+    bool named_
+) const {
+    const auto & n = m_nodes[idx_];
+
+    proton::auto_next an (data_);
+
+    if (pn_data_type (data_) == PN_NULL) {
+        out_ += "null";
+        return;
+    }
+
+    switch (n.kind) {
+        case boolean_t : {
+            out_ += pn_data_get_bool (data_) ? "true" : "false";
+            break;
+        }
+        case int_t : {
+            out_ += std::to_string (pn_data_get_int (data_));
+            break;
+        }
+        case long_t : {
+            out_ += std::to_string (pn_data_get_long (data_));
+            break;
+        }
+        case double_t : {
+            jsonDouble (pn_data_get_double (data_), out_);
+            break;
+        }
+        case string_t : {
+            auto str = readString (data_);
+            amqp::util::jsonString (std::string_view (str.start, str.size), out_);
+            break;
+        }
+        case record_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::is_list (data_);
+
+            proton::auto_list_enter ale (data_, true);
+
+            out_.push_back (named_ ? '{' : '[');
+            for (auto it = n.fields.begin() ; it != n.fields.end() ; ++it) {
+                if (it != n.fields.begin()) out_.push_back (',');
+                if (named_) {
+                    amqp::util::jsonString (it->name, out_);
+                    out_.push_back (':');
+                }
+                encodeJson (it->node, data_, out_, named_);
+            }
+            out_.push_back (named_ ? '}' : ']');
+            break;
+        }
+        case enum_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_list_enter ale (data_, true);
+
+            auto str = readString (data_);
+            amqp::util::jsonString (std::string_view (str.start, str.size), out_);
+            break;
+        }
+        case array_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_list_enter ale (data_, true);
+
+            out_.push_back ('[');
+            for (size_t i { 0 } ; i < ale.elements() ; ++i) {
+                if (i) out_.push_back (',');
+                encodeJson (n.items, data_, out_, named_);
+            }
+            out_.push_back (']');
+            break;
+        }
+        case map_t :
+        case pairs_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_map_enter am (data_, true);
+
+            out_.push_back (n.kind == map_t ? '{' : '[');
+            for (size_t i { 0 } ; i < am.elements() ; i += 2) {
+                if (i) out_.push_back (',');
+                if (n.kind == map_t) {
+                    auto str = readString (data_);
+                    amqp::util::jsonString (std::string_view (str.start, str.size), out_);
+                    pn_data_next (data_);
+                    out_.push_back (':');
+                    encodeJson (n.items, data_, out_, named_);
+                } else {
+                    out_.push_back ('[');
+                    encodeJson (m_nodes[n.items].fields[0].node, data_, out_, named_);
+                    out_.push_back (',');
+                    encodeJson (m_nodes[n.items].fields[1].node, data_, out_, named_);
+                    out_.push_back (']');
+                }
+            }
+            out_.push_back (n.kind == map_t ? '}' : ']');
+            break;
+        }
+    }
+}
+
+/******************************************************************************/
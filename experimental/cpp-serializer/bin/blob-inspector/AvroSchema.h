@@ -0,0 +1,136 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <proton/types.h>
+
+#include "types.h"
+
+namespace amqp::internal::schema {
+
+    class Schema;
+    class AMQPTypeNotation;
+
+}
+
+/******************************************************************************/
+
+/**
+ * An Avro schema derived from the Corda schema carried in a blob's
+ * Envelope, rooted at the type the blob is an instance of.
+ *
+ * The mapping is
+ *
+ *   Composite        -> record
+ *   List / Array     -> array
+ *   Map<string, V>   -> map
+ *   Map<K, V>        -> array of { key, value } records (Avro map keys
+ *                       can only be strings)
+ *   Enum             -> enum
+ *   non mandatory    -> [ "null", T ]
+ *
+ * Deriving the schema compiles it into a flat table of nodes that the
+ * encoders walk alongside the proton tree, so per value work is a switch
+ * on the node kind rather than any lookup into the Corda schema.
+ */
+class AvroSchema {
+    public :
+        enum Kind {
+            boolean_t, int_t, long_t, double_t, string_t,
+            record_t, enum_t, array_t, map_t, pairs_t
+        };
+
+        struct Field {
+            std::string name;
+            size_t      node;
+            bool        nullable;
+        };
+
+        struct Node {
+            Kind                     kind;
+            std::string              name;    // records and enums
+            std::vector<Field>       fields;  // records, and the key / value of pairs
+            std::vector<std::string> symbols; // enums
+            size_t                   items;   // element type of arrays and maps
+        };
+
+    private :
+        std::vector<Node> m_nodes;
+
+        /**
+         * Named Avro types can only be defined once, every other use has
+         * to be by name, so remember what we've made for each Corda type
+         */
+        std::map<std::string, size_t> m_byType;
+
+        size_t m_root;
+
+        std::string m_json;
+
+        using TypeMap = std::map<std::string, const amqp::internal::schema::AMQPTypeNotation *>;
+
+        size_t node (const std::string &, const TypeMap &);
+        size_t restricted (const amqp::internal::schema::AMQPTypeNotation &, const TypeMap &);
+        size_t composite (const amqp::internal::schema::AMQPTypeNotation &, const TypeMap &);
+
+        void json (size_t, std::vector<bool> &, std::string &) const;
+
+        void encode (size_t, pn_data_t *, std::string &) const;
+
+    public :
+        static std::string sanitise (const std::string &);
+
+        /**
+         * An enum constant's name as an Avro symbol, which unlike other
+         * names can't be dotted
+         */
+        static std::string symbol (const std::string &);
+
+        static void writeLong (int64_t, std::string &);
+        static void writeBytes (const char *, size_t, std::string &);
+
+        /**
+         * The string or symbol under the cursor
+         */
+        static pn_bytes_t readString (pn_data_t *);
+
+        /**
+         * The index into an enum node's symbols of the constant under the
+         * cursor. Enumerations carry both the constant's name and its
+         * ordinal, we go by name as that's what the schema's choices list,
+         * made a symbol the same way they were
+         */
+        static int64_t readSymbol (pn_data_t *, const Node &);
+
+        AvroSchema (const amqp::internal::schema::Schema &, const std::string &);
+
+        const std::string & json() const { return m_json; }
+        const std::string & name() const { return m_nodes[m_root].name; }
+
+        const std::vector<Node> & nodes() const { return m_nodes; }
+        size_t root() const { return m_root; }
+
+        /**
+         * Append the Avro binary encoding of the value under the cursor
+         */
+        void encode (pn_data_t *, std::string &) const;
+
+        /**
+         * Append a JSON rendering of the value under the cursor where, as
+         * the schema already names them, records are positional arrays
+         * rather than repeating every field name. Unless [named_] is set
+         * in which case they're objects keyed on their field names.
+         */
+        void encodeJson (pn_data_t *, std::string &, bool named_ = false) const;
+
+        /**
+         * As above for a value of the type described by the given node
+         */
+        void encodeJson (size_t, pn_data_t *, std::string &, bool named_) const;
+};
+
+/******************************************************************************/
@@ -0,0 +1,411 @@
+#include "BlobDiff.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "BlobInspector.h"
+
+#include "amqp/reader/IVisitor.h"
+#include "amqp/util/Json.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    put (std::string & buf_, const std::string & s_) {
+        auto size = static_cast<uint32_t>(s_.size());
+
+        for (int i { 0 } ; i < 4 ; ++i) {
+            buf_ += static_cast<char>((size >> (8 * i)) & 0xff);
+        }
+
+        buf_ += s_;
+    }
+
+    /**
+     * The shortest text that reads back as the same double
+     */
+    std::string
+    real (double val_) {
+        char buf[32];
+
+        for (int precision { 1 } ; precision < 17 ; ++precision) {
+            snprintf (buf, sizeof (buf), "%.*g", precision, val_);
+
+            if (strtod (buf, nullptr) == val_) {
+                return buf;
+            }
+        }
+
+        snprintf (buf, sizeof (buf), "%.17g", val_);
+
+        return buf;
+    }
+
+    void
+    text (const BlobTree::Node & node_, std::string & out_) {
+        switch (node_.kind) {
+            case BlobTree::null_t :
+                out_ += "null";
+                break;
+            case BlobTree::value_t :
+                if (node_.type == "string" || node_.type == "enum") {
+                    amqp::util::jsonString (node_.value, out_);
+                } else {
+                    out_ += node_.value;
+                }
+                break;
+            case BlobTree::list_t : {
+                out_ += '[';
+                const char * sep = "";
+                for (const auto & child : node_.children) {
+                    out_ += sep;
+                    text (child, out_);
+                    sep = ",";
+                }
+                out_ += ']';
+                break;
+            }
+            case BlobTree::composite_t :
+            case BlobTree::map_t : {
+                out_ += '{';
+                const char * sep = "";
+                for (const auto & child : node_.children) {
+                    out_ += sep;
+                    amqp::util::jsonString (child.name, out_);
+                    out_ += ':';
+                    text (child, out_);
+                    sep = ",";
+                }
+                out_ += '}';
+                break;
+            }
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * BlobTree::Builder
+ *
+ ******************************************************************************/
+
+/**
+ * Builds the tree as the blob's decoded, hashing each node once all
+ * that's beneath it has been
+ */
+class BlobTree::Builder : public amqp::reader::IVisitor {
+    private :
+        Node & m_root;
+
+        std::vector<Node> m_open;
+
+        /**
+         * For each node open the key of the map entry whose value is
+         * awaited, if it's a map
+         */
+        std::vector<std::string> m_keys;
+        std::vector<bool>        m_keyed;
+
+        /**
+         * The composite field announced and waiting for its value
+         */
+        std::string m_field;
+
+        static void finish (Node & node_) {
+            if (node_.kind == map_t) {
+                std::sort (node_.children.begin(), node_.children.end(), [](
+                    const Node & a_, const Node & b_
+                ) {
+                    return a_.name < b_.name;
+                });
+            }
+
+            std::string buf;
+            buf += static_cast<char>(node_.kind);
+            put (buf, node_.type);
+            put (buf, node_.value);
+
+            for (const auto & child : node_.children) {
+                put (buf, child.name);
+                buf.append (reinterpret_cast<const char *>(child.hash.data()), child.hash.size());
+            }
+
+            node_.hash = amqp::internal::schema::Murmur3::hash (buf.data(), buf.size());
+        }
+
+        /**
+         * A map's key is named by its text if it's a value, by its hash
+         * if it's anything more
+         */
+        static std::string key (const Node & node_) {
+            switch (node_.kind) {
+                case null_t  : return "null";
+                case value_t : return node_.value;
+                default      : return "#" + hex (node_.hash).substr (0, 16);
+            }
+        }
+
+        /**
+         * What the next node is known by in its parent. Taken when the
+         * node starts since by the time a composite ends the field last
+         * announced is one of its own
+         */
+        std::string name() const {
+            if (m_open.empty()) {
+                return "";
+            }
+
+            const auto & parent = m_open.back();
+
+            switch (parent.kind) {
+                case composite_t : return m_field;
+                case list_t      : return "[" + std::to_string (parent.children.size()) + "]";
+                default          : return "";
+            }
+        }
+
+        void attach (Node && node_) {
+            if (m_open.empty()) {
+                m_root = std::move (node_);
+                return;
+            }
+
+            auto & parent = m_open.back();
+
+            switch (parent.kind) {
+                case composite_t :
+                case list_t :
+                    break;
+                case map_t :
+                    if (!m_keyed.back()) {
+                        m_keys.back() = key (node_);
+                        m_keyed.back() = true;
+                        return;
+                    }
+
+                    node_.name = std::move (m_keys.back());
+                    m_keyed.back() = false;
+                    break;
+                default :
+                    throw std::runtime_error ("Value inside a value");
+            }
+
+            parent.children.push_back (std::move (node_));
+        }
+
+        void value (const char * type_, std::string value_) {
+            Node node;
+            node.kind = value_t;
+            node.name = name();
+            node.type = type_;
+            node.value = std::move (value_);
+
+            finish (node);
+            attach (std::move (node));
+        }
+
+        void open (kind_t kind_, const std::string & type_ = "") {
+            Node node;
+            node.kind = kind_;
+            node.name = name();
+            node.type = type_;
+
+            m_open.push_back (std::move (node));
+            m_keys.emplace_back();
+            m_keyed.push_back (false);
+        }
+
+        void close() {
+            auto node = std::move (m_open.back());
+
+            m_open.pop_back();
+            m_keys.pop_back();
+            m_keyed.pop_back();
+
+            finish (node);
+            attach (std::move (node));
+        }
+
+    public :
+        explicit Builder (Node & root_) : m_root (root_) { }
+
+        void onBeginComposite (const std::string & type_) override { open (composite_t, type_); }
+        void onEndComposite() override { close(); }
+
+        void onField (const std::string & name_) override { m_field = name_; }
+
+        void onNull() override {
+            Node node;
+            node.name = name();
+            finish (node);
+            attach (std::move (node));
+        }
+
+        void onInt (int32_t val_) override { value ("int", std::to_string (val_)); }
+        void onLong (int64_t val_) override { value ("long", std::to_string (val_)); }
+        void onBool (bool val_) override { value ("bool", val_ ? "true" : "false"); }
+        void onDouble (double val_) override { value ("double", real (val_)); }
+        void onString (std::string_view val_) override { value ("string", std::string (val_)); }
+        void onEnum (int32_t, std::string_view name_) override { value ("enum", std::string (name_)); }
+
+        void onBeginList (size_t) override { open (list_t); }
+        void onEndList() override { close(); }
+
+        void onBeginMap (size_t) override { open (map_t); }
+        void onEndMap() override { close(); }
+};
+
+/******************************************************************************
+ *
+ * BlobTree
+ *
+ ******************************************************************************/
+
+BlobTree::BlobTree (const Source & source_) {
+    Builder builder (m_root);
+    source_ (builder);
+}
+
+/******************************************************************************/
+
+BlobTree::BlobTree (BlobInspector & blob_)
+    : BlobTree ([&blob_](amqp::reader::IVisitor & visitor_) { blob_.visit (visitor_); })
+{
+}
+
+/******************************************************************************/
+
+std::string
+BlobTree::text (const Node & node_) {
+    std::string rtn;
+    ::text (node_, rtn);
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+std::string
+BlobTree::hex (const Digest & digest_) {
+    static const char digits[] = "0123456789abcdef";
+
+    std::string rtn;
+    rtn.reserve (digest_.size() * 2);
+
+    for (auto b : digest_) {
+        rtn += digits[b >> 4];
+        rtn += digits[b & 0xf];
+    }
+
+    return rtn;
+}
+
+/******************************************************************************
+ *
+ * BlobDiff
+ *
+ ******************************************************************************/
+
+BlobDiff::BlobDiff (const BlobTree & from_, const BlobTree & to_) : m_skipped (0) {
+    diff (from_.root(), to_.root(), "");
+}
+
+/******************************************************************************/
+
+void
+BlobDiff::diff (
+    const BlobTree::Node & from_,
+    const BlobTree::Node & to_,
+    const std::string & path_
+) {
+    if (from_.hash == to_.hash) {
+        ++m_skipped;
+        return;
+    }
+
+    if (from_.kind != to_.kind
+        || from_.type != to_.type
+        || from_.kind == BlobTree::value_t
+        || from_.kind == BlobTree::null_t)
+    {
+        m_differences.push_back ({ changed, path_, BlobTree::text (from_), BlobTree::text (to_) });
+        return;
+    }
+
+    auto path = [&](const BlobTree::Node & child_) {
+        switch (from_.kind) {
+            case BlobTree::list_t : return path_ + child_.name;
+            case BlobTree::map_t  : return path_ + "{" + child_.name + "}";
+            default : return path_.empty() ? child_.name : path_ + "." + child_.name;
+        }
+    };
+
+    if (from_.kind == BlobTree::list_t) {
+        auto common = std::min (from_.children.size(), to_.children.size());
+
+        for (size_t i { 0 } ; i < common ; ++i) {
+            diff (from_.children[i], to_.children[i], path (from_.children[i]));
+        }
+
+        for (auto i = common ; i < from_.children.size() ; ++i) {
+            const auto & child = from_.children[i];
+            m_differences.push_back ({ removed, path (child), BlobTree::text (child), "" });
+        }
+
+        for (auto i = common ; i < to_.children.size() ; ++i) {
+            const auto & child = to_.children[i];
+            m_differences.push_back ({ added, path (child), "", BlobTree::text (child) });
+        }
+
+        return;
+    }
+
+    std::unordered_map<std::string, const BlobTree::Node *> to;
+    for (const auto & child : to_.children) {
+        to.emplace (child.name, &child);
+    }
+
+    for (const auto & child : from_.children) {
+        auto other = to.find (child.name);
+
+        if (other == to.end()) {
+            m_differences.push_back ({ removed, path (child), BlobTree::text (child), "" });
+        } else {
+            diff (child, *other->second, path (child));
+            to.erase (other);
+        }
+    }
+
+    for (const auto & child : to_.children) {
+        if (to.count (child.name)) {
+            m_differences.push_back ({ added, path (child), "", BlobTree::text (child) });
+        }
+    }
+}
+
+/******************************************************************************/
+
+std::ostream &
+operator << (std::ostream & out_, const BlobDiff::Difference & difference_) {
+    const auto & path = difference_.path.empty() ? std::string (".") : difference_.path;
+
+    switch (difference_.change) {
+        case BlobDiff::added :
+            return out_ << "+ " << path << " : " << difference_.to;
+        case BlobDiff::removed :
+            return out_ << "- " << path << " : " << difference_.from;
+        case BlobDiff::changed :
+            return out_ << "~ " << path << " : " << difference_.from << " -> " << difference_.to;
+    }
+
+    return out_;
+}
+
+/******************************************************************************/
@@ -0,0 +1,142 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "amqp/schema/fingerprint/Murmur3.h"
+
+/******************************************************************************/
+
+class BlobInspector;
+
+namespace amqp::reader {
+
+    class IVisitor;
+
+}
+
+/******************************************************************************/
+
+/**
+ * A decoded blob held as a tree, each subtree carrying a hash of its
+ * type and everything in it worked out as it's decoded. Two subtrees
+ * with the same hash hold the same values, so comparing them needn't go
+ * any further.
+ *
+ * The hash is of what was serialised rather than how; a map's entries
+ * are taken in order of their keys, so two maps holding the same
+ * entries hash the same whatever order they were written in, and ints
+ * never hash the same as longs of the same value.
+ */
+class BlobTree {
+    public :
+        using Digest = amqp::internal::schema::Murmur3::Digest;
+
+        enum kind_t { null_t, value_t, composite_t, list_t, map_t };
+
+        struct Node {
+            kind_t kind { null_t };
+
+            /**
+             * Of a field its name, of an element of a list "[n]" and of
+             * a map's entry its key as text
+             */
+            std::string name;
+
+            /**
+             * A composite's type, or for a value int, long, bool,
+             * double, string or enum
+             */
+            std::string type;
+            std::string value;
+
+            std::vector<Node> children;
+
+            Digest hash { };
+        };
+
+        /**
+         * Walks a blob calling back into the visitor it's given
+         */
+        using Source = std::function<void (amqp::reader::IVisitor &)>;
+
+    private :
+        Node m_root;
+
+        class Builder;
+
+    public :
+        explicit BlobTree (const Source &);
+        explicit BlobTree (BlobInspector &);
+
+        const Node & root() const { return m_root; }
+        const Digest & hash() const { return m_root.hash; }
+
+        /**
+         * [node_] as compact JSON
+         */
+        static std::string text (const Node & node_);
+
+        static std::string hex (const Digest &);
+};
+
+/******************************************************************************/
+
+/**
+ * The differences between two decoded blobs, field by field. Subtrees
+ * whose hashes match are passed over without looking inside them so
+ * the cost follows how much has changed rather than how big the blobs
+ * are.
+ *
+ * Composite fields and map entries are matched by name and key, list
+ * elements by position. Where the type of something has changed it's
+ * reported as a whole rather than gone into.
+ */
+class BlobDiff {
+    public :
+        enum change_t { added, removed, changed };
+
+        /**
+         * [path] is dotted down from the top level object, "[n]" for an
+         * element of a list and "{key}" for the value of a map's entry.
+         * [from] and [to] are as [BlobTree::text]
+         */
+        struct Difference {
+            change_t    change;
+            std::string path;
+            std::string from;
+            std::string to;
+        };
+
+    private :
+        std::vector<Difference> m_differences;
+
+        size_t m_skipped;
+
+        void diff (
+            const BlobTree::Node & from_,
+            const BlobTree::Node & to_,
+            const std::string & path_);
+
+    public :
+        BlobDiff (const BlobTree & from_, const BlobTree & to_);
+
+        const std::vector<Difference> & differences() const { return m_differences; }
+
+        bool empty() const { return m_differences.empty(); }
+
+        /**
+         * Subtrees found to be the same by their hashes
+         */
+        size_t skipped() const { return m_skipped; }
+};
+
+/******************************************************************************/
+
+std::ostream & operator << (std::ostream &, const BlobDiff::Difference &);
+
+/******************************************************************************/
@@ -1,73 +1,728 @@
 #include "BlobInspector.h"
 #include "CordaBytes.h"
+#include "SchemaStore.h"
+#include "Cursor.h"
 
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <assert.h>
+
+#include "trace.h"
+#include "probes.h"
 
 #include "proton/codec.h"
 #include "proton/proton_wrapper.h"
 
+#include "amqp/schema/descriptors/AMQPDescriptors.h"
 #include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+#include "amqp/scanner/Scanner.h"
 
 #include "amqp/CompositeFactory.h"
+#include "amqp/reader/CompositeReader.h"
 #include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/evolution/SchemaEvolver.h"
+#include "amqp/schema/fingerprint/Fingerprinter.h"
+#include "amqp/util/Parallel.h"
 
 /******************************************************************************/
 
-BlobInspector::BlobInspector (CordaBytes & cb_)
-    : m_data { pn_data (cb_.size()) }
+namespace {
+
+    /**
+     * Decodes single values found by the scanner into a proton tree,
+     * positioned on the value
+     */
+    class Decoder {
+        private :
+            pn_data_t * m_data;
+
+        public :
+            Decoder() : m_data (pn_data (0)) { }
+
+            ~Decoder() {
+                pn_data_free (m_data);
+            }
+
+            Decoder (const Decoder &) = delete;
+
+            pn_data_t *
+            decode (const amqp::internal::scanner::Value & value_) {
+                pn_data_clear (m_data);
+
+                if (pn_data_decode (m_data, value_.begin(), value_.size())
+                        != static_cast<ssize_t>(value_.size()))
+                {
+                    throw std::runtime_error ("Failed to decode AMQP value");
+                }
+
+                pn_data_rewind (m_data);
+                pn_data_next (m_data);
+
+                return m_data;
+            }
+    };
+
+    /**************************************************************************/
+
+    /**
+     * The sections of the Envelope; the serialised object, its schema
+     * and the transforms schema
+     */
+    std::vector<amqp::internal::scanner::Value>
+    sections (const CordaBytes & cb_) {
+        amqp::internal::scanner::Value envelope (
+            cb_.bytes(), cb_.bytes() + cb_.size());
+
+        if (!envelope.described() || !envelope.value().list()) {
+            throw std::runtime_error ("Blob does not start with an Envelope");
+        }
+
+        auto rtn = envelope.value().elements();
+
+        if (rtn.size() < 2 || !rtn[0].described()) {
+            throw std::runtime_error ("Malformed Envelope");
+        }
+
+        return rtn;
+    }
+
+    /**************************************************************************/
+
+    /**
+     * @return the type of the elements of a list or array, nullptr for
+     * any other type
+     */
+    const std::string *
+    elementsOf (const amqp::internal::schema::AMQPTypeNotation & type_) {
+        using namespace amqp::internal::schema;
+
+        if (type_.type() != AMQPTypeNotation::restricted_t) {
+            return nullptr;
+        }
+
+        const auto & restricted = dynamic_cast<const Restricted &> (type_);
+
+        switch (restricted.restrictedType()) {
+            case Restricted::list_t :
+                return &dynamic_cast<const List &> (type_).listOf();
+            case Restricted::array_t :
+                return &dynamic_cast<const Array &> (type_).arrayOf();
+            default :
+                return nullptr;
+        }
+    }
+
+    /**************************************************************************/
+
+    /**
+     * Follow a dotted path of field names down from the serialised object
+     * through its raw bytes
+     *
+     * @return the encoded value found at the end of the path and the field
+     * it's the value of, or a null and the field it was found in if one
+     * of the composites along the way was null. Unless [lenient_] a
+     * missing field, or a path through something that isn't a composite,
+     * throws, otherwise no field at all is returned
+     */
+    std::pair<amqp::internal::scanner::Value, const amqp::internal::schema::Field *>
+    locate (
+        const amqp::internal::scanner::Value & object_,
+        const std::string & path_,
+        const amqp::internal::schema::ISchemaType & schema_,
+        bool lenient_ = false
+    ) {
+        using namespace amqp::internal;
+
+        auto value = object_;
+        const schema::Field * field { nullptr };
+
+        for (size_t begin { 0 } ; begin <= path_.size() ; ) {
+            auto end = std::min (path_.find ('.', begin), path_.size());
+            auto name = path_.substr (begin, end - begin);
+
+            if (field && value.code() == scanner::null_t) {
+                break;
+            }
+
+            if (!value.described() || !value.value().list()) {
+                if (lenient_ && field) {
+                    return std::make_pair (value, nullptr);
+                }
+                throw std::runtime_error (
+                    "Can't find " + name + ", "
+                    + (field ? field->name() : "the object") + " isn't a composite");
+            }
+
+            const auto & fields = dynamic_cast<const schema::Composite &> (
+                *(schema_.fromDescriptor (std::string (value.descriptor().bytes()))->second.get())).fields();
+
+            auto list = value.value();
+            if (list.count() != fields.size()) {
+                throw std::runtime_error ("Serialised object doesn't match its schema");
+            }
+
+            if (fields.empty()) {
+                if (lenient_) {
+                    return std::make_pair (value, nullptr);
+                }
+                throw std::runtime_error ("No field named " + name);
+            }
+
+            auto element = list.first();
+
+            size_t i { 0 };
+            for ( ; i < fields.size() && fields[i]->name() != name ; ++i) {
+                if (i + 1 < fields.size()) {
+                    element = list.next (element);
+                }
+            }
+
+            if (i == fields.size()) {
+                if (lenient_) {
+                    return std::make_pair (value, nullptr);
+                }
+                throw std::runtime_error ("No field named " + name);
+            }
+
+            value = element;
+            field = fields[i].get();
+            begin = end + 1;
+        }
+
+        return std::make_pair (value, field);
+    }
+
+    /**************************************************************************/
+
+    using Reader = amqp::reader::IReader<amqp::internal::schema::SchemaMap::const_iterator>;
+
+    /**
+     * Find each of [paths_] in the serialised object and hand [f_] the
+     * reader for it and the value decoded ready to read, or no reader
+     * at all if it's null or missing. Every path is found with the same
+     * factory so asking for several costs little more than asking for
+     * one.
+     */
+    void
+    located (
+        const CordaBytes & bytes_,
+        const amqp::internal::schema::Envelope & envelope_,
+        const std::vector<std::string> & paths_,
+        const std::function<void (
+            const Reader *,
+            const amqp::internal::schema::Field *,
+            pn_data_t *,
+            const amqp::internal::schema::ISchemaType &)> & f_
+    ) {
+        using namespace amqp::internal;
+
+        const auto & schema = envelope_.schema();
+
+        auto object = sections (bytes_)[0];
+
+        CompositeFactory cf;
+        cf.process (schema);
+
+        Decoder decoder;
+
+        for (const auto & path : paths_) {
+            auto located = locate (object, path, schema, true);
+
+            if (!located.second || located.first.code() == scanner::null_t) {
+                f_ (nullptr, nullptr, nullptr, schema);
+                continue;
+            }
+
+            auto reader = cf.byType (located.second->resolvedType());
+            assert (reader);
+
+            f_ (reader.get(), located.second, decoder.decode (located.first), schema);
+        }
+    }
+
+    /**************************************************************************/
+
+    /**
+     * Decode [elements_] a chunk per thread with [reader_], concatenating
+     * the results back in order
+     */
+    sList<uPtr<amqp::reader::IValue>>
+    parallel (
+        const std::vector<amqp::internal::scanner::Value> & elements_,
+        const amqp::reader::IReader<amqp::internal::schema::SchemaMap::const_iterator> & reader_,
+        const amqp::internal::schema::ISchemaType & schema_,
+        size_t threads_
+    ) {
+        std::vector<sList<uPtr<amqp::reader::IValue>>> read (
+            amqp::util::chunks (elements_.size(), threads_));
+
+        amqp::util::parallel (elements_.size(), threads_,
+            [&](size_t chunk_, size_t begin_, size_t end_) {
+                TRACE ("dump chunk");
+
+                Decoder decoder;
+
+                for (auto j = begin_ ; j < end_ ; ++j) {
+                    read[chunk_].emplace_back (reader_.dump (
+                        decoder.decode (elements_[j]), schema_));
+                }
+            });
+
+        sList<uPtr<amqp::reader::IValue>> rtn;
+
+        for (auto & chunk : read) {
+            rtn.splice (rtn.end(), chunk);
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+BlobInspector::BlobInspector (const CordaBytes & cb_, SchemaStore * store_)
+    : m_bytes (cb_)
+    , m_data { nullptr }
+    , m_store { store_ }
 {
-    // returns how many bytes we processed which right now we don't care
-    // about but I assume there is a case where it doesn't process the
-    // entire file
-    auto rtn = pn_data_decode (m_data, cb_.bytes(), cb_.size());
-    assert (rtn == cb_.size());
+    PROBE2 (blob__start, this, m_bytes.size());
+}
+
+/******************************************************************************/
+
+BlobInspector::~BlobInspector() {
+    PROBE2 (blob__done, this, m_bytes.size());
+
+    if (m_data) {
+        pn_data_free (m_data);
+    }
+}
+
+/******************************************************************************/
+
+pn_data_t *
+BlobInspector::data() {
+    if (!m_data) {
+        TRACE ("pn_data_decode");
+
+        m_data = pn_data (m_bytes.size());
+
+        // anything proton can't decode all of is as broken as anything
+        // it can't decode at all, the bytes may not be ours
+        auto rtn = pn_data_decode (m_data, m_bytes.bytes(), m_bytes.size());
+
+        if (rtn < 0 || static_cast<size_t>(rtn) != m_bytes.size()) {
+            pn_data_free (m_data);
+            m_data = nullptr;
+
+            throw std::runtime_error ("Failed to decode AMQP value");
+        }
+    }
+
+    return m_data;
+}
+
+/******************************************************************************/
+
+std::string
+BlobInspector::descriptor() {
+    return std::string (sections (m_bytes)[0].descriptor().bytes());
+}
+
+/******************************************************************************/
+
+std::string
+BlobInspector::schemaKey() {
+    auto envelope = sections (m_bytes);
+
+    return SchemaStore::key (
+        std::string (envelope[0].descriptor().bytes()),
+        envelope[1].begin(),
+        envelope[1].end());
+}
+
+/******************************************************************************/
+
+/**
+ * Only the schema section of the blob is decoded, the serialised object
+ * is left alone until something asks for it
+ */
+const amqp::internal::schema::Envelope &
+BlobInspector::envelope() {
+    if (!m_envelope) {
+        TRACE ("envelope");
+
+        auto envelope = sections (m_bytes);
+        auto desc = std::string (envelope[0].descriptor().bytes());
+
+        uPtr<amqp::internal::schema::Schema> schema;
+        std::string key;
+
+        if (m_store) {
+            key = SchemaStore::key (desc, envelope[1].begin(), envelope[1].end());
+            schema = m_store->get (key);
+
+            if (schema) {
+                PROBE1 (schema__hit, desc.c_str());
+            }
+        }
+
+        if (!schema) {
+            PROBE1 (schema__miss, desc.c_str());
+
+            Decoder decoder;
+            pn_data_t * decoded;
+
+            {
+                TRACE ("pn_data_decode");
+                decoded = decoder.decode (envelope[1]);
+            }
+
+            schema = amqp::internal::schema::descriptors::dispatchDescribed<
+                amqp::internal::schema::Schema> (decoded);
+
+            /*
+             * Everything in the store is keyed in part on its descriptor
+             * so make sure the schema really is what that descriptor says
+             * before anything else trusts it. That's done once, on the way in,
+             * and never again for blobs that find it there
+             */
+            if (m_store) {
+                amqp::internal::schema::Fingerprinter (*schema).verify();
+                m_store->put (key, *schema);
+            }
+        }
+
+        m_envelope = std::make_unique<amqp::internal::schema::Envelope> (
+            schema, std::move (desc));
+    }
+
+    return *m_envelope;
+}
+
+/******************************************************************************/
+
+std::shared_ptr<const amqp::internal::schema::Envelope>
+BlobInspector::sharedEnvelope() {
+    envelope();
+
+    return m_envelope;
+}
+
+/******************************************************************************/
+
+void
+BlobInspector::adopt (std::shared_ptr<const amqp::internal::schema::Envelope> envelope_) {
+    m_envelope = std::move (envelope_);
+}
+
+/******************************************************************************/
+
+const amqp::internal::schema::Schema &
+BlobInspector::schema() {
+    return dynamic_cast<const amqp::internal::schema::Schema &> (
+            envelope().schema());
+}
+
+/******************************************************************************/
+
+void
+BlobInspector::withPayload (
+    const std::function<void (
+        pn_data_t *,
+        const amqp::internal::schema::Envelope &)> & f_
+) {
+    const auto & env = envelope();
+
+    // move to the actual blob entry in the tree - ideally we'd have
+    // saved this on the Envelope but that's not easily doable as we
+    // can't grab an actual copy of our data pointer
+    auto data = this->data();
+
+    proton::auto_enter p (data);
+    pn_data_next (data);
+    proton::is_list (data);
+
+    if (pn_data_get_list (data) != 3) {
+        throw std::runtime_error ("Malformed Envelope");
+    }
+
+    {
+        proton::auto_enter p (data);
+
+        f_ (data, env);
+    }
 }
 
 /******************************************************************************/
 
 std::string
 BlobInspector::dump() {
-    std::unique_ptr<amqp::internal::schema::Envelope> envelope;
+    amqp::internal::CompositeFactory cf;
 
-    if (pn_data_is_described (m_data)) {
-        proton::auto_enter p (m_data);
+    cf.process (envelope().schema());
 
-        auto a = pn_data_get_ulong(m_data);
+    auto reader = cf.byDescriptor (envelope().descriptor());
 
-        envelope.reset (
-                dynamic_cast<amqp::internal::schema::Envelope *> (
-                        amqp::internal::AMQPDescriptorRegistory[a]->build(m_data).release()));
+    if (!reader) {
+        throw std::runtime_error ("Serialised object doesn't match its schema");
     }
 
+    std::stringstream ss;
+
+    withPayload ([&ss, &reader](
+        pn_data_t * data_,
+        const amqp::internal::schema::Envelope & envelope_
+    ) {
+        TRACE_DETAIL ("dump", envelope_.descriptor());
+
+        // We wrap our output like this to make sure it's valid JSON to
+        // facilitate easy pretty printing
+        ss << reader->dump ("{ Parsed", data_, envelope_.schema())->dump()
+           << " }";
+    });
+
+    return ss.str();
+}
+
+/******************************************************************************/
+
+std::string
+BlobInspector::dump (
+        const amqp::internal::schema::Composite & target_,
+        amqp::internal::schema::SchemaEvolver & evolver_
+) {
+    const auto & from = envelope().schema().fromDescriptor (envelope().descriptor());
+
+    auto composite = dynamic_cast<const amqp::internal::schema::Composite *> (
+        from->second.get().get());
+
+    if (!composite) {
+        throw std::runtime_error ("Only composite types can be evolved");
+    }
+
+    auto evolution = evolver_.evolution (*composite, target_);
+
     amqp::internal::CompositeFactory cf;
 
-    cf.process (envelope->schema());
+    cf.process (envelope().schema());
 
-    auto reader = cf.byDescriptor (envelope->descriptor());
-    assert (reader);
+    auto reader = std::dynamic_pointer_cast<amqp::internal::reader::CompositeReader> (
+        cf.byDescriptor (envelope().descriptor()));
 
-    {
-        // move to the actual blob entry in the tree - ideally we'd have
-        // saved this on the Envelope but that's not easily doable as we
-        // can't grab an actual copy of our data pointer
-        proton::auto_enter p (m_data);
-        pn_data_next (m_data);
-        proton::is_list (m_data);
-        assert (pn_data_get_list (m_data) == 3);
+    if (!reader) {
+        throw std::runtime_error ("Serialised object doesn't match its schema");
+    }
+
+    std::stringstream ss;
+
+    withPayload ([&ss, &reader, &evolution](
+        pn_data_t * data_,
+        const amqp::internal::schema::Envelope & envelope_
+    ) {
+        ss << reader->dump (
+                "{ Parsed", data_, envelope_.schema(), *evolution)->dump()
+           << " }";
+    });
+
+    return ss.str();
+}
+
+/******************************************************************************/
+
+void
+BlobInspector::visit (amqp::reader::IVisitor & visitor_) {
+    amqp::internal::CompositeFactory cf;
+
+    cf.process (envelope().schema());
+
+    auto reader = cf.byDescriptor (envelope().descriptor());
+
+    if (!reader) {
+        throw std::runtime_error ("Serialised object doesn't match its schema");
+    }
+
+    withPayload ([&visitor_, &reader](
+        pn_data_t * data_,
+        const amqp::internal::schema::Envelope & envelope_
+    ) {
+        reader->visit (data_, envelope_.schema(), visitor_);
+    });
+}
+
+/******************************************************************************/
+
+std::string
+BlobInspector::dump (size_t threads_, size_t threshold_) {
+    using namespace amqp::internal;
+
+    const auto & env = envelope();
+    const auto & schema = env.schema();
+
+    CompositeFactory cf;
+    cf.process (schema);
+
+    auto object = sections (m_bytes)[0];
+    if (!object.value().list()) {
+        throw std::runtime_error ("Malformed serialised object");
+    }
+
+    auto encoded = object.value().elements();
+
+    const auto & fields = dynamic_cast<const schema::Composite &> (
+        *(schema.fromDescriptor (env.descriptor())->second.get())).fields();
+
+    if (encoded.size() != fields.size()) {
+        throw std::runtime_error ("Serialised object doesn't match its schema");
+    }
+
+    sVec<uPtr<amqp::reader::IValue>> read;
+    read.reserve (fields.size());
+
+    Decoder decoder;
+
+    for (size_t i { 0 } ; i < fields.size() ; ++i) {
+        const auto & field = *fields[i];
+        const auto & value = encoded[i];
+
+        TRACE_DETAIL ("dump", field.name());
+
+        /*
+         * The type of the elements if this field is a list or array long
+         * enough to be worth splitting up
+         */
+        const std::string * elementType { nullptr };
+
+        if (!field.primitive()
+            && value.described()
+            && value.value().list()
+            && value.value().count() >= threshold_)
         {
-            proton::auto_enter p (m_data);
+            elementType = elementsOf (
+                *(schema.fromType (field.resolvedType())->second.get()));
+        }
 
-            std::stringstream ss;
+        if (elementType) {
+            auto reader = cf.byType (*elementType);
+            assert (reader);
 
-            // We wrap our output like this to make sure it's valid JSON to
-            // facilitate easy pretty printing
-            ss << reader->dump ("{ Parsed", m_data, envelope->schema())->dump()
-               << " }";
+            read.emplace_back (std::make_unique<reader::TypedPair<sList<uPtr<amqp::reader::IValue>>>> (
+                field.name(),
+                parallel (value.value().elements(), *reader, schema, threads_)));
+        } else {
+            auto reader = cf.byType (field.resolvedType());
+            assert (reader);
 
-            return ss.str();
+            read.emplace_back (reader->dump (field.name(), decoder.decode (value), schema));
         }
     }
+
+    // As with [dump] we wrap our output to make sure it's valid JSON
+    return reader::TypedPair<sVec<uPtr<amqp::reader::IValue>>> (
+        "{ Parsed", std::move (read)).dump() + " }";
+}
+
+/******************************************************************************/
+
+Cursor
+BlobInspector::elements (const std::string & path_) {
+    using namespace amqp::internal;
+
+    auto envelope = sharedEnvelope();
+    const auto & schema = envelope->schema();
+
+    auto located = locate (sections (m_bytes)[0], path_, schema);
+
+    const auto & value = located.first;
+    const auto & field = *located.second;
+
+    if (field.primitive() || !value.described()) {
+        throw std::runtime_error (path_ + " isn't a list, array or map");
+    }
+
+    auto cf = std::make_shared<CompositeFactory>();
+    cf->process (schema);
+
+    const auto & type = *(schema.fromType (field.resolvedType())->second.get());
+
+    if (auto elementType = elementsOf (type)) {
+        if (!value.value().list()) {
+            throw std::runtime_error ("Malformed list " + path_);
+        }
+
+        auto reader = cf->byType (*elementType);
+        return Cursor (envelope, cf, reader, nullptr, value.value());
+    }
+
+    if (type.type() == schema::AMQPTypeNotation::restricted_t
+        && dynamic_cast<const schema::Restricted &> (type).restrictedType() == schema::Restricted::map_t)
+    {
+        if (!value.value().map()) {
+            throw std::runtime_error ("Malformed map " + path_);
+        }
+
+        auto types = dynamic_cast<const schema::Map &> (type).mapOf();
+
+        return Cursor (
+            envelope, cf,
+            cf->byType (types.first.get()), cf->byType (types.second.get()),
+            value.value());
+    }
+
+    throw std::runtime_error (path_ + " isn't a list, array or map");
+}
+
+/******************************************************************************/
+
+std::vector<std::optional<std::string>>
+BlobInspector::values (const std::vector<std::string> & paths_) {
+    std::vector<std::optional<std::string>> rtn;
+    rtn.reserve (paths_.size());
+
+    located (m_bytes, envelope(), paths_, [&rtn](
+        const Reader * reader_,
+        const amqp::internal::schema::Field * field_,
+        pn_data_t * data_,
+        const amqp::internal::schema::ISchemaType & schema_)
+    {
+        if (!reader_) {
+            rtn.emplace_back();
+        } else if (field_->primitive()) {
+            rtn.emplace_back (reader_->readString (data_));
+        } else {
+            rtn.emplace_back (reader_->dump (data_, schema_)->dump());
+        }
+    });
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+std::vector<std::any>
+BlobInspector::read (const std::vector<std::string> & paths_) {
+    std::vector<std::any> rtn;
+    rtn.reserve (paths_.size());
+
+    located (m_bytes, envelope(), paths_, [&rtn](
+        const Reader * reader_,
+        const amqp::internal::schema::Field * field_,
+        pn_data_t * data_,
+        const amqp::internal::schema::ISchemaType & schema_)
+    {
+        if (!reader_) {
+            rtn.emplace_back();
+        } else if (field_->primitive()) {
+            rtn.emplace_back (reader_->read (data_));
+        } else {
+            rtn.emplace_back (reader_->dump (data_, schema_)->dump());
+        }
+    });
+
+    return rtn;
 }
 
 /******************************************************************************/
@@ -1,23 +1,166 @@
 #pragma once
 
 #include <iosfwd>
+#include <any>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <functional>
+
+#include "types.h"
+#include "Cursor.h"
 #include "CordaBytes.h"
 
 /******************************************************************************/
 
 struct pn_data_t;
 
+class SchemaStore;
+
+namespace amqp::reader {
+
+    class IVisitor;
+
+}
+
+namespace amqp::internal::schema {
+
+    class Schema;
+    class Envelope;
+    class Composite;
+    class SchemaEvolver;
+
+}
+
 /******************************************************************************/
 
 class BlobInspector {
+    public :
+        /**
+         * The fewest elements a list needs before [dump] will split
+         * decoding it across threads
+         */
+        static constexpr size_t PARALLEL_THRESHOLD { 4096 };
+
     private :
+        const CordaBytes & m_bytes;
+
+        /**
+         * The blob decoded into a proton tree, only built once something
+         * needs to walk it
+         */
         pn_data_t * m_data;
 
+        SchemaStore * m_store;
+
+        std::shared_ptr<const amqp::internal::schema::Envelope> m_envelope;
+
+        pn_data_t * data();
+
     public :
-        BlobInspector (CordaBytes &);
+        /**
+         * If given a [SchemaStore] the blob's schema is taken from there
+         * when it's been seen before, and added to it when not
+         */
+        explicit BlobInspector (const CordaBytes &, SchemaStore * store_ = nullptr);
+        ~BlobInspector();
+
+        BlobInspector (const BlobInspector &) = delete;
+
+        /**
+         * The descriptor of the serialised object's type, found without
+         * decoding anything
+         */
+        std::string descriptor();
+
+        /**
+         * What this blob's schema is known by, its descriptor together
+         * with a hash of its schema section, see [SchemaStore::key]
+         */
+        std::string schemaKey();
+
+        const amqp::internal::schema::Envelope & envelope();
+
+        /**
+         * The Envelope decoded from this blob, shareable with other blobs
+         * of the same schema
+         */
+        std::shared_ptr<const amqp::internal::schema::Envelope> sharedEnvelope();
+
+        /**
+         * Use an Envelope decoded from an earlier blob with the same top
+         * level type rather than decoding this one's
+         */
+        void adopt (std::shared_ptr<const amqp::internal::schema::Envelope>);
+        const amqp::internal::schema::Schema & schema();
+
+        /**
+         * Position the underlying tree on the serialised object itself
+         * and hand it, along with the Envelope describing it, to [f_]
+         */
+        void withPayload (
+            const std::function<void (
+                pn_data_t *,
+                const amqp::internal::schema::Envelope &)> & f_);
 
         std::string dump();
 
+        /**
+         * As [dump] but reading the serialised object as [target_], some
+         * other version of its type, with fields it no longer has left
+         * out and those it's gained given their defaults. How one maps to
+         * the other is worked out once per pair of schemas by [evolver_].
+         *
+         * Only the top level object is evolved, [target_] being a single
+         * type, the objects its fields hold are read as they were
+         * serialised
+         */
+        std::string dump (
+            const amqp::internal::schema::Composite & target_,
+            amqp::internal::schema::SchemaEvolver & evolver_);
+
+        /**
+         * Walk the serialised object calling back into [visitor_] as each
+         * part of it is read, no intermediate representation is built
+         */
+        void visit (amqp::reader::IVisitor & visitor_);
+
+        /**
+         * As [dump], but the elements of any list amongst the serialised
+         * object's own fields with at least [threshold_] of them are
+         * decoded in chunks across [threads_] threads.
+         *
+         * A pass over the raw bytes first finds where each field and each
+         * element of those lists starts, hopping over them on their size
+         * prefixes, so only the elements themselves are ever decoded and
+         * no thread has to wait on another to find its first one.
+         */
+        std::string dump (size_t threads_, size_t threshold_ = PARALLEL_THRESHOLD);
+
+        /**
+         * A cursor over the list, array or map at [path_], a dotted path
+         * of field names down from the serialised object. Neither the
+         * collection nor anything around it is decoded to find it.
+         */
+        Cursor elements (const std::string & path_);
+
+        /**
+         * The values at each of [paths_], dotted as for [elements], as
+         * text; a primitive as itself, anything else as it would be
+         * dumped. Nulls, including those under a null composite, come
+         * back empty, as do paths naming fields this blob's type doesn't
+         * have so blobs of many types can be asked the same question.
+         */
+        std::vector<std::optional<std::string>> values (
+            const std::vector<std::string> & paths_);
+
+        /**
+         * As [values] but as the readers read them, primitives as their
+         * own types, anything else as text. What's null or missing is an
+         * empty [std::any].
+         */
+        std::vector<std::any> read (const std::vector<std::string> & paths_);
+
 };
 
 /******************************************************************************/
@@ -0,0 +1,497 @@
+#include "BlobPack.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <proton/codec.h>
+
+#include "Sha256.h"
+#include "CordaBytes.h"
+
+#include "trace.h"
+#include "probes.h"
+
+#include "amqp/scanner/Scanner.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/descriptors/AMQPDescriptors.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const char MAGIC[] = "CRDPACK1";
+    const size_t HEADER_SIZE = 16;
+    const size_t FOOTER_SIZE = 32;
+    const size_t SCHEMA_HEADER_SIZE = 24;
+
+    static_assert (sizeof (BlobPack::Entry) == 56, "Pack index entries are 56 bytes");
+
+    size_t
+    padded (size_t size_) {
+        return (size_ + 7) & ~size_t (7);
+    }
+
+    template<typename T>
+    void
+    scalar (std::string & out_, T val_) {
+        out_.append (reinterpret_cast<const char *>(&val_), sizeof (T));
+    }
+
+    void
+    pad (std::string & out_) {
+        out_.append (padded (out_.size()) - out_.size(), '\0');
+    }
+
+    void
+    bigEndian (std::string & out_, uint32_t val_) {
+        for (int i { 3 } ; i >= 0 ; --i) {
+            out_ += static_cast<char>((val_ >> (8 * i)) & 0xff);
+        }
+    }
+
+    /**
+     * The blob's Envelope with its schema replaced by a null, written as
+     * a list32 whatever it was before since it's never going to be any
+     * bigger
+     */
+    std::string
+    strip (const amqp::internal::scanner::Value & envelope_) {
+        auto elements = envelope_.value().elements();
+
+        std::string body;
+        for (size_t i { 0 } ; i < elements.size() ; ++i) {
+            if (i == 1) {
+                body += static_cast<char>(amqp::internal::scanner::null_t);
+            } else {
+                body.append (elements[i].begin(), elements[i].size());
+            }
+        }
+
+        std::string rtn (envelope_.begin(), envelope_.descriptor().end());
+        rtn += static_cast<char>(amqp::internal::scanner::list32_t);
+        bigEndian (rtn, static_cast<uint32_t>(body.size() + 4));
+        bigEndian (rtn, static_cast<uint32_t>(elements.size()));
+        rtn += body;
+
+        return rtn;
+    }
+
+    std::string
+    hex (const uint8_t (& sha256_)[32]) {
+        Sha256::Digest digest;
+        std::copy (std::begin (sha256_), std::end (sha256_), digest.begin());
+
+        return Sha256::hex (digest);
+    }
+
+}
+
+/******************************************************************************
+ *
+ * BlobPack
+ *
+ ******************************************************************************/
+
+BlobPack::BlobPack (std::string path_)
+    : m_path (std::move (path_))
+    , m_fd (open (m_path.c_str(), O_RDONLY))
+    , m_map (nullptr)
+    , m_mapped (0)
+    , m_entries (nullptr)
+    , m_size (0)
+{
+    if (m_fd < 0) {
+        throw std::runtime_error ("Can't open pack " + m_path);
+    }
+
+    struct stat st { };
+    fstat (m_fd, &st);
+    m_mapped = static_cast<size_t>(st.st_size);
+
+    if (m_mapped < HEADER_SIZE + FOOTER_SIZE) {
+        ::close (m_fd);
+        throw std::runtime_error (m_path + " is not a pack");
+    }
+
+    auto map = mmap (nullptr, m_mapped, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED) {
+        ::close (m_fd);
+        throw std::runtime_error ("Can't map pack " + m_path);
+    }
+
+    m_map = static_cast<const char *>(map);
+
+    try {
+        index();
+    } catch (...) {
+        munmap (const_cast<char *>(m_map), m_mapped);
+        ::close (m_fd);
+        throw;
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Read the index the last footer points at, checking everything in it
+ * lies within the file
+ */
+void
+BlobPack::index() {
+    auto footer = m_map + m_mapped - FOOTER_SIZE;
+
+    if (memcmp (m_map, MAGIC, 8) != 0 || memcmp (footer + 24, MAGIC, 8) != 0) {
+        throw std::runtime_error (m_path + " is not a pack");
+    }
+
+    auto corrupt = [this]() {
+        return std::runtime_error ("Corrupt pack " + m_path);
+    };
+
+    auto within = [](uint64_t offset_, uint64_t length_, uint64_t end_) {
+        return offset_ <= end_ && length_ <= end_ - offset_;
+    };
+
+    uint64_t index, schemas, blobs;
+    memcpy (&index, footer, 8);
+    memcpy (&schemas, footer + 8, 8);
+    memcpy (&blobs, footer + 16, 8);
+
+    auto end = m_mapped - FOOTER_SIZE;
+
+    if (index < HEADER_SIZE || index > end) {
+        throw corrupt();
+    }
+
+    auto at = static_cast<size_t>(index);
+
+    for (uint64_t i { 0 } ; i < schemas ; ++i) {
+        if (!within (at, SCHEMA_HEADER_SIZE, end)) {
+            throw corrupt();
+        }
+
+        Schema schema;
+        uint32_t length;
+        memcpy (&schema.offset, m_map + at, 8);
+        memcpy (&schema.length, m_map + at + 8, 8);
+        memcpy (&length, m_map + at + 16, 4);
+
+        if (!within (schema.offset, schema.length, index)
+            || !within (at + SCHEMA_HEADER_SIZE, length, end))
+        {
+            throw corrupt();
+        }
+
+        schema.descriptor.assign (m_map + at + SCHEMA_HEADER_SIZE, length);
+        at += padded (SCHEMA_HEADER_SIZE + length);
+
+        m_schemas.push_back (std::move (schema));
+    }
+
+    if (at > end || blobs > (end - at) / sizeof (Entry)) {
+        throw corrupt();
+    }
+
+    m_entries = reinterpret_cast<const Entry *>(m_map + at);
+
+    for (uint64_t i { 0 } ; i < blobs ; ++i) {
+        const auto & entry = m_entries[i];
+
+        if (!within (entry.offset, entry.length, index) || entry.schema >= m_schemas.size()) {
+            throw corrupt();
+        }
+    }
+
+    m_size = blobs;
+    m_envelopes.resize (m_schemas.size());
+}
+
+/******************************************************************************/
+
+BlobPack::~BlobPack() {
+    if (m_map) {
+        munmap (const_cast<char *>(m_map), m_mapped);
+    }
+    ::close (m_fd);
+}
+
+/******************************************************************************/
+
+bool
+BlobPack::isPack (const std::string & path_) {
+    std::ifstream file { path_, std::ios::in | std::ios::binary };
+
+    char magic[8] { };
+    file.read (magic, 8);
+
+    return file && memcmp (magic, MAGIC, 8) == 0;
+}
+
+/******************************************************************************/
+
+const BlobPack::Entry &
+BlobPack::entry (size_t i_) const {
+    if (i_ >= m_size) {
+        throw std::out_of_range ("No blob " + std::to_string (i_) + " in " + m_path);
+    }
+
+    return m_entries[i_];
+}
+
+/******************************************************************************/
+
+std::string_view
+BlobPack::schema (size_t id_) const {
+    const auto & schema = m_schemas.at (id_);
+
+    return std::string_view (m_map + schema.offset, schema.length);
+}
+
+/******************************************************************************/
+
+uPtr<CordaBytes>
+BlobPack::bytes (size_t i_) const {
+    const auto & e = entry (i_);
+
+    TRACE ("read");
+
+    return std::make_unique<CordaBytes> (
+        static_cast<amqp::amqp_section_id_t>(e.encoding),
+        m_map + e.offset,
+        e.length);
+}
+
+/******************************************************************************/
+
+std::shared_ptr<const amqp::internal::schema::Envelope>
+BlobPack::envelope (size_t i_) const {
+    auto id = entry (i_).schema;
+
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    if (!m_envelopes[id]) {
+        TRACE ("envelope");
+
+        const auto & schema = m_schemas[id];
+
+        PROBE1 (schema__miss, schema.descriptor.c_str());
+
+        auto data = pn_data (0);
+        ssize_t decoded;
+
+        {
+            TRACE ("pn_data_decode");
+            decoded = pn_data_decode (data, m_map + schema.offset, schema.length);
+        }
+
+        if (decoded != static_cast<ssize_t>(schema.length)) {
+            pn_data_free (data);
+            throw std::runtime_error ("Corrupt schema in pack " + m_path);
+        }
+
+        pn_data_rewind (data);
+        pn_data_next (data);
+
+        uPtr<amqp::internal::schema::Schema> decodedSchema;
+
+        try {
+            decodedSchema = amqp::internal::schema::descriptors::dispatchDescribed<
+                amqp::internal::schema::Schema> (data);
+        } catch (...) {
+            pn_data_free (data);
+            throw;
+        }
+
+        pn_data_free (data);
+
+        m_envelopes[id] = std::make_shared<amqp::internal::schema::Envelope> (
+            decodedSchema, schema.descriptor);
+    } else {
+        PROBE1 (schema__hit, m_schemas[id].descriptor.c_str());
+    }
+
+    return m_envelopes[id];
+}
+
+/******************************************************************************/
+
+std::string
+BlobPack::sha256 (size_t i_) const {
+    return hex (entry (i_).sha256);
+}
+
+/******************************************************************************
+ *
+ * BlobPackWriter
+ *
+ ******************************************************************************/
+
+/**
+ * Adding to an existing pack starts from its index, new blobs going
+ * after its footer
+ */
+BlobPackWriter::BlobPackWriter (std::string path_)
+    : m_path (std::move (path_))
+    , m_fd (-1)
+    , m_offset (0)
+{
+    struct stat st { };
+
+    if (stat (m_path.c_str(), &st) == 0 && st.st_size > 0) {
+        BlobPack pack (m_path);
+
+        m_schemas = pack.schemas();
+
+        for (size_t i { 0 } ; i < m_schemas.size() ; ++i) {
+            auto section = pack.schema (i);
+            m_schemaIds.emplace (
+                Sha256::hex (Sha256().update (section.data(), section.size()).digest()),
+                static_cast<uint32_t>(i));
+        }
+
+        for (size_t i { 0 } ; i < pack.size() ; ++i) {
+            m_entries.push_back (pack.entry (i));
+            m_blobs.emplace (pack.sha256 (i), i);
+        }
+
+        m_offset = static_cast<uint64_t>(st.st_size);
+    }
+
+    m_fd = open (m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+
+    if (m_fd < 0) {
+        throw std::runtime_error ("Can't open pack " + m_path);
+    }
+
+    if (m_offset == 0) {
+        std::string header (MAGIC, 8);
+        header.append (HEADER_SIZE - 8, '\0');
+
+        append (header);
+    }
+}
+
+/******************************************************************************/
+
+BlobPackWriter::~BlobPackWriter() {
+    if (m_fd >= 0) {
+        try {
+            close();
+        } catch (...) {
+            ::close (m_fd);
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+BlobPackWriter::append (const std::string & bytes_) {
+    if (write (m_fd, bytes_.data(), bytes_.size()) != static_cast<ssize_t>(bytes_.size())) {
+        throw std::runtime_error ("Failed to write to pack " + m_path);
+    }
+
+    m_offset += bytes_.size();
+}
+
+/******************************************************************************/
+
+size_t
+BlobPackWriter::add (const CordaBytes & cb_) {
+    auto sha256 = cb_.sha256();
+
+    auto duplicate = m_blobs.find (sha256);
+    if (duplicate != m_blobs.end()) {
+        m_entries.push_back (m_entries[duplicate->second]);
+        return m_entries.size() - 1;
+    }
+
+    amqp::internal::scanner::Value envelope (cb_.bytes(), cb_.bytes() + cb_.size());
+
+    if (!envelope.described() || !envelope.value().list() || envelope.value().count() < 2) {
+        throw std::runtime_error ("Blob does not start with an Envelope");
+    }
+
+    auto schema = envelope.value().next (envelope.value().first());
+    auto hash = Sha256::hex (Sha256().update (schema.begin(), schema.size()).digest());
+
+    auto id = m_schemaIds.find (hash);
+
+    if (id == m_schemaIds.end()) {
+        auto descriptor = std::string (envelope.value().first().descriptor().bytes());
+
+        std::string bytes (schema.begin(), schema.size());
+        pad (bytes);
+
+        m_schemas.push_back ({ m_offset, schema.size(), descriptor });
+        id = m_schemaIds.emplace (hash, static_cast<uint32_t>(m_schemas.size() - 1)).first;
+
+        append (bytes);
+    }
+
+    auto stripped = strip (envelope);
+
+    BlobPack::Entry entry { };
+    entry.offset = m_offset;
+    entry.length = stripped.size();
+    entry.schema = id->second;
+    entry.encoding = static_cast<uint32_t>(cb_.encoding());
+
+    for (size_t i { 0 } ; i < 32 ; ++i) {
+        entry.sha256[i] = static_cast<uint8_t>(std::stoi (sha256.substr (2 * i, 2), nullptr, 16));
+    }
+
+    pad (stripped);
+    append (stripped);
+
+    m_entries.push_back (entry);
+    m_blobs.emplace (sha256, m_entries.size() - 1);
+
+    return m_entries.size() - 1;
+}
+
+/******************************************************************************/
+
+void
+BlobPackWriter::close() {
+    if (m_fd < 0) {
+        return;
+    }
+
+    auto index = m_offset;
+
+    std::string out;
+
+    for (const auto & schema : m_schemas) {
+        scalar<uint64_t> (out, schema.offset);
+        scalar<uint64_t> (out, schema.length);
+        scalar<uint32_t> (out, static_cast<uint32_t>(schema.descriptor.size()));
+        scalar<uint32_t> (out, 0);
+        out += schema.descriptor;
+        pad (out);
+    }
+
+    out.append (
+        reinterpret_cast<const char *>(m_entries.data()),
+        m_entries.size() * sizeof (BlobPack::Entry));
+
+    scalar<uint64_t> (out, index);
+    scalar<uint64_t> (out, m_schemas.size());
+    scalar<uint64_t> (out, m_entries.size());
+    out.append (MAGIC, 8);
+
+    append (out);
+
+    ::close (m_fd);
+    m_fd = -1;
+}
+
+/******************************************************************************/
@@ -0,0 +1,172 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <string_view>
+#include <unordered_map>
+
+#include "types.h"
+#include "amqp/AMQPSectionId.h"
+
+/******************************************************************************/
+
+class CordaBytes;
+
+namespace amqp::internal::schema {
+
+    class Envelope;
+
+}
+
+/******************************************************************************/
+
+/**
+ * Many blobs in one file, so a vault's worth of them can be read with a
+ * single open and a single map rather than a file system call per blob.
+ *
+ * Every blob carries the schema for its type, most of its bytes in the
+ * case of small ones, so each distinct schema section is written to the
+ * pack once and the blobs are kept with theirs swapped for a null.
+ * Sections are told apart by their SHA-256 rather than by the descriptor
+ * of the blob's type, blobs of one type listing different concrete types
+ * for its polymorphic fields. Reading a
+ * blob back pairs it with an Envelope decoded once for all the blobs
+ * sharing it.
+ *
+ * Packs are append only, each batch of blobs added is followed by an
+ * index of everything in the pack and a footer pointing at it. Readers
+ * only ever look at the last footer so an earlier index is simply left
+ * behind when more blobs are added.
+ *
+ *   header : "CRDPACK1" | reserved (8)
+ *   blob   : envelope without its schema, padded to 8 bytes
+ *   schema : schema section, padded to 8 bytes
+ *   index  : per schema, offset (8) | length (8) | descriptor length (4)
+ *              | reserved (4) | descriptor, padded to 8 bytes
+ *            per blob, offset (8) | length (8) | schema (4) | encoding (4)
+ *              | SHA-256 (32)
+ *   footer : index offset (8) | schemas (8) | blobs (8) | "CRDPACK1"
+ *
+ * A blob identical to one already in the pack isn't written again, its
+ * index entry points at the first.
+ *
+ * Opening a pack checks every schema and blob the index points at lies
+ * within the file, so a corrupt one is rejected up front rather than
+ * read out of bounds later.
+ */
+class BlobPack {
+    public :
+        struct Entry {
+            uint64_t offset;
+            uint64_t length;
+            uint32_t schema;
+            uint32_t encoding;
+            uint8_t  sha256[32];
+        };
+
+        struct Schema {
+            uint64_t    offset;
+            uint64_t    length;
+            std::string descriptor;
+        };
+
+    private :
+        std::string m_path;
+        int         m_fd;
+
+        const char * m_map;
+        size_t       m_mapped;
+
+        std::vector<Schema> m_schemas;
+        const Entry *       m_entries;
+        size_t              m_size;
+
+        /**
+         * Envelopes are decoded the first time a blob of their schema is
+         * asked for
+         */
+        mutable std::mutex m_lock;
+        mutable std::vector<std::shared_ptr<const amqp::internal::schema::Envelope>> m_envelopes;
+
+        void index();
+
+    public :
+        explicit BlobPack (std::string);
+        ~BlobPack();
+
+        BlobPack (const BlobPack &) = delete;
+
+        /**
+         * True if the file at [path_] looks like a pack
+         */
+        static bool isPack (const std::string & path_);
+
+        size_t size() const { return m_size; }
+
+        const std::vector<Schema> & schemas() const { return m_schemas; }
+
+        /**
+         * The encoded schema section of the [id_]th schema, straight
+         * from the map
+         */
+        std::string_view schema (size_t id_) const;
+
+        const Entry & entry (size_t) const;
+
+        /**
+         * The [i]th blob, schema and all still to be re-attached by
+         * adopting its [envelope]
+         */
+        uPtr<CordaBytes> bytes (size_t i) const;
+
+        std::shared_ptr<const amqp::internal::schema::Envelope> envelope (size_t i) const;
+
+        std::string sha256 (size_t i) const;
+};
+
+/******************************************************************************/
+
+/**
+ * Adds blobs to a pack, creating it if need be. Nothing added is
+ * readable until [close] has written the index.
+ */
+class BlobPackWriter {
+    private :
+        std::string m_path;
+        int         m_fd;
+        uint64_t    m_offset;
+
+        std::vector<BlobPack::Schema> m_schemas;
+        std::vector<BlobPack::Entry>  m_entries;
+
+        /**
+         * Schemas by the SHA-256 of their section
+         */
+        std::unordered_map<std::string, uint32_t> m_schemaIds;
+        std::unordered_map<std::string, size_t>   m_blobs;
+
+        void append (const std::string &);
+
+    public :
+        explicit BlobPackWriter (std::string);
+        ~BlobPackWriter();
+
+        BlobPackWriter (const BlobPackWriter &) = delete;
+
+        /**
+         * @return the blob's index in the pack
+         */
+        size_t add (const CordaBytes &);
+
+        size_t size() const { return m_entries.size(); }
+        size_t schemas() const { return m_schemas.size(); }
+
+        void close();
+};
+
+/******************************************************************************/
@@ -0,0 +1,331 @@
+#include "Columns.h"
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    setBit (std::string & bits_, int64_t idx_, bool set_) {
+        auto byte = static_cast<size_t>(idx_ / 8);
+        if (byte >= bits_.size()) {
+            bits_.resize (byte + 1, '\0');
+        }
+
+        if (set_) {
+            bits_[byte] = static_cast<char>(bits_[byte] | (1U << (idx_ % 8)));
+        }
+    }
+
+    template<typename T>
+    void
+    appendValue (std::string & data_, T val_) {
+        data_.append (reinterpret_cast<const char *>(&val_), sizeof (T));
+    }
+
+    bool
+    variableWidth (AvroSchema::Kind kind_) {
+        switch (kind_) {
+            case AvroSchema::string_t :
+            case AvroSchema::array_t :
+            case AvroSchema::map_t :
+            case AvroSchema::pairs_t :
+                return true;
+            default :
+                return false;
+        }
+    }
+
+    /**
+     * Start a new slot in a column, the value itself is up to the caller
+     */
+    void
+    slot (Column & column_, bool valid_) {
+        setBit (column_.validity, column_.length, valid_);
+        ++column_.length;
+        if (!valid_) ++column_.nulls;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * Column
+ *
+ ******************************************************************************/
+
+Column::Column (
+    std::string name_,
+    AvroSchema::Kind kind_,
+    size_t node_,
+    bool nullable_
+) : name (std::move (name_))
+  , kind (kind_)
+  , node (node_)
+  , nullable (nullable_)
+  , length (0)
+  , nulls (0)
+{
+    if (variableWidth (kind)) {
+        offsets.push_back (0);
+    }
+}
+
+/******************************************************************************/
+
+void
+Column::clear() {
+    length = 0;
+    nulls = 0;
+
+    validity.clear();
+    data.clear();
+
+    if (variableWidth (kind)) {
+        offsets.assign (1, 0);
+    }
+
+    for (auto & child : children) {
+        child.clear();
+    }
+}
+
+/******************************************************************************
+ *
+ * Columns
+ *
+ ******************************************************************************/
+
+Columns::Columns (const AvroSchema & schema_)
+    : m_schema (schema_)
+    , m_root ("", AvroSchema::record_t, schema_.root(), false)
+{
+    std::vector<size_t> path;
+    m_root = column ("", m_schema.root(), false, path);
+}
+
+/******************************************************************************/
+
+Column
+Columns::column (
+    const std::string & name_,
+    size_t node_,
+    bool nullable_,
+    std::vector<size_t> & path_
+) const {
+    const auto & n = m_schema.nodes()[node_];
+
+    Column column (name_, n.kind, node_, nullable_);
+
+    switch (n.kind) {
+        case AvroSchema::record_t : {
+            if (std::find (path_.begin(), path_.end(), node_) != path_.end()) {
+                throw std::runtime_error (
+                    n.name + " contains itself and can't be represented as columns");
+            }
+
+            path_.push_back (node_);
+            for (const auto & field : n.fields) {
+                column.children.emplace_back (
+                    this->column (field.name, field.node, field.nullable, path_));
+            }
+            path_.pop_back();
+            break;
+        }
+        case AvroSchema::array_t : {
+            column.children.emplace_back (this->column ("item", n.items, true, path_));
+            break;
+        }
+        case AvroSchema::map_t : {
+            Column entries ("entries", AvroSchema::record_t, node_, false);
+            entries.children.emplace_back ("key", AvroSchema::string_t, node_, false);
+            entries.children.emplace_back (this->column ("value", n.items, true, path_));
+
+            column.children.emplace_back (std::move (entries));
+            break;
+        }
+        case AvroSchema::pairs_t : {
+            auto entries = this->column ("entries", n.items, false, path_);
+
+            // only a map's keys have to be present, its values can be null
+            entries.children[1].nullable = true;
+
+            column.children.emplace_back (std::move (entries));
+            break;
+        }
+        default :
+            break;
+    }
+
+    return column;
+}
+
+/******************************************************************************/
+
+void
+Columns::append (pn_data_t * data_) {
+    append (m_root, data_);
+}
+
+/******************************************************************************/
+
+void
+Columns::clear() {
+    m_root.clear();
+}
+
+/******************************************************************************/
+
+void
+Columns::append (Column & column_, pn_data_t * data_) const {
+    proton::auto_next an (data_);
+
+    if (pn_data_type (data_) == PN_NULL) {
+        appendEmpty (column_, false);
+        return;
+    }
+
+    switch (column_.kind) {
+        case AvroSchema::boolean_t : {
+            setBit (column_.data, column_.length, pn_data_get_bool (data_));
+            slot (column_, true);
+            break;
+        }
+        case AvroSchema::int_t : {
+            appendValue<int32_t> (column_.data, pn_data_get_int (data_));
+            slot (column_, true);
+            break;
+        }
+        case AvroSchema::long_t : {
+            appendValue<int64_t> (column_.data, pn_data_get_long (data_));
+            slot (column_, true);
+            break;
+        }
+        case AvroSchema::double_t : {
+            appendValue<double> (column_.data, pn_data_get_double (data_));
+            slot (column_, true);
+            break;
+        }
+        case AvroSchema::string_t : {
+            auto str = AvroSchema::readString (data_);
+            column_.data.append (str.start, str.size);
+            column_.offsets.push_back (static_cast<int32_t>(column_.data.size()));
+            slot (column_, true);
+            break;
+        }
+        case AvroSchema::enum_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_list_enter ale (data_, true);
+
+            appendValue<int32_t> (
+                column_.data,
+                static_cast<int32_t>(AvroSchema::readSymbol (
+                    data_, m_schema.nodes()[column_.node])));
+            slot (column_, true);
+            break;
+        }
+        case AvroSchema::record_t : {
+            appendRecord (column_, data_);
+            break;
+        }
+        case AvroSchema::array_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_list_enter ale (data_, true);
+
+            auto & items = column_.children[0];
+            for (size_t i { 0 } ; i < ale.elements() ; ++i) {
+                append (items, data_);
+            }
+
+            column_.offsets.push_back (static_cast<int32_t>(items.length));
+            slot (column_, true);
+            break;
+        }
+        case AvroSchema::map_t :
+        case AvroSchema::pairs_t : {
+            proton::is_described (data_);
+            proton::auto_enter ae (data_, true);
+            proton::auto_map_enter am (data_, true);
+
+            auto & entries = column_.children[0];
+            for (size_t i { 0 } ; i < am.elements() ; i += 2) {
+                append (entries.children[0], data_);
+                append (entries.children[1], data_);
+                slot (entries, true);
+            }
+
+            column_.offsets.push_back (static_cast<int32_t>(entries.length));
+            slot (column_, true);
+            break;
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+Columns::appendRecord (Column & column_, pn_data_t * data_) const {
+    proton::is_described (data_);
+    proton::auto_enter ae (data_, true);
+    proton::is_list (data_);
+
+    proton::auto_list_enter ale (data_, true);
+
+    for (auto & child : column_.children) {
+        append (child, data_);
+    }
+
+    slot (column_, true);
+}
+
+/******************************************************************************/
+
+/**
+ * Every column beneath a record has to have the same length as it, and
+ * the values beneath a null still have to be there, so fill a slot with
+ * the type's zero value
+ */
+void
+Columns::appendEmpty (Column & column_, bool valid_) const {
+    switch (column_.kind) {
+        case AvroSchema::boolean_t :
+            setBit (column_.data, column_.length, false);
+            break;
+        case AvroSchema::int_t :
+        case AvroSchema::enum_t :
+            appendValue<int32_t> (column_.data, 0);
+            break;
+        case AvroSchema::long_t :
+            appendValue<int64_t> (column_.data, 0);
+            break;
+        case AvroSchema::double_t :
+            appendValue<double> (column_.data, 0.0);
+            break;
+        case AvroSchema::string_t :
+            column_.offsets.push_back (static_cast<int32_t>(column_.data.size()));
+            break;
+        case AvroSchema::record_t :
+            for (auto & child : column_.children) {
+                appendEmpty (child, true);
+            }
+            break;
+        case AvroSchema::array_t :
+        case AvroSchema::map_t :
+        case AvroSchema::pairs_t :
+            column_.offsets.push_back (static_cast<int32_t>(column_.children[0].length));
+            break;
+    }
+
+    slot (column_, valid_);
+}
+
+/******************************************************************************/
@@ -0,0 +1,93 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <vector>
+
+#include "AvroSchema.h"
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+/******************************************************************************/
+
+/**
+ * A single column in Arrow's layout. Every column has a validity bitmap,
+ * variable width ones (strings, lists and maps) a set of offsets into
+ * either their data or their child, and nested ones their children.
+ *
+ *   bool          bit packed data
+ *   int / long    int32 / int64 data
+ *   double        float64 data
+ *   string        int32 offsets, utf8 data
+ *   enum          int32 indices into the dictionary of its constants
+ *   record        a child per field
+ *   list          int32 offsets, a single child
+ *   map           int32 offsets, a single "entries" struct child with a
+ *                 key and value column
+ */
+struct Column {
+    std::string       name;
+    AvroSchema::Kind  kind;
+    size_t            node;     // the schema node the column was made from
+    bool              nullable;
+
+    int64_t length;
+    int64_t nulls;
+
+    std::string          validity;
+    std::vector<int32_t> offsets;
+    std::string          data;
+
+    std::vector<Column> children;
+
+    Column (std::string, AvroSchema::Kind, size_t, bool);
+
+    void clear();
+};
+
+/******************************************************************************/
+
+/**
+ * Flattens blobs of a single schema into per field column buffers, one
+ * row per blob, where the top level columns are the fields of the blob's
+ * type in the order the schema lists them (which is the order the
+ * CompositeFactory builds the composite reader's field readers in).
+ *
+ * Arrow can't describe a type that contains itself so such schemas are
+ * rejected.
+ */
+class Columns {
+    private :
+        const AvroSchema & m_schema;
+
+        Column m_root;
+
+        Column column (const std::string &, size_t, bool, std::vector<size_t> &) const;
+
+        void append (Column &, pn_data_t *) const;
+        void appendEmpty (Column &, bool) const;
+        void appendRecord (Column &, pn_data_t *) const;
+
+    public :
+        explicit Columns (const AvroSchema &);
+
+        const AvroSchema & schema() const { return m_schema; }
+
+        const std::vector<Column> & columns() const { return m_root.children; }
+        int64_t rows() const { return m_root.length; }
+
+        /**
+         * Append the blob under the cursor as a new row
+         */
+        void append (pn_data_t *);
+
+        /**
+         * Drop every row, keeping the columns themselves
+         */
+        void clear();
+};
+
+/******************************************************************************/
@@ -1,14 +1,22 @@
 #include "CordaBytes.h"
 
 #include <array>
+#include <algorithm>
+#include <cstring>
 #include <sys/stat.h>
 #include "amqp/AMQPHeader.h"
 
+#include "Sha256.h"
+
+#include "trace.h"
+
 /******************************************************************************/
 
 CordaBytes::CordaBytes (const std::string & file_)
     : m_blob { nullptr }
 {
+    TRACE_DETAIL ("read", file_);
+
     std::ifstream file { file_, std::ios::in | std::ios::binary };
     struct stat results { };
 
@@ -26,7 +34,9 @@ CordaBytes::CordaBytes (const std::string & file_)
         throw std::runtime_error ("Not a Corda stream");
     }
 
-    file.read (reinterpret_cast<char *>(&m_encoding), 1);
+    char encoding;
+    file.read (&encoding, 1);
+    m_encoding = static_cast<amqp::amqp_section_id_t>(encoding);
 
     m_blob = new char[m_size];
 
@@ -36,3 +46,48 @@ CordaBytes::CordaBytes (const std::string & file_)
 
 /******************************************************************************/
 
+
+CordaBytes::CordaBytes (const char * bytes_, size_t size_)
+    : m_blob { nullptr }
+{
+    if (size_ < amqp::AMQP_HEADER.size() + 1
+        || !std::equal (amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end(), bytes_))
+    {
+        throw std::runtime_error ("Not a Corda stream");
+    }
+
+    m_encoding = static_cast<amqp::amqp_section_id_t>(bytes_[amqp::AMQP_HEADER.size()]);
+
+    m_size = size_ - (amqp::AMQP_HEADER.size() + 1);
+    m_blob = new char[m_size];
+
+    memcpy (m_blob, bytes_ + amqp::AMQP_HEADER.size() + 1, m_size);
+}
+
+/******************************************************************************/
+
+CordaBytes::CordaBytes (
+    amqp::amqp_section_id_t encoding_,
+    const char * body_,
+    size_t size_
+) : m_encoding (encoding_)
+  , m_size (size_)
+  , m_blob (new char[size_])
+{
+    memcpy (m_blob, body_, m_size);
+}
+
+/******************************************************************************/
+
+std::string
+CordaBytes::sha256() const {
+    auto encoding = static_cast<char>(m_encoding);
+
+    return Sha256::hex (Sha256()
+        .update (amqp::AMQP_HEADER.data(), amqp::AMQP_HEADER.size())
+        .update (&encoding, 1)
+        .update (m_blob, m_size)
+        .digest());
+}
+
+/******************************************************************************/
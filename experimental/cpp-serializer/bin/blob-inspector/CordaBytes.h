@@ -15,6 +15,19 @@ class CordaBytes {
     public :
         explicit CordaBytes (const std::string &);
 
+        /**
+         * From a blob already in memory, header included
+         */
+        CordaBytes (const char *, size_t);
+
+        /**
+         * From the body of a blob, its header having been dealt with
+         * elsewhere
+         */
+        CordaBytes (amqp::amqp_section_id_t, const char *, size_t);
+
+        CordaBytes (const CordaBytes &) = delete;
+
         ~CordaBytes() {
             delete [] m_blob;
         }
@@ -26,6 +39,12 @@ class CordaBytes {
         decltype (m_size) size() const { return m_size; }
 
         const char * const bytes() const { return m_blob; }
+
+        /**
+         * SHA-256 of the blob as it was serialised, header and all, so
+         * the same as the SecureHash the JVM would give it
+         */
+        std::string sha256() const;
 };
 
 /******************************************************************************/
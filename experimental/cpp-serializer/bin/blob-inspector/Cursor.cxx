@@ -0,0 +1,151 @@
+#include "Cursor.h"
+
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "amqp/CompositeFactory.h"
+#include "amqp/schema/described-types/Envelope.h"
+
+/******************************************************************************/
+
+Cursor::Cursor (
+    std::shared_ptr<const amqp::internal::schema::Envelope> envelope_,
+    std::shared_ptr<amqp::internal::CompositeFactory> factory_,
+    std::shared_ptr<Reader> reader_,
+    std::shared_ptr<Reader> valueReader_,
+    const amqp::internal::scanner::Value & collection_
+) : m_envelope (std::move (envelope_))
+  , m_factory (std::move (factory_))
+  , m_reader (std::move (reader_))
+  , m_valueReader (std::move (valueReader_))
+  , m_collection (collection_)
+  , m_remaining (collection_.count())
+  , m_data (pn_data (0))
+{ }
+
+/******************************************************************************/
+
+Cursor::Cursor (Cursor && cursor_) noexcept
+    : m_envelope (std::move (cursor_.m_envelope))
+    , m_factory (std::move (cursor_.m_factory))
+    , m_reader (std::move (cursor_.m_reader))
+    , m_valueReader (std::move (cursor_.m_valueReader))
+    , m_collection (cursor_.m_collection)
+    , m_key (cursor_.m_key)
+    , m_value (cursor_.m_value)
+    , m_remaining (cursor_.m_remaining)
+    , m_data (cursor_.m_data)
+{
+    cursor_.m_data = nullptr;
+}
+
+/******************************************************************************/
+
+Cursor::~Cursor() {
+    if (m_data) {
+        pn_data_free (m_data);
+    }
+}
+
+/******************************************************************************/
+
+size_t
+Cursor::size() const {
+    return map() ? m_collection.count() / 2 : m_collection.count();
+}
+
+/******************************************************************************/
+
+bool
+Cursor::next() {
+    if (m_remaining == 0) {
+        m_key.reset();
+        m_value.reset();
+        return false;
+    }
+
+    auto & last = map() ? m_key : m_value;
+
+    if (m_value) {
+        last = m_collection.next (*m_value);
+    } else {
+        last = m_collection.first();
+    }
+
+    if (map()) {
+        m_value = m_collection.next (*m_key);
+        m_remaining -= 2;
+    } else {
+        m_remaining -= 1;
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+
+/**
+ * Each decode replaces the last, so no more than one element is held
+ * at a time
+ */
+pn_data_t *
+Cursor::decode (const amqp::internal::scanner::Value & value_) {
+    pn_data_clear (m_data);
+
+    if (pn_data_decode (m_data, value_.begin(), value_.size())
+            != static_cast<ssize_t>(value_.size()))
+    {
+        throw std::runtime_error ("Failed to decode AMQP value");
+    }
+
+    pn_data_rewind (m_data);
+    pn_data_next (m_data);
+
+    return m_data;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+Cursor::value() {
+    if (!m_value) {
+        throw std::runtime_error ("Cursor isn't on an element");
+    }
+
+    return (map() ? m_valueReader : m_reader)->dump (
+        decode (*m_value), m_envelope->schema());
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+Cursor::key() {
+    if (!map()) {
+        throw std::runtime_error ("Only maps have keys");
+    }
+
+    if (!m_key) {
+        throw std::runtime_error ("Cursor isn't on an element");
+    }
+
+    return m_reader->dump (decode (*m_key), m_envelope->schema());
+}
+
+/******************************************************************************/
+
+void
+Cursor::visit (amqp::reader::IVisitor & visitor_) {
+    if (!m_value) {
+        throw std::runtime_error ("Cursor isn't on an element");
+    }
+
+    if (map()) {
+        m_reader->visit (decode (*m_key), m_envelope->schema(), visitor_);
+        m_valueReader->visit (decode (*m_value), m_envelope->schema(), visitor_);
+    } else {
+        m_reader->visit (decode (*m_value), m_envelope->schema(), visitor_);
+    }
+}
+
+/******************************************************************************/
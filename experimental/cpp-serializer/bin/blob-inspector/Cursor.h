@@ -0,0 +1,119 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <memory>
+#include <optional>
+
+#include "types.h"
+
+#include "amqp/reader/IReader.h"
+#include "amqp/scanner/Scanner.h"
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+namespace amqp::internal {
+
+    class CompositeFactory;
+
+}
+
+namespace amqp::internal::schema {
+
+    class Envelope;
+
+}
+
+/******************************************************************************/
+
+/**
+ * Steps through the elements of a list or array, or the entries of a
+ * map, decoding them one at a time straight from the blob's bytes. Only
+ * the element being looked at is ever decoded so paging through a
+ * collection of any size takes constant memory, and stopping early
+ * costs nothing for the elements never reached.
+ *
+ * It's the pull equivalent of a generator, each call to [next] resuming
+ * where the last left off
+ *
+ *   for (auto cursor = blob.elements ("a") ; cursor.next() ; ) {
+ *       std::cout << cursor.value()->dump() << std::endl;
+ *   }
+ *
+ * The blob's bytes must outlive the cursor.
+ */
+class Cursor {
+    private :
+        using Reader = amqp::reader::IReader<
+            amqp::internal::schema::SchemaMap::const_iterator>;
+
+        /**
+         * Element readers hold their own dependencies weakly so we keep
+         * hold of everything they came from
+         */
+        std::shared_ptr<const amqp::internal::schema::Envelope> m_envelope;
+        std::shared_ptr<amqp::internal::CompositeFactory>       m_factory;
+
+        /**
+         * For a map the key and value readers, otherwise just the first
+         * is used
+         */
+        std::shared_ptr<Reader> m_reader;
+        std::shared_ptr<Reader> m_valueReader;
+
+        amqp::internal::scanner::Value m_collection;
+
+        std::optional<amqp::internal::scanner::Value> m_key;
+        std::optional<amqp::internal::scanner::Value> m_value;
+
+        uint32_t m_remaining;
+
+        pn_data_t * m_data;
+
+        pn_data_t * decode (const amqp::internal::scanner::Value &);
+
+    public :
+        Cursor (
+            std::shared_ptr<const amqp::internal::schema::Envelope>,
+            std::shared_ptr<amqp::internal::CompositeFactory>,
+            std::shared_ptr<Reader>,
+            std::shared_ptr<Reader>,
+            const amqp::internal::scanner::Value &);
+
+        ~Cursor();
+
+        Cursor (const Cursor &) = delete;
+        Cursor (Cursor &&) noexcept;
+
+        bool map() const { return m_valueReader != nullptr; }
+
+        /**
+         * How many elements, or entries of a map, there are in total
+         */
+        size_t size() const;
+
+        /**
+         * Move to the next element, false once they're exhausted
+         */
+        bool next();
+
+        /**
+         * The current element or, for a map, the current entry's value
+         */
+        uPtr<amqp::reader::IValue> value();
+
+        /**
+         * The current entry's key, only for maps
+         */
+        uPtr<amqp::reader::IValue> key();
+
+        /**
+         * Visit the current element, or the current entry's key and then
+         * its value
+         */
+        void visit (amqp::reader::IVisitor &);
+};
+
+/******************************************************************************/
@@ -0,0 +1,198 @@
+#include "Exporters.h"
+#include "BlobInspector.h"
+
+#include <ostream>
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Envelope.h"
+
+/******************************************************************************
+ *
+ * AvroExporter
+ *
+ ******************************************************************************/
+
+AvroExporter::AvroExporter (
+    std::string directory_,
+    bool deflate_
+) : m_directory (std::move (directory_))
+  , m_deflate (deflate_)
+{ }
+
+/******************************************************************************/
+
+void
+AvroExporter::add (BlobInspector & blob_) {
+    const auto & descriptor = blob_.envelope().descriptor();
+    auto key = blob_.schemaKey();
+
+    auto it = m_targets.find (key);
+
+    if (it == m_targets.end()) {
+        auto schema = std::make_unique<AvroSchema> (blob_.schema(), descriptor);
+
+        auto path = m_directory + "/" + schema->name() + "."
+            + std::to_string (m_versions[schema->name()]++) + ".avro";
+
+        auto container = std::make_unique<AvroContainer> (
+            path, schema->json(), m_deflate);
+
+        it = m_targets.emplace (
+            key,
+            Target { std::move (schema), std::move (container) }).first;
+    }
+
+    const auto & target = it->second;
+
+    m_record.clear();
+    blob_.withPayload ([this, &target](
+        pn_data_t * data_,
+        const amqp::internal::schema::Envelope &
+    ) {
+        target.schema->encode (data_, m_record);
+    });
+
+    target.container->append (m_record);
+}
+
+/******************************************************************************/
+
+void
+AvroExporter::close() {
+    for (auto & target : m_targets) {
+        target.second.container->flush();
+    }
+}
+
+/******************************************************************************
+ *
+ * ArrowExporter
+ *
+ ******************************************************************************/
+
+ArrowExporter::ArrowExporter (std::string directory_)
+    : m_directory (std::move (directory_))
+{ }
+
+/******************************************************************************/
+
+void
+ArrowExporter::add (BlobInspector & blob_) {
+    const auto & descriptor = blob_.envelope().descriptor();
+    auto key = blob_.schemaKey();
+
+    auto it = m_targets.find (key);
+
+    if (it == m_targets.end()) {
+        auto schema = std::make_unique<AvroSchema> (blob_.schema(), descriptor);
+        auto columns = std::make_unique<Columns> (*schema);
+
+        auto path = m_directory + "/" + schema->name() + "."
+            + std::to_string (m_versions[schema->name()]++) + ".arrows";
+
+        auto stream = std::make_unique<ArrowStream> (path, *columns);
+
+        it = m_targets.emplace (
+            key,
+            Target { std::move (schema), std::move (columns), std::move (stream) }).first;
+    }
+
+    auto & target = it->second;
+
+    blob_.withPayload ([&target](
+        pn_data_t * data_,
+        const amqp::internal::schema::Envelope &
+    ) {
+        target.columns->append (data_);
+    });
+
+    if (target.columns->rows() >= BATCH_ROWS) {
+        target.stream->write (*target.columns);
+        target.columns->clear();
+    }
+}
+
+/******************************************************************************/
+
+void
+ArrowExporter::close() {
+    for (auto & target : m_targets) {
+        target.second.stream->write (*target.second.columns);
+        target.second.columns->clear();
+        target.second.stream->close();
+    }
+}
+
+/******************************************************************************
+ *
+ * NdJsonExporter
+ *
+ ******************************************************************************/
+
+NdJsonExporter::NdJsonExporter (std::ostream & out_)
+    : m_out (out_)
+{ }
+
+/******************************************************************************/
+
+void
+NdJsonExporter::add (BlobInspector & blob_) {
+    add (blob_, "");
+}
+
+/******************************************************************************/
+
+void
+NdJsonExporter::add (BlobInspector & blob_, const std::string & sha256_) {
+    const auto & descriptor = blob_.envelope().descriptor();
+    auto key = blob_.schemaKey();
+
+    auto it = m_schemas.find (key);
+
+    if (it == m_schemas.end()) {
+        auto id = m_schemas.size();
+
+        it = m_schemas.emplace (
+            key,
+            std::make_pair (
+                id,
+                std::make_unique<AvroSchema> (blob_.schema(), descriptor))).first;
+
+        m_out << R"({"schema":)" << id << R"(,"avro":)"
+              << it->second.second->json() << "}\n";
+    }
+
+    const auto & schema = it->second;
+
+    m_line = R"({"schema":)" + std::to_string (schema.first);
+    if (!sha256_.empty()) {
+        m_line += R"(,"sha256":")" + sha256_ + "\"";
+    }
+    m_line += R"(,"value":)";
+    blob_.withPayload ([this, &schema](
+        pn_data_t * data_,
+        const amqp::internal::schema::Envelope &
+    ) {
+        schema.second->encodeJson (data_, m_line);
+    });
+    m_line += "}\n";
+
+    m_out << m_line;
+}
+
+/******************************************************************************/
+
+void
+NdJsonExporter::duplicate (size_t original_, const std::string & sha256_) {
+    m_out << R"({"duplicate":)" << original_
+          << R"(,"sha256":")" << sha256_ << "\"}\n";
+}
+
+/******************************************************************************/
+
+void
+NdJsonExporter::close() {
+    m_out.flush();
+}
+
+/******************************************************************************/
@@ -0,0 +1,152 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <iosfwd>
+
+#include "types.h"
+#include "AvroSchema.h"
+#include "AvroContainer.h"
+#include "Columns.h"
+#include "ArrowStream.h"
+
+/******************************************************************************/
+
+class BlobInspector;
+
+/******************************************************************************/
+
+/**
+ * Bulk export of blobs where the schema is written once per distinct
+ * schema rather than repeating field names in every record.
+ *
+ * Schemas are keyed on [BlobInspector::schemaKey], blobs of one top
+ * level type can carry different schema sections when they hold
+ * different subtypes or versions of what's beneath it.
+ */
+class Exporter {
+    public :
+        virtual ~Exporter() = default;
+
+        virtual void add (BlobInspector &) = 0;
+
+        /**
+         * As [add] for a blob whose content hash is known, exporters
+         * with somewhere to put it write it alongside the blob
+         */
+        virtual void add (BlobInspector & blob_, const std::string &) { add (blob_); }
+
+        /**
+         * A blob byte for byte identical to the [original_]th one added,
+         * by default nothing at all is written for it
+         */
+        virtual void duplicate (size_t original_, const std::string & sha256_) { }
+
+        virtual void close() = 0;
+};
+
+/******************************************************************************/
+
+/**
+ * One Avro object container file per distinct schema, named for the
+ * type it holds, written into a directory.
+ */
+class AvroExporter : public Exporter {
+    private :
+        struct Target {
+            uPtr<AvroSchema>    schema;
+            uPtr<AvroContainer> container;
+        };
+
+        std::string m_directory;
+        bool        m_deflate;
+
+        std::map<std::string, Target> m_targets;
+
+        /**
+         * Different versions of a type will have different schemas but
+         * the same name, count them so their files don't collide
+         */
+        std::map<std::string, int> m_versions;
+
+        std::string m_record;
+
+    public :
+        AvroExporter (std::string, bool);
+
+        using Exporter::add;
+        void add (BlobInspector &) override;
+        void close() override;
+};
+
+/******************************************************************************/
+
+/**
+ * One Arrow IPC stream file per distinct schema where each blob is a row
+ * and each leaf field a column. Rows are buffered and written out as
+ * record batches of up to BATCH_ROWS at a time.
+ */
+class ArrowExporter : public Exporter {
+    private :
+        struct Target {
+            uPtr<AvroSchema>  schema;
+            uPtr<Columns>     columns;
+            uPtr<ArrowStream> stream;
+        };
+
+        std::string m_directory;
+
+        std::map<std::string, Target> m_targets;
+        std::map<std::string, int> m_versions;
+
+    public :
+        static constexpr int64_t BATCH_ROWS = 64 * 1024;
+
+        explicit ArrowExporter (std::string);
+
+        using Exporter::add;
+        void add (BlobInspector &) override;
+        void close() override;
+};
+
+/******************************************************************************/
+
+/**
+ * Newline delimited JSON. The first time a schema is seen a line
+ * introducing it is written
+ *
+ *   {"schema":0,"avro":{...}}
+ *
+ * after which each blob is a single line referencing it
+ *
+ *   {"schema":0,"value":[...]}
+ *
+ * carrying the blob's SHA-256 when it's known
+ *
+ *   {"schema":0,"sha256":"...","value":[...]}
+ *
+ * A blob identical to an earlier one is written as a reference to that
+ * blob's line, counting only the lines holding values
+ *
+ *   {"duplicate":3,"sha256":"..."}
+ */
+class NdJsonExporter : public Exporter {
+    private :
+        std::ostream & m_out;
+
+        std::map<std::string, std::pair<size_t, uPtr<AvroSchema>>> m_schemas;
+
+        std::string m_line;
+
+    public :
+        explicit NdJsonExporter (std::ostream &);
+
+        void add (BlobInspector &) override;
+        void add (BlobInspector &, const std::string &) override;
+        void duplicate (size_t, const std::string &) override;
+        void close() override;
+};
+
+/******************************************************************************/
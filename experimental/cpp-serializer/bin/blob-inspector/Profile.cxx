@@ -0,0 +1,449 @@
+#include "Profile.h"
+
+#include <vector>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "amqp/reader/IVisitor.h"
+#include "amqp/util/Json.h"
+#include "amqp/util/Parallel.h"
+
+/******************************************************************************/
+
+namespace {
+
+    size_t
+    bucket (size_t length_) {
+        size_t rtn { 0 };
+        while (length_) {
+            ++rtn;
+            length_ >>= 1;
+        }
+
+        return std::min (rtn, Profile::LENGTH_BUCKETS - 1);
+    }
+
+    std::string
+    range (size_t bucket_) {
+        if (bucket_ < 2) {
+            return std::to_string (bucket_);
+        }
+
+        return std::to_string (uint64_t (1) << (bucket_ - 1))
+            + "-" + std::to_string ((uint64_t (1) << bucket_) - 1);
+    }
+
+    std::vector<std::string>
+    kinds (uint32_t kinds_) {
+        static const std::pair<uint32_t, const char *> names[] = {
+            { Profile::int_t, "int" }, { Profile::long_t, "long" },
+            { Profile::bool_t, "bool" }, { Profile::double_t, "double" },
+            { Profile::string_t, "string" }, { Profile::enum_t, "enum" },
+            { Profile::composite_t, "composite" }, { Profile::list_t, "collection" }
+        };
+
+        std::vector<std::string> rtn;
+        for (const auto & name : names) {
+            if (kinds_ & name.first) {
+                rtn.emplace_back (name.second);
+            }
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * Profile::Profiler
+ *
+ ******************************************************************************/
+
+/**
+ * Follows a single blob through the visitor's events keeping track of
+ * the path to whatever's being reported
+ */
+class Profile::Profiler : public amqp::reader::IVisitor {
+    private :
+        enum frame_t { composite_f, list_f, map_f };
+
+        struct Frame {
+            frame_t     kind;
+            std::string path;
+            bool        value { false };
+        };
+
+        Profile & m_profile;
+
+        std::map<std::string, Field> * m_fields { nullptr };
+
+        std::vector<Frame> m_frames;
+
+        /**
+         * The composite field announced and waiting for its value
+         */
+        std::string m_field;
+
+        /**
+         * Where the value about to be reported belongs
+         */
+        std::string path() {
+            auto & top = m_frames.back();
+
+            switch (top.kind) {
+                case composite_f :
+                    return m_field;
+                case list_f :
+                    return top.path + "[]";
+                case map_f :
+                    top.value = !top.value;
+                    return top.path + (top.value ? "{key}" : "{value}");
+            }
+
+            return m_field;
+        }
+
+        Field & field (kind_t kind_) {
+            auto p = path();
+
+            auto f = m_fields->find (p);
+            if (f == m_fields->end()) {
+                f = m_fields->emplace (p, Field (m_profile.m_capacity)).first;
+            }
+
+            ++f->second.count;
+            f->second.kinds |= kind_;
+
+            return f->second;
+        }
+
+        void number (kind_t kind_, const Aggregation::Number & n_) {
+            auto & f = field (kind_);
+            f.number (n_);
+            f.value (n_.str());
+        }
+
+    public :
+        explicit Profiler (Profile & profile_) : m_profile (profile_) { }
+
+        void onBeginComposite (const std::string & type_) override {
+            if (m_frames.empty()) {
+                ++m_profile.m_blobs;
+                ++m_profile.m_counts[type_];
+
+                m_fields = &m_profile.m_types[type_];
+                m_frames.push_back ({ composite_f, "" });
+                return;
+            }
+
+            auto p = path();
+            field (composite_t);
+
+            m_frames.push_back ({ composite_f, p });
+        }
+
+        void onEndComposite() override {
+            m_frames.pop_back();
+        }
+
+        void onField (const std::string & name_) override {
+            const auto & prefix = m_frames.back().path;
+            m_field = prefix.empty() ? name_ : prefix + "." + name_;
+        }
+
+        void onNull() override {
+            auto p = path();
+
+            auto f = m_fields->find (p);
+            if (f == m_fields->end()) {
+                f = m_fields->emplace (p, Field (m_profile.m_capacity)).first;
+            }
+
+            ++f->second.count;
+            ++f->second.nulls;
+        }
+
+        void onInt (int32_t val_) override {
+            Aggregation::Number n;
+            n.integer = val_;
+            number (int_t, n);
+        }
+
+        void onLong (int64_t val_) override {
+            Aggregation::Number n;
+            n.integer = val_;
+            number (long_t, n);
+        }
+
+        void onDouble (double val_) override {
+            Aggregation::Number n;
+            n.real = true;
+            n.value = val_;
+            number (double_t, n);
+        }
+
+        void onBool (bool val_) override {
+            field (bool_t).value (val_ ? "true" : "false");
+        }
+
+        void onString (std::string_view val_) override {
+            auto & f = field (string_t);
+            ++f.lengths[bucket (val_.size())];
+            f.value (val_);
+        }
+
+        void onEnum (int32_t, std::string_view name_) override {
+            field (enum_t).value (name_);
+        }
+
+        void onBeginList (size_t) override {
+            auto p = path();
+            field (list_t);
+
+            m_frames.push_back ({ list_f, p });
+        }
+
+        void onEndList() override {
+            m_frames.pop_back();
+        }
+
+        void onBeginMap (size_t) override {
+            auto p = path();
+            field (list_t);
+
+            m_frames.push_back ({ map_f, p });
+        }
+
+        void onEndMap() override {
+            m_frames.pop_back();
+        }
+};
+
+/******************************************************************************
+ *
+ * Profile::Field
+ *
+ ******************************************************************************/
+
+void
+Profile::Field::number (const Aggregation::Number & n_) {
+    if (numbers == 0 || n_ < min) {
+        min = n_;
+    }
+
+    if (numbers == 0 || max < n_) {
+        max = n_;
+    }
+
+    ++numbers;
+}
+
+/******************************************************************************/
+
+void
+Profile::Field::value (std::string_view value_) {
+    distinct.add (value_);
+    frequent.add (value_);
+}
+
+/******************************************************************************/
+
+void
+Profile::Field::merge (const Field & other_) {
+    count += other_.count;
+    nulls += other_.nulls;
+    kinds |= other_.kinds;
+
+    if (other_.numbers) {
+        if (numbers == 0 || other_.min < min) min = other_.min;
+        if (numbers == 0 || max < other_.max) max = other_.max;
+        numbers += other_.numbers;
+    }
+
+    for (size_t i { 0 } ; i < LENGTH_BUCKETS ; ++i) {
+        lengths[i] += other_.lengths[i];
+    }
+
+    distinct.merge (other_.distinct);
+    frequent.merge (other_.frequent);
+}
+
+/******************************************************************************
+ *
+ * Profile
+ *
+ ******************************************************************************/
+
+Profile::Profile (size_t capacity_)
+    : m_capacity (capacity_)
+    , m_blobs (0)
+{
+}
+
+/******************************************************************************/
+
+uint64_t
+Profile::count (const std::string & type_) const {
+    auto count = m_counts.find (type_);
+
+    return count == m_counts.end() ? 0 : count->second;
+}
+
+/******************************************************************************/
+
+void
+Profile::merge (Profile & other_) {
+    m_blobs += other_.m_blobs;
+
+    for (const auto & count : other_.m_counts) {
+        m_counts[count.first] += count.second;
+    }
+
+    for (auto & type : other_.m_types) {
+        auto & fields = m_types[type.first];
+
+        for (auto & field : type.second) {
+            auto f = fields.find (field.first);
+
+            if (f == fields.end()) {
+                fields.emplace (field.first, std::move (field.second));
+            } else {
+                f->second.merge (field.second);
+            }
+        }
+    }
+
+    other_.m_types.clear();
+    other_.m_counts.clear();
+    other_.m_blobs = 0;
+}
+
+/******************************************************************************/
+
+void
+Profile::run (size_t blobs_, const Source & source_, size_t threads_) {
+    std::vector<Profile> profiles (amqp::util::chunks (blobs_, threads_), Profile (m_capacity));
+
+    amqp::util::parallel (blobs_, threads_, [&](size_t chunk_, size_t begin_, size_t end_) {
+        for (auto j = begin_ ; j < end_ ; ++j) {
+            Profiler profiler (profiles[chunk_]);
+            source_ (j, profiler);
+        }
+    });
+
+    for (auto & profile : profiles) {
+        merge (profile);
+    }
+}
+
+/******************************************************************************/
+
+void
+Profile::text (std::ostream & out_, size_t top_) const {
+    for (const auto & type : m_types) {
+        out_ << type.first << " : " << count (type.first) << " blobs" << std::endl;
+
+        for (const auto & entry : type.second) {
+            const auto & f = entry.second;
+
+            out_ << "  " << entry.first << std::endl;
+
+            out_ << "    kinds    :";
+            for (const auto & kind : kinds (f.kinds)) {
+                out_ << " " << kind;
+            }
+            out_ << std::endl;
+
+            out_ << "    count    : " << f.count << ", " << f.nulls << " null" << std::endl;
+
+            if (f.numbers) {
+                out_ << "    range    : " << f.min.str() << " .. " << f.max.str() << std::endl;
+            }
+
+            if (f.kinds & string_t) {
+                out_ << "    lengths  :";
+                for (size_t i { 0 } ; i < LENGTH_BUCKETS ; ++i) {
+                    if (f.lengths[i]) {
+                        out_ << " " << range (i) << "=" << f.lengths[i];
+                    }
+                }
+                out_ << std::endl;
+            }
+
+            auto top = f.frequent.top (top_);
+
+            if (!top.empty()) {
+                out_ << "    distinct : ~" << f.distinct.estimate() << std::endl;
+                out_ << "    top      :";
+
+                for (const auto & counter : top) {
+                    out_ << " " << counter.value << " (" << counter.count << ")";
+                }
+                out_ << std::endl;
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+Profile::ndjson (std::ostream & out_, size_t top_) const {
+    for (const auto & type : m_types) {
+        for (const auto & entry : type.second) {
+            const auto & f = entry.second;
+
+            out_ << "{\"type\":";
+            amqp::util::jsonString (type.first, out_);
+            out_ << ",\"path\":";
+            amqp::util::jsonString (entry.first, out_);
+
+            out_ << ",\"kinds\":[";
+            const char * sep = "";
+            for (const auto & kind : kinds (f.kinds)) {
+                out_ << sep << "\"" << kind << "\"";
+                sep = ",";
+            }
+            out_ << "]";
+
+            out_ << ",\"count\":" << f.count << ",\"nulls\":" << f.nulls;
+
+            if (f.numbers) {
+                out_ << ",\"min\":" << f.min.str() << ",\"max\":" << f.max.str();
+            }
+
+            if (f.kinds & string_t) {
+                out_ << ",\"lengths\":{";
+                sep = "";
+                for (size_t i { 0 } ; i < LENGTH_BUCKETS ; ++i) {
+                    if (f.lengths[i]) {
+                        out_ << sep << "\"" << range (i) << "\":" << f.lengths[i];
+                        sep = ",";
+                    }
+                }
+                out_ << "}";
+            }
+
+            auto top = f.frequent.top (top_);
+
+            if (!top.empty()) {
+                out_ << ",\"distinct\":" << f.distinct.estimate() << ",\"top\":[";
+                sep = "";
+                for (const auto & counter : top) {
+                    out_ << sep << "{\"value\":";
+                    amqp::util::jsonString (counter.value, out_);
+                    out_ << ",\"count\":" << counter.count
+                         << ",\"error\":" << counter.error << "}";
+                    sep = ",";
+                }
+                out_ << "]";
+            }
+
+            out_ << "}" << std::endl;
+        }
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,134 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <array>
+#include <iosfwd>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+#include "Sketches.h"
+#include "Aggregation.h"
+
+/******************************************************************************/
+
+namespace amqp::reader {
+
+    class IVisitor;
+
+}
+
+/******************************************************************************/
+
+/**
+ * Statistics on every field of every type across a set of blobs, built
+ * in one pass with whatever they need kept in sketches of fixed size so
+ * profiling a corpus of any size takes the same memory.
+ *
+ * Fields are known by their dotted path down from the blob's top level
+ * type; the elements of a list or array by its path and "[]", the keys
+ * and values of a map by "{key}" and "{value}".
+ *
+ * Each worker profiles its share of the blobs into a profile of its own
+ * and those are merged once they're all done, everything here merging
+ * into the profile of everything both saw.
+ */
+class Profile {
+    public :
+        /**
+         * Strings are counted by length in power of two buckets, bucket
+         * n holding lengths from 2^(n-1) up to 2^n - 1 and bucket 0 the
+         * empty ones
+         */
+        static constexpr size_t LENGTH_BUCKETS { 33 };
+
+        enum kind_t : uint8_t {
+            int_t = 1, long_t = 2, bool_t = 4, double_t = 8, string_t = 16,
+            enum_t = 32, composite_t = 64, list_t = 128
+        };
+
+        struct Field {
+            uint64_t count { 0 };
+            uint64_t nulls { 0 };
+
+            /**
+             * Of the kinds of value seen
+             */
+            uint32_t kinds { 0 };
+
+            uint64_t numbers { 0 };
+            Aggregation::Number min;
+            Aggregation::Number max;
+
+            std::array<uint64_t, LENGTH_BUCKETS> lengths { };
+
+            HyperLogLog distinct;
+            SpaceSaving frequent;
+
+            explicit Field (size_t capacity_) : frequent (capacity_) { }
+
+            void number (const Aggregation::Number &);
+            void value (std::string_view);
+
+            void merge (const Field &);
+        };
+
+        /**
+         * Profiles a single blob, called from several threads at once so
+         * each gets a visitor of its own
+         */
+        using Source = std::function<void (size_t, amqp::reader::IVisitor &)>;
+
+    private :
+        size_t m_capacity;
+
+        uint64_t m_blobs;
+
+        /**
+         * Fields by path by top level type
+         */
+        std::map<std::string, std::map<std::string, Field>> m_types;
+
+        /**
+         * Blobs of each top level type
+         */
+        std::map<std::string, uint64_t> m_counts;
+
+        class Profiler;
+
+    public :
+        /**
+         * [capacity_] values per field are tracked as candidates for the
+         * most frequent
+         */
+        explicit Profile (size_t capacity_ = 64);
+
+        /**
+         * Profile [blobs_] blobs across [threads_] workers
+         */
+        void run (size_t blobs_, const Source &, size_t threads_ = 1);
+
+        void merge (Profile &);
+
+        uint64_t blobs() const { return m_blobs; }
+
+        const std::map<std::string, std::map<std::string, Field>> & types() const {
+            return m_types;
+        }
+
+        uint64_t count (const std::string & type_) const;
+
+        /**
+         * Field by field, with the [top_] most frequent values of each
+         */
+        void text (std::ostream &, size_t top_ = 5) const;
+
+        /**
+         * A JSON object per field
+         */
+        void ndjson (std::ostream &, size_t top_ = 5) const;
+};
+
+/******************************************************************************/
@@ -0,0 +1,486 @@
+#include "SchemaStore.h"
+
+#include <list>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Sha256.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Choice.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/described-types/Descriptor.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Restricted.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const char MAGIC[] = "CRDSCHM1";
+    const size_t HEADER_SIZE = 16;
+    const size_t ENTRY_HEADER_SIZE = 16;
+
+    enum : uint8_t { composite_t, restricted_t };
+
+    /**
+     * Holds a lock on the store's file for the duration of a scope,
+     * exclusive unless asked for a shared one
+     */
+    class FileLock {
+        private :
+            int m_fd;
+
+        public :
+            explicit FileLock (int fd_, int operation_ = LOCK_EX) : m_fd (fd_) {
+                if (flock (m_fd, operation_) != 0) {
+                    throw std::runtime_error ("Failed to lock the schema store");
+                }
+            }
+
+            ~FileLock() {
+                flock (m_fd, LOCK_UN);
+            }
+    };
+
+    /**************************************************************************/
+
+    class Writer {
+        private :
+            std::string & m_out;
+
+        public :
+            explicit Writer (std::string & out_) : m_out (out_) { }
+
+            template<typename T>
+            void
+            scalar (T val_) {
+                m_out.append (reinterpret_cast<const char *>(&val_), sizeof (T));
+            }
+
+            void
+            string (const std::string & str_) {
+                scalar<uint32_t> (static_cast<uint32_t>(str_.size()));
+                m_out.append (str_);
+            }
+
+            template<typename C>
+            void
+            strings (const C & strs_) {
+                scalar<uint32_t> (static_cast<uint32_t>(strs_.size()));
+                for (const auto & str : strs_) {
+                    string (str);
+                }
+            }
+    };
+
+    /**************************************************************************/
+
+    class Reader {
+        private :
+            const char * m_pos;
+            const char * m_end;
+
+            void
+            need (size_t size_) const {
+                if (static_cast<size_t>(m_end - m_pos) < size_) {
+                    throw std::runtime_error ("Corrupt schema store entry");
+                }
+            }
+
+        public :
+            Reader (const char * pos_, const char * end_)
+                : m_pos (pos_)
+                , m_end (end_)
+            { }
+
+            template<typename T>
+            T
+            scalar() {
+                need (sizeof (T));
+                T rtn;
+                memcpy (&rtn, m_pos, sizeof (T));
+                m_pos += sizeof (T);
+                return rtn;
+            }
+
+            std::string
+            string() {
+                auto size = scalar<uint32_t>();
+                need (size);
+                std::string rtn (m_pos, size);
+                m_pos += size;
+                return rtn;
+            }
+
+            template<typename C>
+            C
+            strings() {
+                C rtn;
+                for (auto i = scalar<uint32_t>() ; i > 0 ; --i) {
+                    rtn.insert (rtn.end(), string());
+                }
+                return rtn;
+            }
+    };
+
+    /**************************************************************************/
+
+    /**
+     * Only what's needed to read blobs is kept, the parts of the schema
+     * that are purely informational (labels, defaults and the interfaces
+     * composites implement) aren't
+     */
+    void
+    serialise (const amqp::internal::schema::Schema & schema_, Writer & out_) {
+        using namespace amqp::internal::schema;
+
+        size_t levels { 0 };
+        for (auto it = schema_.begin() ; it != schema_.end() ; ++it) ++levels;
+
+        out_.scalar<uint32_t> (static_cast<uint32_t>(levels));
+
+        for (const auto & level : schema_) {
+            out_.scalar<uint32_t> (static_cast<uint32_t>(level.size()));
+
+            for (const auto & type : level) {
+                if (type->type() == AMQPTypeNotation::composite_t) {
+                    const auto & composite = dynamic_cast<const Composite &>(*type);
+
+                    out_.scalar<uint8_t> (composite_t);
+                    out_.string (type->name());
+                    out_.string (type->descriptor());
+
+                    out_.scalar<uint32_t> (static_cast<uint32_t>(composite.fields().size()));
+                    for (const auto & field : composite.fields()) {
+                        out_.string (field->name());
+                        out_.string (field->type());
+                        out_.strings (field->requires());
+                        out_.scalar<uint8_t> (field->mandatory() ? 1 : 0);
+                    }
+                } else {
+                    const auto & restricted = dynamic_cast<const Restricted &>(*type);
+
+                    out_.scalar<uint8_t> (restricted_t);
+                    out_.string (type->name());
+                    out_.string (type->descriptor());
+                    out_.string (restricted.label());
+                    out_.strings (restricted.provides());
+                    out_.string (restricted.restrictedType() == Restricted::map_t ? "map" : "list");
+
+                    if (restricted.restrictedType() == Restricted::enum_t) {
+                        out_.strings (dynamic_cast<const Enum &>(restricted).makeChoices());
+                    } else {
+                        out_.scalar<uint32_t> (0);
+                    }
+                }
+            }
+        }
+    }
+
+    /**************************************************************************/
+
+    uPtr<amqp::internal::schema::Schema>
+    deserialise (Reader & in_) {
+        using namespace amqp::internal::schema;
+
+        OrderedTypeNotations<AMQPTypeNotation> notations;
+
+        for (auto levels = in_.scalar<uint32_t>() ; levels > 0 ; --levels) {
+            std::list<uPtr<AMQPTypeNotation>> level;
+
+            for (auto types = in_.scalar<uint32_t>() ; types > 0 ; --types) {
+                auto kind = in_.scalar<uint8_t>();
+                auto name = in_.string();
+                auto descriptor = std::make_unique<Descriptor> (in_.string());
+
+                if (kind == composite_t) {
+                    auto count = in_.scalar<uint32_t>();
+
+                    std::vector<uPtr<Field>> fields;
+                    fields.reserve (count);
+
+                    for (auto i = count ; i > 0 ; --i) {
+                        auto fieldName = in_.string();
+                        auto type = in_.string();
+                        auto requires = in_.strings<std::list<std::string>>();
+                        auto mandatory = in_.scalar<uint8_t>() != 0;
+
+                        fields.emplace_back (Field::make (
+                            std::move (fieldName), std::move (type), std::move (requires),
+                            "", "", mandatory, false));
+                    }
+
+                    level.emplace_back (std::make_unique<Composite> (
+                        std::move (name), "", std::list<std::string>(),
+                        std::move (descriptor), std::move (fields)));
+                } else {
+                    auto label = in_.string();
+                    auto provides = in_.strings<std::vector<std::string>>();
+                    auto source = in_.string();
+
+                    std::vector<uPtr<Choice>> choices;
+                    for (auto & choice : in_.strings<std::vector<std::string>>()) {
+                        choices.emplace_back (std::make_unique<Choice> (std::move (choice)));
+                    }
+
+                    level.emplace_back (Restricted::make (
+                        std::move (descriptor), std::move (name), std::move (label),
+                        std::move (provides), std::move (source), std::move (choices)));
+                }
+            }
+
+            notations.insertLevel (std::move (level));
+        }
+
+        return std::make_unique<Schema> (std::move (notations));
+    }
+
+}
+
+/******************************************************************************
+ *
+ * SchemaStore
+ *
+ ******************************************************************************/
+
+/**
+ * FNV-1a
+ */
+uint64_t
+SchemaStore::hash (const std::string & key_) {
+    uint64_t rtn { 0xcbf29ce484222325UL };
+    for (auto c : key_) {
+        rtn ^= static_cast<uint8_t>(c);
+        rtn *= 0x100000001b3UL;
+    }
+    return rtn;
+}
+
+/******************************************************************************/
+
+std::string
+SchemaStore::key (
+    const std::string & descriptor_,
+    const char * begin_,
+    const char * end_
+) {
+    return descriptor_ + "/" + Sha256::hex (Sha256().update (begin_, end_ - begin_).digest());
+}
+
+/******************************************************************************/
+
+SchemaStore::SchemaStore (std::string path_)
+    : m_path (std::move (path_))
+    , m_fd (open (m_path.c_str(), O_RDWR | O_CREAT, 0644))
+    , m_map (nullptr)
+    , m_mapped (0)
+    , m_indexed (HEADER_SIZE)
+{
+    if (m_fd < 0) {
+        throw std::runtime_error ("Can't open schema store " + m_path);
+    }
+
+    {
+        FileLock lock (m_fd);
+
+        struct stat st { };
+        fstat (m_fd, &st);
+
+        if (st.st_size == 0) {
+            char header[HEADER_SIZE] { };
+            memcpy (header, MAGIC, 8);
+            if (write (m_fd, header, HEADER_SIZE) != static_cast<ssize_t>(HEADER_SIZE)) {
+                throw std::runtime_error ("Can't initialise schema store " + m_path);
+            }
+        }
+    }
+
+    refresh();
+
+    if (memcmp (m_map, MAGIC, 8) != 0) {
+        throw std::runtime_error (m_path + " is not a schema store");
+    }
+}
+
+/******************************************************************************/
+
+SchemaStore::~SchemaStore() {
+    if (m_map) {
+        munmap (const_cast<char *>(m_map), m_mapped);
+    }
+    close (m_fd);
+}
+
+/******************************************************************************/
+
+void
+SchemaStore::refresh() {
+    FileLock lock (m_fd, LOCK_SH);
+
+    index();
+}
+
+/******************************************************************************/
+
+/**
+ * Map anything that's been appended since we last looked and index it.
+ * Appends only ever happen under an exclusive lock so with any lock held
+ * the file ends with a whole entry
+ */
+void
+SchemaStore::index() {
+    struct stat st { };
+    if (fstat (m_fd, &st) != 0) {
+        throw std::runtime_error ("Can't stat schema store " + m_path);
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    if (size <= m_mapped) {
+        return;
+    }
+
+    if (size < HEADER_SIZE) {
+        throw std::runtime_error (m_path + " is not a schema store");
+    }
+
+    auto from = m_indexed;
+
+    if (m_map) {
+        munmap (const_cast<char *>(m_map), m_mapped);
+    }
+
+    auto map = mmap (nullptr, size, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED) {
+        m_map = nullptr;
+        m_mapped = 0;
+        throw std::runtime_error ("Can't map schema store " + m_path);
+    }
+
+    m_map = static_cast<const char *>(map);
+    m_mapped = size;
+
+    while (from + ENTRY_HEADER_SIZE <= m_mapped) {
+        uint32_t length;
+        uint64_t hash;
+        memcpy (&length, m_map + from, sizeof (length));
+        memcpy (&hash, m_map + from + 8, sizeof (hash));
+
+        if (length < ENTRY_HEADER_SIZE || from + length > m_mapped) {
+            throw std::runtime_error ("Corrupt schema store " + m_path);
+        }
+
+        m_index[hash].push_back (from);
+        from += length;
+    }
+
+    m_indexed = from;
+}
+
+/******************************************************************************/
+
+/**
+ * @return where in the map the stored schema for the key starts
+ */
+const char *
+SchemaStore::find (const std::string & key_) const {
+    auto it = m_index.find (hash (key_));
+
+    if (it == m_index.end()) {
+        return nullptr;
+    }
+
+    for (auto offset : it->second) {
+        uint32_t size;
+        memcpy (&size, m_map + offset + 4, sizeof (size));
+
+        if (size == key_.size()
+            && memcmp (m_map + offset + ENTRY_HEADER_SIZE, key_.data(), size) == 0)
+        {
+            return m_map + offset;
+        }
+    }
+
+    return nullptr;
+}
+
+/******************************************************************************/
+
+uPtr<amqp::internal::schema::Schema>
+SchemaStore::get (const std::string & key_) {
+    auto entry = find (key_);
+
+    if (!entry) {
+        refresh();
+        entry = find (key_);
+    }
+
+    if (!entry) {
+        return nullptr;
+    }
+
+    uint32_t length;
+    memcpy (&length, entry, sizeof (length));
+
+    Reader in (entry + ENTRY_HEADER_SIZE + key_.size(), entry + length);
+
+    return deserialise (in);
+}
+
+/******************************************************************************/
+
+void
+SchemaStore::put (
+    const std::string & key_,
+    const amqp::internal::schema::Schema & schema_
+) {
+    std::string entry (ENTRY_HEADER_SIZE, '\0');
+    entry += key_;
+
+    Writer out (entry);
+    serialise (schema_, out);
+
+    entry.append ((8 - (entry.size() % 8)) % 8, '\0');
+
+    auto length = static_cast<uint32_t>(entry.size());
+    auto size = static_cast<uint32_t>(key_.size());
+    auto h = hash (key_);
+
+    memcpy (&entry[0], &length, sizeof (length));
+    memcpy (&entry[4], &size, sizeof (size));
+    memcpy (&entry[8], &h, sizeof (h));
+
+    FileLock lock (m_fd);
+
+    // someone else may have beaten us to it
+    index();
+    if (find (key_)) {
+        return;
+    }
+
+    auto end = lseek (m_fd, 0, SEEK_END);
+    if (pwrite (m_fd, entry.data(), entry.size(), end) != static_cast<ssize_t>(entry.size())) {
+        throw std::runtime_error ("Failed writing to schema store " + m_path);
+    }
+
+    index();
+}
+
+/******************************************************************************/
+
+size_t
+SchemaStore::size() const {
+    size_t rtn { 0 };
+    for (const auto & entries : m_index) {
+        rtn += entries.second.size();
+    }
+    return rtn;
+}
+
+/******************************************************************************/
@@ -0,0 +1,107 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "types.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    class Schema;
+
+}
+
+/******************************************************************************/
+
+/**
+ * A persistent store of the schemas we've seen, shared between runs and
+ * between processes, so a blob whose schema has been seen before doesn't
+ * pay for decoding and dependency sorting it again.
+ *
+ * Schemas are keyed on the descriptor of the blob's top level type along
+ * with a hash of the encoded schema section, see [key]. The descriptor
+ * alone isn't enough, Corda's fingerprint only covers the types as
+ * declared while the schema section lists the concrete types carried by
+ * polymorphic fields, so two blobs of the same top level type can carry
+ * different schemas.
+ *
+ * What's kept is the schema already in dependency order, which is also
+ * the order the CompositeFactory builds readers in, so rebuilding both is
+ * a single pass over the stored entry.
+ *
+ * The file is an append only log of entries that's memory mapped, an index
+ * of it is built as it's opened. Writers take an exclusive lock on the
+ * file to append and readers pick up entries added by other processes
+ * when they miss, taking a shared lock to do so, so they never see an
+ * entry that's only partly written.
+ *
+ *   header : "CRDSCHM1" | reserved (8)
+ *   entry  : length (4) | key length (4) | hash (8) | key
+ *            | schema, padded to 8 bytes
+ */
+class SchemaStore {
+    private :
+        std::string m_path;
+        int         m_fd;
+
+        const char * m_map;
+        size_t       m_mapped;
+
+        /**
+         * How far into the map the entries have been indexed
+         */
+        size_t m_indexed;
+
+        /**
+         * entry offsets keyed by the hash of their key
+         */
+        std::unordered_map<uint64_t, std::vector<size_t>> m_index;
+
+        /**
+         * Takes a shared lock on the file and [index]es whatever's been
+         * added since we last looked
+         */
+        void refresh();
+
+        /**
+         * Only to be called holding a lock on the file
+         */
+        void index();
+
+        const char * find (const std::string &) const;
+
+    public :
+        static uint64_t hash (const std::string &);
+
+        /**
+         * What a blob's schema is stored under, its top level type's
+         * [descriptor_] and the SHA-256 of the schema section's encoding
+         * running from [begin_] to [end_]
+         */
+        static std::string key (
+            const std::string & descriptor_,
+            const char * begin_,
+            const char * end_);
+
+        explicit SchemaStore (std::string);
+        ~SchemaStore();
+
+        SchemaStore (const SchemaStore &) = delete;
+
+        /**
+         * @return the schema stored under the [key], or nullptr if there
+         * isn't one
+         */
+        uPtr<amqp::internal::schema::Schema> get (const std::string &);
+
+        void put (const std::string &, const amqp::internal::schema::Schema &);
+
+        size_t size() const;
+};
+
+/******************************************************************************/
@@ -0,0 +1,275 @@
+#include "Sha256.h"
+
+#include <cstring>
+#include <algorithm>
+
+#if defined (__x86_64__) && (defined (__GNUC__) || defined (__clang__))
+#define BLOB_INSPECTOR_SHA_NI
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+/******************************************************************************/
+
+namespace {
+
+    alignas (16) const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    inline uint32_t
+    rotr (uint32_t x_, int n_) {
+        return (x_ >> n_) | (x_ << (32 - n_));
+    }
+
+    void
+    portable (uint32_t * state_, const uint8_t * data_, size_t blocks_) {
+        for ( ; blocks_ > 0 ; --blocks_, data_ += 64) {
+            uint32_t w[64];
+
+            for (int i { 0 } ; i < 16 ; ++i) {
+                w[i] = uint32_t (data_[4 * i]) << 24
+                     | uint32_t (data_[4 * i + 1]) << 16
+                     | uint32_t (data_[4 * i + 2]) << 8
+                     | uint32_t (data_[4 * i + 3]);
+            }
+
+            for (int i { 16 } ; i < 64 ; ++i) {
+                auto s0 = rotr (w[i - 15], 7) ^ rotr (w[i - 15], 18) ^ (w[i - 15] >> 3);
+                auto s1 = rotr (w[i - 2], 17) ^ rotr (w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            auto a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+            auto e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+
+            for (int i { 0 } ; i < 64 ; ++i) {
+                auto t1 = h + (rotr (e, 6) ^ rotr (e, 11) ^ rotr (e, 25))
+                        + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                auto t2 = (rotr (a, 2) ^ rotr (a, 13) ^ rotr (a, 22))
+                        + ((a & b) ^ (a & c) ^ (b & c));
+
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+
+            state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+            state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+        }
+    }
+
+#ifdef BLOB_INSPECTOR_SHA_NI
+
+    /**
+     * Four rounds at a time with the SHA extensions, the state being
+     * kept as the ABEF and CDGH halves the instructions work on
+     */
+    __attribute__ ((target ("sha,sse4.1,ssse3")))
+    void
+    shani (uint32_t * state_, const uint8_t * data_, size_t blocks_) {
+        const __m128i mask = _mm_set_epi64x (0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        auto tmp = _mm_loadu_si128 (reinterpret_cast<const __m128i *>(state_));
+        auto state1 = _mm_loadu_si128 (reinterpret_cast<const __m128i *>(state_ + 4));
+
+        tmp = _mm_shuffle_epi32 (tmp, 0xb1);
+        state1 = _mm_shuffle_epi32 (state1, 0x1b);
+        auto state0 = _mm_alignr_epi8 (tmp, state1, 8);
+        state1 = _mm_blend_epi16 (state1, tmp, 0xf0);
+
+        for ( ; blocks_ > 0 ; --blocks_, data_ += 64) {
+            auto abef = state0;
+            auto cdgh = state1;
+
+            // w[i & 3] holds the four words of the schedule four groups back
+            __m128i w[4];
+
+            for (int i { 0 } ; i < 16 ; ++i) {
+                if (i < 4) {
+                    w[i] = _mm_shuffle_epi8 (
+                        _mm_loadu_si128 (reinterpret_cast<const __m128i *>(data_ + 16 * i)),
+                        mask);
+                } else {
+                    w[i & 3] = _mm_sha256msg2_epu32 (
+                        _mm_add_epi32 (
+                            _mm_sha256msg1_epu32 (w[i & 3], w[(i + 1) & 3]),
+                            _mm_alignr_epi8 (w[(i + 3) & 3], w[(i + 2) & 3], 4)),
+                        w[(i + 3) & 3]);
+                }
+
+                auto msg = _mm_add_epi32 (
+                    w[i & 3],
+                    _mm_load_si128 (reinterpret_cast<const __m128i *>(K + 4 * i)));
+
+                state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+                state0 = _mm_sha256rnds2_epu32 (state0, state1, _mm_shuffle_epi32 (msg, 0x0e));
+            }
+
+            state0 = _mm_add_epi32 (state0, abef);
+            state1 = _mm_add_epi32 (state1, cdgh);
+        }
+
+        tmp = _mm_shuffle_epi32 (state0, 0x1b);
+        state1 = _mm_shuffle_epi32 (state1, 0xb1);
+        state0 = _mm_blend_epi16 (tmp, state1, 0xf0);
+        state1 = _mm_alignr_epi8 (state1, tmp, 8);
+
+        _mm_storeu_si128 (reinterpret_cast<__m128i *>(state_), state0);
+        _mm_storeu_si128 (reinterpret_cast<__m128i *>(state_ + 4), state1);
+    }
+
+    bool
+    cpuHasSha() {
+        unsigned int a, b, c, d;
+
+        if (!__get_cpuid (1, &a, &b, &c, &d) || !(c & bit_SSE4_1) || !(c & bit_SSSE3)) {
+            return false;
+        }
+
+        if (!__get_cpuid_count (7, 0, &a, &b, &c, &d)) {
+            return false;
+        }
+
+        return (b & (1U << 29)) != 0;
+    }
+
+#endif
+
+}
+
+/******************************************************************************/
+
+bool
+Sha256::accelerated() {
+#ifdef BLOB_INSPECTOR_SHA_NI
+    static const bool sha = cpuHasSha();
+    return sha;
+#else
+    return false;
+#endif
+}
+
+/******************************************************************************/
+
+std::string
+Sha256::hex (const Digest & digest_) {
+    static const char digits[] = "0123456789ABCDEF";
+
+    std::string rtn;
+    rtn.reserve (2 * digest_.size());
+
+    for (auto b : digest_) {
+        rtn += digits[b >> 4];
+        rtn += digits[b & 0xf];
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+Sha256::Sha256 (bool accelerate_)
+    : m_state {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 }
+    , m_buffer { }
+    , m_buffered { 0 }
+    , m_length { 0 }
+    , m_accelerate { accelerate_ && accelerated() }
+{ }
+
+/******************************************************************************/
+
+void
+Sha256::blocks (const uint8_t * data_, size_t blocks_) {
+#ifdef BLOB_INSPECTOR_SHA_NI
+    if (m_accelerate) {
+        shani (m_state.data(), data_, blocks_);
+        return;
+    }
+#endif
+
+    portable (m_state.data(), data_, blocks_);
+}
+
+/******************************************************************************/
+
+/**
+ * Whole blocks are compressed straight from the caller's bytes, only the
+ * ragged ends are copied
+ */
+Sha256 &
+Sha256::update (const char * data_, size_t size_) {
+    auto data = reinterpret_cast<const uint8_t *>(data_);
+
+    m_length += size_;
+
+    if (m_buffered) {
+        auto n = std::min (size_, m_buffer.size() - m_buffered);
+
+        memcpy (m_buffer.data() + m_buffered, data, n);
+        m_buffered += n;
+        data += n;
+        size_ -= n;
+
+        if (m_buffered < m_buffer.size()) {
+            return *this;
+        }
+
+        blocks (m_buffer.data(), 1);
+        m_buffered = 0;
+    }
+
+    if (size_ >= 64) {
+        blocks (data, size_ / 64);
+        data += size_ & ~size_t (63);
+        size_ &= 63;
+    }
+
+    memcpy (m_buffer.data(), data, size_);
+    m_buffered = size_;
+
+    return *this;
+}
+
+/******************************************************************************/
+
+Sha256::Digest
+Sha256::digest() {
+    auto bits = m_length * 8;
+
+    m_buffer[m_buffered++] = 0x80;
+
+    if (m_buffered > 56) {
+        memset (m_buffer.data() + m_buffered, 0, 64 - m_buffered);
+        blocks (m_buffer.data(), 1);
+        m_buffered = 0;
+    }
+
+    memset (m_buffer.data() + m_buffered, 0, 56 - m_buffered);
+
+    for (int i { 0 } ; i < 8 ; ++i) {
+        m_buffer[63 - i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+
+    blocks (m_buffer.data(), 1);
+
+    Digest rtn;
+    for (size_t i { 0 } ; i < 8 ; ++i) {
+        rtn[4 * i]     = static_cast<uint8_t>(m_state[i] >> 24);
+        rtn[4 * i + 1] = static_cast<uint8_t>(m_state[i] >> 16);
+        rtn[4 * i + 2] = static_cast<uint8_t>(m_state[i] >> 8);
+        rtn[4 * i + 3] = static_cast<uint8_t>(m_state[i]);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
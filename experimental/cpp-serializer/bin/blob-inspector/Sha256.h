@@ -0,0 +1,55 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/******************************************************************************/
+
+/**
+ * SHA-256, as Corda's SecureHash.sha256, fed incrementally.
+ *
+ * Where the CPU has the SHA extensions blocks are compressed with them,
+ * otherwise, or when asked not to, with plain C++. Both give the same
+ * digest, only the speed differs.
+ */
+class Sha256 {
+    public :
+        using Digest = std::array<uint8_t, 32>;
+
+        /**
+         * True when this CPU has the SHA extensions
+         */
+        static bool accelerated();
+
+        /**
+         * Upper case hex, as SecureHash prints itself
+         */
+        static std::string hex (const Digest &);
+
+    private :
+        std::array<uint32_t, 8> m_state;
+        std::array<uint8_t, 64> m_buffer;
+
+        size_t   m_buffered;
+        uint64_t m_length;
+        bool     m_accelerate;
+
+        void blocks (const uint8_t *, size_t);
+
+    public :
+        explicit Sha256 (bool accelerate_ = true);
+
+        Sha256 & update (const char *, size_t);
+
+        /**
+         * Pads and finishes the hash, after which nothing more can be
+         * added
+         */
+        Digest digest();
+};
+
+/******************************************************************************/
@@ -0,0 +1,300 @@
+#include "Sketches.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "amqp/schema/fingerprint/Murmur3.h"
+
+/******************************************************************************/
+
+namespace {
+
+    uint64_t
+    hash64 (std::string_view value_) {
+        auto digest = amqp::internal::schema::Murmur3::hash (value_.data(), value_.size());
+
+        uint64_t rtn;
+        memcpy (&rtn, digest.data(), sizeof (rtn));
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * HyperLogLog
+ *
+ ******************************************************************************/
+
+HyperLogLog::HyperLogLog() : m_registers { } { }
+
+/******************************************************************************/
+
+/**
+ * The top bits pick the register, the rest give the run of zeros it
+ * remembers the longest of
+ */
+void
+HyperLogLog::add (std::string_view value_) {
+    auto h = hash64 (value_);
+
+    auto index = h >> (64 - PRECISION);
+    auto rest = (h << PRECISION) | (uint64_t (1) << (PRECISION - 1));
+
+    auto rank = static_cast<uint8_t>(__builtin_clzll (rest) + 1);
+
+    m_registers[index] = std::max (m_registers[index], rank);
+}
+
+/******************************************************************************/
+
+void
+HyperLogLog::merge (const HyperLogLog & other_) {
+    for (size_t i { 0 } ; i < REGISTERS ; ++i) {
+        m_registers[i] = std::max (m_registers[i], other_.m_registers[i]);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * With linear counting for the small cardinalities raw HyperLogLog
+ * overestimates
+ */
+uint64_t
+HyperLogLog::estimate() const {
+    const double m = REGISTERS;
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+    double sum { 0 };
+    size_t zeros { 0 };
+
+    for (auto r : m_registers) {
+        sum += std::ldexp (1.0, -r);
+        zeros += r == 0;
+    }
+
+    auto e = alpha * m * m / sum;
+
+    if (e <= 2.5 * m && zeros) {
+        e = m * std::log (m / zeros);
+    }
+
+    return static_cast<uint64_t>(std::llround (e));
+}
+
+/******************************************************************************
+ *
+ * SpaceSaving
+ *
+ ******************************************************************************/
+
+SpaceSaving::SpaceSaving (size_t capacity_)
+    : m_capacity (std::max<size_t> (capacity_, 1))
+{
+}
+
+/******************************************************************************/
+
+/**
+ * Nodes point at their buckets and the index at the nodes' values, so
+ * a copy has to be rebuilt rather than copied member by member
+ */
+SpaceSaving::SpaceSaving (const SpaceSaving & other_)
+    : m_capacity (other_.m_capacity)
+{
+    assign (other_.counters());
+}
+
+/******************************************************************************/
+
+SpaceSaving &
+SpaceSaving::operator= (const SpaceSaving & other_) {
+    if (this != &other_) {
+        m_capacity = other_.m_capacity;
+        assign (other_.counters());
+    }
+
+    return *this;
+}
+
+/******************************************************************************/
+
+uint64_t
+SpaceSaving::minimum() const {
+    if (m_index.size() < m_capacity) {
+        return 0;
+    }
+
+    return m_buckets.front().count;
+}
+
+/******************************************************************************/
+
+/**
+ * Move the counter on to the bucket one above its own, creating that if
+ * there isn't one and dropping its old bucket if it's left empty
+ */
+void
+SpaceSaving::increment (std::list<Node>::iterator node_) {
+    auto bucket = node_->bucket;
+    auto next = std::next (bucket);
+
+    if (next == m_buckets.end() || next->count != bucket->count + 1) {
+        next = m_buckets.insert (next, Bucket { bucket->count + 1, { } });
+    }
+
+    next->nodes.splice (next->nodes.end(), bucket->nodes, node_);
+    node_->bucket = next;
+    ++node_->counter.count;
+
+    if (bucket->nodes.empty()) {
+        m_buckets.erase (bucket);
+    }
+}
+
+/******************************************************************************/
+
+void
+SpaceSaving::add (std::string_view value_) {
+    auto counter = m_index.find (value_);
+    if (counter != m_index.end()) {
+        increment (counter->second);
+        return;
+    }
+
+    if (m_index.size() < m_capacity) {
+        if (m_buckets.empty() || m_buckets.front().count != 1) {
+            m_buckets.push_front (Bucket { 1, { } });
+        }
+
+        auto & nodes = m_buckets.front().nodes;
+        auto node = nodes.insert (
+            nodes.end(), Node { Counter { std::string (value_), 1, 0 }, m_buckets.begin() });
+
+        m_index.emplace (node->counter.value, node);
+        return;
+    }
+
+    // evict the least frequent, its count becoming the newcomer's error
+    auto node = m_buckets.front().nodes.begin();
+
+    m_index.erase (node->counter.value);
+
+    node->counter.value.assign (value_.data(), value_.size());
+    node->counter.error = node->counter.count;
+
+    m_index.emplace (node->counter.value, node);
+
+    increment (node);
+}
+
+/******************************************************************************/
+
+std::vector<SpaceSaving::Counter>
+SpaceSaving::counters() const {
+    std::vector<Counter> rtn;
+    rtn.reserve (m_index.size());
+
+    for (const auto & bucket : m_buckets) {
+        for (const auto & node : bucket.nodes) {
+            rtn.push_back (node.counter);
+        }
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+/**
+ * Rebuild the summary from [counters_], which must fit
+ */
+void
+SpaceSaving::assign (std::vector<Counter> counters_) {
+    m_index.clear();
+    m_buckets.clear();
+
+    std::sort (counters_.begin(), counters_.end(),
+        [](const Counter & a_, const Counter & b_) { return a_.count < b_.count; });
+
+    for (auto & counter : counters_) {
+        if (m_buckets.empty() || m_buckets.back().count != counter.count) {
+            m_buckets.push_back (Bucket { counter.count, { } });
+        }
+
+        auto bucket = std::prev (m_buckets.end());
+        auto node = bucket->nodes.insert (
+            bucket->nodes.end(), Node { std::move (counter), bucket });
+
+        m_index.emplace (node->counter.value, node);
+    }
+}
+
+/******************************************************************************/
+
+void
+SpaceSaving::merge (const SpaceSaving & other_) {
+    auto mine = minimum();
+    auto theirs = other_.minimum();
+
+    std::vector<Counter> merged;
+    merged.reserve (m_index.size() + other_.m_index.size());
+
+    for (const auto & counter : counters()) {
+        auto c = counter;
+        auto other = other_.m_index.find (counter.value);
+
+        if (other != other_.m_index.end()) {
+            c.count += other->second->counter.count;
+            c.error += other->second->counter.error;
+        } else {
+            c.count += theirs;
+            c.error += theirs;
+        }
+
+        merged.push_back (std::move (c));
+    }
+
+    for (const auto & counter : other_.counters()) {
+        if (m_index.count (counter.value)) {
+            continue;
+        }
+
+        auto c = counter;
+        c.count += mine;
+        c.error += mine;
+
+        merged.push_back (std::move (c));
+    }
+
+    if (merged.size() > m_capacity) {
+        std::nth_element (merged.begin(), merged.begin() + m_capacity, merged.end(),
+            [](const Counter & a_, const Counter & b_) { return a_.count > b_.count; });
+
+        merged.resize (m_capacity);
+    }
+
+    assign (std::move (merged));
+}
+
+/******************************************************************************/
+
+std::vector<SpaceSaving::Counter>
+SpaceSaving::top (size_t n_) const {
+    auto rtn = counters();
+
+    std::sort (rtn.begin(), rtn.end(), [](const Counter & a_, const Counter & b_) {
+        return a_.count != b_.count ? a_.count > b_.count : a_.value < b_.value;
+    });
+
+    if (rtn.size() > n_) {
+        rtn.resize (n_);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
@@ -0,0 +1,108 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <list>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+/******************************************************************************/
+
+/**
+ * Approximate count of distinct values in fixed memory, 2^12 one byte
+ * registers giving a standard error of about 1.6%. Two sketches merge
+ * into the sketch of everything either saw.
+ */
+class HyperLogLog {
+    public :
+        static constexpr int    PRECISION { 12 };
+        static constexpr size_t REGISTERS { 1U << PRECISION };
+
+    private :
+        std::array<uint8_t, REGISTERS> m_registers;
+
+    public :
+        HyperLogLog();
+
+        void add (std::string_view);
+
+        void merge (const HyperLogLog &);
+
+        uint64_t estimate() const;
+};
+
+/******************************************************************************/
+
+/**
+ * The most frequent values seen, by Metwally et al's SpaceSaving; only
+ * [capacity] counters are ever kept and a new value evicts whichever has
+ * the lowest count, inheriting it as its possible overcount. Anything
+ * seen more than n / capacity times is guaranteed to be kept.
+ *
+ * Counters are kept in their stream summary, buckets of counters sharing
+ * a count in ascending order, so both counting a value already held and
+ * evicting the least frequent are constant time. Counters are found by a
+ * view of their own value so counting one costs no allocation.
+ *
+ * Merging, as per Agarwal et al, counts a value missing from a full
+ * summary as that summary's minimum before trimming back to capacity.
+ */
+class SpaceSaving {
+    public :
+        struct Counter {
+            std::string value;
+            uint64_t    count;
+            uint64_t    error;
+        };
+
+    private :
+        struct Bucket;
+
+        struct Node {
+            Counter                          counter;
+            std::list<Bucket>::iterator      bucket;
+        };
+
+        struct Bucket {
+            uint64_t        count;
+            std::list<Node> nodes;
+        };
+
+        size_t m_capacity;
+
+        /**
+         * Ascending by count, never holding an empty bucket
+         */
+        std::list<Bucket> m_buckets;
+
+        std::unordered_map<std::string_view, std::list<Node>::iterator> m_index;
+
+        uint64_t minimum() const;
+
+        void increment (std::list<Node>::iterator);
+
+        std::vector<Counter> counters() const;
+
+        void assign (std::vector<Counter>);
+
+    public :
+        explicit SpaceSaving (size_t capacity_ = 64);
+
+        SpaceSaving (const SpaceSaving &);
+        SpaceSaving & operator= (const SpaceSaving &);
+
+        void add (std::string_view);
+
+        void merge (const SpaceSaving &);
+
+        /**
+         * The [n_] most frequent, most frequent first
+         */
+        std::vector<Counter> top (size_t n_) const;
+};
+
+/******************************************************************************/
@@ -0,0 +1,439 @@
+#include "ValueIndex.h"
+
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "BlobPack.h"
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/util/Parallel.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const char MAGIC[] = "CRDVIDX1";
+    const size_t HEADER_SIZE = 16;
+    const size_t FOOTER_SIZE = 24;
+    const size_t PATH_HEADER_SIZE = 24;
+
+    static_assert (sizeof (ValueIndex::Key) == 24, "Index keys are 24 bytes");
+
+    using Run = std::vector<std::pair<std::string, uint64_t>>;
+
+    size_t
+    padded (size_t size_) {
+        return (size_ + 7) & ~size_t (7);
+    }
+
+    void
+    pad (std::string & out_) {
+        out_.append (padded (out_.size()) - out_.size(), '\0');
+    }
+
+    template<typename T>
+    void
+    scalar (std::string & out_, T val_) {
+        out_.append (reinterpret_cast<const char *>(&val_), sizeof (T));
+    }
+
+    void
+    leb128 (std::string & out_, uint64_t val_) {
+        do {
+            uint8_t byte = val_ & 0x7f;
+            val_ >>= 7;
+            out_ += static_cast<char>(val_ ? byte | 0x80 : byte);
+        } while (val_);
+    }
+
+    /**
+     * Every distinct value in [run_], which is sorted, followed by the
+     * postings of each and then the keys pointing at them. [offset_] is
+     * where in the file the section will start.
+     *
+     * @return the section and where in it the keys start
+     */
+    std::pair<std::string, size_t>
+    section (const Run & run_, uint64_t offset_) {
+        std::vector<ValueIndex::Key> keys;
+        std::string values;
+        std::string postings;
+
+        for (auto i = run_.begin() ; i != run_.end() ; ) {
+            ValueIndex::Key key { };
+            key.value = values.size();
+            key.length = static_cast<uint32_t>(i->first.size());
+            key.postings = postings.size();
+
+            values += i->first;
+
+            uint64_t last { 0 };
+            auto j = i;
+            for ( ; j != run_.end() && j->first == i->first ; ++j) {
+                leb128 (postings, j->second - last);
+                last = j->second;
+                ++key.count;
+            }
+
+            keys.push_back (key);
+            i = j;
+        }
+
+        /*
+         * Both offsets in the keys are relative to the section until
+         * now, make them relative to the file
+         */
+        for (auto & key : keys) {
+            key.value += offset_;
+            key.postings += offset_ + values.size();
+        }
+
+        auto rtn = values + postings;
+        pad (rtn);
+
+        auto at = rtn.size();
+        rtn.append (
+            reinterpret_cast<const char *>(keys.data()),
+            keys.size() * sizeof (ValueIndex::Key));
+
+        return std::make_pair (std::move (rtn), at);
+    }
+
+}
+
+/******************************************************************************
+ *
+ * ValueIndex
+ *
+ ******************************************************************************/
+
+ValueIndex::ValueIndex (const std::string & path_)
+    : m_fd (open (path_.c_str(), O_RDONLY))
+    , m_map (nullptr)
+    , m_mapped (0)
+{
+    if (m_fd < 0) {
+        throw std::runtime_error ("Can't open index " + path_);
+    }
+
+    struct stat st { };
+    fstat (m_fd, &st);
+    m_mapped = static_cast<size_t>(st.st_size);
+
+    if (m_mapped < HEADER_SIZE + FOOTER_SIZE) {
+        ::close (m_fd);
+        throw std::runtime_error (path_ + " is not an index");
+    }
+
+    auto map = mmap (nullptr, m_mapped, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED) {
+        ::close (m_fd);
+        throw std::runtime_error ("Can't map index " + path_);
+    }
+
+    m_map = static_cast<const char *>(map);
+
+    try {
+        index (path_);
+    } catch (...) {
+        munmap (const_cast<char *>(m_map), m_mapped);
+        ::close (m_fd);
+        throw;
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Read the list of paths the footer points at, checking every key of
+ * every path lies within the file
+ */
+void
+ValueIndex::index (const std::string & path_) {
+    auto footer = m_map + m_mapped - FOOTER_SIZE;
+
+    if (memcmp (m_map, MAGIC, 8) != 0 || memcmp (footer + 16, MAGIC, 8) != 0) {
+        throw std::runtime_error (path_ + " is not an index");
+    }
+
+    auto corrupt = [&path_]() {
+        return std::runtime_error ("Corrupt index " + path_);
+    };
+
+    auto within = [](uint64_t offset_, uint64_t length_, uint64_t end_) {
+        return offset_ <= end_ && length_ <= end_ - offset_;
+    };
+
+    uint64_t at, paths;
+    memcpy (&at, footer, 8);
+    memcpy (&paths, footer + 8, 8);
+
+    auto end = m_mapped - FOOTER_SIZE;
+
+    if (at < HEADER_SIZE || at > end) {
+        throw corrupt();
+    }
+
+    for (uint64_t i { 0 } ; i < paths ; ++i) {
+        if (!within (at, PATH_HEADER_SIZE, end)) {
+            throw corrupt();
+        }
+
+        uint64_t keys, size;
+        uint32_t length;
+        memcpy (&keys, m_map + at, 8);
+        memcpy (&size, m_map + at + 8, 8);
+        memcpy (&length, m_map + at + 16, 4);
+
+        if (!within (at + PATH_HEADER_SIZE, length, end)
+            || keys < HEADER_SIZE || keys > end || keys % alignof (Key) != 0
+            || size > (end - keys) / sizeof (Key))
+        {
+            throw corrupt();
+        }
+
+        auto first = reinterpret_cast<const Key *>(m_map + keys);
+
+        /*
+         * Every posting takes at least a byte, so a key can't claim more
+         * of them than there are bytes left
+         */
+        for (uint64_t k { 0 } ; k < size ; ++k) {
+            const auto & key = first[k];
+
+            if (!within (key.value, key.length, end)
+                || key.postings < HEADER_SIZE
+                || !within (key.postings, key.count, end))
+            {
+                throw corrupt();
+            }
+        }
+
+        m_paths.push_back ({
+            std::string (m_map + at + PATH_HEADER_SIZE, length),
+            first,
+            static_cast<size_t>(size) });
+
+        at += padded (PATH_HEADER_SIZE + length);
+    }
+}
+
+/******************************************************************************/
+
+ValueIndex::~ValueIndex() {
+    if (m_map) {
+        munmap (const_cast<char *>(m_map), m_mapped);
+    }
+    ::close (m_fd);
+}
+
+/******************************************************************************/
+
+std::vector<std::string>
+ValueIndex::paths() const {
+    std::vector<std::string> rtn;
+    for (const auto & path : m_paths) {
+        rtn.push_back (path.path);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+const ValueIndex::Path &
+ValueIndex::path (const std::string & path_) const {
+    for (const auto & path : m_paths) {
+        if (path.path == path_) {
+            return path;
+        }
+    }
+
+    throw std::runtime_error (path_ + " isn't indexed");
+}
+
+/******************************************************************************/
+
+size_t
+ValueIndex::cardinality (const std::string & path_) const {
+    return path (path_).size;
+}
+
+/******************************************************************************/
+
+std::vector<uint64_t>
+ValueIndex::lookup (const std::string & path_, const std::string & value_) const {
+    const auto & p = path (path_);
+
+    auto key = std::lower_bound (
+        p.keys, p.keys + p.size, std::string_view (value_),
+        [this](const Key & key_, std::string_view value_) {
+            return std::string_view (m_map + key_.value, key_.length) < value_;
+        });
+
+    std::vector<uint64_t> rtn;
+
+    if (key == p.keys + p.size
+        || std::string_view (m_map + key->value, key->length) != value_)
+    {
+        return rtn;
+    }
+
+    rtn.reserve (key->count);
+
+    auto postings = reinterpret_cast<const uint8_t *>(m_map + key->postings);
+    auto end = reinterpret_cast<const uint8_t *>(m_map + m_mapped - FOOTER_SIZE);
+
+    uint64_t ordinal { 0 };
+
+    for (uint32_t i { 0 } ; i < key->count ; ++i) {
+        uint64_t delta { 0 };
+        int shift { 0 };
+
+        do {
+            if (postings == end || shift >= 64) {
+                throw std::runtime_error ("Corrupt postings for " + path_);
+            }
+            delta |= uint64_t (*postings & 0x7f) << shift;
+            shift += 7;
+        } while (*postings++ & 0x80);
+
+        ordinal += delta;
+        rtn.push_back (ordinal);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************
+ *
+ * ValueIndexBuilder
+ *
+ ******************************************************************************/
+
+ValueIndexBuilder::ValueIndexBuilder (std::vector<std::string> paths_, size_t threads_)
+    : m_paths (std::move (paths_))
+    , m_threads (std::max<size_t> (threads_, 1))
+{
+    if (m_paths.empty()) {
+        throw std::runtime_error ("Nothing to index on");
+    }
+}
+
+/******************************************************************************/
+
+void
+ValueIndexBuilder::build (
+    size_t blobs_,
+    const Source & source_,
+    const std::string & out_
+) const {
+    auto chunks = amqp::util::chunks (blobs_, m_threads);
+
+    // a run per path per thread
+    std::vector<std::vector<Run>> runs (chunks, std::vector<Run> (m_paths.size()));
+
+    amqp::util::parallel (blobs_, m_threads, [&](size_t chunk_, size_t begin_, size_t end_) {
+        for (auto j = begin_ ; j < end_ ; ++j) {
+            auto values = source_ (j);
+
+            for (size_t k { 0 } ; k < m_paths.size() ; ++k) {
+                if (values[k]) {
+                    runs[chunk_][k].emplace_back (std::move (*values[k]), j);
+                }
+            }
+        }
+
+        // ordinals went in ascending so a stable sort keeps them that way
+        for (auto & run : runs[chunk_]) {
+            std::stable_sort (run.begin(), run.end(),
+                [](const auto & a_, const auto & b_) { return a_.first < b_.first; });
+        }
+    });
+
+    std::ofstream out (out_, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error ("Can't create index " + out_);
+    }
+
+    std::string header (MAGIC, 8);
+    header.append (HEADER_SIZE - 8, '\0');
+    out.write (header.data(), header.size());
+
+    uint64_t offset { HEADER_SIZE };
+
+    std::string paths;
+
+    for (size_t k { 0 } ; k < m_paths.size() ; ++k) {
+        /*
+         * Each thread's run covers ordinals after the last's, merging
+         * them in order with a stable merge keeps a value's ordinals
+         * ascending
+         */
+        Run merged;
+        for (size_t i { 0 } ; i < chunks ; ++i) {
+            auto middle = merged.size();
+
+            merged.insert (
+                merged.end(),
+                std::make_move_iterator (runs[i][k].begin()),
+                std::make_move_iterator (runs[i][k].end()));
+
+            std::inplace_merge (merged.begin(), merged.begin() + middle, merged.end(),
+                [](const auto & a_, const auto & b_) { return a_.first < b_.first; });
+
+            Run().swap (runs[i][k]);
+        }
+
+        auto s = section (merged, offset);
+        auto keys = (s.first.size() - s.second) / sizeof (ValueIndex::Key);
+
+        scalar<uint64_t> (paths, offset + s.second);
+        scalar<uint64_t> (paths, keys);
+        scalar<uint32_t> (paths, static_cast<uint32_t>(m_paths[k].size()));
+        scalar<uint32_t> (paths, 0);
+        paths += m_paths[k];
+        pad (paths);
+
+        out.write (s.first.data(), s.first.size());
+        offset += s.first.size();
+    }
+
+    scalar<uint64_t> (paths, offset);
+    scalar<uint64_t> (paths, m_paths.size());
+    paths.append (MAGIC, 8);
+
+    out.write (paths.data(), paths.size());
+
+    if (!out) {
+        throw std::runtime_error ("Failed to write index " + out_);
+    }
+}
+
+/******************************************************************************/
+
+void
+ValueIndexBuilder::build (const BlobPack & pack_, const std::string & out_) const {
+    build (
+        pack_.size(),
+        [&pack_, this](size_t i_) {
+            auto cb = pack_.bytes (i_);
+
+            BlobInspector blobInspector (*cb);
+            blobInspector.adopt (pack_.envelope (i_));
+
+            return blobInspector.values (m_paths);
+        },
+        out_);
+}
+
+/******************************************************************************/
@@ -0,0 +1,127 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+
+/******************************************************************************/
+
+class BlobPack;
+
+/******************************************************************************/
+
+/**
+ * A side file of blobs keyed by the values of some of their fields, so
+ * finding every blob with a given value at a path takes a couple of
+ * binary searches rather than decoding everything.
+ *
+ * Blobs are known by their ordinal, their position in whatever set of
+ * them was indexed, for a pack its index in the pack. For each path the
+ * distinct values are kept sorted along with the ordinals of the blobs
+ * having them, in order and delta encoded as unsigned LEB128.
+ *
+ *   header   : "CRDVIDX1" | reserved (8)
+ *   per path : values, each its bytes
+ *              postings, each the deltas between ordinals, padded to 8
+ *              keys, per value, value offset (8) | postings offset (8)
+ *                | value length (4) | postings (4)
+ *   paths    : per path, keys offset (8) | keys (8) | path length (4)
+ *                | reserved (4) | path, padded to 8
+ *   footer   : paths offset (8) | paths (8) | "CRDVIDX1"
+ *
+ * The index is mapped and searched in place, nothing is read up front
+ * but the list of paths.
+ */
+class ValueIndex {
+    public :
+        struct Key {
+            uint64_t value;
+            uint64_t postings;
+            uint32_t length;
+            uint32_t count;
+        };
+
+    private :
+        struct Path {
+            std::string  path;
+            const Key *  keys;
+            size_t       size;
+        };
+
+        int          m_fd;
+        const char * m_map;
+        size_t       m_mapped;
+
+        std::vector<Path> m_paths;
+
+        void index (const std::string &);
+
+        const Path & path (const std::string &) const;
+
+    public :
+        explicit ValueIndex (const std::string &);
+        ~ValueIndex();
+
+        ValueIndex (const ValueIndex &) = delete;
+
+        std::vector<std::string> paths() const;
+
+        /**
+         * The ordinals, in order, of every blob whose value at [path_]
+         * is [value_]
+         *
+         * @throws std::runtime_error if [path_] wasn't indexed
+         */
+        std::vector<uint64_t> lookup (
+            const std::string & path_,
+            const std::string & value_) const;
+
+        /**
+         * How many distinct values [path_] has
+         */
+        size_t cardinality (const std::string & path_) const;
+};
+
+/******************************************************************************/
+
+/**
+ * Builds a [ValueIndex] over [paths_], splitting the blobs into a run
+ * per thread. Each thread sorts what it finds and the runs are merged
+ * once they're all done, ordinals staying in order since each run
+ * covers a contiguous range of them.
+ */
+class ValueIndexBuilder {
+    public :
+        using Values = std::vector<std::optional<std::string>>;
+
+        /**
+         * Given a blob's ordinal its values at each of the paths, called
+         * from several threads at once
+         */
+        using Source = std::function<Values (size_t)>;
+
+    private :
+        std::vector<std::string> m_paths;
+        size_t                   m_threads;
+
+    public :
+        ValueIndexBuilder (std::vector<std::string> paths_, size_t threads_ = 1);
+
+        const std::vector<std::string> & paths() const { return m_paths; }
+
+        /**
+         * Index [blobs_] blobs into the file [out_]
+         */
+        void build (size_t blobs_, const Source &, const std::string & out_) const;
+
+        /**
+         * Index every blob in [pack_]
+         */
+        void build (const BlobPack & pack_, const std::string & out_) const;
+};
+
+/******************************************************************************/
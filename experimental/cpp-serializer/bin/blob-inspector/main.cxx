@@ -2,50 +2,594 @@
 #include <iomanip>
 #include <fstream>
 #include <cstddef>
+#include <future>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
 
 #include <assert.h>
 #include <string.h>
+#include <getopt.h>
 #include <proton/types.h>
 #include <proton/codec.h>
 #include <sys/stat.h>
 
 #include "debug.h"
+#include "trace.h"
 
 #include "proton/proton_wrapper.h"
 
 #include "amqp/AMQPHeader.h"
 #include "amqp/AMQPSectionId.h"
+#include "amqp/trace/Tracer.h"
+#include "amqp/stats/Stats.h"
 #include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
 
 #include "amqp/schema/described-types/Envelope.h"
 #include "amqp/CompositeFactory.h"
 #include "CordaBytes.h"
 #include "BlobInspector.h"
+#include "Exporters.h"
+#include "SchemaStore.h"
+#include "BlobPack.h"
+#include "ValueIndex.h"
+#include "Aggregation.h"
+#include "Profile.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    usage (const char * name_) {
+        std::cerr
+            << "usage: " << name_ << " [options] <blob|pack> [<blob|pack> ...]" << std::endl
+            << std::endl
+            << "  --ndjson        write newline delimited JSON, one line per blob" << std::endl
+            << "  --avro <dir>    write an Avro container file per distinct schema into <dir>" << std::endl
+            << "  --deflate       deflate Avro blocks" << std::endl
+            << "  --arrow <dir>   write an Arrow IPC stream file per distinct schema into <dir>" << std::endl
+            << "  --store <file>  keep the schemas seen in <file> and reuse them in later runs" << std::endl
+            << "  --threads <n>   decode the elements of large lists across <n> threads" << std::endl
+            << "  --sha256        write the SHA-256 of each blob alongside it" << std::endl
+            << "  --dedup         write a reference to the first of any identical blobs rather than decoding them again" << std::endl
+            << "  --index <file>  the value index to build with --key or search with --where" << std::endl
+            << "  --key <path>    index the blobs on the value at <path> rather than writing them, may be repeated" << std::endl
+            << "  --where <path>=<value>" << std::endl
+            << "                  only the blobs whose value at <path> is <value>, found through the index" << std::endl
+            << "  --group-by <path>" << std::endl
+            << "                  aggregate over the blobs grouped on the value at <path>, may be repeated" << std::endl
+            << "  --count         aggregate the number of blobs" << std::endl
+            << "  --sum <path>    aggregate the sum of the values at <path>, similarly" << std::endl
+            << "  --min <path>    and --max <path> their least and greatest" << std::endl
+            << "  --profile       write statistics on every field of every type rather than the blobs" << std::endl
+            << "  --trace <file>  write a Chrome trace of where the time went to <file>, when built" << std::endl
+            << "                  with -DAMQP_TRACE=ON" << std::endl
+            << "  --stats         write to stderr how often each reader of each type ran, what it" << std::endl
+            << "                  read and how long it took" << std::endl;
+    }
+
+    /**
+     * Turns tracing on and writes out what was recorded once main is
+     * done with, whichever way it returns
+     */
+    class TraceFile {
+        private :
+            std::string m_path;
+
+        public :
+            explicit TraceFile (std::string path_) : m_path (std::move (path_)) {
+                if (!m_path.empty()) {
+                    amqp::trace::Tracer::enable();
+                }
+            }
+
+            ~TraceFile() {
+                if (m_path.empty()) {
+                    return;
+                }
+
+                amqp::trace::Tracer::enable (false);
+
+                std::ofstream out (m_path);
+                amqp::trace::Tracer::write (out);
+
+                if (!out) {
+                    std::cerr << m_path << ": failed to write trace" << std::endl;
+                }
+            }
+
+            TraceFile (const TraceFile &) = delete;
+    };
+
+    /**
+     * Counts what every reader does while main runs and writes the
+     * totals out once it's done with, whichever way it returns
+     */
+    class StatsReport {
+        private :
+            bool m_on;
+
+        public :
+            explicit StatsReport (bool on_) : m_on (on_) {
+                if (m_on) {
+                    amqp::stats::Stats::enable();
+                }
+            }
+
+            ~StatsReport() {
+                if (m_on) {
+                    amqp::stats::Stats::enable (false);
+                    amqp::stats::Stats::write (std::cerr);
+                }
+            }
+
+            StatsReport (const StatsReport &) = delete;
+    };
+
+    /**
+     * Something named on the command line, either a blob file or one of
+     * the blobs in a pack
+     */
+    struct Input {
+        std::string      path;
+        const BlobPack * pack;
+        size_t           index;
+    };
+
+    /**
+     * A blob read, and being hashed, ahead of its turn to be decoded.
+     * Those from a pack come with their hash already worked out and
+     * the Envelope they share with the pack's other blobs of their type
+     */
+    struct Blob {
+        std::string              path;
+        std::string              error;
+        uPtr<CordaBytes>         bytes;
+        std::future<std::string> sha256;
+
+        std::shared_ptr<const amqp::internal::schema::Envelope> envelope;
+    };
+
+    Blob
+    read (const Input & input_, bool hash_) {
+        Blob blob { input_.path, "", nullptr, { }, nullptr };
+
+        if (input_.pack) {
+            try {
+                blob.bytes = input_.pack->bytes (input_.index);
+                blob.envelope = input_.pack->envelope (input_.index);
+            } catch (const std::runtime_error & e) {
+                blob.error = e.what();
+                return blob;
+            }
+
+            if (hash_) {
+                auto pack = input_.pack;
+                auto index = input_.index;
+                blob.sha256 = std::async (std::launch::deferred, [pack, index] {
+                    return pack->sha256 (index);
+                });
+            }
+
+            return blob;
+        }
+
+        struct stat results { };
+
+        if (stat (input_.path.c_str(), &results) != 0) {
+            blob.error = "no such file";
+            return blob;
+        }
+
+        try {
+            blob.bytes = std::make_unique<CordaBytes> (input_.path);
+        } catch (const std::runtime_error & e) {
+            blob.error = e.what();
+            return blob;
+        }
+
+        if (hash_) {
+            auto bytes = blob.bytes.get();
+            blob.sha256 = std::async (std::launch::async, [bytes] {
+                return bytes->sha256();
+            });
+        }
+
+        return blob;
+    }
+
+
+    /**
+     * Read [input_] and hand an inspector over it to [f_], for the
+     * workers that take blobs out of order rather than one ahead
+     */
+    template<typename T>
+    T
+    inspect (const Input & input_, const std::function<T (BlobInspector &)> & f_) {
+        auto blob = read (input_, false);
+
+        if (!blob.bytes) {
+            throw std::runtime_error (blob.path + ": " + blob.error);
+        }
+
+        BlobInspector blobInspector (*blob.bytes);
+        if (blob.envelope) {
+            blobInspector.adopt (blob.envelope);
+        }
+
+        return f_ (blobInspector);
+    }
+
+}
 
 /******************************************************************************/
 
 int
 main (int argc, char **argv) {
-    struct stat results { };
+    static const option options[] = {
+        { "ndjson",  no_argument,       nullptr, 'n' },
+        { "avro",    required_argument, nullptr, 'a' },
+        { "deflate", no_argument,       nullptr, 'd' },
+        { "arrow",   required_argument, nullptr, 'r' },
+        { "store",   required_argument, nullptr, 's' },
+        { "threads", required_argument, nullptr, 't' },
+        { "sha256",  no_argument,       nullptr, 'x' },
+        { "dedup",   no_argument,       nullptr, 'u' },
+        { "index",   required_argument, nullptr, 'i' },
+        { "key",     required_argument, nullptr, 'k' },
+        { "where",   required_argument, nullptr, 'w' },
+        { "group-by", required_argument, nullptr, 'g' },
+        { "count",   no_argument,       nullptr, 'c' },
+        { "sum",     required_argument, nullptr, 'S' },
+        { "min",     required_argument, nullptr, 'm' },
+        { "max",     required_argument, nullptr, 'M' },
+        { "profile", no_argument,       nullptr, 'p' },
+        { "trace",   required_argument, nullptr, 'T' },
+        { "stats",   no_argument,       nullptr, 'P' },
+        { "help",    no_argument,       nullptr, 'h' },
+        { nullptr,   0,                 nullptr, 0 }
+    };
 
-    if (stat(argv[1], &results) != 0) {
-        return EXIT_FAILURE;
+    bool ndjson { false };
+    bool deflate { false };
+    std::string avro;
+    std::string arrow;
+    std::string store;
+    size_t threads { 1 };
+    bool sha256 { false };
+    bool dedup { false };
+    std::string index;
+    std::vector<std::string> keys;
+    std::string where;
+    std::vector<std::string> groupBy;
+    std::vector<Aggregation::Measure> measures;
+    bool profile { false };
+    std::string trace;
+    bool stats { false };
+
+    int opt;
+    while ((opt = getopt_long (argc, argv, "na:dr:s:t:xui:k:w:g:cS:m:M:pT:Ph", options, nullptr)) != -1) {
+        switch (opt) {
+            case 'n' : ndjson = true; break;
+            case 'a' : avro = optarg; break;
+            case 'd' : deflate = true; break;
+            case 'r' : arrow = optarg; break;
+            case 's' : store = optarg; break;
+            case 't' : threads = std::max (1, atoi (optarg)); break;
+            case 'x' : sha256 = true; break;
+            case 'u' : dedup = true; break;
+            case 'i' : index = optarg; break;
+            case 'k' : keys.push_back (optarg); break;
+            case 'w' : where = optarg; break;
+            case 'g' : groupBy.push_back (optarg); break;
+            case 'c' : measures.push_back ({ Aggregation::count_t, "" }); break;
+            case 'S' : measures.push_back ({ Aggregation::sum_t, optarg }); break;
+            case 'm' : measures.push_back ({ Aggregation::min_t, optarg }); break;
+            case 'M' : measures.push_back ({ Aggregation::max_t, optarg }); break;
+            case 'p' : profile = true; break;
+            case 'T' : trace = optarg; break;
+            case 'P' : stats = true; break;
+            default  : usage (argv[0]); return EXIT_FAILURE;
+        }
     }
 
-    CordaBytes cb (argv[1]);
-    
-    if (cb.encoding() == amqp::DATA_AND_STOP) {
-        BlobInspector blobInspector (cb);
-        auto val = blobInspector.dump();
-        std::cout << val << std::endl;
-    } else {
-        std::cerr << "BAD ENCODING " << cb.encoding() << " != "
-            << amqp::DATA_AND_STOP << std::endl;
+    if (optind == argc || (index.empty() && (!keys.empty() || !where.empty()))) {
+        usage (argv[0]);
+        return EXIT_FAILURE;
+    }
 
+    if (!trace.empty() && AMQP_TRACE < 1) {
+        std::cerr << "--trace needs a build configured with -DAMQP_TRACE=ON" << std::endl;
         return EXIT_FAILURE;
     }
 
-    return EXIT_SUCCESS;
+    TraceFile traceFile (trace);
+    StatsReport statsReport (stats);
+
+    uPtr<SchemaStore> schemaStore;
+    if (!store.empty()) {
+        schemaStore = std::make_unique<SchemaStore> (store);
+    }
+
+    int rtn { EXIT_SUCCESS };
+
+    /*
+     * Every distinct blob by its hash, along with which of the blobs
+     * written it was and where it came from
+     */
+    std::unordered_map<std::string, std::pair<size_t, std::string>> seen;
+    size_t written { 0 };
+
+    /*
+     * Packs are opened up front and every blob in them queued in their
+     * place amongst the plain files
+     */
+    std::vector<uPtr<BlobPack>> packs;
+    std::vector<Input> inputs;
+
+    for (int i { optind } ; i < argc ; ++i) {
+        if (!BlobPack::isPack (argv[i])) {
+            inputs.push_back ({ argv[i], nullptr, 0 });
+            continue;
+        }
+
+        try {
+            packs.push_back (std::make_unique<BlobPack> (argv[i]));
+        } catch (const std::runtime_error & e) {
+            std::cerr << argv[i] << ": " << e.what() << std::endl;
+            rtn = EXIT_FAILURE;
+            continue;
+        }
+
+        for (size_t j { 0 } ; j < packs.back()->size() ; ++j) {
+            inputs.push_back ({
+                std::string (argv[i]) + "[" + std::to_string (j) + "]",
+                packs.back().get(),
+                j });
+        }
+    }
+
+    if (!keys.empty()) {
+        try {
+            ValueIndexBuilder builder (keys, threads);
+
+            builder.build (
+                inputs.size(),
+                [&inputs, &keys](size_t i_) {
+                    return inspect<ValueIndexBuilder::Values> (
+                        inputs[i_],
+                        [&keys](BlobInspector & bi_) { return bi_.values (keys); });
+                },
+                index);
+
+            ValueIndex built (index);
+            std::cout << index << ": " << inputs.size() << " blobs" << std::endl;
+
+            for (const auto & key : keys) {
+                std::cout << "  " << key << " : " << built.cardinality (key)
+                    << " values" << std::endl;
+            }
+        } catch (const std::runtime_error & e) {
+            std::cerr << index << ": " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        return rtn;
+    }
+
+    /*
+     * Only the blobs the index says match are kept, in their original
+     * order, nothing else is read at all
+     */
+    if (!where.empty()) {
+        auto eq = where.find ('=');
+        if (eq == std::string::npos) {
+            usage (argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        std::vector<uint64_t> matches;
+
+        try {
+            matches = ValueIndex (index).lookup (where.substr (0, eq), where.substr (eq + 1));
+        } catch (const std::runtime_error & e) {
+            std::cerr << index << ": " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::vector<Input> matched;
+        for (auto match : matches) {
+            if (match >= inputs.size()) {
+                std::cerr << index << ": doesn't match the blobs given" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            matched.push_back (inputs[match]);
+        }
+
+        inputs.swap (matched);
+    }
+
+    if (profile) {
+        try {
+            Profile p;
+
+            p.run (
+                inputs.size(),
+                [&inputs](size_t i_, amqp::reader::IVisitor & visitor_) {
+                    inspect<void> (inputs[i_], [&visitor_](BlobInspector & bi_) {
+                        bi_.visit (visitor_);
+                    });
+                },
+                threads);
+
+            if (ndjson) {
+                p.ndjson (std::cout);
+            } else {
+                p.text (std::cout);
+            }
+        } catch (const std::runtime_error & e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        return rtn;
+    }
+
+    /*
+     * Aggregates are worked out across the blobs, after any --where, in
+     * place of writing them out
+     */
+    if (!measures.empty() || !groupBy.empty()) {
+        if (measures.empty()) {
+            measures.push_back ({ Aggregation::count_t, "" });
+        }
+
+        try {
+            Aggregation aggregation (groupBy, measures);
+
+            auto rows = aggregation.run (
+                inputs.size(),
+                [&inputs, &aggregation](size_t i_) {
+                    return inspect<std::vector<std::any>> (
+                        inputs[i_],
+                        [&aggregation](BlobInspector & bi_) {
+                            return bi_.read (aggregation.paths());
+                        });
+                },
+                threads);
+
+            if (ndjson) {
+                aggregation.ndjson (std::cout, rows);
+            } else {
+                aggregation.tsv (std::cout, rows);
+            }
+        } catch (const std::runtime_error & e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        return rtn;
+    }
+
+    uPtr<Exporter> exporter;
+    if (!arrow.empty()) {
+        exporter = std::make_unique<ArrowExporter> (arrow);
+    } else if (!avro.empty()) {
+        exporter = std::make_unique<AvroExporter> (avro, deflate);
+    } else if (ndjson) {
+        exporter = std::make_unique<NdJsonExporter> (std::cout);
+    }
+
+    /*
+     * Blobs are read and hashed one ahead of the one being decoded so
+     * hashing happens alongside decoding rather than before it
+     */
+    bool hash = sha256 || dedup;
+    Blob next;
+
+    if (!inputs.empty()) {
+        next = read (inputs.front(), hash);
+    }
+
+    for (size_t i { 0 } ; i < inputs.size() ; ++i) {
+        auto blob = std::move (next);
+
+        if (i + 1 < inputs.size()) {
+            next = read (inputs[i + 1], hash);
+        }
+
+        if (!blob.bytes) {
+            std::cerr << blob.path << ": " << blob.error << std::endl;
+            rtn = EXIT_FAILURE;
+            continue;
+        }
+
+        const auto & cb = *blob.bytes;
+
+        if (cb.encoding() != amqp::DATA_AND_STOP) {
+            std::cerr << blob.path << ": BAD ENCODING " << cb.encoding() << " != "
+                << amqp::DATA_AND_STOP << std::endl;
+
+            rtn = EXIT_FAILURE;
+            continue;
+        }
+
+        std::string digest;
+        if (hash) {
+            digest = blob.sha256.get();
+        }
+
+        if (dedup) {
+            auto original = seen.find (digest);
+
+            if (original != seen.end()) {
+                if (exporter) {
+                    exporter->duplicate (original->second.first, digest);
+                } else {
+                    if (sha256) {
+                        std::cout << digest << "  " << blob.path << std::endl;
+                    }
+                    std::cout << "{ Duplicate : " << original->second.second << " }" << std::endl;
+                }
+
+                continue;
+            }
+        }
+
+        BlobInspector blobInspector (cb, schemaStore.get());
+
+        if (blob.envelope) {
+            blobInspector.adopt (blob.envelope);
+        }
+
+        if (exporter) {
+            try {
+                exporter->add (blobInspector, sha256 ? digest : "");
+            } catch (const std::exception & e) {
+                std::cerr << blob.path << ": " << e.what() << std::endl;
+                rtn = EXIT_FAILURE;
+                continue;
+            }
+        } else {
+            std::string val;
+
+            /*
+             * One bad blob is reported and passed over like any other
+             * that can't be read, the rest of the batch is still wanted
+             */
+            try {
+                val = threads > 1
+                    ? blobInspector.dump (threads)
+                    : blobInspector.dump();
+            } catch (const std::exception & e) {
+                std::cerr << blob.path << ": " << e.what() << std::endl;
+                rtn = EXIT_FAILURE;
+                continue;
+            }
+
+            TRACE ("output");
+
+            if (sha256) {
+                std::cout << digest << "  " << blob.path << std::endl;
+            }
+            std::cout << val << std::endl;
+        }
+
+        if (dedup) {
+            seen.emplace (digest, std::make_pair (written, blob.path));
+        }
+
+        ++written;
+    }
+
+    if (exporter) {
+        TRACE ("output");
+        exporter->close();
+    }
+
+    return rtn;
 }
 
 /******************************************************************************/
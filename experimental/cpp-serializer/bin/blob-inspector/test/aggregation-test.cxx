@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "CordaBytes.h"
+#include "Aggregation.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    /**
+     * [blobs_] over and over, [n_] blobs in all
+     */
+    Aggregation::Source
+    source (
+        const std::vector<std::unique_ptr<CordaBytes>> & blobs_,
+        const Aggregation & aggregation_
+    ) {
+        return [&blobs_, &aggregation_](size_t i_) {
+            BlobInspector bi (*blobs_[i_ % blobs_.size()]);
+            return bi.read (aggregation_.paths());
+        };
+    }
+
+    std::vector<std::unique_ptr<CordaBytes>>
+    load (const std::vector<std::string> & names_) {
+        std::vector<std::unique_ptr<CordaBytes>> rtn;
+        for (const auto & name : names_) {
+            rtn.push_back (std::make_unique<CordaBytes> (filepath + name));
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Aggregation, read) { // NOLINT
+    CordaBytes cb (filepath + "_i_is__");
+    BlobInspector bi (cb);
+
+    auto values = bi.read ({ "a", "b.b", "b.c" });
+
+    ASSERT_EQ (1, std::any_cast<int> (values[0]));
+    ASSERT_EQ ("three", std::any_cast<std::string> (values[1]));
+    ASSERT_FALSE (values[2].has_value());
+}
+
+/******************************************************************************/
+
+/**
+ * "a" is 69, 1 and 1 across the three, "x" only in _l_
+ */
+TEST (Aggregation, ungrouped) { // NOLINT
+    auto blobs = load ({ "_i_", "_Oi_", "_i_is__", "_l_" });
+
+    Aggregation aggregation ({ }, {
+        { Aggregation::count_t, "" },
+        { Aggregation::sum_t, "a" },
+        { Aggregation::min_t, "a" },
+        { Aggregation::max_t, "a" },
+        { Aggregation::sum_t, "x" } });
+
+    auto rows = aggregation.run (400, source (blobs, aggregation), 3);
+
+    ASSERT_EQ (1, rows.size());
+
+    const auto & cells = rows[0].cells;
+    ASSERT_EQ (400, cells[0].count);
+    ASSERT_EQ (100 * 71, cells[1].number.integer);
+    ASSERT_EQ (300, cells[1].count);
+    ASSERT_EQ (1, cells[2].number.integer);
+    ASSERT_EQ (69, cells[3].number.integer);
+    ASSERT_EQ (100 * 100000000000L, cells[4].number.integer);
+}
+
+/******************************************************************************/
+
+TEST (Aggregation, grouped) { // NOLINT
+    auto blobs = load ({ "_i_", "_Oi_", "_i_is__", "_l_" });
+
+    Aggregation aggregation ({ "a" }, {
+        { Aggregation::count_t, "" },
+        { Aggregation::sum_t, "b.a" } });
+
+    auto one = aggregation.run (10, source (blobs, aggregation), 1);
+    auto many = aggregation.run (10, source (blobs, aggregation), 4);
+
+    std::stringstream a, b;
+    aggregation.tsv (a, one);
+    aggregation.tsv (b, many);
+
+    ASSERT_EQ (a.str(), b.str());
+    ASSERT_EQ (
+        "a\tcount\tsum(b.a)\n"
+        "\t2\t\n"
+        "1\t5\t4\n"
+        "69\t3\t\n",
+        a.str());
+
+    std::stringstream ss;
+    aggregation.ndjson (ss, many);
+
+    ASSERT_EQ (
+        R"json({"a":null,"count":2,"sum(b.a)":null})json" "\n"
+        R"json({"a":"1","count":5,"sum(b.a)":4})json" "\n"
+        R"json({"a":"69","count":3,"sum(b.a)":null})json" "\n",
+        ss.str());
+}
+
+/******************************************************************************/
+
+TEST (Aggregation, notANumber) { // NOLINT
+    auto blobs = load ({ "_i_is__" });
+
+    Aggregation aggregation ({ }, { { Aggregation::sum_t, "b.b" } });
+
+    ASSERT_THROW (aggregation.run (1, source (blobs, aggregation)), std::runtime_error);
+}
+
+/******************************************************************************/
+
+/**
+ * A sum of integers too big for 64 bits carries on as a real number
+ * rather than wrapping
+ */
+TEST (Aggregation, overflow) { // NOLINT
+    Aggregation::Number a, b;
+    a.integer = INT64_MAX - 1;
+    b.integer = 1;
+
+    a += b;
+    ASSERT_FALSE (a.real);
+    ASSERT_EQ (INT64_MAX, a.integer);
+
+    a += b;
+    ASSERT_TRUE (a.real);
+    ASSERT_DOUBLE_EQ (static_cast<double>(INT64_MAX) + 1, a.value);
+    ASSERT_LT (0, a.asReal());
+
+    Aggregation::Number c, d;
+    c.integer = INT64_MIN;
+    d.integer = -1;
+
+    c += d;
+    ASSERT_TRUE (c.real);
+    ASSERT_GT (0, c.asReal());
+}
+
+/******************************************************************************/
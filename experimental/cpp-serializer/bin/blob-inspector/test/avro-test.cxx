@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+
+#include <proton/codec.h>
+
+#include "CordaBytes.h"
+#include "AvroSchema.h"
+#include "Exporters.h"
+#include "BlobInspector.h"
+
+#include "amqp/schema/described-types/Envelope.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    std::string
+    avroJson (const std::string & file_) {
+        CordaBytes cb (filepath + file_);
+        BlobInspector bi (cb);
+
+        return AvroSchema (bi.schema(), bi.envelope().descriptor()).json();
+    }
+
+    std::string
+    avroBinary (const std::string & file_) {
+        CordaBytes cb (filepath + file_);
+        BlobInspector bi (cb);
+
+        AvroSchema schema (bi.schema(), bi.envelope().descriptor());
+
+        std::string rtn;
+        bi.withPayload ([&schema, &rtn](
+            pn_data_t * data_,
+            const amqp::internal::schema::Envelope &
+        ) {
+            schema.encode (data_, rtn);
+        });
+
+        return rtn;
+    }
+
+    std::string
+    ndjson (const std::vector<std::string> & files_) {
+        std::stringstream ss;
+        NdJsonExporter exporter (ss);
+
+        for (const auto & file : files_) {
+            CordaBytes cb (filepath + file);
+            BlobInspector bi (cb);
+            exporter.add (bi);
+        }
+        exporter.close();
+
+        return ss.str();
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Avro, sanitise) { // NOLINT
+    ASSERT_EQ ("net.corda.Outer_Inner", AvroSchema::sanitise ("net.corda.Outer$Inner"));
+    ASSERT_EQ ("java.util.Map_int__string_", AvroSchema::sanitise ("java.util.Map<int, string>"));
+    ASSERT_EQ ("a._1b", AvroSchema::sanitise ("a.1b"));
+}
+
+/******************************************************************************/
+
+/**
+ * Constants are found by their name made a symbol, the same as the
+ * schema's choices were
+ */
+TEST (Avro, readSymbol) { // NOLINT
+    AvroSchema::Node node { AvroSchema::enum_t, "E", { }, { }, 0 };
+    node.symbols = { AvroSchema::symbol ("A"), AvroSchema::symbol ("1st.B$C") };
+
+    ASSERT_EQ ("_1st_B_C", node.symbols[1]);
+
+    auto symbol = [&node](const std::string & bytes_) {
+        auto data = pn_data (0);
+        pn_data_decode (data, bytes_.data(), bytes_.size());
+        pn_data_rewind (data);
+        pn_data_next (data);
+
+        try {
+            auto rtn = AvroSchema::readSymbol (data, node);
+            pn_data_free (data);
+            return rtn;
+        } catch (...) {
+            pn_data_free (data);
+            throw;
+        }
+    };
+
+    ASSERT_EQ (1, symbol ("\xa3\x07" "1st.B$C"));
+    ASSERT_EQ (0, symbol ("\xa3\x01" "A"));
+    ASSERT_THROW (symbol ("\xa3\x01" "D"), std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (Avro, zigzag) { // NOLINT
+    std::string out;
+    AvroSchema::writeLong (0, out);
+    AvroSchema::writeLong (-1, out);
+    AvroSchema::writeLong (1, out);
+    AvroSchema::writeLong (-64, out);
+    AvroSchema::writeLong (64, out);
+
+    ASSERT_EQ (std::string ("\x00\x01\x02\x7f\x80\x01", 6), out);
+}
+
+/******************************************************************************/
+
+TEST (Avro, _i_schema) { // NOLINT
+    ASSERT_EQ (
+        R"({"type":"record","name":"net.corda.blobwriter._i_","fields":[{"name":"a","type":"int"}]})",
+        avroJson ("_i_"));
+}
+
+/******************************************************************************/
+
+TEST (Avro, _i_binary) { // NOLINT
+    // 69 zig-zags to 138
+    ASSERT_EQ (std::string ("\x8a\x01", 2), avroBinary ("_i_"));
+}
+
+/******************************************************************************/
+
+TEST (Avro, _Mis_schema) { // NOLINT
+    ASSERT_EQ (
+        R"({"type":"record","name":"net.corda.blobwriter._Mis_","fields":[{"name":"a","type":{"type":"array","items":{"type":"record","name":"java.util.Map_int__string_","fields":[{"name":"key","type":"int"},{"name":"value","type":"string"}]}}}]})",
+        avroJson ("_Mis_"));
+}
+
+/******************************************************************************/
+
+TEST (Avro, _Le_schema) { // NOLINT
+    auto json = avroJson ("_Le_");
+
+    ASSERT_NE (std::string::npos, json.find (R"("type":"enum")"));
+    ASSERT_NE (std::string::npos, json.find (R"("symbols":["A","B","C"])"));
+}
+
+/******************************************************************************/
+
+TEST (NdJson, schemaOncePerType) { // NOLINT
+    auto out = ndjson ({ "_i_", "_l_", "_i_" });
+
+    ASSERT_EQ (
+        R"({"schema":0,"avro":{"type":"record","name":"net.corda.blobwriter._i_","fields":[{"name":"a","type":"int"}]}})" "\n"
+        R"({"schema":0,"value":[69]})" "\n"
+        R"({"schema":1,"avro":{"type":"record","name":"net.corda.blobwriter._l_","fields":[{"name":"x","type":"long"}]}})" "\n"
+        R"({"schema":1,"value":[100000000000]})" "\n"
+        R"({"schema":0,"value":[69]})" "\n",
+        out);
+}
+
+/******************************************************************************/
+
+TEST (NdJson, _Mi_is__) { // NOLINT
+    auto out = ndjson ({ "_Mi_is__" });
+
+    ASSERT_NE (
+        std::string::npos,
+        out.find (R"({"schema":0,"value":[[[1,[2,"three"]],[4,[5,"six"]],[7,[8,"nine"]]]]})"));
+}
+
+/******************************************************************************/
+
+/**
+ * Blobs of the same type whose schema sections differ each get their
+ * own schema rather than being encoded with the first one's
+ */
+TEST (NdJson, schemaPerSection) { // NOLINT
+    std::ifstream in (filepath + "_i_", std::ios::binary);
+    std::stringstream bytes;
+    bytes << in.rdbuf();
+
+    // _i_ with its field renamed from a to b
+    auto renamed = bytes.str();
+    ASSERT_EQ ('a', renamed[0xbc]);
+    renamed[0xbc] = 'b';
+
+    std::stringstream ss;
+    NdJsonExporter exporter (ss);
+
+    CordaBytes a (filepath + "_i_");
+    CordaBytes b (renamed.data(), renamed.size());
+
+    for (auto cb : { &a, &b, &a }) {
+        BlobInspector bi (*cb);
+        exporter.add (bi);
+    }
+    exporter.close();
+
+    ASSERT_EQ (
+        R"({"schema":0,"avro":{"type":"record","name":"net.corda.blobwriter._i_","fields":[{"name":"a","type":"int"}]}})" "\n"
+        R"({"schema":0,"value":[69]})" "\n"
+        R"({"schema":1,"avro":{"type":"record","name":"net.corda.blobwriter._i_","fields":[{"name":"b","type":"int"}]}})" "\n"
+        R"({"schema":1,"value":[69]})" "\n"
+        R"({"schema":0,"value":[69]})" "\n",
+        ss.str());
+}
+
+/******************************************************************************/
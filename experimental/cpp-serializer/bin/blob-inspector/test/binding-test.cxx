@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/codegen/Binding.h"
+
+/******************************************************************************/
+
+namespace binding {
+
+    struct Is {
+        int32_t a;
+        std::string b;
+    };
+
+    /**
+     * The serialised type's fields are a and b, only bind the one and
+     * under a type that isn't quite the same
+     */
+    struct IIs {
+        std::optional<Is> b;
+    };
+
+    struct LMis {
+        std::vector<std::map<int32_t, std::string>> x;
+        int32_t missing;
+    };
+
+    struct Collections {
+        std::vector<std::map<int32_t, std::string>> x;
+    };
+
+    struct ALd {
+        std::vector<std::vector<double>> a;
+    };
+
+    enum class E { A, B, C };
+
+    struct Enum {
+        E e;
+    };
+
+    struct WrongType {
+        std::string a;
+    };
+
+}
+
+AMQP_BIND (binding::Is, b, a)
+AMQP_BIND (binding::IIs, b)
+AMQP_BIND (binding::LMis, x, missing)
+AMQP_BIND (binding::Collections, x)
+AMQP_BIND (binding::ALd, a)
+AMQP_BIND (binding::Enum, e)
+AMQP_BIND (binding::WrongType, a)
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    template<typename T>
+    T
+    decode (amqp::codegen::Binder<T> & binder_, const std::string & file_) {
+        CordaBytes cb (filepath + file_);
+        BlobInspector bi (cb);
+
+        return binder_.decode (
+            cb.bytes(), cb.bytes() + cb.size(),
+            [&bi]() -> const amqp::internal::schema::Schema & { return bi.schema(); });
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Binding, nested) { // NOLINT
+    amqp::codegen::Binder<binding::IIs> binder;
+
+    auto val = decode (binder, "_i_is__");
+
+    ASSERT_TRUE (val.b);
+    ASSERT_EQ (2, val.b->a);
+    ASSERT_EQ ("three", val.b->b);
+}
+
+/******************************************************************************/
+
+TEST (Binding, collections) { // NOLINT
+    amqp::codegen::Binder<binding::Collections> maps;
+
+    auto val = decode (maps, "__i_LMis_l__");
+
+    ASSERT_EQ (2, val.x.size());
+    ASSERT_EQ ("six", val.x[0].at (5));
+    ASSERT_EQ ("eight", val.x[1].at (7));
+
+    amqp::codegen::Binder<binding::ALd> arrays;
+
+    auto ald = decode (arrays, "_ALd_");
+
+    ASSERT_EQ (3, ald.a.size());
+    ASSERT_EQ ((std::vector<double> { 13.4 }), ald.a[2]);
+}
+
+/******************************************************************************/
+
+TEST (Binding, enumeration) { // NOLINT
+    amqp::codegen::Binder<binding::Enum> binder;
+
+    ASSERT_EQ (binding::E::A, decode (binder, "_e_").e);
+}
+
+/******************************************************************************/
+
+TEST (Binding, planReused) { // NOLINT
+    amqp::codegen::Binder<binding::IIs> binder;
+
+    decode (binder, "_i_is__");
+
+    CordaBytes cb (filepath + "_i_is__");
+    bool asked { false };
+
+    auto val = binder.decode (
+        cb.bytes(), cb.bytes() + cb.size(),
+        [&asked]() -> const amqp::internal::schema::Schema & {
+            asked = true;
+            throw std::runtime_error ("schema wanted");
+        });
+
+    ASSERT_FALSE (asked);
+    ASSERT_EQ (2, val.b->a);
+    ASSERT_EQ (1, binder.size());
+}
+
+/******************************************************************************/
+
+TEST (Binding, mismatches) { // NOLINT
+    amqp::codegen::Binder<binding::LMis> missing;
+    EXPECT_THROW (decode (missing, "__i_LMis_l__"), std::runtime_error);
+
+    amqp::codegen::Binder<binding::WrongType> wrongType;
+    EXPECT_THROW (decode (wrongType, "_i_"), std::runtime_error);
+
+    amqp::codegen::Binder<binding::Is> wrongClass;
+    EXPECT_THROW (decode (wrongClass, "_Li_"), std::runtime_error);
+}
+
+/******************************************************************************/
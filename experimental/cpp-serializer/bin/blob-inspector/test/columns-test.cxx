@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "CordaBytes.h"
+#include "Columns.h"
+#include "ArrowStream.h"
+#include "BlobInspector.h"
+
+#include "amqp/schema/described-types/Envelope.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    /**
+     * Append a blob to the columns built for its schema, as the schema
+     * and columns need to outlive the blob we hand both back
+     */
+    struct Loaded {
+        uPtr<AvroSchema> schema;
+        uPtr<Columns>    columns;
+    };
+
+    Loaded
+    load (const std::string & file_, int times_ = 1) {
+        Loaded rtn;
+
+        for (int i { 0 } ; i < times_ ; ++i) {
+            CordaBytes cb (filepath + file_);
+            BlobInspector bi (cb);
+
+            if (!rtn.schema) {
+                rtn.schema = std::make_unique<AvroSchema> (
+                    bi.schema(), bi.envelope().descriptor());
+                rtn.columns = std::make_unique<Columns> (*rtn.schema);
+            }
+
+            bi.withPayload ([&rtn](
+                pn_data_t * data_,
+                const amqp::internal::schema::Envelope &
+            ) {
+                rtn.columns->append (data_);
+            });
+        }
+
+        return rtn;
+    }
+
+    template<typename T>
+    std::vector<T>
+    values (const Column & column_) {
+        std::vector<T> rtn (column_.data.size() / sizeof (T));
+        memcpy (rtn.data(), column_.data.data(), column_.data.size());
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Columns, _i_) { // NOLINT
+    auto loaded = load ("_i_", 3);
+    const auto & columns = loaded.columns->columns();
+
+    ASSERT_EQ (3, loaded.columns->rows());
+    ASSERT_EQ (1, columns.size());
+    ASSERT_EQ ("a", columns[0].name);
+    ASSERT_EQ (0, columns[0].nulls);
+    ASSERT_EQ (std::vector<int32_t> ({ 69, 69, 69 }), values<int32_t> (columns[0]));
+}
+
+/******************************************************************************/
+
+TEST (Columns, _Li_) { // NOLINT
+    auto loaded = load ("_Li_", 2);
+    const auto & a = loaded.columns->columns()[0];
+
+    ASSERT_EQ (AvroSchema::array_t, a.kind);
+    ASSERT_EQ (std::vector<int32_t> ({ 0, 6, 12 }), a.offsets);
+    ASSERT_EQ (12, a.children[0].length);
+    ASSERT_EQ (
+        std::vector<int32_t> ({ 1, 2, 3, 4, 5, 6, 1, 2, 3, 4, 5, 6 }),
+        values<int32_t> (a.children[0]));
+}
+
+/******************************************************************************/
+
+TEST (Columns, _Mis_) { // NOLINT
+    auto loaded = load ("_Mis_");
+    const auto & a = loaded.columns->columns()[0];
+
+    ASSERT_EQ (AvroSchema::pairs_t, a.kind);
+    ASSERT_EQ (std::vector<int32_t> ({ 0, 3 }), a.offsets);
+
+    const auto & entries = a.children[0];
+    ASSERT_EQ (3, entries.length);
+    ASSERT_EQ (std::vector<int32_t> ({ 1, 3, 5 }), values<int32_t> (entries.children[0]));
+    ASSERT_EQ ("twofoursix", entries.children[1].data);
+    ASSERT_EQ (std::vector<int32_t> ({ 0, 3, 7, 10 }), entries.children[1].offsets);
+}
+
+/******************************************************************************/
+
+TEST (Columns, _Le_) { // NOLINT
+    auto loaded = load ("_Le_");
+    const auto & items = loaded.columns->columns()[0].children[0];
+
+    ASSERT_EQ (AvroSchema::enum_t, items.kind);
+    ASSERT_EQ (std::vector<int32_t> ({ 0, 1, 2 }), values<int32_t> (items));
+}
+
+/******************************************************************************/
+
+TEST (Columns, clear) { // NOLINT
+    auto loaded = load ("_L_i__");
+    loaded.columns->clear();
+
+    const auto & listy = loaded.columns->columns()[0];
+
+    ASSERT_EQ (0, loaded.columns->rows());
+    ASSERT_EQ (std::vector<int32_t> ({ 0 }), listy.offsets);
+    ASSERT_EQ (0, listy.children[0].length);
+    ASSERT_EQ (0, listy.children[0].children[0].length);
+}
+
+/******************************************************************************/
+
+TEST (ArrowStream, framing) { // NOLINT
+    auto loaded = load ("_i_");
+    const std::string path ("arrow-stream-test.arrows");
+
+    {
+        ArrowStream stream (path, *loaded.columns);
+        stream.write (*loaded.columns);
+    }
+
+    std::ifstream in (path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    auto bytes = ss.str();
+
+    remove (path.c_str());
+
+    // a schema and a record batch, each with 8 byte aligned metadata
+    ASSERT_EQ (std::string ("\xff\xff\xff\xff", 4), bytes.substr (0, 4));
+    ASSERT_EQ (0, bytes.size() % 8);
+
+    // followed by the end of stream marker
+    ASSERT_EQ (std::string ("\xff\xff\xff\xff\0\0\0\0", 8), bytes.substr (bytes.size() - 8));
+}
+
+/******************************************************************************/
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "Cursor.h"
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/reader/IMapValue.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    std::string
+    all (Cursor & cursor_) {
+        std::string rtn;
+
+        while (cursor_.next()) {
+            if (cursor_.map()) {
+                rtn += cursor_.key()->dump() + " : ";
+            }
+            rtn += cursor_.value()->dump() + ", ";
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Cursor, list) { // NOLINT
+    CordaBytes cb (filepath + "_Li_");
+    BlobInspector bi (cb);
+
+    auto cursor = bi.elements ("a");
+
+    ASSERT_FALSE (cursor.map());
+    ASSERT_EQ (6, cursor.size());
+    ASSERT_EQ ("1, 2, 3, 4, 5, 6, ", all (cursor));
+    ASSERT_FALSE (cursor.next());
+}
+
+/******************************************************************************/
+
+TEST (Cursor, stopEarly) { // NOLINT
+    CordaBytes cb (filepath + "_L_i__");
+    BlobInspector bi (cb);
+
+    auto cursor = bi.elements ("listy");
+
+    ASSERT_TRUE (cursor.next());
+    ASSERT_TRUE (cursor.next());
+    ASSERT_EQ ("{ a : 2 }", cursor.value()->dump());
+}
+
+/******************************************************************************/
+
+TEST (Cursor, array) { // NOLINT
+    CordaBytes cb (filepath + "_ALd_");
+    BlobInspector bi (cb);
+
+    auto cursor = bi.elements ("a");
+
+    ASSERT_EQ ("[ 10.100000, 11.200000, 12.300000 ], [  ], [ 13.400000 ], ", all (cursor));
+}
+
+/******************************************************************************/
+
+TEST (Cursor, map) { // NOLINT
+    CordaBytes cb (filepath + "_Mi_is__");
+    BlobInspector bi (cb);
+
+    auto cursor = bi.elements ("a");
+
+    ASSERT_TRUE (cursor.map());
+    ASSERT_EQ (3, cursor.size());
+    ASSERT_EQ (
+        R"(1 : { a : 2, b : "three" }, 4 : { a : 5, b : "six" }, 7 : { a : 8, b : "nine" }, )",
+        all (cursor));
+}
+
+/******************************************************************************/
+
+TEST (Cursor, notCollections) { // NOLINT
+    CordaBytes cb (filepath + "__i_LMis_l__");
+    BlobInspector bi (cb);
+
+    EXPECT_THROW (bi.elements ("y"), std::runtime_error);
+    EXPECT_THROW (bi.elements ("y.x"), std::runtime_error);
+    EXPECT_THROW (bi.elements ("y.x.z"), std::runtime_error);
+    EXPECT_THROW (bi.elements ("nope"), std::runtime_error);
+
+    auto cursor = bi.elements ("x");
+    ASSERT_EQ (2, cursor.size());
+}
+
+/******************************************************************************/
+
+TEST (Cursor, mapLookup) { // NOLINT
+    CordaBytes cb (filepath + "__i_LMis_l__");
+    BlobInspector bi (cb);
+
+    auto cursor = bi.elements ("x");
+
+    ASSERT_TRUE (cursor.next());
+    auto first = cursor.value();
+    ASSERT_TRUE (cursor.next());
+    auto second = cursor.value();
+
+    auto map = dynamic_cast<const amqp::reader::IMapValue *>(first.get());
+    ASSERT_NE (nullptr, map);
+    ASSERT_EQ (3, map->entries());
+    ASSERT_EQ ("\"four\"", map->find (int32_t { 3 })->dump());
+    ASSERT_EQ (nullptr, map->find (int32_t { 7 }));
+    ASSERT_EQ (nullptr, map->find (int64_t { 3 }));
+
+    map = dynamic_cast<const amqp::reader::IMapValue *>(second.get());
+    ASSERT_EQ ("\"eight\"", map->find (int32_t { 7 })->dump());
+    ASSERT_EQ ("\"ten\"", map->find (int32_t { 9 })->dump());
+}
+
+/******************************************************************************/
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "BlobDiff.h"
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/reader/IVisitor.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    BlobTree
+    tree (const std::string & file_) {
+        CordaBytes cb (filepath + file_);
+        BlobInspector bi (cb);
+
+        return BlobTree (bi);
+    }
+
+    /**
+     * { a, b : { x }, l : [ ... ], m : { int -> string } } with the map's
+     * entries written in the order given
+     */
+    BlobTree
+    tree (
+        int a_,
+        const std::string & x_,
+        const std::vector<int> & l_,
+        const std::vector<std::pair<int, std::string>> & m_
+    ) {
+        return BlobTree ([&](amqp::reader::IVisitor & v_) {
+            v_.onBeginComposite ("test.A");
+            v_.onField ("a");
+            v_.onInt (a_);
+            v_.onField ("b");
+            v_.onBeginComposite ("test.B");
+            v_.onField ("x");
+            v_.onString (x_);
+            v_.onEndComposite();
+            v_.onField ("l");
+            v_.onBeginList (l_.size());
+            for (auto i : l_) {
+                v_.onInt (i);
+            }
+            v_.onEndList();
+            v_.onField ("m");
+            v_.onBeginMap (m_.size());
+            for (const auto & e : m_) {
+                v_.onInt (e.first);
+                v_.onString (e.second);
+            }
+            v_.onEndMap();
+            v_.onEndComposite();
+        });
+    }
+
+    std::vector<std::string>
+    differences (const BlobDiff & diff_) {
+        std::vector<std::string> rtn;
+
+        for (const auto & difference : diff_.differences()) {
+            std::stringstream ss;
+            ss << difference;
+            rtn.push_back (ss.str());
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (BlobDiff, text) { // NOLINT
+    EXPECT_EQ (R"({"a":69})", BlobTree::text (tree ("_i_").root()));
+    EXPECT_EQ (R"({"listy":["A","B","C"]})", BlobTree::text (tree ("_Le_").root()));
+    EXPECT_EQ (
+        R"({"x":[{"1":"two","3":"four","5":"six"},{"7":"eight","9":"ten"}],"y":{"x":1000000},"z":{"a":666}})",
+        BlobTree::text (tree ("__i_LMis_l__").root()));
+}
+
+/******************************************************************************/
+
+TEST (BlobDiff, identical) { // NOLINT
+    auto from = tree ("__i_LMis_l__");
+    auto to = tree ("__i_LMis_l__");
+
+    ASSERT_EQ (from.hash(), to.hash());
+
+    BlobDiff diff (from, to);
+
+    ASSERT_TRUE (diff.empty());
+    ASSERT_EQ (1, diff.skipped());
+}
+
+/******************************************************************************/
+
+TEST (BlobDiff, differentTypes) { // NOLINT
+    BlobDiff diff (tree ("_i_"), tree ("_Oi_"));
+
+    ASSERT_EQ (std::vector<std::string> { R"(~ . : {"a":69} -> {"a":1})" }, differences (diff));
+}
+
+/******************************************************************************/
+
+TEST (BlobDiff, mapOrder) { // NOLINT
+    auto from = tree (1, "s", { 1, 2 }, { { 1, "one" }, { 2, "two" } });
+    auto to = tree (1, "s", { 1, 2 }, { { 2, "two" }, { 1, "one" } });
+
+    ASSERT_EQ (from.hash(), to.hash());
+
+    /*
+     * An int isn't a long, nor a string an enum, however they read
+     */
+    auto a = BlobTree ([](amqp::reader::IVisitor & v_) { v_.onInt (1); });
+    auto b = BlobTree ([](amqp::reader::IVisitor & v_) { v_.onLong (1); });
+
+    ASSERT_NE (a.hash(), b.hash());
+}
+
+/******************************************************************************/
+
+TEST (BlobDiff, fields) { // NOLINT
+    auto from = tree (1, "s", { 1, 2, 3 }, { { 1, "one" }, { 2, "two" }, { 4, "four" } });
+    auto to = tree (1, "t", { 1, 5, 3, 4 }, { { 3, "three" }, { 2, "deux" }, { 1, "one" } });
+
+    BlobDiff diff (from, to);
+
+    std::vector<std::string> expected {
+        R"(~ b.x : "s" -> "t")",
+        R"(~ l[1] : 2 -> 5)",
+        R"(+ l[3] : 4)",
+        R"(~ m{2} : "two" -> "deux")",
+        R"(- m{4} : "four")",
+        R"(+ m{3} : "three")"
+    };
+
+    ASSERT_EQ (expected, differences (diff));
+
+    /*
+     * a, l[0], l[2] and m{1}
+     */
+    ASSERT_EQ (4, diff.skipped());
+}
+
+/******************************************************************************/
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/evolution/SchemaEvolver.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::schema;
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    /**
+     * The blob's own top level type with its fields swapped round, [a]
+     * dropped, an [int] and a nullable [string] added and a [string]
+     * with a default
+     */
+    uPtr<Composite>
+    evolved (BlobInspector & bi_) {
+        const auto & it = bi_.schema().fromDescriptor (bi_.envelope().descriptor());
+        const auto & was = dynamic_cast<const Composite &> (*(it->second.get()));
+
+        std::vector<uPtr<Field>> fields;
+
+        fields.emplace_back (Field::make ("c", "int", { }, "42", "", true, false));
+        fields.emplace_back (Field::make (
+            "b", was.fields()[1]->type(), was.fields()[1]->requires(),
+            "", "", true, false));
+        fields.emplace_back (Field::make ("d", "string", { }, "", "", false, false));
+        fields.emplace_back (Field::make ("e", "string", { }, "four", "", true, false));
+
+        return std::make_unique<Composite> (
+            was.name(), "", std::list<std::string> { },
+            std::make_unique<Descriptor> (was.descriptor() + ":evolved"),
+            std::move (fields));
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Evolution, dump) { // NOLINT
+    CordaBytes cb (filepath + "_i_is__");
+    BlobInspector bi (cb);
+
+    SchemaEvolver evolver;
+    auto target = evolved (bi);
+
+    ASSERT_EQ (
+        R"({ Parsed : { c : 42, b : { a : 2, b : "three" }, d : null, e : "four" } })",
+        bi.dump (*target, evolver));
+
+    ASSERT_EQ (1, evolver.size());
+}
+
+/******************************************************************************/
+
+TEST (Evolution, unchanged) { // NOLINT
+    CordaBytes cb (filepath + "_i_is__");
+    BlobInspector bi (cb);
+
+    SchemaEvolver evolver;
+
+    const auto & it = bi.schema().fromDescriptor (bi.envelope().descriptor());
+
+    ASSERT_EQ (
+        bi.dump(),
+        bi.dump (dynamic_cast<const Composite &> (*(it->second.get())), evolver));
+}
+
+/******************************************************************************/
+
+TEST (Evolution, reused) { // NOLINT
+    CordaBytes cb (filepath + "_i_is__");
+    BlobInspector bi1 (cb);
+    BlobInspector bi2 (cb);
+
+    SchemaEvolver evolver;
+    auto target = evolved (bi1);
+
+    ASSERT_EQ (bi1.dump (*target, evolver), bi2.dump (*target, evolver));
+    ASSERT_EQ (1, evolver.size());
+}
+
+/******************************************************************************/
+
+/**
+ * Evolution stops at the top level type, the composite held by [b] is
+ * read as it was serialised whatever's asked of the top level type
+ */
+TEST (Evolution, nestedAsSerialised) { // NOLINT
+    CordaBytes cb (filepath + "_i_is__");
+    BlobInspector bi (cb);
+
+    SchemaEvolver evolver;
+
+    const auto & it = bi.schema().fromDescriptor (bi.envelope().descriptor());
+    const auto & was = dynamic_cast<const Composite &> (*(it->second.get()));
+
+    std::vector<uPtr<Field>> fields;
+    fields.emplace_back (Field::make (
+        "b", was.fields()[1]->type(), was.fields()[1]->requires(),
+        "", "", true, false));
+
+    Composite target (
+        was.name(), "", std::list<std::string> { },
+        std::make_unique<Descriptor> (was.descriptor() + ":nested"),
+        std::move (fields));
+
+    ASSERT_EQ (R"({ Parsed : { b : { a : 2, b : "three" } } })", bi.dump (target, evolver));
+    ASSERT_EQ (1, evolver.size());
+}
+
+/******************************************************************************/
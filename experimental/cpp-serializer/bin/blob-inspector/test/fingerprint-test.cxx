@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/fingerprint/Fingerprinter.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::schema;
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    const std::vector<std::string> files = { // NOLINT
+        "_i_", "_l_", "_Oi_", "_Ai_", "_Ci_", "_ALd_", "_Li_", "_L_i__",
+        "_Le_", "_Le_2", "_Mis_", "_MiLs_", "_Mi_is__", "__i_LMis_l__",
+        "_Pls_", "_e_", "_i_is__"
+    };
+
+}
+
+/******************************************************************************/
+
+/**
+ * Every type of every blob, not just the top level one, should come out
+ * with the descriptor the JVM gave it
+ */
+TEST (Fingerprint, blobs) { // NOLINT
+    for (const auto & file : files) {
+        CordaBytes cb (filepath + file);
+        BlobInspector bi (cb);
+
+        Fingerprinter fingerprinter (bi.schema());
+
+        for (const auto & level : bi.schema()) {
+            for (const auto & type : level) {
+                EXPECT_EQ (type->descriptor(), fingerprinter.fingerprint (*type))
+                    << file << " : " << type->name();
+            }
+        }
+
+        const auto & it = bi.schema().fromDescriptor (bi.descriptor());
+        ASSERT_EQ (bi.descriptor(), fingerprinter.fingerprint (*(it->second.get())));
+    }
+}
+
+/******************************************************************************/
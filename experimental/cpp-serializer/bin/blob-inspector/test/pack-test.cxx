@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "BlobPack.h"
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    const std::vector<std::string> blobs { // NOLINT
+        "_i_", "_Oi_", "_Li_", "_Le_", "_Mis_", "_i_", "_ALd_", "_i_is__"
+    };
+
+    std::string
+    pack() {
+        auto path = "pack-test." + std::to_string (getpid());
+        std::remove (path.c_str());
+
+        return path;
+    }
+
+    size_t
+    openFiles() {
+        size_t rtn { 0 };
+
+        if (auto dir = opendir ("/proc/self/fd")) {
+            while (readdir (dir)) {
+                ++rtn;
+            }
+            closedir (dir);
+        }
+
+        return rtn;
+    }
+
+    std::string
+    dump (const std::string & path_) {
+        CordaBytes cb (filepath + path_);
+
+        return BlobInspector (cb).dump();
+    }
+
+    std::string
+    dump (const BlobPack & pack_, size_t i_) {
+        auto cb = pack_.bytes (i_);
+        BlobInspector bi (*cb);
+        bi.adopt (pack_.envelope (i_));
+
+        return bi.dump();
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (BlobPack, roundTrip) { // NOLINT
+    auto path = pack();
+
+    std::set<std::string> descriptors;
+
+    {
+        BlobPackWriter writer (path);
+
+        for (const auto & blob : blobs) {
+            CordaBytes cb (filepath + blob);
+            descriptors.insert (BlobInspector (cb).descriptor());
+
+            writer.add (cb);
+        }
+
+        writer.close();
+    }
+
+    ASSERT_TRUE (BlobPack::isPack (path));
+    ASSERT_FALSE (BlobPack::isPack (filepath + "_i_"));
+
+    BlobPack pack (path);
+
+    ASSERT_EQ (blobs.size(), pack.size());
+    ASSERT_EQ (descriptors.size(), pack.schemas().size());
+
+    /*
+     * Backwards so nothing relies on the blobs being read in order
+     */
+    for (size_t i { blobs.size() } ; i-- > 0 ; ) {
+        ASSERT_EQ (dump (blobs[i]), dump (pack, i)) << blobs[i];
+        ASSERT_EQ (CordaBytes (filepath + blobs[i]).sha256(), pack.sha256 (i));
+        ASSERT_EQ (amqp::DATA_AND_STOP, pack.bytes (i)->encoding());
+    }
+
+    ASSERT_THROW (pack.bytes (blobs.size()), std::out_of_range);
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
+
+/**
+ * Duplicates share the first copy's bytes and blobs added by a later
+ * writer are found alongside the earlier ones
+ */
+TEST (BlobPack, append) { // NOLINT
+    auto path = pack();
+
+    {
+        BlobPackWriter writer (path);
+        writer.add (CordaBytes (filepath + "_i_"));
+        writer.add (CordaBytes (filepath + "_i_"));
+    }
+
+    {
+        BlobPackWriter writer (path);
+
+        ASSERT_EQ (2, writer.size());
+        ASSERT_EQ (1, writer.schemas());
+
+        writer.add (CordaBytes (filepath + "_Oi_"));
+        writer.add (CordaBytes (filepath + "_i_"));
+    }
+
+    BlobPack pack (path);
+
+    ASSERT_EQ (4, pack.size());
+    ASSERT_EQ (2, pack.schemas().size());
+
+    ASSERT_EQ (pack.entry (0).offset, pack.entry (1).offset);
+    ASSERT_EQ (pack.entry (0).offset, pack.entry (3).offset);
+    ASSERT_EQ (pack.envelope (0), pack.envelope (3));
+
+    ASSERT_EQ (dump ("_i_"), dump (pack, 3));
+    ASSERT_EQ (dump ("_Oi_"), dump (pack, 2));
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
+
+/**
+ * Two blobs of one type with different schema sections each keep their
+ * own, packs are keyed on the section and not the type's descriptor
+ */
+TEST (BlobPack, schemaPerSection) { // NOLINT
+    auto path = pack();
+    auto renamed = path + ".blob";
+
+    // _i_ with its field renamed from a to b
+    {
+        std::ifstream in (filepath + "_i_", std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+
+        auto bytes = ss.str();
+        ASSERT_EQ ('a', bytes[0xbc]);
+        bytes[0xbc] = 'b';
+
+        std::ofstream out (renamed, std::ios::binary);
+        out << bytes;
+    }
+
+    {
+        BlobPackWriter writer (path);
+        writer.add (CordaBytes (filepath + "_i_"));
+        writer.add (CordaBytes (renamed));
+        writer.add (CordaBytes (filepath + "_i_"));
+    }
+
+    BlobPack pack (path);
+
+    ASSERT_EQ (2, pack.schemas().size());
+    ASSERT_EQ (pack.schemas()[0].descriptor, pack.schemas()[1].descriptor);
+
+    ASSERT_EQ (dump ("_i_"), dump (pack, 0));
+    CordaBytes cb (renamed);
+    ASSERT_EQ (BlobInspector (cb).dump(), dump (pack, 1));
+    ASSERT_NE (dump (pack, 0), dump (pack, 1));
+
+    std::remove (renamed.c_str());
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
+
+/**
+ * An index pointing outside the file, or at a schema that isn't there,
+ * is rejected when the pack's opened, without leaking the file
+ */
+TEST (BlobPack, corrupt) { // NOLINT
+    auto path = pack();
+
+    {
+        BlobPackWriter writer (path);
+        writer.add (CordaBytes (filepath + "_i_"));
+    }
+
+    std::string good;
+    {
+        std::ifstream in (path, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        good = ss.str();
+    }
+
+    // the only blob's entry sits just before the footer
+    auto entry = good.size() - 32 - sizeof (BlobPack::Entry);
+
+    auto corrupt = [&](size_t at_, uint64_t val_, size_t width_) {
+        auto bytes = good;
+        memcpy (&bytes[at_], &val_, width_);
+
+        std::ofstream out (path, std::ios::binary | std::ios::trunc);
+        out << bytes;
+        out.close();
+
+        try {
+            BlobPack pack (path);
+            FAIL() << "opened a corrupt pack";
+        } catch (const std::runtime_error & e) {
+            ASSERT_EQ ("Corrupt pack " + path, e.what());
+        }
+    };
+
+    auto files = openFiles();
+
+    corrupt (entry, good.size(), 8);
+    corrupt (entry + 8, ~uint64_t { 0 }, 8);
+    corrupt (entry + 16, 1, 4);
+    corrupt (good.size() - 32, good.size(), 8);
+    corrupt (good.size() - 16, ~uint64_t { 0 } / 2, 8);
+
+    ASSERT_EQ (files, openFiles());
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/schema/described-types/Envelope.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    const std::vector<std::string> files = { // NOLINT
+        "_i_", "_l_", "_Oi_", "_Ai_", "_ALd_", "_Li_", "_L_i__", "_Le_",
+        "_Mis_", "_MiLs_", "_Mi_is__", "__i_LMis_l__", "_Pls_", "_e_",
+        "_i_is__", "_Ci_"
+    };
+
+}
+
+/******************************************************************************/
+
+/**
+ * With a threshold of one every list field is split up, more ways than
+ * most of them have elements
+ */
+TEST (Parallel, matchesSequential) { // NOLINT
+    for (const auto & file : files) {
+        CordaBytes cb (filepath + file);
+
+        auto sequential = BlobInspector (cb).dump();
+
+        for (size_t threads : { 1, 2, 4 }) {
+            EXPECT_EQ (sequential, BlobInspector (cb).dump (threads, 1)) << file;
+        }
+    }
+}
+
+/******************************************************************************/
+
+TEST (Parallel, belowThreshold) { // NOLINT
+    CordaBytes cb (filepath + "_Li_");
+
+    ASSERT_EQ (
+        "{ Parsed : { a : [ 1, 2, 3, 4, 5, 6 ] } }",
+        BlobInspector (cb).dump (4));
+}
+
+/******************************************************************************/
+
+TEST (Parallel, descriptor) { // NOLINT
+    CordaBytes cb (filepath + "_Li_");
+    BlobInspector bi (cb);
+
+    ASSERT_EQ (bi.envelope().descriptor(), bi.descriptor());
+}
+
+/******************************************************************************/
+
+TEST (Parallel, badElement) { // NOLINT
+    CordaBytes cb (filepath + "_Le_2");
+
+    EXPECT_THROW (BlobInspector (cb).dump (4, 1), std::runtime_error);
+}
+
+/******************************************************************************/
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "Profile.h"
+#include "Sketches.h"
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+}
+
+/******************************************************************************/
+
+TEST (Sketches, hyperLogLog) { // NOLINT
+    HyperLogLog a, b;
+
+    for (int i { 0 } ; i < 100000 ; ++i) {
+        (i % 2 ? a : b).add (std::to_string (i));
+    }
+
+    for (int i { 0 } ; i < 10 ; ++i) {
+        a.add ("repeat");
+    }
+
+    auto half = static_cast<double>(a.estimate());
+    ASSERT_NEAR (50001.0, half, 50001.0 * 0.05);
+
+    a.merge (b);
+    ASSERT_NEAR (100001.0, static_cast<double>(a.estimate()), 100001.0 * 0.05);
+
+    HyperLogLog small;
+    small.add ("a");
+    small.add ("b");
+    small.add ("a");
+    ASSERT_EQ (2, small.estimate());
+}
+
+/******************************************************************************/
+
+/**
+ * A handful of values seen far more often than a long tail of others
+ * stay on top however the stream is split
+ */
+TEST (Sketches, spaceSaving) { // NOLINT
+    SpaceSaving a (16), b (16);
+
+    for (int i { 0 } ; i < 10000 ; ++i) {
+        auto & s = i < 5000 ? a : b;
+
+        s.add ("tail" + std::to_string (i));
+        if (i % 2 == 0) s.add ("GBP");
+        if (i % 5 == 0) s.add ("USD");
+    }
+
+    a.merge (b);
+
+    auto top = a.top (2);
+    ASSERT_EQ (2, top.size());
+    ASSERT_EQ ("GBP", top[0].value);
+    ASSERT_EQ ("USD", top[1].value);
+
+    ASSERT_GE (top[0].count, 5000);
+    ASSERT_LE (top[0].count - top[0].error, 5000);
+}
+
+/******************************************************************************/
+
+/**
+ * A newcomer to a full summary takes over the least frequent counter,
+ * its count becoming the newcomer's error, and copies stand alone
+ */
+TEST (Sketches, spaceSavingEvicts) { // NOLINT
+    SpaceSaving s (2);
+
+    for (const auto & v : { "a", "a", "a", "b", "b", "c" }) {
+        s.add (v);
+    }
+
+    auto copy = s;
+
+    auto top = s.top (2);
+    ASSERT_EQ (2, top.size());
+    ASSERT_EQ ("a", top[0].value);
+    ASSERT_EQ (3, top[0].count);
+    ASSERT_EQ (0, top[0].error);
+    ASSERT_EQ ("c", top[1].value);
+    ASSERT_EQ (3, top[1].count);
+    ASSERT_EQ (2, top[1].error);
+
+    s.add ("c");
+    s.add ("d");
+
+    ASSERT_EQ ("c", s.top (1)[0].value);
+    ASSERT_EQ (4, s.top (1)[0].count);
+    ASSERT_EQ ("d", s.top (2)[1].value);
+    ASSERT_EQ (4, s.top (2)[1].count);
+
+    copy.add ("a");
+    ASSERT_EQ (4, copy.top (1)[0].count);
+    ASSERT_EQ ("a", copy.top (1)[0].value);
+}
+
+/******************************************************************************/
+
+TEST (Profile, fields) { // NOLINT
+    std::vector<std::unique_ptr<CordaBytes>> blobs;
+    for (const auto & name : { "_i_", "_Oi_", "_i_is__", "_L_i__", "_Mis_", "_i_" }) {
+        blobs.push_back (std::make_unique<CordaBytes> (filepath + name));
+    }
+
+    auto source = [&blobs](size_t i_, amqp::reader::IVisitor & visitor_) {
+        BlobInspector (*blobs[i_ % blobs.size()]).visit (visitor_);
+    };
+
+    Profile one, many;
+    one.run (60, source, 1);
+    many.run (60, source, 4);
+
+    std::stringstream a, b;
+    one.ndjson (a);
+    many.ndjson (b);
+
+    ASSERT_EQ (a.str(), b.str());
+    ASSERT_EQ (60, many.blobs());
+    ASSERT_EQ (20, many.count ("net.corda.blobwriter._i_"));
+
+    const auto & i = many.types().at ("net.corda.blobwriter._i_").at ("a");
+    ASSERT_EQ (20, i.count);
+    ASSERT_EQ (69, i.min.integer);
+    ASSERT_EQ (1, i.distinct.estimate());
+
+    const auto & nested = many.types().at ("net.corda.blobwriter._i_is__");
+    ASSERT_EQ (10, nested.at ("b").count);
+    ASSERT_EQ (10, nested.at ("b.b").lengths[3]);
+    ASSERT_EQ ("three", nested.at ("b.b").frequent.top (1)[0].value);
+
+    const auto & list = many.types().at ("net.corda.blobwriter._L_i__");
+    ASSERT_EQ (30, list.at ("listy[].a").count);
+    ASSERT_EQ (1, list.at ("listy[].a").min.integer);
+    ASSERT_EQ (3, list.at ("listy[].a").max.integer);
+    ASSERT_EQ (3, list.at ("listy[].a").distinct.estimate());
+
+    const auto & map = many.types().at ("net.corda.blobwriter._Mis_");
+    ASSERT_EQ (30, map.at ("a{key}").count);
+    ASSERT_EQ (30, map.at ("a{value}").count);
+}
+
+/******************************************************************************/
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "Sha256.h"
+#include "CordaBytes.h"
+#include "Exporters.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    std::string
+    sha256 (const std::string & s_, bool accelerate_) {
+        return Sha256::hex (Sha256 (accelerate_).update (s_.data(), s_.size()).digest());
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * FIPS 180-2 test vectors, through both the SHA extensions, when this
+ * CPU has them, and the portable implementation
+ */
+TEST (Sha256, vectors) { // NOLINT
+    for (auto accelerate : { true, false }) {
+        ASSERT_EQ (
+            "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855",
+            sha256 ("", accelerate));
+
+        ASSERT_EQ (
+            "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD",
+            sha256 ("abc", accelerate));
+
+        ASSERT_EQ (
+            "248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1",
+            sha256 ("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", accelerate));
+
+        ASSERT_EQ (
+            "CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0",
+            sha256 (std::string (1000000, 'a'), accelerate));
+    }
+}
+
+/******************************************************************************/
+
+TEST (Sha256, incremental) { // NOLINT
+    std::string s;
+    for (int i { 0 } ; i < 1000 ; ++i) {
+        s += static_cast<char>(i * 31);
+    }
+
+    Sha256 h;
+    for (size_t i { 0 }, n { 1 } ; i < s.size() ; i += n, n = n * 3 % 97) {
+        h.update (s.data() + i, std::min (n, s.size() - i));
+    }
+
+    ASSERT_EQ (sha256 (s, true), Sha256::hex (h.digest()));
+}
+
+/******************************************************************************/
+
+TEST (Sha256, blob) { // NOLINT
+    CordaBytes cb (filepath + "_i_");
+
+    ASSERT_EQ (
+        "05ED9966A9AC2E65008DAFB316836E38B88624E4A24143D04207D7D2D6923CA9",
+        cb.sha256());
+}
+
+/******************************************************************************/
+
+TEST (Sha256, ndjson) { // NOLINT
+    std::stringstream ss;
+    NdJsonExporter exporter (ss);
+
+    CordaBytes cb (filepath + "_i_");
+    BlobInspector bi (cb);
+
+    exporter.add (bi, cb.sha256());
+    exporter.duplicate (0, cb.sha256());
+    exporter.close();
+
+    ASSERT_NE (
+        std::string::npos,
+        ss.str().find (
+            R"({"schema":0,"sha256":"05ED9966A9AC2E65008DAFB316836E38B88624E4A24143D04207D7D2D6923CA9","value":[69]})" "\n"
+            R"({"duplicate":0,"sha256":"05ED9966A9AC2E65008DAFB316836E38B88624E4A24143D04207D7D2D6923CA9"})" "\n"));
+}
+
+/******************************************************************************/
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+#include "CordaBytes.h"
+#include "SchemaStore.h"
+#include "BlobInspector.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Envelope.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+    const std::string storePath ("schema-store-test.store"); // NOLINT
+
+    std::string
+    dump (const std::string & file_, SchemaStore * store_ = nullptr) {
+        CordaBytes cb (filepath + file_);
+        BlobInspector bi (cb, store_);
+
+        return bi.dump();
+    }
+
+    const std::vector<std::string> files = { // NOLINT
+        "_i_", "_l_", "_Oi_", "_Ai_", "_ALd_", "_Li_", "_L_i__", "_Le_",
+        "_Mis_", "_MiLs_", "_Mi_is__", "__i_LMis_l__", "_Pls_", "_e_", "_i_is__"
+    };
+
+}
+
+/******************************************************************************/
+
+TEST (SchemaStore, hash) { // NOLINT
+    // FNV-1a test vectors
+    ASSERT_EQ (0xcbf29ce484222325UL, SchemaStore::hash (""));
+    ASSERT_EQ (0xaf63dc4c8601ec8cUL, SchemaStore::hash ("a"));
+}
+
+/******************************************************************************/
+
+TEST (SchemaStore, descriptor) { // NOLINT
+    CordaBytes cb (filepath + "_i_");
+    BlobInspector bi (cb);
+
+    auto descriptor = bi.descriptor();
+
+    ASSERT_EQ (descriptor, bi.envelope().descriptor());
+}
+
+/******************************************************************************/
+
+/**
+ * Blobs of the same top level type can carry different schemas, the
+ * concrete types of polymorphic fields being listed in them, so one
+ * blob's schema mustn't be found for another's just by its descriptor
+ */
+TEST (SchemaStore, keyedOnSchema) { // NOLINT
+    const char a[] = "schema a";
+    const char b[] = "schema b";
+
+    ASSERT_EQ (SchemaStore::key ("net.corda:x", a, a + 8), SchemaStore::key ("net.corda:x", a, a + 8));
+    ASSERT_NE (SchemaStore::key ("net.corda:x", a, a + 8), SchemaStore::key ("net.corda:x", b, b + 8));
+
+    remove (storePath.c_str());
+
+    {
+        CordaBytes cb (filepath + "_l_");
+        BlobInspector bi (cb);
+
+        CordaBytes other (filepath + "_i_");
+        BlobInspector stale (other);
+
+        SchemaStore store (storePath);
+        store.put (SchemaStore::key (bi.descriptor(), a, a + 8), stale.schema());
+
+        ASSERT_EQ (nullptr, store.get (bi.schemaKey()));
+        ASSERT_EQ (dump ("_l_"), dump ("_l_", &store));
+        ASSERT_EQ (2, store.size());
+    }
+
+    remove (storePath.c_str());
+}
+
+/******************************************************************************/
+
+TEST (SchemaStore, roundTrip) { // NOLINT
+    remove (storePath.c_str());
+
+    {
+        SchemaStore store (storePath);
+
+        for (const auto & file : files) {
+            ASSERT_EQ (dump (file), dump (file, &store));
+        }
+
+        ASSERT_EQ (files.size(), store.size());
+    }
+
+    // and then read them back in a later "run"
+    {
+        SchemaStore store (storePath);
+        ASSERT_EQ (files.size(), store.size());
+
+        for (const auto & file : files) {
+            CordaBytes cb (filepath + file);
+            BlobInspector bi (cb);
+            ASSERT_NE (nullptr, store.get (bi.schemaKey()));
+
+            ASSERT_EQ (dump (file), dump (file, &store));
+        }
+
+        ASSERT_EQ (files.size(), store.size());
+        ASSERT_EQ (nullptr, store.get ("net.corda:nothing"));
+    }
+
+    remove (storePath.c_str());
+}
+
+/******************************************************************************/
+
+TEST (SchemaStore, sharedBetweenInstances) { // NOLINT
+    remove (storePath.c_str());
+
+    SchemaStore first (storePath);
+    SchemaStore second (storePath);
+
+    dump ("_i_", &first);
+
+    // the second store learns of the new entry as it misses
+    CordaBytes cb (filepath + "_i_");
+    BlobInspector bi (cb);
+    ASSERT_NE (nullptr, second.get (bi.schemaKey()));
+
+    dump ("_i_", &second);
+    ASSERT_EQ (1, second.size());
+
+    remove (storePath.c_str());
+}
+
+/******************************************************************************/
+
+/**
+ * Another process part way through appending an entry holds the lock, a
+ * reader missing in the meantime waits for it rather than finding what's
+ * there so far and calling the store corrupt
+ */
+TEST (SchemaStore, partialAppend) { // NOLINT
+    const std::string other ("schema-store-test.other");
+
+    CordaBytes cb (filepath + "_i_");
+    BlobInspector bi (cb);
+
+    // the bytes of a whole entry, as another writer would append them
+    remove (other.c_str());
+    {
+        SchemaStore store (other);
+        store.put (bi.schemaKey(), bi.schema());
+    }
+
+    std::ifstream in (other, std::ios::binary);
+    std::string entry { std::istreambuf_iterator<char> (in), std::istreambuf_iterator<char>() };
+    entry.erase (0, 16);
+    remove (other.c_str());
+
+    remove (storePath.c_str());
+
+    SchemaStore store (storePath);
+
+    auto fd = open (storePath.c_str(), O_RDWR | O_APPEND);
+    ASSERT_LE (0, fd);
+    ASSERT_EQ (0, flock (fd, LOCK_EX));
+    ASSERT_EQ (8, write (fd, entry.data(), 8));
+
+    bool found { false };
+    std::thread reader ([&]() { found = store.get (bi.schemaKey()) != nullptr; });
+
+    std::this_thread::sleep_for (std::chrono::milliseconds (50));
+
+    auto rest = static_cast<ssize_t>(entry.size() - 8);
+    ASSERT_EQ (rest, write (fd, entry.data() + 8, entry.size() - 8));
+    flock (fd, LOCK_UN);
+    close (fd);
+
+    reader.join();
+
+    ASSERT_TRUE (found);
+    ASSERT_EQ (1, store.size());
+
+    remove (storePath.c_str());
+}
+
+/******************************************************************************/
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "BlobPack.h"
+#include "ValueIndex.h"
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    std::string
+    temp (const std::string & name_) {
+        auto path = name_ + "." + std::to_string (getpid());
+        std::remove (path.c_str());
+
+        return path;
+    }
+
+    size_t
+    openFiles() {
+        size_t rtn { 0 };
+
+        if (auto dir = opendir ("/proc/self/fd")) {
+            while (readdir (dir)) {
+                ++rtn;
+            }
+            closedir (dir);
+        }
+
+        return rtn;
+    }
+
+    /**
+     * Some blobs with an "a" that's an int, one where it's a composite
+     * and one where it's a map, and one with a nested "b.b"
+     */
+    const std::vector<std::string> blobs { // NOLINT
+        "_i_", "_Oi_", "_i_is__", "_Pls_", "_Mis_", "_Oi_", "_l_", "_i_"
+    };
+
+}
+
+/******************************************************************************/
+
+TEST (ValueIndex, values) { // NOLINT
+    CordaBytes cb (filepath + "_i_is__");
+    BlobInspector bi (cb);
+
+    auto values = bi.values ({ "a", "b", "b.b", "b.c", "a.b" });
+
+    ASSERT_EQ ("1", values[0].value());
+    ASSERT_EQ ("{ a : 2, b : \"three\" }", values[1].value());
+    ASSERT_EQ ("three", values[2].value());
+    ASSERT_FALSE (values[3]);
+    ASSERT_FALSE (values[4]);
+}
+
+/******************************************************************************/
+
+TEST (ValueIndex, pack) { // NOLINT
+    auto packPath = temp ("value-index-test.pack");
+    auto indexPath = temp ("value-index-test.idx");
+
+    {
+        BlobPackWriter writer (packPath);
+        for (const auto & blob : blobs) {
+            writer.add (CordaBytes (filepath + blob));
+        }
+    }
+
+    BlobPack pack (packPath);
+
+    /*
+     * More threads than would each get a single blob so the runs are
+     * ragged and every merge has something to do
+     */
+    ValueIndexBuilder ({ "a", "b.b", "x" }, 3).build (pack, indexPath);
+
+    ValueIndex index (indexPath);
+
+    ASSERT_EQ ((std::vector<std::string> { "a", "b.b", "x" }), index.paths());
+
+    ASSERT_EQ ((std::vector<uint64_t> { 0, 7 }), index.lookup ("a", "69"));
+    ASSERT_EQ ((std::vector<uint64_t> { 1, 2, 5 }), index.lookup ("a", "1"));
+    ASSERT_EQ ((std::vector<uint64_t> { 2 }), index.lookup ("b.b", "three"));
+    ASSERT_EQ ((std::vector<uint64_t> { 6 }), index.lookup ("x", "100000000000"));
+    ASSERT_EQ ((std::vector<uint64_t> { 3 }), index.lookup ("a", "{ first : 1, second : \"two\" }"));
+
+    ASSERT_TRUE (index.lookup ("a", "2").empty());
+    ASSERT_TRUE (index.lookup ("a", "").empty());
+    ASSERT_TRUE (index.lookup ("a", "zzz").empty());
+
+    ASSERT_EQ (4, index.cardinality ("a"));
+    ASSERT_EQ (1, index.cardinality ("b.b"));
+
+    ASSERT_THROW (index.lookup ("b", "1"), std::runtime_error);
+
+    std::remove (packPath.c_str());
+    std::remove (indexPath.c_str());
+}
+
+/******************************************************************************/
+
+/**
+ * However many threads build it the index comes out the same
+ */
+TEST (ValueIndex, threads) { // NOLINT
+    std::vector<std::unique_ptr<CordaBytes>> bytes;
+    for (const auto & blob : blobs) {
+        bytes.push_back (std::make_unique<CordaBytes> (filepath + blob));
+    }
+
+    auto source = [&bytes](size_t i_) {
+        BlobInspector bi (*bytes[i_ % bytes.size()]);
+        return bi.values ({ "a" });
+    };
+
+    auto one = temp ("value-index-test.1");
+    auto many = temp ("value-index-test.n");
+
+    ValueIndexBuilder ({ "a" }, 1).build (100, source, one);
+    ValueIndexBuilder ({ "a" }, 7).build (100, source, many);
+
+    ValueIndex a (one), b (many);
+
+    ASSERT_EQ (a.lookup ("a", "1"), b.lookup ("a", "1"));
+    ASSERT_EQ (25, b.lookup ("a", "69").size());
+    ASSERT_EQ (96, b.lookup ("a", "69").back());
+
+    std::remove (one.c_str());
+    std::remove (many.c_str());
+}
+
+/******************************************************************************/
+
+TEST (ValueIndex, corrupt) { // NOLINT
+    std::vector<std::unique_ptr<CordaBytes>> bytes;
+    for (const auto & blob : blobs) {
+        bytes.push_back (std::make_unique<CordaBytes> (filepath + blob));
+    }
+
+    auto source = [&bytes](size_t i_) {
+        BlobInspector bi (*bytes[i_]);
+        return bi.values ({ "a" });
+    };
+
+    auto path = temp ("value-index-test.idx");
+
+    ValueIndexBuilder ({ "a" }, 1).build (bytes.size(), source, path);
+
+    std::string good;
+    {
+        std::ifstream in (path, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        good = ss.str();
+    }
+
+    // the only path, "a", sits just before the footer
+    auto footer = good.size() - 24;
+    auto entry = footer - 32;
+
+    uint64_t keys;
+    memcpy (&keys, &good[entry], 8);
+
+    auto corrupt = [&](size_t at_, uint64_t val_, size_t width_) {
+        auto bytes = good;
+        memcpy (&bytes[at_], &val_, width_);
+
+        std::ofstream out (path, std::ios::binary | std::ios::trunc);
+        out << bytes;
+        out.close();
+
+        try {
+            ValueIndex index (path);
+            FAIL() << "opened a corrupt index";
+        } catch (const std::runtime_error & e) {
+            ASSERT_EQ ("Corrupt index " + path, e.what());
+        }
+    };
+
+    auto files = openFiles();
+
+    corrupt (footer, good.size(), 8);
+    corrupt (footer + 8, ~uint64_t { 0 }, 8);
+    corrupt (entry, ~uint64_t { 0 } - 8, 8);
+    corrupt (entry, keys + 1, 8);
+    corrupt (entry + 8, ~uint64_t { 0 } / 2, 8);
+    corrupt (entry + 16, ~uint32_t { 0 }, 4);
+    corrupt (keys, ~uint64_t { 0 }, 8);
+    corrupt (keys + 8, good.size(), 8);
+    corrupt (keys + 16, ~uint32_t { 0 }, 4);
+    corrupt (keys + 20, ~uint32_t { 0 }, 4);
+
+    ASSERT_EQ (files, openFiles());
+
+    std::remove (path.c_str());
+}
+
+/******************************************************************************/
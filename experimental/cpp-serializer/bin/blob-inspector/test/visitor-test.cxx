@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+
+#include "amqp/reader/IVisitor.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    /**
+     * Records every event it's given
+     */
+    class Recorder : public amqp::reader::IVisitor {
+        private :
+            std::stringstream m_events;
+
+        public :
+            void onBeginComposite (const std::string & type_) override {
+                m_events << "{" << type_.substr (type_.rfind ('.') + 1) << " ";
+            }
+
+            void onEndComposite() override { m_events << "} "; }
+
+            void onNull() override { m_events << "null "; }
+
+            void onField (const std::string & name_) override {
+                m_events << name_ << "=";
+            }
+
+            void onInt (int32_t val_) override { m_events << "i" << val_ << " "; }
+            void onLong (int64_t val_) override { m_events << "l" << val_ << " "; }
+            void onBool (bool val_) override { m_events << "b" << val_ << " "; }
+            void onDouble (double val_) override { m_events << "d" << val_ << " "; }
+
+            void onString (std::string_view val_) override {
+                m_events << "\"" << val_ << "\" ";
+            }
+
+            void onEnum (int32_t ordinal_, std::string_view name_) override {
+                m_events << "e" << ordinal_ << ":" << name_ << " ";
+            }
+
+            void onBeginList (size_t elements_) override {
+                m_events << "[" << elements_ << " ";
+            }
+
+            void onEndList() override { m_events << "] "; }
+
+            void onBeginMap (size_t entries_) override {
+                m_events << "<" << entries_ << " ";
+            }
+
+            void onEndMap() override { m_events << "> "; }
+
+            std::string events() const { return m_events.str(); }
+    };
+
+    std::string
+    visit (const std::string & file_) {
+        CordaBytes cb (filepath + file_);
+        Recorder recorder;
+
+        BlobInspector (cb).visit (recorder);
+
+        return recorder.events();
+    }
+
+    std::string
+    bytes (const std::string & file_) {
+        std::ifstream in (filepath + file_, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+
+        return ss.str();
+    }
+
+    std::string
+    visitBytes (const std::string & bytes_) {
+        CordaBytes cb (bytes_.data(), bytes_.size());
+        Recorder recorder;
+
+        BlobInspector (cb).visit (recorder);
+
+        return recorder.events();
+    }
+
+    /**
+     * A test blob with the [length_] bytes of a value at [at_] replaced by
+     * a null, the sizes of the lists and maps at [sizes_] it's within
+     * shrunk to match
+     */
+    std::string
+    visitWithNull (
+        const std::string & file_,
+        size_t at_,
+        size_t length_,
+        const std::vector<std::pair<size_t, size_t>> & sizes_)
+    {
+        auto bytes = ::bytes (file_);
+
+        for (const auto & size : sizes_) {
+            uint64_t val { 0 };
+            for (size_t i { 0 } ; i < size.second ; ++i) {
+                val = (val << 8U) | static_cast<uint8_t>(bytes[size.first + i]);
+            }
+
+            val -= length_ - 1;
+
+            for (size_t i { size.second } ; i-- > 0 ; val >>= 8U) {
+                bytes[size.first + i] = static_cast<char>(val & 0xffU);
+            }
+        }
+
+        bytes.replace (at_, length_, 1, '\x40');
+
+        return visitBytes (bytes);
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Visitor, primitives) { // NOLINT
+    EXPECT_EQ ("{_i_ a=i69 } ", visit ("_i_"));
+    EXPECT_EQ ("{_l_ x=l100000000000 } ", visit ("_l_"));
+}
+
+/******************************************************************************/
+
+TEST (Visitor, lists) { // NOLINT
+    EXPECT_EQ ("{_Li_ a=[6 i1 i2 i3 i4 i5 i6 ] } ", visit ("_Li_"));
+    EXPECT_EQ ("{_L_i__ listy=[3 {_i_ a=i1 } {_i_ a=i2 } {_i_ a=i3 } ] } ", visit ("_L_i__"));
+    EXPECT_EQ ("{_ALd_ a=[3 [3 d10.1 d11.2 d12.3 ] [0 ] [1 d13.4 ] ] } ", visit ("_ALd_"));
+}
+
+/******************************************************************************/
+
+TEST (Visitor, enums) { // NOLINT
+    EXPECT_EQ ("{_e_ e=e0:A } ", visit ("_e_"));
+    EXPECT_EQ ("{_Le_ listy=[3 e0:A e1:B e2:C ] } ", visit ("_Le_"));
+}
+
+/******************************************************************************/
+
+/**
+ * An enum's constant is picked by its ordinal when its name agrees and by
+ * its name when it doesn't, the enum having been reordered since
+ */
+TEST (Visitor, enumConstants) { // NOLINT
+    // _e_ holds constant A of A, B, C, encoded as its name and ordinal
+    auto e = bytes ("_e_");
+    ASSERT_EQ ('A', e[0x6d]);
+    ASSERT_EQ (0, e[0x6f]);
+
+    auto matching = e;
+    matching[0x6d] = 'C';
+    matching[0x6f] = 2;
+    EXPECT_EQ ("{_e_ e=e2:C } ", visitBytes (matching));
+
+    auto reordered = e;
+    reordered[0x6d] = 'B';
+    EXPECT_EQ ("{_e_ e=e1:B } ", visitBytes (reordered));
+
+    CordaBytes cb (reordered.data(), reordered.size());
+    EXPECT_EQ ("{ Parsed : { e : B } }", BlobInspector (cb).dump());
+
+    auto unknown = e;
+    unknown[0x6d] = 'D';
+    try {
+        visitBytes (unknown);
+        FAIL() << "visited an unknown constant";
+    } catch (const std::runtime_error & e) {
+        EXPECT_EQ (0, std::string (e.what()).find ("Unknown constant D of "));
+    }
+}
+
+/******************************************************************************/
+
+TEST (Visitor, maps) { // NOLINT
+    EXPECT_EQ (
+        R"({_Mi_is__ a=<3 i1 {_is_ a=i2 b="three" } i4 {_is_ a=i5 b="six" } i7 {_is_ a=i8 b="nine" } > } )",
+        visit ("_Mi_is__"));
+}
+
+/******************************************************************************/
+
+TEST (Visitor, matchesDump) { // NOLINT
+    EXPECT_EQ (
+        R"({__i_LMis_l__ x=[2 <3 i1 "two" i3 "four" i5 "six" > <2 i7 "eight" i9 "ten" > ] y={_l_ x=l1000000 } z={_i_ a=i666 } } )",
+        visit ("__i_LMis_l__"));
+}
+
+/******************************************************************************/
+
+/**
+ * Null elements of lists and maps are reported as nulls rather than
+ * handed to the element's reader
+ */
+TEST (Visitor, nullElements) { // NOLINT
+    // _Li_ with its first element, smallint 1, a null
+    EXPECT_EQ (
+        "{_Li_ a=[6 null i2 i3 i4 i5 i6 ] } ",
+        visitWithNull ("_Li_", 0x6b, 2, { { 0x13, 4 }, { 0x41, 1 }, { 0x69, 1 } }));
+
+    // _Mis_ with the value of its first entry, "two", a null
+    EXPECT_EQ (
+        R"({_Mis_ a=<3 i1 null i3 "four" i5 "six" > } )",
+        visitWithNull ("_Mis_", 0x6d, 5, { { 0x13, 4 }, { 0x41, 1 }, { 0x69, 1 } }));
+}
+
+/******************************************************************************/
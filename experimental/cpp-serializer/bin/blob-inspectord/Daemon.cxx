@@ -0,0 +1,276 @@
+#include "Daemon.h"
+
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <stdexcept>
+#include <condition_variable>
+
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+
+#include "CordaBytes.h"
+#include "Projection.h"
+#include "BlobInspector.h"
+
+#include "amqp/AMQPSectionId.h"
+#include "amqp/schema/described-types/Envelope.h"
+
+/******************************************************************************/
+
+namespace {
+
+    uint32_t
+    getInt (const char * bytes_, size_t size_ = 4) {
+        uint32_t rtn { 0 };
+        for (size_t i { 0 } ; i < size_ ; ++i) {
+            rtn = (rtn << 8U) | static_cast<uint8_t>(bytes_[i]);
+        }
+        return rtn;
+    }
+
+    void
+    putInt (std::string & out_, uint32_t val_) {
+        for (int i { 3 } ; i >= 0 ; --i) {
+            out_.push_back (static_cast<char>((val_ >> (8U * i)) & 0xFFU));
+        }
+    }
+
+    bool
+    readFully (int fd_, char * bytes_, size_t size_) {
+        while (size_) {
+            auto got = read (fd_, bytes_, size_);
+            if (got <= 0) {
+                return false;
+            }
+            bytes_ += got;
+            size_ -= got;
+        }
+        return true;
+    }
+
+    void
+    writeFully (int fd_, const char * bytes_, size_t size_) {
+        while (size_) {
+            auto wrote = write (fd_, bytes_, size_);
+            if (wrote <= 0) {
+                throw std::runtime_error ("Failed writing response");
+            }
+            bytes_ += wrote;
+            size_ -= wrote;
+        }
+    }
+
+    /**
+     * Responses for a single stream. Writes are serialised and we keep
+     * count of the requests still being worked on so the stream isn't
+     * closed underneath them
+     */
+    struct Connection {
+        int                     out;
+        std::mutex              mutex;
+        std::condition_variable cv;
+        size_t                  outstanding { 0 };
+        bool                    broken { false };
+
+        explicit Connection (int out_) : out (out_) { }
+
+        void
+        respond (uint32_t id_, bool ok_, const std::string & body_) {
+            std::string frame;
+            frame.reserve (body_.size() + 9);
+            putInt (frame, static_cast<uint32_t>(body_.size() + 5));
+            putInt (frame, id_);
+            frame.push_back (ok_ ? 0 : 1);
+            frame += body_;
+
+            std::lock_guard<std::mutex> lock (mutex);
+            if (!broken) {
+                try {
+                    writeFully (out, frame.data(), frame.size());
+                } catch (const std::runtime_error &) {
+                    broken = true;
+                }
+            }
+
+            --outstanding;
+            cv.notify_all();
+        }
+    };
+
+}
+
+/******************************************************************************/
+
+Daemon::Daemon (size_t threads_, SchemaStore * store_)
+    : m_cache (m_metrics, store_)
+    , m_pool (threads_)
+{ }
+
+/******************************************************************************/
+
+bool
+Daemon::handle (
+    uint8_t op_,
+    const char * payload_,
+    size_t size_,
+    std::string & out_
+) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok { true };
+
+    try {
+        std::vector<std::string> paths;
+
+        if (op_ == metrics_op) {
+            out_ = m_metrics.json();
+            return true;
+        }
+
+        if (op_ == project_op) {
+            if (size_ < 2) throw std::runtime_error ("Truncated projection");
+
+            auto count = getInt (payload_, 2);
+            payload_ += 2; size_ -= 2;
+
+            for (uint32_t i { 0 } ; i < count ; ++i) {
+                if (size_ < 2) throw std::runtime_error ("Truncated projection");
+                auto length = getInt (payload_, 2);
+                payload_ += 2; size_ -= 2;
+
+                if (size_ < length) throw std::runtime_error ("Truncated projection");
+                paths.emplace_back (payload_, length);
+                payload_ += length; size_ -= length;
+            }
+        } else if (op_ != json_op && op_ != dump_op) {
+            throw std::runtime_error ("Unknown op " + std::to_string (op_));
+        }
+
+        CordaBytes cb (payload_, size_);
+
+        if (cb.encoding() != amqp::DATA_AND_STOP) {
+            throw std::runtime_error ("Bad encoding");
+        }
+
+        BlobInspector blob (cb);
+        auto decoder = m_cache.get (blob);
+
+        out_.clear();
+
+        std::unique_ptr<Projection> projection;
+        if (op_ == project_op) {
+            projection = std::make_unique<Projection> (decoder->schema, std::move (paths));
+        }
+
+        blob.withPayload ([op_, &decoder, &projection, &out_](
+            pn_data_t * data_,
+            const amqp::internal::schema::Envelope & envelope_
+        ) {
+            switch (op_) {
+                case json_op :
+                    decoder->schema.encodeJson (data_, out_, true);
+                    break;
+                case project_op :
+                    out_ = projection->json (data_);
+                    break;
+                default :
+                    out_ = decoder->reader->dump (
+                        "{ Parsed", data_, envelope_.schema())->dump() + " }";
+                    break;
+            }
+        });
+    } catch (const std::exception & e) {
+        out_ = e.what();
+        ok = false;
+    }
+
+    m_metrics.request (
+        std::chrono::duration_cast<std::chrono::microseconds> (
+            std::chrono::steady_clock::now() - start).count(),
+        ok);
+
+    return ok;
+}
+
+/******************************************************************************/
+
+void
+Daemon::serve (int in_, int out_) {
+    auto connection = std::make_shared<Connection> (out_);
+
+    for (;;) {
+        char header[9];
+        if (!readFully (in_, header, sizeof (header))) {
+            break;
+        }
+
+        auto length = getInt (header);
+        auto id = getInt (header + 4);
+        auto op = static_cast<uint8_t>(header[8]);
+
+        if (length < 5 || length > MAX_FRAME) {
+            break;
+        }
+
+        auto payload = std::make_shared<std::string> (length - 5, '\0');
+        if (!readFully (in_, &(*payload)[0], payload->size())) {
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock (connection->mutex);
+            ++connection->outstanding;
+        }
+
+        m_pool.submit ([this, connection, payload, id, op]() {
+            std::string body;
+            auto ok = handle (op, payload->data(), payload->size(), body);
+            connection->respond (id, ok, body);
+        });
+    }
+
+    std::unique_lock<std::mutex> lock (connection->mutex);
+    connection->cv.wait (lock, [&connection]() { return connection->outstanding == 0; });
+}
+
+/******************************************************************************/
+
+void
+Daemon::listen (const std::string & path_) {
+    sockaddr_un addr { };
+    if (path_.size() >= sizeof (addr.sun_path)) {
+        throw std::runtime_error ("Socket path too long: " + path_);
+    }
+
+    addr.sun_family = AF_UNIX;
+    strncpy (addr.sun_path, path_.c_str(), sizeof (addr.sun_path) - 1);
+
+    auto fd = socket (AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error ("Failed to create socket");
+    }
+
+    unlink (path_.c_str());
+
+    if (bind (fd, reinterpret_cast<sockaddr *>(&addr), sizeof (addr)) != 0
+        || ::listen (fd, SOMAXCONN) != 0)
+    {
+        close (fd);
+        throw std::runtime_error ("Failed to listen on " + path_);
+    }
+
+    for (;;) {
+        auto client = accept (fd, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+
+        std::thread ([this, client]() {
+            serve (client, client);
+            close (client);
+        }).detach();
+    }
+}
+
+/******************************************************************************/
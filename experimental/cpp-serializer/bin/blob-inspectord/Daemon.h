@@ -0,0 +1,79 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+
+#include "Metrics.h"
+#include "WorkerPool.h"
+#include "DecoderCache.h"
+
+/******************************************************************************/
+
+class SchemaStore;
+
+/******************************************************************************/
+
+/**
+ * Decodes blobs sent to it over a stream, a Unix domain socket or a pipe,
+ * on a pool of workers sharing a cache of decoders.
+ *
+ * Every integer on the wire is big endian. A request is
+ *
+ *   length (4) | id (4) | op (1) | payload
+ *
+ * where length covers everything after itself, and a response
+ *
+ *   length (4) | id (4) | status (1) | body
+ *
+ * carrying the id of the request it answers. Requests are handled
+ * concurrently so responses can arrive in a different order. The ops are
+ *
+ *   json     payload is a blob, the body its JSON rendering
+ *   project  payload is a count of paths (2), each path as length (2) and
+ *            bytes, followed by a blob. The body is a JSON object of the
+ *            paths and their values
+ *   dump     payload is a blob, the body is as blob-inspector prints it
+ *   metrics  no payload, the body is the daemon's metrics as JSON
+ *
+ * A status of 0 means success, anything else that the body is an error
+ * message.
+ */
+class Daemon {
+    public :
+        enum Op : uint8_t { json_op = 0, project_op = 1, dump_op = 2, metrics_op = 3 };
+
+        static constexpr size_t MAX_FRAME = 64 * 1024 * 1024;
+
+    private :
+        Metrics      m_metrics;
+        DecoderCache m_cache;
+        WorkerPool   m_pool;
+
+    public :
+        Daemon (size_t, SchemaStore *);
+
+        /**
+         * Handle a single request
+         *
+         * @return true on success, false if [out_] is an error message
+         */
+        bool handle (uint8_t, const char *, size_t, std::string & out_);
+
+        /**
+         * Read requests from [in_] until it's closed and write responses
+         * to [out_], returning once every request has been answered
+         */
+        void serve (int in_, int out_);
+
+        /**
+         * Accept connections on a Unix domain socket at [path_], serving
+         * each on its own thread. Never returns.
+         */
+        void listen (const std::string & path_);
+
+        const Metrics & metrics() const { return m_metrics; }
+        DecoderCache & cache() { return m_cache; }
+};
+
+/******************************************************************************/
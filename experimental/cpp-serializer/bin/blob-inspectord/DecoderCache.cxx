@@ -0,0 +1,120 @@
+#include "DecoderCache.h"
+
+#include "Metrics.h"
+#include "SchemaStore.h"
+#include "BlobInspector.h"
+
+#include "probes.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Envelope.h"
+#include "amqp/schema/fingerprint/Fingerprinter.h"
+
+/******************************************************************************
+ *
+ * Decoder
+ *
+ ******************************************************************************/
+
+Decoder::Decoder (
+    std::shared_ptr<const amqp::internal::schema::Envelope> envelope_
+) : envelope (std::move (envelope_))
+  , schema (
+        dynamic_cast<const amqp::internal::schema::Schema &>(envelope->schema()),
+        envelope->descriptor())
+{
+    factory.process (envelope->schema());
+    reader = factory.byDescriptor (envelope->descriptor());
+
+    if (!reader) {
+        throw std::runtime_error ("No reader for " + envelope->descriptor());
+    }
+}
+
+/******************************************************************************
+ *
+ * DecoderCache
+ *
+ ******************************************************************************/
+
+DecoderCache::DecoderCache (Metrics & metrics_, SchemaStore * store_)
+    : m_metrics (metrics_)
+    , m_store (store_)
+{ }
+
+/******************************************************************************/
+
+std::shared_ptr<const Decoder>
+DecoderCache::get (BlobInspector & blob_) {
+    auto descriptor = blob_.descriptor();
+    auto key = blob_.schemaKey();
+
+    {
+        std::shared_lock<std::shared_mutex> lock (m_mutex);
+
+        auto it = m_decoders.find (key);
+        if (it != m_decoders.end()) {
+            m_metrics.hit();
+            PROBE1 (schema__hit, descriptor.c_str());
+            blob_.adopt (it->second->envelope);
+            return it->second;
+        }
+    }
+
+    m_metrics.miss();
+    PROBE1 (schema__miss, descriptor.c_str());
+
+    std::lock_guard<std::mutex> build (m_build);
+
+    // someone may have built it whilst we waited
+    {
+        std::shared_lock<std::shared_mutex> lock (m_mutex);
+
+        auto it = m_decoders.find (key);
+        if (it != m_decoders.end()) {
+            blob_.adopt (it->second->envelope);
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<const amqp::internal::schema::Envelope> envelope;
+
+    if (m_store) {
+        if (auto schema = m_store->get (key)) {
+            envelope = std::make_shared<amqp::internal::schema::Envelope> (
+                schema, descriptor);
+            blob_.adopt (envelope);
+        }
+    }
+
+    /*
+     * Every later blob with this schema will be read by what we build
+     * here without a second look at it, so it had better be the schema
+     * the descriptor is the fingerprint of
+     */
+    if (!envelope) {
+        envelope = blob_.sharedEnvelope();
+        amqp::internal::schema::Fingerprinter (blob_.schema()).verify();
+
+        if (m_store) {
+            m_store->put (key, blob_.schema());
+        }
+    }
+
+    auto decoder = std::make_shared<const Decoder> (envelope);
+
+    std::unique_lock<std::shared_mutex> lock (m_mutex);
+    m_decoders.emplace (key, decoder);
+
+    return decoder;
+}
+
+/******************************************************************************/
+
+size_t
+DecoderCache::size() {
+    std::shared_lock<std::shared_mutex> lock (m_mutex);
+    return m_decoders.size();
+}
+
+/******************************************************************************/
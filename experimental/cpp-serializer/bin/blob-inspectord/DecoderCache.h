@@ -0,0 +1,71 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <shared_mutex>
+
+#include "AvroSchema.h"
+
+#include "amqp/CompositeFactory.h"
+
+/******************************************************************************/
+
+class Metrics;
+class SchemaStore;
+class BlobInspector;
+
+/******************************************************************************/
+
+/**
+ * Everything needed to decode blobs of a single schema, built once and
+ * then shared, read only, between every worker
+ */
+struct Decoder {
+    std::shared_ptr<const amqp::internal::schema::Envelope> envelope;
+
+    AvroSchema schema;
+
+    amqp::internal::CompositeFactory factory;
+    std::shared_ptr<amqp::internal::CompositeFactory::ReaderType> reader;
+
+    explicit Decoder (std::shared_ptr<const amqp::internal::schema::Envelope>);
+};
+
+/******************************************************************************/
+
+/**
+ * Decoders keyed as the SchemaStore keys schemas, on the descriptor of the
+ * blob's top level type and a hash of its schema section, blobs of one
+ * type not always carrying the same schema
+ */
+class DecoderCache {
+    private :
+        Metrics     & m_metrics;
+        SchemaStore * m_store;
+
+        std::shared_mutex m_mutex;
+        std::map<std::string, std::shared_ptr<const Decoder>> m_decoders;
+
+        /**
+         * Serialises building decoders so concurrent misses on the same
+         * schema only build it once, and guards the store
+         */
+        std::mutex m_build;
+
+    public :
+        explicit DecoderCache (Metrics &, SchemaStore * = nullptr);
+
+        /**
+         * Find, or build, the decoder for a blob, leaving the blob using
+         * the decoder's Envelope
+         */
+        std::shared_ptr<const Decoder> get (BlobInspector &);
+
+        size_t size();
+};
+
+/******************************************************************************/
@@ -0,0 +1,73 @@
+#include "Metrics.h"
+
+#include <cstdio>
+
+/******************************************************************************/
+
+Metrics::Metrics()
+    : m_requests (0)
+    , m_errors (0)
+    , m_hits (0)
+    , m_misses (0)
+{
+    for (auto & bucket : m_latency) {
+        bucket = 0;
+    }
+}
+
+/******************************************************************************/
+
+size_t
+Metrics::bucket (uint64_t micros_) {
+    size_t rtn { 0 };
+    while (micros_ && rtn < BUCKETS - 1) {
+        micros_ >>= 1U;
+        ++rtn;
+    }
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+Metrics::request (uint64_t micros_, bool ok_) {
+    ++m_requests;
+    if (!ok_) ++m_errors;
+    ++m_latency[bucket (micros_)];
+}
+
+/******************************************************************************/
+
+double
+Metrics::hitRate() const {
+    auto hits = m_hits.load();
+    auto total = hits + m_misses.load();
+
+    return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+}
+
+/******************************************************************************/
+
+std::string
+Metrics::json() const {
+    char rate[32];
+    snprintf (rate, sizeof (rate), "%.4f", hitRate());
+
+    std::string rtn = R"({"requests":)" + std::to_string (m_requests)
+        + R"(,"errors":)" + std::to_string (m_errors)
+        + R"(,"cache":{"hits":)" + std::to_string (m_hits)
+        + R"(,"misses":)" + std::to_string (m_misses)
+        + R"(,"hitRate":)" + rate
+        + R"(},"latencyUs":[)";
+
+    // each bucket is written as its upper bound and count
+    for (size_t i { 0 } ; i < BUCKETS ; ++i) {
+        if (i) rtn += ",";
+        rtn += "[" + (i == BUCKETS - 1 ? std::string ("null") : std::to_string (1UL << i))
+            + "," + std::to_string (m_latency[i]) + "]";
+    }
+
+    return rtn + "]}";
+}
+
+/******************************************************************************/
@@ -0,0 +1,50 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <string>
+
+/******************************************************************************/
+
+/**
+ * Counters kept by the daemon, all updated without locking. Latencies are
+ * kept as a histogram with power of two microsecond buckets, bucket i
+ * counting requests that took less than 2^i us, the last catching the
+ * rest.
+ */
+class Metrics {
+    public :
+        static constexpr size_t BUCKETS = 24;
+
+    private :
+        std::atomic<uint64_t> m_requests;
+        std::atomic<uint64_t> m_errors;
+        std::atomic<uint64_t> m_hits;
+        std::atomic<uint64_t> m_misses;
+
+        std::array<std::atomic<uint64_t>, BUCKETS> m_latency;
+
+    public :
+        Metrics();
+
+        static size_t bucket (uint64_t);
+
+        void request (uint64_t, bool);
+        void hit() { ++m_hits; }
+        void miss() { ++m_misses; }
+
+        uint64_t requests() const { return m_requests; }
+        uint64_t errors() const { return m_errors; }
+        uint64_t hits() const { return m_hits; }
+        uint64_t misses() const { return m_misses; }
+
+        uint64_t latency (size_t bucket_) const { return m_latency[bucket_]; }
+
+        double hitRate() const;
+
+        std::string json() const;
+};
+
+/******************************************************************************/
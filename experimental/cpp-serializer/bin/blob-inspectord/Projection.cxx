@@ -0,0 +1,132 @@
+#include "Projection.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "proton/proton_wrapper.h"
+
+#include "amqp/util/Json.h"
+
+/******************************************************************************/
+
+Projection::Projection (
+    const AvroSchema & schema_,
+    std::vector<std::string> paths_
+) : m_schema (schema_)
+  , m_paths (std::move (paths_))
+{
+    m_root.node = m_schema.root();
+
+    for (size_t i { 0 } ; i < m_paths.size() ; ++i) {
+        auto * step = &m_root;
+
+        std::stringstream ss (m_paths[i]);
+        std::string name;
+        while (std::getline (ss, name, '.')) {
+            const auto & node = m_schema.nodes()[step->node];
+
+            if (node.kind != AvroSchema::record_t) {
+                throw std::runtime_error (
+                    m_paths[i] + ": " + name + " isn't a field of a composite");
+            }
+
+            size_t field { 0 };
+            while (field < node.fields.size() && node.fields[field].name != name) {
+                ++field;
+            }
+
+            if (field == node.fields.size()) {
+                throw std::runtime_error (
+                    m_paths[i] + ": " + node.name + " has no field " + name);
+            }
+
+            auto & next = step->fields[field];
+            next.node = node.fields[field].node;
+            step = &next;
+        }
+
+        if (step == &m_root) {
+            throw std::runtime_error ("Empty projection");
+        }
+
+        step->output = static_cast<int>(i);
+    }
+}
+
+/******************************************************************************/
+
+std::string
+Projection::json (pn_data_t * data_) const {
+    std::vector<std::string> values (m_paths.size());
+
+    walk (m_root, data_, values);
+
+    std::string rtn { "{" };
+    for (size_t i { 0 } ; i < m_paths.size() ; ++i) {
+        if (i) rtn += ",";
+        amqp::util::jsonString (m_paths[i], rtn);
+        rtn += ":" + values[i];
+    }
+
+    return rtn + "}";
+}
+
+/******************************************************************************/
+
+/**
+ * Expects to be on the composite itself and leaves the cursor there
+ */
+void
+Projection::walk (
+    const Step & step_,
+    pn_data_t * data_,
+    std::vector<std::string> & values_
+) const {
+    if (pn_data_type (data_) == PN_NULL) {
+        nulls (step_, values_);
+        return;
+    }
+
+    proton::is_described (data_);
+    proton::auto_enter ae (data_, true);
+    proton::is_list (data_);
+
+    proton::auto_list_enter ale (data_, true);
+
+    size_t i { 0 };
+    for (const auto & field : step_.fields) {
+        for ( ; i < field.first ; ++i) {
+            pn_data_next (data_);
+        }
+
+        if (!field.second.fields.empty()) {
+            walk (field.second, data_, values_);
+        }
+
+        if (field.second.output >= 0) {
+            // moves us on to the next field
+            m_schema.encodeJson (
+                field.second.node, data_, values_[field.second.output], true);
+        } else {
+            pn_data_next (data_);
+        }
+
+        ++i;
+    }
+}
+
+/******************************************************************************/
+
+void
+Projection::nulls (const Step & step_, std::vector<std::string> & values_) const {
+    for (const auto & field : step_.fields) {
+        if (field.second.output >= 0) {
+            values_[field.second.output] = "null";
+        }
+        nulls (field.second, values_);
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,54 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "AvroSchema.h"
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+/******************************************************************************/
+
+/**
+ * Picks a set of fields, named by dotted paths through nested composites
+ * (e.g. "b.a"), out of a blob without rendering the rest of it.
+ *
+ * The paths are merged into a tree so the blob is walked once however
+ * many are asked for, fields nobody asked for are skipped over whole.
+ */
+class Projection {
+    private :
+        struct Step {
+            size_t                 node;
+            int                    output { -1 };
+            std::map<size_t, Step> fields;
+        };
+
+        const AvroSchema & m_schema;
+
+        std::vector<std::string> m_paths;
+
+        Step m_root;
+
+        void walk (const Step &, pn_data_t *, std::vector<std::string> &) const;
+        void nulls (const Step &, std::vector<std::string> &) const;
+
+    public :
+        /**
+         * @throws std::runtime_error if a path doesn't name a field
+         */
+        Projection (const AvroSchema &, std::vector<std::string>);
+
+        /**
+         * @return a JSON object of the requested paths and their values
+         * for the blob under the cursor
+         */
+        std::string json (pn_data_t *) const;
+};
+
+/******************************************************************************/
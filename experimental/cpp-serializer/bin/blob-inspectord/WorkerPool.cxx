@@ -0,0 +1,62 @@
+#include "WorkerPool.h"
+
+/******************************************************************************/
+
+WorkerPool::WorkerPool (size_t threads_)
+    : m_stopping (false)
+{
+    m_threads.reserve (threads_);
+    for (size_t i { 0 } ; i < threads_ ; ++i) {
+        m_threads.emplace_back (&WorkerPool::run, this);
+    }
+}
+
+/******************************************************************************/
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+
+    for (auto & thread : m_threads) {
+        thread.join();
+    }
+}
+
+/******************************************************************************/
+
+void
+WorkerPool::submit (std::function<void()> work_) {
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_work.push (std::move (work_));
+    }
+    m_cv.notify_one();
+}
+
+/******************************************************************************/
+
+void
+WorkerPool::run() {
+    for (;;) {
+        std::function<void()> work;
+
+        {
+            std::unique_lock<std::mutex> lock (m_mutex);
+            m_cv.wait (lock, [this]() { return m_stopping || !m_work.empty(); });
+
+            if (m_work.empty()) {
+                return;
+            }
+
+            work = std::move (m_work.front());
+            m_work.pop();
+        }
+
+        work();
+    }
+}
+
+/******************************************************************************/
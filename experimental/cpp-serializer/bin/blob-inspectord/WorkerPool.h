@@ -0,0 +1,43 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+/******************************************************************************/
+
+/**
+ * A fixed set of threads pulling work off a shared queue
+ */
+class WorkerPool {
+    private :
+        std::vector<std::thread>          m_threads;
+        std::queue<std::function<void()>> m_work;
+
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;
+        bool                    m_stopping;
+
+        void run();
+
+    public :
+        explicit WorkerPool (size_t);
+
+        /**
+         * Finishes whatever work has already been queued before returning
+         */
+        ~WorkerPool();
+
+        WorkerPool (const WorkerPool &) = delete;
+
+        void submit (std::function<void()>);
+
+        size_t size() const { return m_threads.size(); }
+};
+
+/******************************************************************************/
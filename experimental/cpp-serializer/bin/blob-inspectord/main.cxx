@@ -0,0 +1,85 @@
+#include <thread>
+#include <iostream>
+
+#include <csignal>
+#include <getopt.h>
+#include <unistd.h>
+
+#include "types.h"
+
+#include "Daemon.h"
+#include "SchemaStore.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    usage (const char * name_) {
+        std::cerr
+            << "usage: " << name_ << " [options]" << std::endl
+            << std::endl
+            << "  --socket <path>  listen on a Unix domain socket (default "
+                << "/tmp/blob-inspectord.sock)" << std::endl
+            << "  --stdio          serve a single client over stdin and stdout" << std::endl
+            << "  --threads <n>    number of decoding threads" << std::endl
+            << "  --store <file>   keep the schemas seen in <file> and reuse them" << std::endl;
+    }
+
+}
+
+/******************************************************************************/
+
+int
+main (int argc, char **argv) {
+    static const option options[] = {
+        { "socket",  required_argument, nullptr, 'S' },
+        { "stdio",   no_argument,       nullptr, 'i' },
+        { "threads", required_argument, nullptr, 't' },
+        { "store",   required_argument, nullptr, 's' },
+        { "help",    no_argument,       nullptr, 'h' },
+        { nullptr,   0,                 nullptr, 0 }
+    };
+
+    std::string socket { "/tmp/blob-inspectord.sock" };
+    std::string store;
+    bool stdio { false };
+    size_t threads { std::max (1U, std::thread::hardware_concurrency()) };
+
+    int opt;
+    while ((opt = getopt_long (argc, argv, "S:it:s:h", options, nullptr)) != -1) {
+        switch (opt) {
+            case 'S' : socket = optarg; break;
+            case 'i' : stdio = true; break;
+            case 't' : threads = std::max (1, atoi (optarg)); break;
+            case 's' : store = optarg; break;
+            default  : usage (argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    // a client going away mid response shouldn't take us with it
+    signal (SIGPIPE, SIG_IGN);
+
+    try {
+        uPtr<SchemaStore> schemaStore;
+        if (!store.empty()) {
+            schemaStore = std::make_unique<SchemaStore> (store);
+        }
+
+        Daemon daemon (threads, schemaStore.get());
+
+        if (stdio) {
+            daemon.serve (STDIN_FILENO, STDOUT_FILENO);
+            std::cerr << daemon.metrics().json() << std::endl;
+        } else {
+            daemon.listen (socket);
+        }
+    } catch (const std::runtime_error & e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/******************************************************************************/
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "Daemon.h"
+#include "Metrics.h"
+#include "CordaBytes.h"
+#include "Projection.h"
+#include "BlobInspector.h"
+
+#include "amqp/scanner/Scanner.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    std::string
+    blob (const std::string & file_) {
+        std::ifstream in (filepath + file_, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    std::string
+    projectPayload (const std::vector<std::string> & paths_, const std::string & blob_) {
+        std::string rtn;
+        rtn.push_back (static_cast<char>(paths_.size() >> 8U));
+        rtn.push_back (static_cast<char>(paths_.size() & 0xFFU));
+        for (const auto & path : paths_) {
+            rtn.push_back (static_cast<char>(path.size() >> 8U));
+            rtn.push_back (static_cast<char>(path.size() & 0xFFU));
+            rtn += path;
+        }
+        return rtn + blob_;
+    }
+
+    std::string
+    frame (uint32_t id_, uint8_t op_, const std::string & payload_) {
+        std::string rtn;
+        auto length = static_cast<uint32_t>(payload_.size() + 5);
+        for (int i { 3 } ; i >= 0 ; --i) rtn.push_back (static_cast<char>(length >> (8U * i)));
+        for (int i { 3 } ; i >= 0 ; --i) rtn.push_back (static_cast<char>(id_ >> (8U * i)));
+        rtn.push_back (static_cast<char>(op_));
+        return rtn + payload_;
+    }
+
+    /**
+     * [file_] with its Envelope cut down to the object and its schema
+     */
+    std::string
+    twoSections (const std::string & file_) {
+        using amqp::internal::scanner::Value;
+
+        auto b = blob (file_);
+        Value envelope (b.data() + 8, b.data() + b.size());
+        auto sections = envelope.value().elements();
+
+        std::string list (sections[0].begin(), sections[1].end());
+
+        std::string rtn (b.c_str(), envelope.value().begin());
+        rtn.push_back ('\xc0');
+        rtn.push_back (static_cast<char>(list.size() + 1));
+        rtn.push_back ('\x02');
+
+        return rtn + list;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Metrics, buckets) { // NOLINT
+    ASSERT_EQ (0, Metrics::bucket (0));
+    ASSERT_EQ (1, Metrics::bucket (1));
+    ASSERT_EQ (2, Metrics::bucket (3));
+    ASSERT_EQ (3, Metrics::bucket (4));
+    ASSERT_EQ (Metrics::BUCKETS - 1, Metrics::bucket (~0UL));
+}
+
+/******************************************************************************/
+
+TEST (Daemon, json) { // NOLINT
+    Daemon daemon (1, nullptr);
+    std::string out;
+
+    auto b = blob ("__i_LMis_l__");
+    ASSERT_TRUE (daemon.handle (Daemon::json_op, b.data(), b.size(), out));
+    ASSERT_EQ (
+        R"({"x":[[[1,"two"],[3,"four"],[5,"six"]],[[7,"eight"],[9,"ten"]]],"y":{"x":1000000},"z":{"a":666}})",
+        out);
+}
+
+/******************************************************************************/
+
+TEST (Daemon, dump) { // NOLINT
+    Daemon daemon (1, nullptr);
+    std::string out;
+
+    auto b = blob ("_i_is__");
+    ASSERT_TRUE (daemon.handle (Daemon::dump_op, b.data(), b.size(), out));
+
+    CordaBytes cb (filepath + "_i_is__");
+    BlobInspector bi (cb);
+    ASSERT_EQ (bi.dump(), out);
+}
+
+/******************************************************************************/
+
+TEST (Daemon, project) { // NOLINT
+    Daemon daemon (1, nullptr);
+    std::string out;
+
+    auto b = projectPayload ({ "z.a", "y", "z" }, blob ("__i_LMis_l__"));
+    ASSERT_TRUE (daemon.handle (Daemon::project_op, b.data(), b.size(), out));
+    ASSERT_EQ (R"({"z.a":666,"y":{"x":1000000},"z":{"a":666}})", out);
+
+    b = projectPayload ({ "nope" }, blob ("__i_LMis_l__"));
+    ASSERT_FALSE (daemon.handle (Daemon::project_op, b.data(), b.size(), out));
+}
+
+/******************************************************************************/
+
+TEST (Daemon, cache) { // NOLINT
+    Daemon daemon (1, nullptr);
+    std::string out;
+
+    for (const auto & file : { "_i_", "_i_", "_l_", "_i_" }) {
+        auto b = blob (file);
+        ASSERT_TRUE (daemon.handle (Daemon::json_op, b.data(), b.size(), out));
+    }
+
+    ASSERT_EQ (2, daemon.cache().size());
+    ASSERT_EQ (2, daemon.metrics().hits());
+    ASSERT_EQ (2, daemon.metrics().misses());
+    ASSERT_EQ (4, daemon.metrics().requests());
+
+    ASSERT_FALSE (daemon.handle (Daemon::json_op, "junk", 4, out));
+    ASSERT_EQ (1, daemon.metrics().errors());
+}
+
+/******************************************************************************/
+
+TEST (Daemon, serve) { // NOLINT
+    int fds[2];
+    ASSERT_EQ (0, socketpair (AF_UNIX, SOCK_STREAM, 0, fds));
+
+    Daemon daemon (4, nullptr);
+
+    std::string requests;
+    for (uint32_t i { 0 } ; i < 32 ; ++i) {
+        requests += frame (i, Daemon::json_op, blob (i % 2 ? "_i_" : "_Mis_"));
+    }
+
+    ASSERT_EQ (requests.size(), write (fds[1], requests.data(), requests.size()));
+    shutdown (fds[1], SHUT_WR);
+
+    daemon.serve (fds[0], fds[0]);
+    close (fds[0]);
+
+    std::string responses;
+    char buf[4096];
+    ssize_t got;
+    while ((got = read (fds[1], buf, sizeof (buf))) > 0) {
+        responses.append (buf, got);
+    }
+    close (fds[1]);
+
+    std::vector<bool> seen (32, false);
+    size_t pos { 0 };
+    while (pos < responses.size()) {
+        auto length = (uint8_t (responses[pos + 2]) << 8U) | uint8_t (responses[pos + 3]);
+        auto id = uint8_t (responses[pos + 7]);
+
+        ASSERT_EQ (0, responses[pos + 8]);
+        ASSERT_EQ (
+            std::string (id % 2 ? R"({"a":69})" : R"({"a":[[1,"two"],[3,"four"],[5,"six"]]})"),
+            responses.substr (pos + 9, length - 5));
+
+        seen[id] = true;
+        pos += 4 + length;
+    }
+
+    ASSERT_EQ (std::vector<bool> (32, true), seen);
+}
+
+/******************************************************************************/
+
+/**
+ * Bytes from a client that proton can't decode all of, or an Envelope
+ * missing a section, are errors for that request and nothing more
+ */
+TEST (Daemon, malformed) { // NOLINT
+    Daemon daemon (2, nullptr);
+    std::string out;
+
+    auto two = twoSections ("_i_");
+    ASSERT_FALSE (daemon.handle (Daemon::json_op, two.data(), two.size(), out));
+    ASSERT_EQ ("Malformed Envelope", out);
+
+    auto trailing = blob ("_i_") + std::string ("\xa1\x05" "ab", 4);
+    ASSERT_FALSE (daemon.handle (Daemon::dump_op, trailing.data(), trailing.size(), out));
+
+    int fds[2];
+    ASSERT_EQ (0, socketpair (AF_UNIX, SOCK_STREAM, 0, fds));
+
+    auto requests = frame (0, Daemon::json_op, two)
+        + frame (1, Daemon::dump_op, trailing)
+        + frame (2, Daemon::json_op, blob ("_i_"));
+
+    ASSERT_EQ (requests.size(), write (fds[1], requests.data(), requests.size()));
+    shutdown (fds[1], SHUT_WR);
+
+    daemon.serve (fds[0], fds[0]);
+    close (fds[0]);
+
+    std::string responses;
+    char buf[4096];
+    ssize_t got;
+    while ((got = read (fds[1], buf, sizeof (buf))) > 0) {
+        responses.append (buf, got);
+    }
+    close (fds[1]);
+
+    std::vector<int> status (3, -1);
+    std::string served;
+    size_t pos { 0 };
+    while (pos < responses.size()) {
+        auto length = (uint8_t (responses[pos + 2]) << 8U) | uint8_t (responses[pos + 3]);
+        auto id = uint8_t (responses[pos + 7]);
+
+        status[id] = responses[pos + 8];
+        if (id == 2) {
+            served = responses.substr (pos + 9, length - 5);
+        }
+
+        pos += 4 + length;
+    }
+
+    ASSERT_NE (0, status[0]);
+    ASSERT_NE (0, status[1]);
+    ASSERT_EQ (0, status[2]);
+    ASSERT_EQ (R"({"a":69})", served);
+}
+
+/******************************************************************************/
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <cstddef>
+#include <stdexcept>
+
+#include "CordaBytes.h"
+#include "BlobPack.h"
+
+/******************************************************************************/
+
+/**
+ * Adds blobs to a pack, creating it if it doesn't already exist, for
+ * blob-inspector to then read back in one go. Blobs that can't be read,
+ * or aren't Envelopes, are reported and left out.
+ */
+int
+main (int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <pack> <blob> [<blob> ...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int rtn { EXIT_SUCCESS };
+
+    try {
+        BlobPackWriter pack (argv[1]);
+
+        auto blobs = pack.size();
+        auto schemas = pack.schemas();
+
+        for (int i { 2 } ; i < argc ; ++i) {
+            try {
+                pack.add (CordaBytes (argv[i]));
+            } catch (const std::runtime_error & e) {
+                std::cerr << argv[i] << ": " << e.what() << std::endl;
+                rtn = EXIT_FAILURE;
+            }
+        }
+
+        std::cout << argv[1] << ": added " << pack.size() - blobs << " blobs and "
+            << pack.schemas() - schemas << " schemas, " << pack.size() << " blobs and "
+            << pack.schemas() << " schemas in total" << std::endl;
+
+        pack.close();
+    } catch (const std::runtime_error & e) {
+        std::cerr << argv[1] << ": " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
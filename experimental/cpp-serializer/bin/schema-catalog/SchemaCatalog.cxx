@@ -0,0 +1,320 @@
+#include "SchemaCatalog.h"
+
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <proton/codec.h>
+
+#include "Sha256.h"
+
+#include "amqp/scanner/Scanner.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Restricted.h"
+#include "amqp/schema/descriptors/AMQPDescriptors.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+#include "amqp/util/Json.h"
+
+/******************************************************************************/
+
+namespace {
+
+    /**************************************************************************/
+
+    std::string
+    kind (const amqp::internal::schema::AMQPTypeNotation & type_) {
+        using namespace amqp::internal::schema;
+
+        if (type_.type() == AMQPTypeNotation::composite_t) {
+            return "composite";
+        }
+
+        switch (dynamic_cast<const Restricted &> (type_).restrictedType()) {
+            case Restricted::list_t  : return "list";
+            case Restricted::map_t   : return "map";
+            case Restricted::enum_t  : return "enum";
+            case Restricted::array_t : return "array";
+        }
+
+        return "restricted";
+    }
+
+    /**************************************************************************/
+
+    std::vector<std::string>
+    fields (const amqp::internal::schema::AMQPTypeNotation & type_) {
+        using namespace amqp::internal::schema;
+
+        std::vector<std::string> rtn;
+
+        if (type_.type() == AMQPTypeNotation::composite_t) {
+            for (const auto & field : dynamic_cast<const Composite &> (type_).fields()) {
+                rtn.push_back (field->name() + " : " + field->type()
+                    + (field->mandatory() ? "" : "?"));
+            }
+        } else {
+            const auto & restricted = dynamic_cast<const Restricted &> (type_);
+
+            if (restricted.restrictedType() == Restricted::enum_t) {
+                rtn = dynamic_cast<const Enum &> (restricted).makeChoices();
+            }
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+SchemaCatalog::SchemaCatalog() : m_blobs (0) { }
+
+/******************************************************************************/
+
+std::pair<const char *, const char *>
+SchemaCatalog::schema (const char * begin_, const char * end_) {
+    amqp::internal::scanner::Value envelope (begin_, end_);
+
+    if (!envelope.described() || !envelope.value().list() || envelope.value().count() < 2) {
+        throw std::runtime_error ("Blob does not start with an Envelope");
+    }
+
+    auto schema = envelope.value().next (envelope.value().first());
+
+    return { schema.begin(), schema.end() };
+}
+
+/******************************************************************************/
+
+std::unique_ptr<amqp::internal::schema::Schema>
+SchemaCatalog::decode (const char * begin_, const char * end_) {
+    auto data = pn_data (0);
+    auto size = end_ - begin_;
+
+    try {
+        if (pn_data_decode (data, begin_, size) != static_cast<ssize_t>(size)) {
+            throw std::runtime_error ("Failed to decode schema");
+        }
+
+        pn_data_rewind (data);
+        pn_data_next (data);
+
+        auto rtn = amqp::internal::schema::descriptors::dispatchDescribed<
+            amqp::internal::schema::Schema> (data);
+
+        pn_data_free (data);
+
+        return rtn;
+    } catch (...) {
+        pn_data_free (data);
+        throw;
+    }
+}
+
+/******************************************************************************/
+
+void
+SchemaCatalog::add (const std::string & hash_, Seen seen_) {
+    auto seen = m_schemas.find (hash_);
+
+    if (seen == m_schemas.end()) {
+        m_schemas.emplace (hash_, std::move (seen_));
+        return;
+    }
+
+    seen->second.blobs += seen_.blobs;
+
+    for (const auto & object : seen_.objects) {
+        seen->second.objects[object.first] += object.second;
+    }
+
+    if (seen_.ordinal < seen->second.ordinal) {
+        seen->second.ordinal = seen_.ordinal;
+        seen->second.first = std::move (seen_.first);
+    }
+}
+
+/******************************************************************************/
+
+void
+SchemaCatalog::add (
+    const char * begin_,
+    const char * end_,
+    const std::string & source_,
+    uint64_t ordinal_
+) {
+    amqp::internal::scanner::Value envelope (begin_, end_);
+
+    if (!envelope.described() || !envelope.value().list() || envelope.value().count() < 2) {
+        throw std::runtime_error ("Blob does not start with an Envelope");
+    }
+
+    auto object = envelope.value().first();
+    auto schema = envelope.value().next (object);
+
+    addSchema (
+        schema.begin(), schema.end(), 1,
+        { { std::string (object.descriptor().bytes()), 1 } },
+        source_, ordinal_);
+}
+
+/******************************************************************************/
+
+void
+SchemaCatalog::addSchema (
+    const char * begin_,
+    const char * end_,
+    uint64_t blobs_,
+    const std::map<std::string, uint64_t> & objects_,
+    const std::string & source_,
+    uint64_t ordinal_
+) {
+    auto hash = Sha256::hex (Sha256().update (begin_, end_ - begin_).digest());
+
+    m_blobs += blobs_;
+
+    auto seen = m_schemas.find (hash);
+
+    // don't copy the schema's bytes for every blob that carries it
+    if (seen != m_schemas.end()) {
+        add (hash, Seen { "", blobs_, source_, ordinal_, objects_ });
+    } else {
+        add (hash, Seen { std::string (begin_, end_), blobs_, source_, ordinal_, objects_ });
+    }
+}
+
+/******************************************************************************/
+
+void
+SchemaCatalog::merge (SchemaCatalog & other_) {
+    m_blobs += other_.m_blobs;
+
+    for (auto & schema : other_.m_schemas) {
+        add (schema.first, std::move (schema.second));
+    }
+
+    other_.m_schemas.clear();
+    other_.m_blobs = 0;
+}
+
+/******************************************************************************/
+
+std::map<std::string, std::vector<SchemaCatalog::Version>>
+SchemaCatalog::types() const {
+    std::map<std::string, std::pair<std::string, Version>> versions;
+
+    for (const auto & entry : m_schemas) {
+        const auto & seen = entry.second;
+        auto schema = decode (seen.bytes.data(), seen.bytes.data() + seen.bytes.size());
+
+        for (const auto & types : *schema) {
+            for (const auto & type : types) {
+                auto v = versions.find (type->descriptor());
+
+                if (v == versions.end()) {
+                    Version version;
+                    version.descriptor = type->descriptor();
+                    version.kind = kind (*type);
+                    version.fields = fields (*type);
+                    version.first = seen.first;
+                    version.ordinal = seen.ordinal;
+
+                    v = versions.emplace (
+                        type->descriptor(),
+                        std::make_pair (type->name(), std::move (version))).first;
+                } else if (seen.ordinal < v->second.second.ordinal) {
+                    v->second.second.ordinal = seen.ordinal;
+                    v->second.second.first = seen.first;
+                }
+
+                v->second.second.blobs += seen.blobs;
+
+                auto objects = seen.objects.find (type->descriptor());
+                if (objects != seen.objects.end()) {
+                    v->second.second.objects += objects->second;
+                }
+            }
+        }
+    }
+
+    std::map<std::string, std::vector<Version>> rtn;
+
+    for (auto & version : versions) {
+        rtn[version.second.first].push_back (std::move (version.second.second));
+    }
+
+    for (auto & type : rtn) {
+        std::sort (type.second.begin(), type.second.end(), [](const Version & a_, const Version & b_) {
+            return a_.ordinal < b_.ordinal;
+        });
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+SchemaCatalog::text (std::ostream & out_) const {
+    auto catalogue = types();
+
+    out_ << m_blobs << " blobs, " << m_schemas.size() << " distinct schemas, "
+         << catalogue.size() << " types" << std::endl;
+
+    for (const auto & type : catalogue) {
+        out_ << std::endl << type.first;
+        if (type.second.size() > 1) {
+            out_ << " : " << type.second.size() << " versions";
+        }
+        out_ << std::endl;
+
+        for (size_t i { 0 } ; i < type.second.size() ; ++i) {
+            const auto & v = type.second[i];
+
+            out_ << "  " << i + 1 << ". " << v.descriptor << " " << v.kind
+                 << ", in " << v.blobs << " blobs";
+
+            if (v.objects) {
+                out_ << ", the object of " << v.objects;
+            }
+
+            out_ << ", first in " << v.first << std::endl;
+
+            for (const auto & field : v.fields) {
+                out_ << "       " << field << std::endl;
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
+void
+SchemaCatalog::ndjson (std::ostream & out_) const {
+    for (const auto & type : types()) {
+        for (size_t i { 0 } ; i < type.second.size() ; ++i) {
+            const auto & v = type.second[i];
+
+            out_ << "{\"name\":";
+            amqp::util::jsonString (type.first, out_);
+            out_ << ",\"version\":" << i + 1 << ",\"descriptor\":";
+            amqp::util::jsonString (v.descriptor, out_);
+            out_ << ",\"kind\":\"" << v.kind << "\",\"fields\":[";
+
+            const char * sep = "";
+            for (const auto & field : v.fields) {
+                out_ << sep;
+                amqp::util::jsonString (field, out_);
+                sep = ",";
+            }
+
+            out_ << "],\"blobs\":" << v.blobs << ",\"objects\":" << v.objects << ",\"first\":";
+            amqp::util::jsonString (v.first, out_);
+            out_ << "}" << std::endl;
+        }
+    }
+}
+
+/******************************************************************************/
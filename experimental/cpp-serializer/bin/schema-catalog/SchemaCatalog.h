@@ -0,0 +1,136 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    class Schema;
+
+}
+
+/******************************************************************************/
+
+/**
+ * Every distinct type found in the schemas of a set of blobs, how many
+ * blobs carry each and, where a class has changed over time, each of
+ * its versions in the order they were first seen.
+ *
+ * Only the schema section of each blob is looked at, the payload ahead
+ * of it is hopped over on its size prefix without being read. Blobs
+ * written by the same version of the same code carry byte for byte the
+ * same schema so they're told apart by a hash of those bytes and each
+ * distinct schema is decoded once, however many blobs carry it.
+ */
+class SchemaCatalog {
+    public :
+        /**
+         * One version of a type, as identified by its descriptor
+         */
+        struct Version {
+            std::string descriptor;
+            std::string kind;
+
+            /**
+             * For a composite its fields, as "name : type" with a "?"
+             * after those that may be null, for an enum its constants
+             */
+            std::vector<std::string> fields;
+
+            /**
+             * Blobs whose schema includes it and how many of those it's
+             * the top level type of
+             */
+            uint64_t blobs { 0 };
+            uint64_t objects { 0 };
+
+            /**
+             * Where, and as which of the blobs added, it was first seen
+             */
+            std::string first;
+            uint64_t    ordinal { 0 };
+        };
+
+    private :
+        struct Seen {
+            std::string bytes;
+            uint64_t    blobs;
+            std::string first;
+            uint64_t    ordinal;
+
+            /**
+             * Blobs by the descriptor of the object they carry
+             */
+            std::map<std::string, uint64_t> objects;
+        };
+
+        /**
+         * Distinct schemas by the SHA-256 of their encoding
+         */
+        std::unordered_map<std::string, Seen> m_schemas;
+
+        uint64_t m_blobs;
+
+        void add (const std::string &, Seen);
+
+    public :
+        SchemaCatalog();
+
+        /**
+         * The schema section of a blob's Envelope, left encoded
+         *
+         * @throws std::runtime_error if it isn't an Envelope
+         */
+        static std::pair<const char *, const char *> schema (const char * begin_, const char * end_);
+
+        static std::unique_ptr<amqp::internal::schema::Schema> decode (
+            const char * begin_,
+            const char * end_);
+
+        /**
+         * Catalogue a single blob's schema, [ordinal_] placing it amongst
+         * the rest
+         *
+         * @throws std::runtime_error if it isn't an Envelope
+         */
+        void add (const char * begin_, const char * end_, const std::string & source_, uint64_t ordinal_);
+
+        /**
+         * Catalogue an encoded schema section carried by [blobs_] blobs
+         */
+        void addSchema (
+            const char * begin_,
+            const char * end_,
+            uint64_t blobs_,
+            const std::map<std::string, uint64_t> & objects_,
+            const std::string & source_,
+            uint64_t ordinal_);
+
+        /**
+         * Fold [other_]'s schemas into ours
+         */
+        void merge (SchemaCatalog & other_);
+
+        uint64_t blobs() const { return m_blobs; }
+        size_t schemas() const { return m_schemas.size(); }
+
+        /**
+         * Each type by name, its versions in the order they first
+         * appear. Each distinct schema is decoded here, once.
+         */
+        std::map<std::string, std::vector<Version>> types() const;
+
+        void text (std::ostream &) const;
+        void ndjson (std::ostream &) const;
+};
+
+/******************************************************************************/
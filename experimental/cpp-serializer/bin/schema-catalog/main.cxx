@@ -0,0 +1,259 @@
+#include <memory>
+#include <functional>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "BlobPack.h"
+#include "SchemaCatalog.h"
+
+#include "amqp/AMQPHeader.h"
+#include "amqp/AMQPSectionId.h"
+#include "amqp/schema/diff/SchemaDiff.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/util/Parallel.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    usage (const char * name_) {
+        std::cerr
+            << "usage: " << name_ << " [options] <blob|pack> [<blob|pack> ...]" << std::endl
+            << std::endl
+            << "       " << name_ << " --diff <blob> <blob>" << std::endl
+            << std::endl
+            << "  --diff         list what changed between the schemas of two blobs," << std::endl
+            << "                 exiting 1 if anything did and 2 on error" << std::endl
+            << "  --ndjson       write a JSON object per version of each type" << std::endl
+            << "  --threads <n>  scan the blobs across <n> threads" << std::endl;
+    }
+
+    /**
+     * Map the blob and hand [fn_] its envelope. Only the pages holding
+     * the envelope's list header and its schema are ever read by what
+     * we do with it, the payload is hopped over
+     */
+    void
+    mapped (const char * path_, const std::function<void (const char *, const char *)> & fn_) {
+        int fd = open (path_, O_RDONLY);
+        struct stat results { };
+
+        if (fd < 0 || fstat (fd, &results) != 0) {
+            if (fd >= 0) close (fd);
+            throw std::runtime_error ("no such file");
+        }
+
+        auto size = static_cast<size_t>(results.st_size);
+        auto headerSize = amqp::AMQP_HEADER.size() + 1;
+
+        if (size < headerSize) {
+            close (fd);
+            throw std::runtime_error ("Bad Header in blob");
+        }
+
+        auto map = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close (fd);
+
+        if (map == MAP_FAILED) {
+            throw std::runtime_error ("can't map file");
+        }
+
+        auto blob = static_cast<const char *>(map);
+
+        try {
+            if (!std::equal (amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end(), blob)) {
+                throw std::runtime_error ("Bad Header in blob");
+            }
+
+            if (static_cast<amqp::amqp_section_id_t>(blob[amqp::AMQP_HEADER.size()])
+                    != amqp::DATA_AND_STOP)
+            {
+                throw std::runtime_error ("BAD ENCODING");
+            }
+
+            fn_ (blob + headerSize, blob + size);
+        } catch (...) {
+            munmap (map, size);
+            throw;
+        }
+
+        munmap (map, size);
+    }
+
+    void
+    catalogue (SchemaCatalog & catalog_, const char * path_, uint64_t ordinal_) {
+        mapped (path_, [&](const char * begin_, const char * end_) {
+            catalog_.add (begin_, end_, path_, ordinal_);
+        });
+    }
+
+    /**
+     * A pack's schemas are already distinct, each is catalogued once
+     * with the count of the blobs using it
+     */
+    void
+    catalogue (SchemaCatalog & catalog_, const BlobPack & pack_, const std::string & path_, uint64_t ordinal_) {
+        std::vector<uint64_t> blobs (pack_.schemas().size());
+
+        for (size_t i { 0 } ; i < pack_.size() ; ++i) {
+            ++blobs[pack_.entry (i).schema];
+        }
+
+        for (size_t i { 0 } ; i < blobs.size() ; ++i) {
+            if (!blobs[i]) {
+                continue;
+            }
+
+            auto schema = pack_.schema (i);
+
+            catalog_.addSchema (
+                schema.data(), schema.data() + schema.size(), blobs[i],
+                { { pack_.schemas()[i].descriptor, blobs[i] } },
+                path_, ordinal_);
+        }
+    }
+
+    /**
+     * Compares the blobs' schemas through their Merkle trees so only the
+     * types that differ are ever looked at
+     */
+    int
+    diff (const char * from_, const char * to_) {
+        using namespace amqp::internal::schema;
+
+        std::unique_ptr<Schema> schemas[2];
+        const char * paths[2] { from_, to_ };
+
+        for (int i { 0 } ; i < 2 ; ++i) {
+            if (BlobPack::isPack (paths[i])) {
+                throw std::runtime_error (
+                    std::string (paths[i]) + ": a pack holds more than one schema");
+            }
+
+            mapped (paths[i], [&](const char * begin_, const char * end_) {
+                auto schema = SchemaCatalog::schema (begin_, end_);
+                schemas[i] = SchemaCatalog::decode (schema.first, schema.second);
+            });
+        }
+
+        MerkleSchema from (*schemas[0]);
+        MerkleSchema to (*schemas[1]);
+
+        SchemaDiff diff (from, to);
+
+        for (const auto & change : diff.changes()) {
+            std::cout << change << std::endl;
+        }
+
+        return diff.empty() ? EXIT_SUCCESS : 1;
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * Lists every type carried by a set of blobs, or packs of them, and the
+ * versions of each. See [SchemaCatalog]
+ */
+int
+main (int argc, char **argv) {
+    static const option options[] = {
+        { "diff",    no_argument,       nullptr, 'd' },
+        { "ndjson",  no_argument,       nullptr, 'n' },
+        { "threads", required_argument, nullptr, 't' },
+        { "help",    no_argument,       nullptr, 'h' },
+        { nullptr,   0,                 nullptr, 0 }
+    };
+
+    bool diff { false };
+    bool ndjson { false };
+    size_t threads { 1 };
+
+    int opt;
+    while ((opt = getopt_long (argc, argv, "dnt:h", options, nullptr)) != -1) {
+        switch (opt) {
+            case 'd' : diff = true; break;
+            case 'n' : ndjson = true; break;
+            case 't' : threads = std::max (1, atoi (optarg)); break;
+            default  : usage (argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    if (optind == argc) {
+        usage (argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (diff) {
+        if (argc - optind != 2) {
+            usage (argv[0]);
+            return 2;
+        }
+
+        try {
+            return ::diff (argv[optind], argv[optind + 1]);
+        } catch (const std::runtime_error & e) {
+            std::cerr << e.what() << std::endl;
+            return 2;
+        }
+    }
+
+    size_t inputs = argc - optind;
+    auto chunks = amqp::util::chunks (inputs, threads);
+
+    std::vector<SchemaCatalog> catalogs (chunks);
+    std::vector<int> failed (chunks, 0);
+
+    /*
+     * The ordinal of each blob is its position on the command line so
+     * however the work is split the versions of a type come out in the
+     * order given
+     */
+    amqp::util::parallel (inputs, threads, [&](size_t chunk_, size_t begin_, size_t end_) {
+        for (auto j = begin_ ; j < end_ ; ++j) {
+            const char * path = argv[optind + j];
+
+            try {
+                if (BlobPack::isPack (path)) {
+                    BlobPack pack (path);
+                    catalogue (catalogs[chunk_], pack, path, j);
+                } else {
+                    catalogue (catalogs[chunk_], path, j);
+                }
+            } catch (const std::runtime_error & e) {
+                std::cerr << std::string (path) + ": " + e.what() + "\n";
+                failed[chunk_] = 1;
+            }
+        }
+    });
+
+    for (size_t i { 1 } ; i < chunks ; ++i) {
+        catalogs[0].merge (catalogs[i]);
+    }
+
+    try {
+        if (ndjson) {
+            catalogs[0].ndjson (std::cout);
+        } else {
+            catalogs[0].text (std::cout);
+        }
+    } catch (const std::runtime_error & e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return std::count (failed.begin(), failed.end(), 1) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/******************************************************************************/
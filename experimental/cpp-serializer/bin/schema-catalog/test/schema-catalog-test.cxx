@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <unistd.h>
+
+#include "BlobPack.h"
+#include "CordaBytes.h"
+#include "SchemaCatalog.h"
+
+#include "amqp/AMQPHeader.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    void
+    add (SchemaCatalog & catalog_, const std::string & blob_, uint64_t ordinal_) {
+        std::ifstream in (filepath + blob_, std::ios::binary);
+        std::string bytes ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char>());
+
+        auto skip = amqp::AMQP_HEADER.size() + 1;
+        catalog_.add (bytes.data() + skip, bytes.data() + bytes.size(), blob_, ordinal_);
+    }
+
+    std::string
+    text (const SchemaCatalog & catalog_) {
+        std::stringstream ss;
+        catalog_.text (ss);
+
+        return ss.str();
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (SchemaCatalog, dedupe) { // NOLINT
+    SchemaCatalog catalog;
+
+    add (catalog, "_i_", 0);
+    add (catalog, "_Oi_", 1);
+    add (catalog, "_i_", 2);
+    add (catalog, "_i_is__", 3);
+
+    ASSERT_EQ (4, catalog.blobs());
+    ASSERT_EQ (3, catalog.schemas());
+
+    auto types = catalog.types();
+
+    ASSERT_EQ (1, types.count ("net.corda.blobwriter._i_"));
+
+    const auto & versions = types["net.corda.blobwriter._i_"];
+    ASSERT_EQ (1, versions.size());
+
+    const auto & v = versions.front();
+    ASSERT_EQ ("composite", v.kind);
+    ASSERT_EQ (std::vector<std::string> { "a : int" }, v.fields);
+    ASSERT_EQ (2, v.blobs);
+    ASSERT_EQ (2, v.objects);
+    ASSERT_EQ ("_i_", v.first);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCatalog, badEnvelope) { // NOLINT
+    SchemaCatalog catalog;
+    const char bytes[] = { 0x40 };
+
+    EXPECT_THROW ( // NOLINT
+        catalog.add (bytes, bytes + sizeof (bytes), "null", 0),
+        std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCatalog, merge) { // NOLINT
+    const std::vector<std::string> blobs {
+        "_i_", "_Oi_", "_Mis_", "_i_", "_Le_", "_i_is__", "_Pls_"
+    };
+
+    SchemaCatalog whole;
+    SchemaCatalog left;
+    SchemaCatalog right;
+
+    for (size_t i { 0 } ; i < blobs.size() ; ++i) {
+        add (whole, blobs[i], i);
+        add (i < blobs.size() / 2 ? left : right, blobs[i], i);
+    }
+
+    /*
+     * Merged the other way round so the first sighting has to come
+     * from the ordinals rather than the order of merging
+     */
+    right.merge (left);
+
+    ASSERT_EQ (0, left.blobs());
+    ASSERT_EQ (whole.blobs(), right.blobs());
+    ASSERT_EQ (whole.schemas(), right.schemas());
+    ASSERT_EQ (text (whole), text (right));
+}
+
+/******************************************************************************/
+
+TEST (SchemaCatalog, pack) { // NOLINT
+    const std::vector<std::string> blobs { "_i_", "_Oi_", "_i_", "_i_is__" };
+
+    auto path = "schema-catalog-test." + std::to_string (getpid());
+    std::remove (path.c_str());
+
+    SchemaCatalog single;
+
+    {
+        BlobPackWriter writer (path);
+
+        for (size_t i { 0 } ; i < blobs.size() ; ++i) {
+            writer.add (CordaBytes (filepath + blobs[i]));
+            add (single, blobs[i], 0);
+        }
+
+        writer.close();
+    }
+
+    BlobPack pack (path);
+    SchemaCatalog packed;
+
+    std::vector<uint64_t> counts (pack.schemas().size());
+    for (size_t i { 0 } ; i < pack.size() ; ++i) {
+        ++counts[pack.entry (i).schema];
+    }
+
+    for (size_t i { 0 } ; i < counts.size() ; ++i) {
+        auto schema = pack.schema (i);
+
+        packed.addSchema (
+            schema.data(), schema.data() + schema.size(), counts[i],
+            { { pack.schemas()[i].descriptor, counts[i] } }, path, 0);
+    }
+
+    std::remove (path.c_str());
+
+    ASSERT_EQ (single.blobs(), packed.blobs());
+    ASSERT_EQ (single.schemas(), packed.schemas());
+
+    auto expected = single.types();
+    auto actual = packed.types();
+
+    ASSERT_EQ (expected.size(), actual.size());
+
+    for (const auto & type : expected) {
+        ASSERT_EQ (type.second.size(), actual[type.first].size()) << type.first;
+
+        for (size_t i { 0 } ; i < type.second.size() ; ++i) {
+            ASSERT_EQ (type.second[i].fields, actual[type.first][i].fields);
+            ASSERT_EQ (type.second[i].blobs, actual[type.first][i].blobs);
+            ASSERT_EQ (type.second[i].objects, actual[type.first][i].objects);
+        }
+    }
+}
+
+/******************************************************************************/
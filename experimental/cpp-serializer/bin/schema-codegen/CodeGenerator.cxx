@@ -0,0 +1,325 @@
+#include "CodeGenerator.h"
+
+#include <ostream>
+#include <stdexcept>
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Map.h"
+#include "amqp/schema/restricted-types/List.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Array.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::map<std::string, std::string> primitives = { // NOLINT
+        { "boolean", "bool" },
+        { "bool",    "bool" },
+        { "int",     "int32_t" },
+        { "long",    "int64_t" },
+        { "double",  "double" },
+        { "string",  "std::string" }
+    };
+
+    const std::set<std::string> keywords = { // NOLINT
+        "alignas", "alignof", "and", "asm", "auto", "bool", "break", "case",
+        "catch", "char", "class", "const", "constexpr", "continue", "default",
+        "delete", "do", "double", "else", "enum", "explicit", "export",
+        "extern", "false", "float", "for", "friend", "goto", "if", "inline",
+        "int", "long", "mutable", "namespace", "new", "noexcept", "not",
+        "nullptr", "operator", "or", "private", "protected", "public",
+        "register", "return", "short", "signed", "sizeof", "static",
+        "struct", "switch", "template", "this", "throw", "true", "try",
+        "typedef", "typeid", "typename", "union", "unsigned", "using",
+        "virtual", "void", "volatile", "while", "xor"
+    };
+
+    std::string
+    quoted (const std::string & str_) {
+        std::string rtn { "\"" };
+        for (auto c : str_) {
+            if (c == '"' || c == '\\') rtn.push_back ('\\');
+            rtn.push_back (c);
+        }
+        rtn.push_back ('"');
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * CodeGenerator statics
+ *
+ ******************************************************************************/
+
+std::string
+CodeGenerator::sanitise (const std::string & name_) {
+    std::string rtn;
+    rtn.reserve (name_.size() + 1);
+
+    if (name_.empty() || isdigit (name_.front())) rtn.push_back ('_');
+
+    for (auto c : name_) {
+        rtn.push_back ((isalnum (c) || c == '_') ? c : '_');
+    }
+
+    if (keywords.count (rtn)) rtn.push_back ('_');
+
+    return rtn;
+}
+
+/******************************************************************************
+ *
+ * CodeGenerator
+ *
+ ******************************************************************************/
+
+CodeGenerator::CodeGenerator (std::string namespace_)
+    : m_namespace (std::move (namespace_))
+{ }
+
+/******************************************************************************/
+
+/**
+ * Java class names lose their package, and inner classes their outer
+ * class, unless that leaves them clashing with one we already have
+ */
+std::string
+CodeGenerator::identifier (const std::string & name_) {
+    auto rtn = sanitise (name_.substr (name_.find_last_of (".$") + 1));
+
+    if (m_identifiers.count (rtn)) {
+        auto base = rtn;
+        for (int i { 2 } ; m_identifiers.count (rtn) ; ++i) {
+            rtn = base + "_" + std::to_string (i);
+        }
+    }
+
+    m_identifiers.insert (rtn);
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+CodeGenerator::add (const amqp::internal::schema::Schema & schema_) {
+    TypeMap types;
+
+    for (const auto & level : schema_) {
+        for (const auto & type : level) {
+            types[type->name()] = type.get();
+        }
+    }
+
+    Resolved resolved;
+
+    for (const auto & type : types) {
+        this->type (type.first, types, resolved);
+    }
+}
+
+/******************************************************************************/
+
+std::string
+CodeGenerator::type (
+    const std::string & type_,
+    const TypeMap & types_,
+    Resolved & resolved_
+) {
+    auto known = resolved_.find (type_);
+    if (known != resolved_.end()) {
+        if (known->second.empty()) {
+            throw std::runtime_error (type_ + " contains itself");
+        }
+        return known->second;
+    }
+
+    auto prim = primitives.find (type_);
+    if (prim != primitives.end()) {
+        return prim->second;
+    }
+
+    auto it = types_.find (type_);
+    if (it == types_.end()) {
+        throw std::runtime_error ("Unknown type " + type_);
+    }
+
+    // a struct can't hold itself by value so mark that we're working on
+    // this one to catch any type that would
+    resolved_[type_];
+
+    switch (it->second->type()) {
+        case amqp::internal::schema::AMQPTypeNotation::composite_t :
+            return resolved_[type_] = composite (*it->second, types_, resolved_);
+        case amqp::internal::schema::AMQPTypeNotation::restricted_t :
+            return resolved_[type_] = restricted (*it->second, types_, resolved_);
+    }
+
+    throw std::runtime_error ("Unknown type notation for " + type_);
+}
+
+/******************************************************************************/
+
+std::string
+CodeGenerator::composite (
+    const amqp::internal::schema::AMQPTypeNotation & type_,
+    const TypeMap & types_,
+    Resolved & resolved_
+) {
+    auto done = m_byDescriptor.find (type_.descriptor());
+    if (done != m_byDescriptor.end()) {
+        return done->second;
+    }
+
+    const auto & composite = dynamic_cast<const amqp::internal::schema::Composite &>(type_);
+
+    std::vector<std::pair<std::string, std::string>> fields;
+    fields.reserve (composite.fields().size());
+
+    for (const auto & field : composite.fields()) {
+        auto cpp = type (field->resolvedType(), types_, resolved_);
+
+        fields.emplace_back (
+            sanitise (field->name()),
+            field->mandatory() ? cpp : "std::optional<" + cpp + ">");
+    }
+
+    auto name = identifier (type_.name());
+    auto qualified = m_namespace + "::" + name;
+
+    m_types += "\n    /**\n     * " + type_.name() + "\n     */\n";
+    m_types += "    struct " + name + " {\n";
+    for (const auto & field : fields) {
+        m_types += "        " + field.second + " " + field.first + ";\n";
+    }
+    m_types += "    };\n";
+
+    m_decoders += "\n    template<>\n";
+    m_decoders += "    struct Decoder<" + qualified + "> {\n";
+    m_decoders += "        static constexpr std::string_view descriptor { "
+        + quoted (type_.descriptor()) + " };\n\n";
+    m_decoders += "        static " + qualified + " decode (const Value & value_) {\n";
+    m_decoders += "            " + qualified + " rtn;\n";
+
+    if (!fields.empty()) {
+        m_decoders += "            auto fields = composite (value_, descriptor, "
+            + std::to_string (fields.size()) + ");\n\n";
+
+        for (size_t i { 0 } ; i < fields.size() ; ++i) {
+            m_decoders += i == 0
+                ? "            auto field = fields.first();\n"
+                : "            field = fields.next (field);\n";
+            m_decoders += "            rtn." + fields[i].first + " = Decoder<"
+                + fields[i].second + ">::decode (field);\n";
+        }
+    } else {
+        m_decoders += "            composite (value_, descriptor, 0);\n";
+    }
+
+    m_decoders += "\n            return rtn;\n";
+    m_decoders += "        }\n";
+    m_decoders += "    };\n";
+
+    return m_byDescriptor[type_.descriptor()] = qualified;
+}
+
+/******************************************************************************/
+
+std::string
+CodeGenerator::restricted (
+    const amqp::internal::schema::AMQPTypeNotation & type_,
+    const TypeMap & types_,
+    Resolved & resolved_
+) {
+    using namespace amqp::internal::schema;
+
+    const auto & restricted = dynamic_cast<const Restricted &>(type_);
+
+    switch (restricted.restrictedType()) {
+        case Restricted::RestrictedTypes::list_t :
+            return "std::vector<" + type (
+                dynamic_cast<const List &>(restricted).listOf(), types_, resolved_) + ">";
+        case Restricted::RestrictedTypes::array_t :
+            return "std::vector<" + type (
+                dynamic_cast<const Array &>(restricted).arrayOf(), types_, resolved_) + ">";
+        case Restricted::RestrictedTypes::map_t : {
+            auto types = dynamic_cast<const Map &>(restricted).mapOf();
+            auto key = type (types.first, types_, resolved_);
+            return "std::map<" + key + ", " + type (types.second, types_, resolved_) + ">";
+        }
+        case Restricted::RestrictedTypes::enum_t :
+            break;
+    }
+
+    auto done = m_byDescriptor.find (type_.descriptor());
+    if (done != m_byDescriptor.end()) {
+        return done->second;
+    }
+
+    auto name = identifier (type_.name());
+    auto qualified = m_namespace + "::" + name;
+
+    m_types += "\n    /**\n     * " + type_.name() + "\n     */\n";
+    m_types += "    enum class " + name + " : int32_t {\n";
+
+    auto choices = dynamic_cast<const Enum &>(restricted).makeChoices();
+    for (size_t i { 0 } ; i < choices.size() ; ++i) {
+        m_types += "        " + sanitise (choices[i]) + " = " + std::to_string (i)
+            + (i + 1 < choices.size() ? ",\n" : "\n");
+    }
+    m_types += "    };\n";
+
+    m_decoders += "\n    template<>\n";
+    m_decoders += "    struct Decoder<" + qualified + "> {\n";
+    m_decoders += "        static constexpr std::string_view descriptor { "
+        + quoted (type_.descriptor()) + " };\n\n";
+    m_decoders += "        static " + qualified + " decode (const Value & value_) {\n";
+    m_decoders += "            return static_cast<" + qualified
+        + ">(ordinal (value_, descriptor));\n";
+    m_decoders += "        }\n";
+    m_decoders += "    };\n";
+
+    return m_byDescriptor[type_.descriptor()] = qualified;
+}
+
+/******************************************************************************/
+
+void
+CodeGenerator::write (std::ostream & out_) const {
+    out_
+        << "#pragma once\n"
+        << "\n"
+        << "/*\n"
+        << " * Generated by schema-codegen, don't edit\n"
+        << " */\n"
+        << "\n"
+        << "#include <map>\n"
+        << "#include <string>\n"
+        << "#include <vector>\n"
+        << "#include <cstdint>\n"
+        << "#include <optional>\n"
+        << "#include <string_view>\n"
+        << "\n"
+        << "#include \"amqp/codegen/Decoder.h\"\n"
+        << "\n"
+        << "/******************************************************************************/\n"
+        << "\n"
+        << "namespace " << m_namespace << " {\n"
+        << m_types
+        << "\n}\n"
+        << "\n"
+        << "/******************************************************************************/\n"
+        << "\n"
+        << "namespace amqp::codegen {\n"
+        << m_decoders
+        << "\n}\n"
+        << "\n"
+        << "/******************************************************************************/\n";
+}
+
+/******************************************************************************/
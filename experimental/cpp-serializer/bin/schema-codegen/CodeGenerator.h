@@ -0,0 +1,86 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <set>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace amqp::internal::schema {
+
+    class Schema;
+    class AMQPTypeNotation;
+
+}
+
+/******************************************************************************/
+
+/**
+ * Writes a C++ header declaring a type for every type found in the
+ * schemas of the blobs it's given, along with a specialisation of
+ * amqp::codegen::Decoder for each that reads it straight from a blob's
+ * bytes. The mapping is
+ *
+ *   Composite        -> struct
+ *   List / Array     -> std::vector
+ *   Map              -> std::map
+ *   Enum             -> enum class, with the constants' ordinals
+ *   non mandatory    -> std::optional
+ *
+ * Each generated decoder knows its type's fields, their order and their
+ * types at compile time so reading an object is a straight run of calls
+ * with nothing looked up. A composite's decoder is keyed on the
+ * descriptor, the fingerprint of the type, it was generated from and
+ * refuses anything else.
+ *
+ * Types are recognised across blobs by their descriptor. Should two
+ * blobs hold different versions of the same class each gets a struct of
+ * its own, the later suffixed with a number.
+ */
+class CodeGenerator {
+    private :
+        std::string m_namespace;
+
+        using TypeMap = std::map<std::string, const amqp::internal::schema::AMQPTypeNotation *>;
+
+        /**
+         * The C++ type of each Corda type, by name, of the schema being
+         * added
+         */
+        using Resolved = std::map<std::string, std::string>;
+
+        /**
+         * The C++ type already generated for each descriptor
+         */
+        std::map<std::string, std::string> m_byDescriptor;
+
+        std::set<std::string> m_identifiers;
+
+        std::string m_types;
+        std::string m_decoders;
+
+        std::string type (const std::string &, const TypeMap &, Resolved &);
+        std::string composite (const amqp::internal::schema::AMQPTypeNotation &, const TypeMap &, Resolved &);
+        std::string restricted (const amqp::internal::schema::AMQPTypeNotation &, const TypeMap &, Resolved &);
+
+        std::string identifier (const std::string &);
+
+    public :
+        explicit CodeGenerator (std::string namespace_);
+
+        /**
+         * Generate whatever's not been seen before in [schema_]
+         */
+        void add (const amqp::internal::schema::Schema & schema_);
+
+        void write (std::ostream &) const;
+
+        /**
+         * Something usable as a C++ name made from a Java one
+         */
+        static std::string sanitise (const std::string &);
+};
+
+/******************************************************************************/
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+
+#include <getopt.h>
+#include <sys/stat.h>
+
+#include "CordaBytes.h"
+#include "BlobInspector.h"
+#include "CodeGenerator.h"
+
+#include "amqp/schema/described-types/Schema.h"
+
+/******************************************************************************/
+
+namespace {
+
+    void
+    usage (const char * name_) {
+        std::cerr
+            << "usage: " << name_ << " [options] <blob> [<blob> ...]" << std::endl
+            << std::endl
+            << "  --namespace <ns>  put the generated types in <ns>, by default corda" << std::endl
+            << "  --output <file>   write the header to <file> rather than stdout" << std::endl;
+    }
+
+}
+
+/******************************************************************************/
+
+/**
+ * Generates C++ types, and decoders for them, from the schemas carried
+ * by a set of blobs. See [CodeGenerator]
+ */
+int
+main (int argc, char **argv) {
+    static const option options[] = {
+        { "namespace", required_argument, nullptr, 'n' },
+        { "output",    required_argument, nullptr, 'o' },
+        { "help",      no_argument,       nullptr, 'h' },
+        { nullptr,     0,                 nullptr, 0 }
+    };
+
+    std::string ns { "corda" };
+    std::string output;
+
+    int opt;
+    while ((opt = getopt_long (argc, argv, "n:o:h", options, nullptr)) != -1) {
+        switch (opt) {
+            case 'n' : ns = optarg; break;
+            case 'o' : output = optarg; break;
+            default  : usage (argv[0]); return EXIT_FAILURE;
+        }
+    }
+
+    if (optind == argc) {
+        usage (argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    CodeGenerator generator (ns);
+
+    for (int i { optind } ; i < argc ; ++i) {
+        struct stat results { };
+
+        if (stat (argv[i], &results) != 0) {
+            std::cerr << argv[i] << ": no such file" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        try {
+            CordaBytes cb (argv[i]);
+            BlobInspector blobInspector (cb);
+
+            generator.add (blobInspector.schema());
+        } catch (const std::runtime_error & e) {
+            std::cerr << argv[i] << ": " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (output.empty()) {
+        generator.write (std::cout);
+    } else {
+        std::ofstream out (output);
+        generator.write (out);
+
+        if (!out) {
+            std::cerr << output << ": can't write" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/******************************************************************************/
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "CordaBytes.h"
+
+#include "Generated.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const std::string filepath ("../../test-files/"); // NOLINT
+
+    template<typename T>
+    T
+    decode (const std::string & file_) {
+        CordaBytes cb (filepath + file_);
+
+        return amqp::codegen::decode<T> (cb.bytes(), cb.bytes() + cb.size());
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (SchemaCodegen, composite) { // NOLINT
+    auto val = decode<generated::_i_is__> ("_i_is__");
+
+    ASSERT_EQ (1, val.a);
+    ASSERT_EQ (2, val.b.a);
+    ASSERT_EQ ("three", val.b.b);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCodegen, list) { // NOLINT
+    auto val = decode<generated::_Li_> ("_Li_");
+
+    ASSERT_EQ ((std::vector<int32_t> { 1, 2, 3, 4, 5, 6 }), val.a);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCodegen, map) { // NOLINT
+    auto val = decode<generated::_Mis_> ("_Mis_");
+
+    ASSERT_EQ (
+        (std::map<int32_t, std::string> { { 1, "two" }, { 3, "four" }, { 5, "six" } }),
+        val.a);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCodegen, enumeration) { // NOLINT
+    auto val = decode<generated::_e_> ("_e_");
+
+    ASSERT_EQ (generated::E::A, val.e);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCodegen, arrayOfLists) { // NOLINT
+    auto val = decode<generated::_ALd_> ("_ALd_");
+
+    ASSERT_EQ (3, val.a.size());
+    ASSERT_EQ ((std::vector<double> { 10.1, 11.2, 12.3 }), val.a[0]);
+    ASSERT_TRUE (val.a[1].empty());
+    ASSERT_EQ ((std::vector<double> { 13.4 }), val.a[2]);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCodegen, nested) { // NOLINT
+    auto val = decode<generated::__i_LMis_l__> ("__i_LMis_l__");
+
+    ASSERT_EQ (2, val.x.size());
+    ASSERT_EQ (3, val.x[0].size());
+    ASSERT_EQ ("ten", val.x[1].at (9));
+    ASSERT_EQ (1000000, val.y.x);
+    ASSERT_EQ (666, val.z.a);
+}
+
+/******************************************************************************/
+
+TEST (SchemaCodegen, wrongType) { // NOLINT
+    EXPECT_THROW (decode<generated::_Li_> ("_i_is__"), std::runtime_error);
+    EXPECT_THROW (decode<generated::_i_> ("_l_"), std::runtime_error);
+}
+
+/******************************************************************************/
@@ -1,91 +1,86 @@
 #include <iostream>
-#include <iomanip>
-#include <fstream>
 #include <cstddef>
+#include <algorithm>
+#include <stdexcept>
 
-#include <assert.h>
-#include <string.h>
-#include <proton/types.h>
-#include <proton/codec.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
-#include <sstream>
-
-#include "debug.h"
-
-#include "proton/proton_wrapper.h"
 
 #include "amqp/AMQPHeader.h"
 #include "amqp/AMQPSectionId.h"
-#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
 
-#include "amqp/schema/described-types/Envelope.h"
-#include "amqp/CompositeFactory.h"
+#include "amqp/scanner/BufferedWriter.h"
+#include "amqp/scanner/StructureDumper.h"
 
 /******************************************************************************/
 
-void
-printNode (pn_data_t * d_) {
-    std::stringstream ss;
-
-    if (pn_data_is_described (d_)) {
-        amqp::internal::AMQPDescriptorRegistory[22UL]->read (d_, ss);
+/**
+ * Dumps the structure of a blob straight from the file. It's mapped
+ * rather than read so blobs far larger than memory can be looked at,
+ * and nothing about the blob's schema is assumed so it'll get as far
+ * as it can through ones that are broken.
+ */
+int
+main (int argc, char **argv) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <blob>" << std::endl;
+        return EXIT_FAILURE;
     }
 
-    std::cout << ss.str() << std::endl;
-}
-
-
-/******************************************************************************/
-
-void
-data_and_stop(std::ifstream & f_, ssize_t sz) {
-    char * blob = new char[sz];
-    memset (blob, 0, sz);
-    f_.read(blob, sz);
-
-    pn_data_t * d = pn_data(sz);
-
-    // returns how many bytes we processed which right now we don't care
-    // about but I assume there is a case where it doesn't process the
-    // entire file
-    auto rtn = pn_data_decode (d, blob, sz);
-    assert (rtn == sz);
+    int fd = open (argv[1], O_RDONLY);
+    struct stat results { };
 
-    printNode (d);
+    if (fd < 0 || fstat (fd, &results) != 0) {
+        std::cerr << argv[1] << ": no such file" << std::endl;
+        return EXIT_FAILURE;
+    }
 
-}
+    auto size = static_cast<size_t>(results.st_size);
+    auto headerSize = amqp::AMQP_HEADER.size() + 1;
 
-/******************************************************************************/
+    if (size < headerSize) {
+        std::cerr << "Bad Header in blob" << std::endl;
+        return EXIT_FAILURE;
+    }
 
-int
-main (int argc, char **argv) {
-    struct stat results { };
+    auto map = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
 
-    if (stat(argv[1], &results) != 0) {
+    if (map == MAP_FAILED) {
+        std::cerr << argv[1] << ": can't map file" << std::endl;
         return EXIT_FAILURE;
     }
 
-    std::ifstream f (argv[1], std::ios::in | std::ios::binary);
-    std::array<char, 7> header { };
-    f.read(header.data(), 7);
+    madvise (map, size, MADV_SEQUENTIAL);
 
-    if (header != amqp::AMQP_HEADER) {
+    auto blob = static_cast<const char *>(map);
+
+    if (!std::equal (amqp::AMQP_HEADER.begin(), amqp::AMQP_HEADER.end(), blob)) {
         std::cerr << "Bad Header in blob" << std::endl;
         return EXIT_FAILURE;
     }
 
-    amqp::amqp_section_id_t encoding;
-    f.read((char *)&encoding, 1);
+    auto encoding = static_cast<amqp::amqp_section_id_t>(blob[amqp::AMQP_HEADER.size()]);
 
-    if (encoding == amqp::DATA_AND_STOP) {
-        data_and_stop(f, results.st_size - 8);
-    } else {
+    if (encoding != amqp::DATA_AND_STOP) {
         std::cerr << "BAD ENCODING " << encoding << " != "
             << amqp::DATA_AND_STOP << std::endl;
 
         return EXIT_FAILURE;
     }
 
+    amqp::internal::scanner::BufferedWriter out (STDOUT_FILENO);
+
+    try {
+        amqp::internal::scanner::StructureDumper (out).dump (
+            blob + headerSize, blob + size);
+    } catch (const std::runtime_error &) {
+        // already reported in the output
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,44 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <variant>
+
+#include "amqp/reader/IReader.h"
+
+/******************************************************************************
+ *
+ * class amqp::reader::IMapValue
+ *
+ ******************************************************************************/
+
+/**
+ * What the [IValue]s dumped from a map can also be looked up through.
+ * Keys are held as their native type, so an int keyed map is searched
+ * with an int32_t, a long keyed one with an int64_t. Keys with no native
+ * form, composites and enums, are held as they dump.
+ *
+ * Nothing is indexed, nor are the keys captured, until the first lookup.
+ */
+namespace amqp::reader {
+
+    using MapKey = std::variant<bool, int32_t, int64_t, double, std::string>;
+
+    class IMapValue {
+        public :
+            virtual ~IMapValue() = default;
+
+            virtual size_t entries() const = 0;
+
+            /**
+             * The value of [key_], null if there isn't one
+             */
+            virtual const IValue * find (const MapKey & key_) const = 0;
+    };
+
+}
+
+/******************************************************************************/
@@ -5,6 +5,7 @@
 #include <any>
 
 #include "amqp/AMQPDescribed.h"
+#include "amqp/reader/IVisitor.h"
 
 #include "amqp/schema/described-types/Schema.h"
 
@@ -68,6 +69,15 @@ namespace amqp::reader {
                     pn_data_t *,
                     const SchemaType &) const = 0;
 
+            /**
+             * Walk the value, pushing what's found to the visitor rather
+             * than building a tree of it
+             */
+            virtual void visit(
+                    pn_data_t *,
+                    const SchemaType &,
+                    IVisitor &) const = 0;
+
     };
 
 }
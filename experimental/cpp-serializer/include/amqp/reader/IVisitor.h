@@ -0,0 +1,61 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/******************************************************************************
+ *
+ * class amqp::reader::IVisitor
+ *
+ ******************************************************************************/
+
+/**
+ * The push alternative to dump; rather than building a tree of [IValue]s
+ * the readers call back into a visitor as they walk the blob so whatever
+ * it's building can be built in a single pass.
+ *
+ * Each field of a composite is announced with [onField] ahead of its
+ * value, a null field's value, or a null element of a list, array or map,
+ * being an [onNull]. Arrays are reported as
+ * lists. Map entries arrive as a key followed by its value. Every begin
+ * is matched by an end.
+ *
+ * Strings are only valid for the duration of the call, copy them if
+ * they're needed afterwards.
+ *
+ * Everything defaults to doing nothing so visitors need only override
+ * the events they're interested in.
+ */
+namespace amqp::reader {
+
+    class IVisitor {
+        public :
+            virtual ~IVisitor() = default;
+
+            virtual void onBeginComposite (const std::string & type_) { }
+            virtual void onEndComposite() { }
+            virtual void onField (const std::string & name_) { }
+            virtual void onNull() { }
+
+            virtual void onInt (int32_t) { }
+            virtual void onLong (int64_t) { }
+            virtual void onBool (bool) { }
+            virtual void onDouble (double) { }
+            virtual void onString (std::string_view) { }
+
+            virtual void onEnum (int32_t ordinal_, std::string_view name_) { }
+
+            virtual void onBeginList (size_t elements_) { }
+            virtual void onEndList() { }
+
+            virtual void onBeginMap (size_t entries_) { }
+            virtual void onEndMap() { }
+    };
+
+}
+
+/******************************************************************************/
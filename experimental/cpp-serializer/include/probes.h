@@ -0,0 +1,43 @@
+#pragma once
+
+/******************************************************************************/
+
+/*
+ * USDT probes, provider "amqp", for bpftrace or perf to attach to a
+ * running process. Each is a single nop until something attaches, so
+ * unlike the trace spans they're left in wherever <sys/sdt.h> is found
+ * at configure time, and compile to nothing where it isn't or with
+ * -DAMQP_USDT=OFF.
+ *
+ *   blob__start (blob, size)          a blob's been handed to an inspector
+ *   blob__done (blob, size)           and the inspector's finished with it
+ *   schema__hit (descriptor)          a blob's schema was already known
+ *   schema__miss (descriptor)         and one that had to be decoded
+ *   readers__build__start (schema)    building the readers for a schema
+ *   readers__build__done (schema, n)  built, n types now having readers
+ *   composite__entry (type, node)     reading an object of a composite type
+ *   composite__return (type, node)    and done reading it
+ *
+ * [blob] and [schema] are addresses to pair starts with their ends
+ * across threads, [node] the position of the object amongst the nodes
+ * proton decoded the blob into, proton keeping no byte offsets.
+ */
+#ifndef AMQP_USDT
+    #define AMQP_USDT 0
+#endif
+
+/******************************************************************************/
+
+#if defined AMQP_USDT && AMQP_USDT >= 1
+    #include <sys/sdt.h>
+
+    #define PROBE(NAME) DTRACE_PROBE (amqp, NAME)
+    #define PROBE1(NAME, A) DTRACE_PROBE1 (amqp, NAME, A)
+    #define PROBE2(NAME, A, B) DTRACE_PROBE2 (amqp, NAME, A, B)
+#else
+    #define PROBE(NAME)
+    #define PROBE1(NAME, A)
+    #define PROBE2(NAME, A, B)
+#endif
+
+/******************************************************************************/
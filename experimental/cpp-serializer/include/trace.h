@@ -0,0 +1,29 @@
+#pragma once
+
+/******************************************************************************/
+
+/*
+ * Spans recorded for a Chrome trace, see amqp/trace/Tracer.h. Like DBG
+ * they're compiled out unless asked for, configure with -DAMQP_TRACE=ON
+ * to have them compiled in and then turn them on at run time.
+ */
+#ifndef AMQP_TRACE
+    #define AMQP_TRACE 0
+#endif
+
+/******************************************************************************/
+
+#if defined AMQP_TRACE && AMQP_TRACE >= 1
+    #include "amqp/trace/Tracer.h"
+
+    #define TRACE_SPAN_(L) trace_span_ ## L
+    #define TRACE_SPAN(L) TRACE_SPAN_(L)
+
+    #define TRACE(NAME) ::amqp::trace::Span TRACE_SPAN(__LINE__) (NAME)
+    #define TRACE_DETAIL(NAME, DETAIL) ::amqp::trace::Span TRACE_SPAN(__LINE__) (NAME, DETAIL)
+#else
+    #define TRACE(NAME)
+    #define TRACE_DETAIL(NAME, DETAIL)
+#endif
+
+/******************************************************************************/
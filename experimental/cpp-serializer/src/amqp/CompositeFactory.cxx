@@ -9,6 +9,8 @@
 #include <assert.h>
 
 #include "debug.h"
+#include "trace.h"
+#include "probes.h"
 
 #include "amqp/reader/IReader.h"
 #include "amqp/reader/PropertyReader.h"
@@ -85,6 +87,8 @@ void
 amqp::internal::
 CompositeFactory::process (const SchemaType & schema_) {
     DBG ("process schema" << std::endl);
+    TRACE ("CompositeFactory::process");
+    PROBE1 (readers__build__start, &schema_);
 
     for (const auto & i : dynamic_cast<const schema::Schema &>(schema_)) {
         for (const auto & j : i) {
@@ -92,6 +96,8 @@ CompositeFactory::process (const SchemaType & schema_) {
             m_readersByDescriptor[j->descriptor()] = m_readersByType[j->name()];
         }
     }
+
+    PROBE2 (readers__build__done, &schema_, m_readersByType.size());
 }
 
 /******************************************************************************/
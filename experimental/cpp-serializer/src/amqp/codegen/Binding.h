@@ -0,0 +1,534 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <tuple>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Decoder.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Map.h"
+#include "amqp/schema/restricted-types/List.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Array.h"
+
+/******************************************************************************
+ *
+ * Binding hand written C++ types to serialised Corda types
+ *
+ *   struct Cash { std::string owner; int64_t amount; std::vector<int32_t> refs; };
+ *
+ *   AMQP_BIND (Cash, owner, amount, refs)
+ *
+ *   amqp::codegen::Binder<Cash> binder;
+ *   Cash cash = binder.decode (begin, end, schema);
+ *
+ * Members are matched to the serialised type's fields by name, their
+ * order and any fields left unbound don't matter. The first blob of each
+ * schema is checked against the binding, every member must be found
+ * with a type it can be read as, and a [Plan] is made from that. Every
+ * blob after that with the same schema goes straight through its plan
+ * and into the members.
+ *
+ * Members can be int32_t, int64_t, bool, double, std::string, an enum,
+ * another bound type, or std::optional, std::vector or std::map of
+ * those.
+ *
+ ******************************************************************************/
+
+namespace amqp::codegen {
+
+    template<typename T, typename M>
+    struct Field {
+        const char * name;
+        M T::* member;
+    };
+
+    /**
+     * Specialised by [AMQP_BIND]
+     */
+    template<typename T>
+    struct Binding;
+
+    template<typename T, typename = void>
+    struct bound : std::false_type { };
+
+    template<typename T>
+    struct bound<T, std::void_t<decltype (Binding<T>::fields())>> : std::true_type { };
+
+    using TypeMap = std::map<std::string, const amqp::internal::schema::AMQPTypeNotation *>;
+
+    template<typename T>
+    class Plan;
+
+}
+
+/******************************************************************************
+ *
+ * How each kind of member is checked against the schema and then read
+ *
+ ******************************************************************************/
+
+namespace amqp::codegen {
+
+    template<typename M>
+    struct Primitive;
+
+    template<> struct Primitive<int32_t> { static constexpr const char * name = "int"; };
+    template<> struct Primitive<int64_t> { static constexpr const char * name = "long"; };
+    template<> struct Primitive<bool> { static constexpr const char * name = "boolean"; };
+    template<> struct Primitive<double> { static constexpr const char * name = "double"; };
+    template<> struct Primitive<std::string> { static constexpr const char * name = "string"; };
+
+    template<typename M, typename = void>
+    struct primitive : std::false_type { };
+
+    template<typename M>
+    struct primitive<M, std::void_t<decltype (Primitive<M>::name)>> : std::true_type { };
+
+    inline const amqp::internal::schema::AMQPTypeNotation &
+    lookup (const std::string & type_, const TypeMap & types_) {
+        auto it = types_.find (type_);
+
+        if (it == types_.end()) {
+            throw std::runtime_error ("Unknown type " + type_);
+        }
+
+        return *it->second;
+    }
+
+    inline const amqp::internal::schema::Restricted &
+    restricted (
+        const std::string & type_,
+        const TypeMap & types_,
+        amqp::internal::schema::Restricted::RestrictedTypes kind_
+    ) {
+        using namespace amqp::internal::schema;
+
+        const auto & type = lookup (type_, types_);
+
+        if (type.type() != AMQPTypeNotation::restricted_t) {
+            throw std::runtime_error ("Can't bind " + type_);
+        }
+
+        const auto & rtn = dynamic_cast<const Restricted &>(type);
+
+        // lists and arrays both bind to vectors
+        if (rtn.restrictedType() != kind_
+            && !(kind_ == Restricted::list_t && rtn.restrictedType() == Restricted::array_t))
+        {
+            throw std::runtime_error ("Can't bind " + type_);
+        }
+
+        return rtn;
+    }
+
+    template<typename M, typename = void>
+    struct Reader;
+
+    template<typename M>
+    struct Reader<M, std::enable_if_t<primitive<M>::value>> {
+        void prepare (const std::string & type_, const TypeMap &) {
+            if (type_ != Primitive<M>::name
+                && !(std::is_same_v<M, bool> && type_ == "bool"))
+            {
+                throw std::runtime_error (
+                    std::string ("Can't bind ") + type_ + " to " + Primitive<M>::name);
+            }
+        }
+
+        M read (const Value & value_) const { return Decoder<M>::decode (value_); }
+    };
+
+    template<typename M>
+    struct Reader<M, std::enable_if_t<std::is_enum_v<M>>> {
+        std::string m_descriptor;
+
+        void prepare (const std::string & type_, const TypeMap & types_) {
+            m_descriptor = restricted (
+                type_, types_, amqp::internal::schema::Restricted::enum_t).descriptor();
+        }
+
+        M read (const Value & value_) const {
+            return static_cast<M>(ordinal (value_, m_descriptor));
+        }
+    };
+
+    template<typename M>
+    struct Reader<M, std::enable_if_t<bound<M>::value>> {
+        std::unique_ptr<Plan<M>> m_plan;
+
+        void prepare (const std::string & type_, const TypeMap & types_) {
+            const auto & type = lookup (type_, types_);
+
+            if (type.type() != amqp::internal::schema::AMQPTypeNotation::composite_t) {
+                throw std::runtime_error ("Can't bind " + type_ + " to a struct");
+            }
+
+            m_plan = std::make_unique<Plan<M>>(
+                dynamic_cast<const amqp::internal::schema::Composite &>(type), types_);
+        }
+
+        M read (const Value & value_) const { return m_plan->decode (value_); }
+    };
+
+    template<typename M>
+    struct Reader<std::optional<M>> {
+        Reader<M> m_reader;
+
+        void prepare (const std::string & type_, const TypeMap & types_) {
+            m_reader.prepare (type_, types_);
+        }
+
+        std::optional<M> read (const Value & value_) const {
+            if (value_.code() == amqp::internal::scanner::null_t) {
+                return std::nullopt;
+            }
+
+            return m_reader.read (value_);
+        }
+    };
+
+    template<typename M>
+    struct Reader<std::vector<M>> {
+        Reader<M> m_reader;
+
+        void prepare (const std::string & type_, const TypeMap & types_) {
+            using namespace amqp::internal::schema;
+
+            const auto & type = restricted (type_, types_, Restricted::list_t);
+
+            m_reader.prepare (type.restrictedType() == Restricted::array_t
+                ? dynamic_cast<const Array &>(type).arrayOf()
+                : dynamic_cast<const List &>(type).listOf(), types_);
+        }
+
+        std::vector<M> read (const Value & value_) const {
+            auto list = undescribed (value_);
+
+            std::vector<M> rtn;
+            rtn.reserve (list.count());
+
+            if (list.count() != 0) {
+                auto element = list.first();
+                rtn.push_back (m_reader.read (element));
+
+                for (uint32_t i { 1 } ; i < list.count() ; ++i) {
+                    element = list.next (element);
+                    rtn.push_back (m_reader.read (element));
+                }
+            }
+
+            return rtn;
+        }
+    };
+
+    template<typename K, typename V>
+    struct Reader<std::map<K, V>> {
+        Reader<K> m_key;
+        Reader<V> m_value;
+
+        void prepare (const std::string & type_, const TypeMap & types_) {
+            using namespace amqp::internal::schema;
+
+            auto types = dynamic_cast<const Map &>(
+                restricted (type_, types_, Restricted::map_t)).mapOf();
+
+            m_key.prepare (types.first, types_);
+            m_value.prepare (types.second, types_);
+        }
+
+        std::map<K, V> read (const Value & value_) const {
+            auto map = undescribed (value_);
+
+            std::map<K, V> rtn;
+
+            if (map.count() != 0) {
+                auto key = map.first();
+
+                for (uint32_t i { 0 } ; i < map.count() ; i += 2) {
+                    auto value = map.next (key);
+                    rtn.emplace (m_key.read (key), m_value.read (value));
+
+                    if (i + 2 < map.count()) {
+                        key = map.next (value);
+                    }
+                }
+            }
+
+            return rtn;
+        }
+    };
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::codegen::Plan
+ *
+ ******************************************************************************/
+
+namespace amqp::codegen {
+
+    /**
+     * A binding checked against one version of the serialised type. For
+     * each of its fields, in the order they're serialised, which member
+     * it's read into, if any. Reading an object is then one step along
+     * the fields and one call per bound member.
+     */
+    template<typename T>
+    class Plan {
+        public :
+            static constexpr size_t SKIP { std::numeric_limits<size_t>::max() };
+
+        private :
+            static constexpr auto s_fields = Binding<T>::fields();
+            static constexpr size_t s_size = std::tuple_size_v<decltype (s_fields)>;
+
+            template<typename F>
+            struct readers;
+
+            template<typename... M>
+            struct readers<std::tuple<Field<T, M>...>> {
+                using type = std::tuple<Reader<M>...>;
+            };
+
+            using Setter = void (*)(const Plan &, T &, const Value &);
+
+            std::string m_descriptor;
+            uint32_t    m_count;
+
+            /**
+             * For each serialised field the member it's bound to or [SKIP]
+             */
+            std::vector<size_t> m_targets;
+
+            typename readers<std::remove_const_t<decltype (s_fields)>>::type m_readers;
+
+            template<size_t I>
+            static void
+            set (const Plan & plan_, T & t_, const Value & value_) {
+                t_.*(std::get<I>(s_fields).member) = std::get<I>(plan_.m_readers).read (value_);
+            }
+
+            template<size_t... I>
+            static constexpr std::array<Setter, s_size>
+            setters (std::index_sequence<I...>) {
+                return { &set<I>... };
+            }
+
+            template<size_t I>
+            void
+            bind (const amqp::internal::schema::Composite & composite_, const TypeMap & types_) {
+                const auto & fields = composite_.fields();
+                const auto & name = std::get<I>(s_fields).name;
+
+                for (size_t i { 0 } ; i < fields.size() ; ++i) {
+                    if (fields[i]->name() == name) {
+                        std::get<I>(m_readers).prepare (fields[i]->resolvedType(), types_);
+                        m_targets[i] = I;
+                        return;
+                    }
+                }
+
+                throw std::runtime_error (
+                    std::string (Binding<T>::name) + "::" + name
+                        + " isn't a field of " + composite_.name());
+            }
+
+            template<size_t... I>
+            void
+            bind (
+                const amqp::internal::schema::Composite & composite_,
+                const TypeMap & types_,
+                std::index_sequence<I...>
+            ) {
+                (bind<I> (composite_, types_), ...);
+            }
+
+        public :
+            /**
+             * Throws if any member can't be bound
+             */
+            Plan (const amqp::internal::schema::Composite & composite_, const TypeMap & types_)
+                : m_descriptor (composite_.descriptor())
+                , m_count (static_cast<uint32_t>(composite_.fields().size()))
+                , m_targets (composite_.fields().size(), SKIP)
+            {
+                bind (composite_, types_, std::make_index_sequence<s_size> { });
+            }
+
+            T
+            decode (const Value & value_) const {
+                static constexpr auto table = setters (std::make_index_sequence<s_size> { });
+
+                auto fields = amqp::codegen::composite (value_, m_descriptor, m_count);
+
+                T rtn { };
+
+                if (m_count != 0) {
+                    auto field = fields.first();
+
+                    for (uint32_t i { 0 } ; i < m_count ; ++i) {
+                        if (i != 0) {
+                            field = fields.next (field);
+                        }
+
+                        if (m_targets[i] != SKIP) {
+                            table[m_targets[i]] (*this, rtn, field);
+                        }
+                    }
+                }
+
+                return rtn;
+            }
+    };
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::codegen::Binder
+ *
+ ******************************************************************************/
+
+namespace amqp::codegen {
+
+    /**
+     * Decodes blobs into [T]s, keeping a [Plan] for each version of the
+     * serialised type it's seen. Blobs are recognised by the descriptor
+     * of the object they hold, found without decoding anything, so the
+     * blob's schema is only wanted the first time its version is seen.
+     */
+    template<typename T>
+    class Binder {
+        public :
+            using SchemaSource = std::function<const amqp::internal::schema::Schema & ()>;
+
+        private :
+            mutable std::mutex m_lock;
+
+            std::map<std::string, std::shared_ptr<const Plan<T>>> m_plans;
+
+        public :
+            std::shared_ptr<const Plan<T>>
+            plan (const std::string & descriptor_, const SchemaSource & schema_) {
+                std::lock_guard<std::mutex> lock (m_lock);
+
+                auto it = m_plans.find (descriptor_);
+                if (it != m_plans.end()) {
+                    return it->second;
+                }
+
+                TypeMap types;
+                const amqp::internal::schema::AMQPTypeNotation * root { nullptr };
+
+                for (const auto & level : schema_()) {
+                    for (const auto & type : level) {
+                        types[type->name()] = type.get();
+                        if (type->descriptor() == descriptor_) root = type.get();
+                    }
+                }
+
+                if (!root || root->type() != amqp::internal::schema::AMQPTypeNotation::composite_t) {
+                    throw std::runtime_error ("No composite with descriptor " + descriptor_);
+                }
+
+                return m_plans[descriptor_] = std::make_shared<const Plan<T>>(
+                    dynamic_cast<const amqp::internal::schema::Composite &>(*root), types);
+            }
+
+            /**
+             * Decode a blob, its bytes after the Corda header. [schema_]
+             * is only called on if this is the first blob of its schema
+             */
+            T
+            decode (const char * begin_, const char * end_, const SchemaSource & schema_) {
+                Value envelope (begin_, end_);
+
+                if (!envelope.described() || !envelope.value().list()
+                    || envelope.value().count() == 0)
+                {
+                    throw std::runtime_error ("Blob doesn't hold an envelope");
+                }
+
+                auto object = envelope.value().first();
+
+                if (!object.described()) {
+                    throw std::runtime_error ("Blob doesn't hold a described object");
+                }
+
+                return plan (std::string (object.descriptor().bytes()), schema_)->decode (object);
+            }
+
+            size_t
+            size() const {
+                std::lock_guard<std::mutex> lock (m_lock);
+                return m_plans.size();
+            }
+    };
+
+}
+
+/******************************************************************************
+ *
+ * AMQP_BIND (Type, member, ...)
+ *
+ * Must be used at global scope. Up to 16 members can be bound.
+ *
+ ******************************************************************************/
+
+#define AMQP_BIND_FIELD(T, f) ::amqp::codegen::Field<T, decltype (T::f)> { #f, &T::f }
+
+#define AMQP_BIND_1(T, a) AMQP_BIND_FIELD(T, a)
+#define AMQP_BIND_2(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_1(T, __VA_ARGS__)
+#define AMQP_BIND_3(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_2(T, __VA_ARGS__)
+#define AMQP_BIND_4(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_3(T, __VA_ARGS__)
+#define AMQP_BIND_5(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_4(T, __VA_ARGS__)
+#define AMQP_BIND_6(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_5(T, __VA_ARGS__)
+#define AMQP_BIND_7(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_6(T, __VA_ARGS__)
+#define AMQP_BIND_8(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_7(T, __VA_ARGS__)
+#define AMQP_BIND_9(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_8(T, __VA_ARGS__)
+#define AMQP_BIND_10(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_9(T, __VA_ARGS__)
+#define AMQP_BIND_11(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_10(T, __VA_ARGS__)
+#define AMQP_BIND_12(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_11(T, __VA_ARGS__)
+#define AMQP_BIND_13(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_12(T, __VA_ARGS__)
+#define AMQP_BIND_14(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_13(T, __VA_ARGS__)
+#define AMQP_BIND_15(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_14(T, __VA_ARGS__)
+#define AMQP_BIND_16(T, a, ...) AMQP_BIND_FIELD(T, a), AMQP_BIND_15(T, __VA_ARGS__)
+
+#define AMQP_BIND_PICK( \
+    _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+
+#define AMQP_BIND_FIELDS(T, ...) \
+    AMQP_BIND_PICK (__VA_ARGS__, \
+        AMQP_BIND_16, AMQP_BIND_15, AMQP_BIND_14, AMQP_BIND_13, \
+        AMQP_BIND_12, AMQP_BIND_11, AMQP_BIND_10, AMQP_BIND_9, \
+        AMQP_BIND_8, AMQP_BIND_7, AMQP_BIND_6, AMQP_BIND_5, \
+        AMQP_BIND_4, AMQP_BIND_3, AMQP_BIND_2, AMQP_BIND_1, 0) (T, __VA_ARGS__)
+
+#define AMQP_BIND(T, ...)                                                   \
+    namespace amqp::codegen {                                               \
+        template<>                                                          \
+        struct Binding<T> {                                                 \
+            static constexpr const char * name = #T;                        \
+                                                                            \
+            static constexpr auto fields() {                                \
+                return std::make_tuple (AMQP_BIND_FIELDS (T, __VA_ARGS__)); \
+            }                                                               \
+        };                                                                  \
+    }
+
+/******************************************************************************/
@@ -0,0 +1,191 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include "amqp/scanner/Scanner.h"
+
+/******************************************************************************
+ *
+ * What the code schema-codegen writes is built on. Each type it generates
+ * gets its own specialisation of [Decoder], everything else a type can
+ * be made of is covered here
+ *
+ ******************************************************************************/
+
+namespace amqp::codegen {
+
+    using amqp::internal::scanner::Value;
+
+    template<typename T>
+    struct Decoder;
+
+    /**
+     * Check [value_] is a composite described by [descriptor_] with
+     * [fields_] fields and hand back the list holding them
+     */
+    inline Value
+    composite (const Value & value_, std::string_view descriptor_, uint32_t fields_) {
+        if (!value_.described() || value_.descriptor().bytes() != descriptor_) {
+            throw std::runtime_error (
+                "Expected an instance of " + std::string (descriptor_));
+        }
+
+        auto fields = value_.value();
+
+        if (!fields.list() || fields.count() != fields_) {
+            throw std::runtime_error (
+                "Wrong number of fields for " + std::string (descriptor_));
+        }
+
+        return fields;
+    }
+
+    /**
+     * Enums are serialised as their constant's name and its ordinal, only
+     * the latter is needed to pick the constant
+     */
+    inline int32_t
+    ordinal (const Value & value_, std::string_view descriptor_) {
+        auto constant = composite (value_, descriptor_, 2);
+
+        return constant.next (constant.first()).int32();
+    }
+
+    /**
+     * Lists and arrays are both described by their Java type, which tells
+     * us nothing the generated code doesn't already know
+     */
+    inline Value
+    undescribed (const Value & value_) {
+        return value_.described() ? value_.value() : value_;
+    }
+
+}
+
+/******************************************************************************/
+
+namespace amqp::codegen {
+
+    template<>
+    struct Decoder<int32_t> {
+        static int32_t decode (const Value & value_) { return value_.int32(); }
+    };
+
+    template<>
+    struct Decoder<int64_t> {
+        static int64_t decode (const Value & value_) { return value_.int64(); }
+    };
+
+    template<>
+    struct Decoder<bool> {
+        static bool decode (const Value & value_) { return value_.boolean(); }
+    };
+
+    template<>
+    struct Decoder<double> {
+        static double decode (const Value & value_) { return value_.float64(); }
+    };
+
+    template<>
+    struct Decoder<std::string> {
+        static std::string decode (const Value & value_) {
+            return std::string (value_.bytes());
+        }
+    };
+
+    /**
+     * For fields that aren't mandatory, those which can be null
+     */
+    template<typename T>
+    struct Decoder<std::optional<T>> {
+        static std::optional<T> decode (const Value & value_) {
+            if (value_.code() == amqp::internal::scanner::null_t) {
+                return std::nullopt;
+            }
+
+            return Decoder<T>::decode (value_);
+        }
+    };
+
+    template<typename T>
+    struct Decoder<std::vector<T>> {
+        static std::vector<T> decode (const Value & value_) {
+            auto list = undescribed (value_);
+
+            std::vector<T> rtn;
+            rtn.reserve (list.count());
+
+            if (list.count() != 0) {
+                auto element = list.first();
+                rtn.push_back (Decoder<T>::decode (element));
+
+                for (uint32_t i { 1 } ; i < list.count() ; ++i) {
+                    element = list.next (element);
+                    rtn.push_back (Decoder<T>::decode (element));
+                }
+            }
+
+            return rtn;
+        }
+    };
+
+    template<typename K, typename V>
+    struct Decoder<std::map<K, V>> {
+        static std::map<K, V> decode (const Value & value_) {
+            auto map = undescribed (value_);
+
+            std::map<K, V> rtn;
+
+            if (map.count() != 0) {
+                auto key = map.first();
+
+                for (uint32_t i { 0 } ; i < map.count() ; i += 2) {
+                    auto value = map.next (key);
+                    rtn.emplace (Decoder<K>::decode (key), Decoder<V>::decode (value));
+
+                    if (i + 2 < map.count()) {
+                        key = map.next (value);
+                    }
+                }
+            }
+
+            return rtn;
+        }
+    };
+
+}
+
+/******************************************************************************/
+
+namespace amqp::codegen {
+
+    /**
+     * Decode a whole blob, its bytes after the Corda header, as a [T]. The
+     * blob's schema is never looked at, if the object isn't a [T] it's
+     * caught by its descriptor not matching the one [T] was generated from
+     */
+    template<typename T>
+    T
+    decode (const char * begin_, const char * end_) {
+        Value envelope (begin_, end_);
+
+        if (!envelope.described() || !envelope.value().list()
+            || envelope.value().count() == 0)
+        {
+            throw std::runtime_error ("Blob doesn't hold an envelope");
+        }
+
+        return Decoder<T>::decode (envelope.value().first());
+    }
+
+}
+
+/******************************************************************************/
@@ -1,5 +1,7 @@
 #include "CompositeReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include <string>
 #include <iostream>
 #include <assert.h>
@@ -7,9 +9,52 @@
 #include <proton/codec.h>
 #include <sstream>
 #include "debug.h"
+#include "probes.h"
 #include "Reader.h"
 #include "amqp/reader/IReader.h"
 #include "proton/proton_wrapper.h"
+#include "amqp/schema/evolution/SchemaEvolver.h"
+
+/******************************************************************************/
+
+#if defined AMQP_USDT && AMQP_USDT >= 1
+
+namespace {
+
+    /**
+     * Fires composite__entry on the way into an object and
+     * composite__return however it's left, both with where it sits in
+     * the blob so the two can be paired
+     */
+    class CompositeProbe {
+        private :
+            const std::string & m_type;
+            pn_handle_t         m_node;
+
+        public :
+            CompositeProbe (const std::string & type_, pn_data_t * data_)
+                : m_type (type_)
+                , m_node (pn_data_point (data_))
+            {
+                PROBE2 (composite__entry, m_type.c_str(), m_node);
+            }
+
+            ~CompositeProbe() {
+                PROBE2 (composite__return, m_type.c_str(), m_node);
+            }
+
+            CompositeProbe (const CompositeProbe &) = delete;
+    };
+
+}
+
+#define COMPOSITE_PROBE(TYPE, DATA) CompositeProbe composite_probe (TYPE, DATA)
+
+#else
+
+#define COMPOSITE_PROBE(TYPE, DATA)
+
+#endif
 
 /******************************************************************************/
 
@@ -136,6 +181,9 @@ CompositeReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::composite_t, type(), data_);
+    COMPOSITE_PROBE (m_type, data_);
+
     proton::auto_next an (data_);
 
     return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
@@ -154,6 +202,9 @@ CompositeReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::composite_t, type(), data_);
+    COMPOSITE_PROBE (m_type, data_);
+
     proton::auto_next an (data_);
 
     return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>> (
@@ -162,3 +213,118 @@ CompositeReader::dump (
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+CompositeReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    amqp::stats::Sample sample (amqp::stats::composite_t, type(), data_);
+    COMPOSITE_PROBE (m_type, data_);
+
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    const auto & it = schema_.fromDescriptor (
+            proton::get_symbol<std::string>(data_));
+
+    auto & fields = dynamic_cast<schema::Composite &> (
+            *(it->second.get())).fields();
+
+    assert (fields.size() == m_readers.size());
+
+    pn_data_next (data_);
+    proton::is_list (data_);
+
+    visitor_.onBeginComposite (m_type);
+
+    {
+        proton::auto_enter ae (data_);
+
+        for (size_t i { 0 } ; i < m_readers.size() ; ++i) {
+            if (auto l = m_readers[i].lock()) {
+                visitor_.onField (fields[i]->name());
+
+                if (pn_data_type (data_) == PN_NULL) {
+                    visitor_.onNull();
+                    pn_data_next (data_);
+                } else {
+                    l->visit (data_, schema_, visitor_);
+                }
+            } else {
+                throw std::runtime_error ("null field reader: " + fields[i]->name());
+            }
+        }
+    }
+
+    visitor_.onEndComposite();
+}
+
+/******************************************************************************/
+
+uPtr<amqp::reader::IValue>
+amqp::internal::reader::
+CompositeReader::dump (
+    const std::string & name_,
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    const schema::Evolution & evolution_) const
+{
+    amqp::stats::Sample sample (amqp::stats::composite_t, type(), data_);
+    COMPOSITE_PROBE (m_type, data_);
+
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+
+    sVec<uPtr<amqp::reader::IValue>> read (evolution_.targetFields());
+
+    {
+        proton::auto_enter ae (data_);
+
+        const auto & it = schema_.fromDescriptor (
+                proton::get_symbol<std::string>(data_));
+
+        auto & fields = dynamic_cast<schema::Composite &> (
+                *(it->second.get())).fields();
+
+        if (fields.size() != evolution_.sourceFields()
+            || m_readers.size() != evolution_.sourceFields())
+        {
+            throw std::runtime_error (
+                "Evolution of " + m_type + " doesn't match the blob's schema");
+        }
+
+        pn_data_next (data_);
+        proton::is_list (data_);
+
+        {
+            proton::auto_enter ae (data_);
+
+            for (size_t i { 0 } ; i < m_readers.size() ; ++i) {
+                auto target = evolution_.targetOf (i);
+
+                if (target == schema::Evolution::DROPPED) {
+                    pn_data_next (data_);
+                } else if (auto l = m_readers[i].lock()) {
+                    read[target] = l->dump (
+                        evolution_.name (target), data_, schema_);
+                } else {
+                    throw std::runtime_error ("null field reader: " + fields[i]->name());
+                }
+            }
+        }
+    }
+
+    for (const auto & d : evolution_.defaults()) {
+        read[d.index] = std::make_unique<TypedPair<std::string>> (
+            d.name, std::string (d.value));
+    }
+
+    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>> (
+        name_,
+        std::move (read));
+}
+
+/******************************************************************************/
@@ -11,6 +11,14 @@
 
 /******************************************************************************/
 
+namespace amqp::internal::schema {
+
+    class Evolution;
+
+}
+
+/******************************************************************************/
+
 namespace amqp::internal::reader {
 
     class CompositeReader : public Reader {
@@ -41,6 +49,24 @@ namespace amqp::internal::reader {
                 pn_data_t *,
                 const SchemaType &) const override;
 
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
+
+            /**
+             * Read an object serialised with an older or newer version of
+             * this type as the version [evolution_] leads to. Fields the
+             * target doesn't have are stepped over without being read.
+             * Only this object is evolved, any composites its fields hold
+             * are read as they were serialised
+             */
+            std::unique_ptr<amqp::reader::IValue> dump(
+                const std::string &,
+                pn_data_t *,
+                const SchemaType &,
+                const schema::Evolution & evolution_) const;
+
             const std::string & name() const override;
             const std::string & type() const override;
 
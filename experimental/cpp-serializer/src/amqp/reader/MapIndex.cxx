@@ -0,0 +1,59 @@
+#include "MapIndex.h"
+
+#include <functional>
+
+/******************************************************************************/
+
+amqp::internal::reader::
+MapIndex::MapIndex (std::vector<amqp::reader::MapKey> keys_)
+    : m_keys (std::move (keys_))
+{ }
+
+/******************************************************************************/
+
+/**
+ * Kept no more than half full so probe sequences stay short
+ */
+void
+amqp::internal::reader::
+MapIndex::build() const {
+    size_t capacity { 8 };
+    while (capacity < m_keys.size() * 2) capacity <<= 1U;
+
+    m_slots.assign (capacity, 0);
+
+    auto mask = capacity - 1;
+
+    for (size_t i { 0 } ; i < m_keys.size() ; ++i) {
+        auto slot = std::hash<amqp::reader::MapKey>{ }(m_keys[i]) & mask;
+
+        while (m_slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+
+        m_slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::reader::
+MapIndex::find (const amqp::reader::MapKey & key_) const {
+    std::call_once (m_built, [this] { build(); });
+
+    auto mask = m_slots.size() - 1;
+    auto slot = std::hash<amqp::reader::MapKey>{ }(key_) & mask;
+
+    while (m_slots[slot] != 0) {
+        if (m_keys[m_slots[slot] - 1] == key_) {
+            return m_slots[slot] - 1;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return NOT_FOUND;
+}
+
+/******************************************************************************/
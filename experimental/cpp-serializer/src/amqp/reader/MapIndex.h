@@ -0,0 +1,46 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <mutex>
+#include <limits>
+#include <vector>
+
+#include "amqp/reader/IMapValue.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::reader {
+
+    /**
+     * A flat, open addressed hash index over a map's keys, built the
+     * first time it's searched. Slots hold the position of a key in the
+     * map, one past it so that zero means empty, and collisions probe
+     * linearly to the next slot.
+     */
+    class MapIndex {
+        public :
+            static constexpr size_t NOT_FOUND { std::numeric_limits<size_t>::max() };
+
+        private :
+            std::vector<amqp::reader::MapKey> m_keys;
+
+            mutable std::once_flag         m_built;
+            mutable std::vector<uint32_t>  m_slots;
+
+            void build() const;
+
+        public :
+            explicit MapIndex (std::vector<amqp::reader::MapKey>);
+
+            size_t size() const { return m_keys.size(); }
+
+            /**
+             * The position of [key_] amongst the map's entries
+             */
+            size_t find (const amqp::reader::MapKey & key_) const;
+    };
+
+}
+
+/******************************************************************************/
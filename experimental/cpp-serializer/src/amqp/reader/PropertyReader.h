@@ -40,6 +40,12 @@ namespace amqp::internal::reader {
                 const SchemaType &
             ) const override = 0;
 
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &
+            ) const override = 0;
+
             const std::string & name() const override = 0;
             const std::string & type() const override = 0;
     };
@@ -5,6 +5,7 @@
 #include <any>
 #include <list>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 
@@ -143,6 +144,9 @@ namespace amqp::internal::reader {
               , m_value (std::move (value_))
         { }
 
+        const amqp::reader::IValue & key() const { return *m_key; }
+        const amqp::reader::IValue & value() const { return *m_value; }
+
         std::string dump() const override;
     };
 
@@ -168,6 +172,17 @@ TypedSingle<std::string>::dump() const {
     return m_value;
 }
 
+/**
+ * Views are only ever taken of strings that live for the life of the
+ * process, see [EnumReader]
+ */
+template<>
+inline std::string
+amqp::internal::reader::
+TypedSingle<std::string_view>::dump() const {
+    return std::string (m_value);
+}
+
 template<>
 std::string
 amqp::internal::reader::
@@ -208,6 +223,13 @@ TypedPair<std::string>::dump() const {
     return m_property + " : " + m_value;
 }
 
+template<>
+inline std::string
+amqp::internal::reader::
+TypedPair<std::string_view>::dump() const {
+    return m_property + " : " + std::string (m_value);
+}
+
 template<>
 std::string
 amqp::internal::reader::
@@ -267,6 +289,11 @@ namespace amqp::internal::reader  {
             uPtr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override = 0;
+
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override = 0;
     };
 
 }
@@ -1,5 +1,7 @@
 #include "BoolPropertyReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include "proton/proton_wrapper.h"
 
 /******************************************************************************
@@ -51,6 +53,8 @@ BoolPropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedPair<std::string>> (
             name_,
             std::to_string (proton::readAndNext<bool> (data_)));
@@ -64,12 +68,28 @@ BoolPropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedSingle<std::string>> (
             std::to_string (proton::readAndNext<bool> (data_)));
 }
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+BoolPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
+    visitor_.onBool (proton::readAndNext<bool> (data_));
+}
+
+/******************************************************************************/
+
 const std::string &
 amqp::internal::reader::
 BoolPropertyReader::name() const {
@@ -29,6 +29,12 @@ namespace amqp::internal::reader {
                 const SchemaType &
             ) const override;
 
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &
+            ) const override;
+
             const std::string & name() const override;
             const std::string & type() const override;
     };
@@ -1,5 +1,7 @@
 #include "DoublePropertyReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include "proton/proton_wrapper.h"
 
 /******************************************************************************
@@ -49,6 +51,8 @@ DoublePropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedPair<std::string>> (
             name_,
             std::to_string (proton::readAndNext<double> (data_)));
@@ -62,12 +66,28 @@ DoublePropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedSingle<std::string>> (
             std::to_string (proton::readAndNext<double> (data_)));
 }
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+DoublePropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
+    visitor_.onDouble (proton::readAndNext<double> (data_));
+}
+
+/******************************************************************************/
+
 const std::string &
 amqp::internal::reader::
 DoublePropertyReader::name() const {
@@ -1,6 +1,8 @@
 
 #include "IntPropertyReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include <any>
 #include <string>
 #include <proton/codec.h>
@@ -57,6 +59,8 @@ IntPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedPair<std::string>> (
             name_,
             std::to_string (proton::readAndNext<int> (data_)));
@@ -70,12 +74,28 @@ IntPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedSingle<std::string>> (
             std::to_string (proton::readAndNext<int> (data_)));
 }
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+IntPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
+    visitor_.onInt (proton::readAndNext<int> (data_));
+}
+
+/******************************************************************************/
+
 const std::string &
 amqp::internal::reader::
 IntPropertyReader::name() const {
@@ -1,5 +1,7 @@
 #include "LongPropertyReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include "proton/proton_wrapper.h"
 
 /******************************************************************************
@@ -51,6 +53,8 @@ LongPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedPair<std::string>> (
             name_,
             std::to_string (proton::readAndNext<long> (data_)));
@@ -64,12 +68,28 @@ LongPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedSingle<std::string>> (
             std::to_string (proton::readAndNext<long> (data_)));
 }
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+LongPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
+    visitor_.onLong (proton::readAndNext<long> (data_));
+}
+
+/******************************************************************************/
+
 const std::string &
 amqp::internal::reader::
 LongPropertyReader::name() const {
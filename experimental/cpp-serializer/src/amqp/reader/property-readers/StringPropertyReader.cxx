@@ -1,5 +1,7 @@
 #include "StringPropertyReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include <proton/codec.h>
 
 #include "proton/proton_wrapper.h"
@@ -53,6 +55,8 @@ StringPropertyReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedPair<std::string>> (
             name_,
             "\"" + proton::readAndNext<std::string> (data_) + "\"");
@@ -66,12 +70,28 @@ StringPropertyReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_) const
 {
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
     return std::make_unique<TypedSingle<std::string>> (
             "\"" + proton::readAndNext<std::string> (data_) + "\"");
 }
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+StringPropertyReader::visit (
+    pn_data_t * data_,
+    const SchemaType & schema_,
+    amqp::reader::IVisitor & visitor_) const
+{
+    amqp::stats::Sample sample (amqp::stats::property_t, type(), data_);
+
+    visitor_.onString (proton::readAndNext<std::string_view> (data_));
+}
+
+/******************************************************************************/
+
 const std::string &
 amqp::internal::reader::
 StringPropertyReader::name() const {
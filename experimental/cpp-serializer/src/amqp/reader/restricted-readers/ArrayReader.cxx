@@ -1,5 +1,7 @@
 #include "ArrayReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include "proton/proton_wrapper.h"
 
 /******************************************************************************
@@ -33,6 +35,8 @@ ArrayReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    amqp::stats::Sample sample (amqp::stats::array_t, type(), data_);
+
     proton::auto_next an (data_);
 
     return std::make_unique<TypedPair<sList<uPtr<amqp::reader::IValue>>>>(
@@ -48,6 +52,8 @@ ArrayReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    amqp::stats::Sample sample (amqp::stats::array_t, type(), data_);
+
     proton::auto_next an (data_);
 
     return std::make_unique<TypedSingle<sList<uPtr<amqp::reader::IValue>>>>(
@@ -84,3 +90,40 @@ ArrayReader::dump_(
 
 /******************************************************************************/
 
+void
+amqp::internal::reader::
+ArrayReader::visit (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    amqp::stats::Sample sample (amqp::stats::array_t, type(), data_);
+
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+
+    {
+        proton::auto_enter ae (data_);
+        schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
+
+        {
+            proton::auto_list_enter ale (data_, true);
+            auto reader = m_reader.lock();
+
+            visitor_.onBeginList (ale.elements());
+
+            for (size_t i { 0 } ; i < ale.elements() ; ++i) {
+                if (pn_data_type (data_) == PN_NULL) {
+                    visitor_.onNull();
+                    pn_data_next (data_);
+                } else {
+                    reader->visit (data_, schema_, visitor_);
+                }
+            }
+
+            visitor_.onEndList();
+        }
+    }
+}
+
+/******************************************************************************/
@@ -1,5 +1,11 @@
 #include "EnumReader.h"
 
+#include "amqp/stats/Stats.h"
+
+#include <mutex>
+#include <algorithm>
+#include <unordered_set>
+
 #include "amqp/reader/IReader.h"
 #include "amqp/schema/Descriptors.h"
 #include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
@@ -7,57 +13,102 @@
 
 /******************************************************************************/
 
+namespace {
+
+    /**
+     * Referenced objects are added to a stream when the serialiser
+     * notices it's writing a value it's already written, so to save
+     * space it will just link back to that. Currently we have
+     * no mechanism for decoding that so just throw an error
+     */
+    void
+    notReferenced (pn_data_t * data_) {
+        if (pn_data_type (data_) == PN_ULONG) {
+            if (amqp::stripCorda(pn_data_get_ulong(data_)) ==
+            amqp::schema::descriptors::REFERENCED_OBJECT
+        ) {
+                throw std::runtime_error (
+                        "Currently don't support referenced objects");
+            }
+        }
+    }
+
+    /**
+     * Every enum's constants, held for the life of the process so views
+     * of them can be handed out freely. There are only ever as many as
+     * the schemas we've seen declare
+     */
+    std::string_view
+    intern (std::string choice_) {
+        static std::mutex lock;
+        static std::unordered_set<std::string> interned;
+
+        std::lock_guard<std::mutex> guard (lock);
+
+        return *interned.insert (std::move (choice_)).first;
+    }
+
+}
+
+/******************************************************************************/
+
 amqp::internal::reader::
 EnumReader::EnumReader (
     std::string type_,
     std::vector<std::string> choices_
 ) : RestrictedReader (std::move (type_))
-  , m_choices (std::move (choices_)
-) {
+{
+    m_choices.reserve (choices_.size());
 
+    for (auto & choice : choices_) {
+        m_choices.push_back (intern (std::move (choice)));
+    }
 }
 
 /******************************************************************************/
 
-namespace {
+/**
+ * Enums are serialised as the constant's name followed by its ordinal.
+ * The ordinal picks the constant from our table and the name serves only
+ * to check it, so neither is copied. Should they disagree the type has
+ * evolved since the blob was written and the name is the one to trust
+ */
+std::pair<int32_t, std::string_view>
+amqp::internal::reader::
+EnumReader::choice (
+        pn_data_t * data_,
+        amqp::stats::Sample & sample_
+) const {
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
 
-    std::string
-    getValue (pn_data_t * data_) {
-        proton::is_described (data_);
-
-        {
-            proton::auto_enter ae (data_);
-
-            /*
-             * Referenced objects are added to a stream when the serialiser
-             * notices it's writing a value it's already written, so to save
-             * space it will just link back to that. Currently we have
-             * no mechanism for decoding that so just throw an error
-             */
-            if (pn_data_type (data_) == PN_ULONG) {
-                if (amqp::stripCorda(pn_data_get_ulong(data_)) ==
-                amqp::schema::descriptors::REFERENCED_OBJECT
-            ) {
-                    throw std::runtime_error (
-                            "Currently don't support referenced objects");
-                }
-            }
+    notReferenced (data_);
 
-            auto fingerprint = proton::readAndNext<std::string>(data_);
+    // skip the fingerprint
+    pn_data_next (data_);
 
-            proton::auto_list_enter ale (data_, true);
+    proton::auto_list_enter ale (data_, true);
 
-            return proton::readAndNext<std::string>(data_);
+    auto name = proton::readAndNext<std::string_view>(data_);
+    auto ordinal = proton::readAndNext<int>(data_);
 
-            /*
-             * After a string representation of the enumerated value
-             * the ordinal value is also encoded. We don't need that for
-             * just dumping things to a string but if I don't leave this
-             * here I'll forget its even a thing
-             */
-            // auto idx = proton::readAndNext<int>(data_);
-        }
+    sample_.consumed (name.size() + sizeof (ordinal));
+
+    if (ordinal >= 0
+        && static_cast<size_t>(ordinal) < m_choices.size()
+        && m_choices[ordinal] == name)
+    {
+        return { ordinal, m_choices[ordinal] };
+    }
+
+    auto it = std::find (m_choices.begin(), m_choices.end(), name);
+
+    if (it == m_choices.end()) {
+        throw std::runtime_error (
+            "Unknown constant " + std::string (name) + " of " + type());
     }
+
+    return { static_cast<int32_t>(it - m_choices.begin()), *it };
 }
 
 /******************************************************************************/
@@ -69,12 +120,13 @@ EnumReader::dump (
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    amqp::stats::Sample sample (amqp::stats::enum_t, type(), data_);
+
     proton::auto_next an (data_);
-    proton::is_described (data_);
 
-    return std::make_unique<TypedPair<std::string>> (
+    return std::make_unique<TypedPair<std::string_view>> (
             name_,
-            getValue(data_));
+            choice (data_, sample).second);
 }
 
 /******************************************************************************/
@@ -85,10 +137,29 @@ EnumReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    amqp::stats::Sample sample (amqp::stats::enum_t, type(), data_);
+
     proton::auto_next an (data_);
-    proton::is_described (data_);
 
-    return std::make_unique<TypedSingle<std::string>> (getValue(data_));
+    return std::make_unique<TypedSingle<std::string_view>> (choice (data_, sample).second);
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+EnumReader::visit (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    amqp::stats::Sample sample (amqp::stats::enum_t, type(), data_);
+
+    proton::auto_next an (data_);
+
+    auto choice = this->choice (data_, sample);
+
+    visitor_.onEnum (choice.first, choice.second);
 }
 
 /******************************************************************************/
@@ -2,13 +2,36 @@
 
 #include "RestrictedReader.h"
 
+#include <string_view>
+
+/******************************************************************************/
+
+namespace amqp::stats {
+
+    class Sample;
+
+}
+
 /******************************************************************************/
 
 namespace amqp::internal::reader {
 
     class EnumReader : public RestrictedReader {
         private :
-            std::vector<std::string> m_choices;
+            /**
+             * The enum's constants by ordinal, interned so the names we
+             * hand out outlive us
+             */
+            std::vector<std::string_view> m_choices;
+
+            /**
+             * The constant's name and ordinal are read here rather than
+             * by readers of their own, so are counted to [sample_]
+             */
+            std::pair<int32_t, std::string_view> choice (
+                pn_data_t *,
+                amqp::stats::Sample & sample_) const;
+
         public :
             EnumReader (std::string, std::vector<std::string>);
 
@@ -20,6 +43,11 @@ namespace amqp::internal::reader {
             std::unique_ptr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override;
+
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
     };
 
 }
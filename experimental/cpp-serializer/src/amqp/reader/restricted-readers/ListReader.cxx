@@ -1,5 +1,7 @@
 #include "ListReader.h"
 
+#include "amqp/stats/Stats.h"
+
 #include "proton/proton_wrapper.h"
 
 /******************************************************************************
@@ -23,6 +25,8 @@ ListReader::dump (
     pn_data_t * data_,
     const SchemaType & schema_
 ) const {
+    amqp::stats::Sample sample (amqp::stats::list_t, type(), data_);
+
     proton::auto_next an (data_);
 
     return std::make_unique<TypedPair<sList<uPtr<amqp::reader::IValue>>>>(
@@ -38,6 +42,8 @@ ListReader::dump(
     pn_data_t * data_,
     const SchemaType & schema_
 ) const {
+    amqp::stats::Sample sample (amqp::stats::list_t, type(), data_);
+
     proton::auto_next an (data_);
 
     return std::make_unique<TypedSingle<sList<uPtr<amqp::reader::IValue>>>>(
@@ -73,3 +79,41 @@ ListReader::dump_(
 }
 
 /******************************************************************************/
+
+void
+amqp::internal::reader::
+ListReader::visit (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    amqp::stats::Sample sample (amqp::stats::list_t, type(), data_);
+
+    proton::auto_next an (data_);
+    proton::is_described (data_);
+
+    {
+        proton::auto_enter ae (data_);
+        schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
+
+        {
+            proton::auto_list_enter ale (data_, true);
+            auto reader = m_reader.lock();
+
+            visitor_.onBeginList (ale.elements());
+
+            for (size_t i { 0 } ; i < ale.elements() ; ++i) {
+                if (pn_data_type (data_) == PN_NULL) {
+                    visitor_.onNull();
+                    pn_data_next (data_);
+                } else {
+                    reader->visit (data_, schema_, visitor_);
+                }
+            }
+
+            visitor_.onEndList();
+        }
+    }
+}
+
+/******************************************************************************/
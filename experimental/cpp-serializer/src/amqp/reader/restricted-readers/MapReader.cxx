@@ -1,11 +1,132 @@
 #include "MapReader.h"
 
+#include "amqp/stats/Stats.h"
+
+#include <map>
+#include <mutex>
+
 #include "Reader.h"
+#include "MapIndex.h"
 #include "amqp/reader/IReader.h"
 #include "proton/proton_wrapper.h"
 
 /******************************************************************************/
 
+namespace {
+
+    using namespace amqp::internal::reader;
+
+    /**
+     * What a map's keys are as AMQP types, going by the reader they're
+     * dumped with, anything without a property reader having no native
+     * form
+     */
+    pn_type_t
+    keyTypeOf (const Reader & reader_) {
+        static const std::map<std::string, pn_type_t> types { // NOLINT
+            { "int", PN_INT },
+            { "long", PN_LONG },
+            { "boolean", PN_BOOL },
+            { "double", PN_DOUBLE },
+            { "string", PN_STRING }
+        };
+
+        auto it = types.find (reader_.type());
+
+        return it == types.end() ? PN_NULL : it->second;
+    }
+
+    /**
+     * The native form of a key of [type_], recovered from what it was
+     * dumped as
+     */
+    amqp::reader::MapKey
+    mapKey (pn_type_t type_, const amqp::reader::IValue & key_) {
+        auto dumped = key_.dump();
+
+        switch (type_) {
+            case PN_BOOL : return dumped == "1";
+            case PN_INT  : return static_cast<int32_t>(std::stol (dumped));
+            case PN_LONG : return static_cast<int64_t>(std::stoll (dumped));
+            case PN_STRING : {
+                if (dumped.size() >= 2 && dumped.front() == '"' && dumped.back() == '"') {
+                    return dumped.substr (1, dumped.size() - 2);
+                }
+                return dumped;
+            }
+            default : return dumped;
+        }
+    }
+
+    /**
+     * A map's dumped entries along with an index over their keys. Most
+     * maps are never searched so the keys aren't captured until the
+     * first search, when they're recovered from the dumped entries
+     */
+    template<class Base>
+    class IndexedMap : public Base, public amqp::reader::IMapValue {
+        private :
+            pn_type_t m_keyType;
+
+            /**
+             * Doubles are dumped to six places so can't be recovered,
+             * the keys of maps keyed on them are captured as they're
+             * dumped
+             */
+            mutable std::vector<amqp::reader::MapKey> m_keys;
+
+            mutable std::once_flag            m_indexed;
+            mutable std::unique_ptr<MapIndex> m_index;
+
+            const MapIndex &
+            index() const {
+                std::call_once (m_indexed, [this] {
+                    if (m_keyType != PN_DOUBLE) {
+                        m_keys.reserve (this->value().size());
+
+                        for (const auto & entry : this->value()) {
+                            m_keys.push_back (mapKey (
+                                m_keyType,
+                                static_cast<const ValuePair &>(*entry).key()));
+                        }
+                    }
+
+                    m_index = std::make_unique<MapIndex> (std::move (m_keys));
+                });
+
+                return *m_index;
+            }
+
+        public :
+            template<typename... Args>
+            IndexedMap (
+                pn_type_t keyType_,
+                std::vector<amqp::reader::MapKey> keys_,
+                Args &&... args_
+            ) : Base (std::forward<Args>(args_)...)
+              , m_keyType (keyType_)
+              , m_keys (std::move (keys_))
+            { }
+
+            size_t entries() const override {
+                return this->value().size();
+            }
+
+            const amqp::reader::IValue * find (const amqp::reader::MapKey & key_) const override {
+                auto i = index().find (key_);
+
+                if (i == MapIndex::NOT_FOUND) {
+                    return nullptr;
+                }
+
+                return &static_cast<const ValuePair &>(*this->value()[i]).value();
+            }
+    };
+
+}
+
+/******************************************************************************/
+
 amqp::internal::schema::Restricted::RestrictedTypes
 amqp::internal::reader::
 MapReader::restrictedType() const {
@@ -18,7 +139,8 @@ sVec<uPtr<amqp::reader::IValue>>
 amqp::internal::reader::
 MapReader::dump_(
     pn_data_t * data_,
-    const SchemaType & schema_
+    const SchemaType & schema_,
+    std::vector<amqp::reader::MapKey> & doubles_
 ) const {
     proton::is_described (data_);
     proton::auto_enter ae (data_);
@@ -33,16 +155,23 @@ MapReader::dump_(
     {
         proton::auto_map_enter am (data_, true);
 
-        decltype (dump_(data_, schema_)) rtn;
+        sVec<uPtr<amqp::reader::IValue>> rtn;
         rtn.reserve (am.elements() / 2);
 
+        auto doubles = keyTypeOf (*m_keyReader.lock()) == PN_DOUBLE;
+
         for (int i {0} ; i < am.elements() ; i += 2) {
+            // the key has to be looked at before it's dumped as dumping
+            // moves us on to the value
+            if (doubles) {
+                doubles_.emplace_back (pn_data_get_double (data_));
+            }
+
+            auto key = m_keyReader.lock()->dump (data_, schema_);
+            auto value = m_valueReader.lock()->dump (data_, schema_);
+
             rtn.emplace_back (
-                std::make_unique<ValuePair> (
-                    m_keyReader.lock()->dump (data_, schema_),
-                    m_valueReader.lock()->dump (data_, schema_)
-                )
-            );
+                std::make_unique<ValuePair> (std::move (key), std::move (value)));
         }
 
         return rtn;
@@ -58,11 +187,18 @@ MapReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
 ) const {
+    amqp::stats::Sample sample (amqp::stats::map_t, type(), data_);
+
     proton::auto_next an (data_);
 
-    return std::make_unique<TypedPair<sVec<uPtr<amqp::reader::IValue>>>>(
+    std::vector<amqp::reader::MapKey> doubles;
+    auto entries = dump_ (data_, schema_, doubles);
+
+    return std::make_unique<IndexedMap<TypedPair<sVec<uPtr<amqp::reader::IValue>>>>>(
+            keyTypeOf (*m_keyReader.lock()),
+            std::move (doubles),
             name_,
-            dump_ (data_, schema_));
+            std::move (entries));
 }
 
 /******************************************************************************/
@@ -73,10 +209,54 @@ MapReader::dump(
         pn_data_t * data_,
         const SchemaType & schema_
 ) const  {
+    amqp::stats::Sample sample (amqp::stats::map_t, type(), data_);
+
+    proton::auto_next an (data_);
+
+    std::vector<amqp::reader::MapKey> doubles;
+    auto entries = dump_ (data_, schema_, doubles);
+
+    return std::make_unique<IndexedMap<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>>>(
+            keyTypeOf (*m_keyReader.lock()),
+            std::move (doubles),
+            std::move (entries));
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::reader::
+MapReader::visit (
+        pn_data_t * data_,
+        const SchemaType & schema_,
+        amqp::reader::IVisitor & visitor_
+) const {
+    amqp::stats::Sample sample (amqp::stats::map_t, type(), data_);
+
     proton::auto_next an (data_);
+    proton::is_described (data_);
+    proton::auto_enter ae (data_);
+
+    schema_.fromDescriptor (proton::readAndNext<std::string>(data_));
 
-    return std::make_unique<TypedSingle<sVec<uPtr<amqp::reader::IValue>>>>(
-            dump_ (data_, schema_));
+    {
+        proton::auto_map_enter am (data_, true);
+        auto keyReader = m_keyReader.lock();
+        auto valueReader = m_valueReader.lock();
+
+        visitor_.onBeginMap (am.elements() / 2);
+
+        for (size_t i { 0 } ; i < am.elements() ; ++i) {
+            if (pn_data_type (data_) == PN_NULL) {
+                visitor_.onNull();
+                pn_data_next (data_);
+            } else {
+                (i % 2 ? valueReader : keyReader)->visit (data_, schema_, visitor_);
+            }
+        }
+
+        visitor_.onEndMap();
+    }
 }
 
 /******************************************************************************/
@@ -4,6 +4,8 @@
 
 #include "RestrictedReader.h"
 
+#include "amqp/reader/IMapValue.h"
+
 /******************************************************************************/
 
 namespace amqp::internal::reader {
@@ -16,7 +18,8 @@ namespace amqp::internal::reader {
 
             sVec<uPtr<amqp::reader::IValue>> dump_(
                     pn_data_t *,
-                    const SchemaType &) const;
+                    const SchemaType &,
+                    std::vector<amqp::reader::MapKey> & doubles_) const;
 
         public :
             MapReader (
@@ -32,6 +35,9 @@ namespace amqp::internal::reader {
 
             internal::schema::Restricted::RestrictedTypes restrictedType() const;
 
+            /**
+             * The values dumped are also [IMapValue]s
+             */
             std::unique_ptr<amqp::reader::IValue> dump(
                 const std::string &,
                 pn_data_t *,
@@ -40,6 +46,11 @@ namespace amqp::internal::reader {
             std::unique_ptr<amqp::reader::IValue> dump(
                 pn_data_t *,
                 const SchemaType &) const override;
+
+            void visit (
+                pn_data_t *,
+                const SchemaType &,
+                amqp::reader::IVisitor &) const override;
     };
 
 }
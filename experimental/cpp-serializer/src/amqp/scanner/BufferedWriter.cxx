@@ -0,0 +1,121 @@
+#include "BufferedWriter.h"
+
+#include <string>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+
+/******************************************************************************/
+
+amqp::internal::scanner::
+BufferedWriter::BufferedWriter (int fd_)
+    : m_fd (fd_)
+    , m_used (0)
+{ }
+
+/******************************************************************************/
+
+amqp::internal::scanner::
+BufferedWriter::~BufferedWriter() {
+    try {
+        flush();
+    } catch (const std::runtime_error &) {
+        // nowhere left to report it
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scanner::
+BufferedWriter::flush() {
+    size_t written { 0 };
+
+    while (written < m_used) {
+        auto rtn = ::write (m_fd, m_buffer + written, m_used - written);
+
+        if (rtn < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            m_used = 0;
+            throw std::runtime_error (std::string ("Write failed: ") + strerror (errno));
+        }
+
+        written += rtn;
+    }
+
+    m_used = 0;
+}
+
+/******************************************************************************/
+
+/**
+ * Make sure there's room for [size_] more bytes in the buffer
+ */
+void
+amqp::internal::scanner::
+BufferedWriter::reserve (size_t size_) {
+    if (BUFFER_SIZE - m_used < size_) {
+        flush();
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scanner::
+BufferedWriter::write (std::string_view str_) {
+    while (!str_.empty()) {
+        if (m_used == BUFFER_SIZE) {
+            flush();
+        }
+
+        auto size = std::min (str_.size(), BUFFER_SIZE - m_used);
+        memcpy (m_buffer + m_used, str_.data(), size);
+
+        m_used += size;
+        str_.remove_prefix (size);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scanner::
+BufferedWriter::put (char c_) {
+    reserve (1);
+    m_buffer[m_used++] = c_;
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scanner::
+BufferedWriter::indent (size_t depth_) {
+    for (auto i = depth_ * 2 ; i > 0 ; --i) {
+        put (' ');
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scanner::
+BufferedWriter::hex (const char * bytes_, size_t size_) {
+    static const char digits[] = "0123456789abcdef";
+
+    for (size_t i { 0 } ; i < size_ ; ++i) {
+        reserve (2);
+
+        auto byte = static_cast<uint8_t>(bytes_[i]);
+        m_buffer[m_used++] = digits[byte >> 4];
+        m_buffer[m_used++] = digits[byte & 0xf];
+    }
+}
+
+/******************************************************************************/
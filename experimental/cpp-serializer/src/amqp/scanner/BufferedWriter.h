@@ -0,0 +1,76 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+/******************************************************************************/
+
+namespace amqp::internal::scanner {
+
+    /**
+     * Accumulates output in a fixed buffer that's written to a file
+     * descriptor each time it fills, so however much is written nothing
+     * more than the buffer is ever held in memory and nothing is
+     * allocated to write it
+     */
+    class BufferedWriter {
+        private :
+            static constexpr size_t BUFFER_SIZE { 1 << 16 };
+
+            int    m_fd;
+            size_t m_used;
+            char   m_buffer[BUFFER_SIZE];
+
+            void reserve (size_t);
+
+        public :
+            explicit BufferedWriter (int);
+            ~BufferedWriter();
+
+            BufferedWriter (const BufferedWriter &) = delete;
+
+            void write (std::string_view);
+            void put (char);
+
+            /**
+             * [depth_] levels of two spaces
+             */
+            void indent (size_t depth_);
+
+            /**
+             * Lower case hex, two digits a byte
+             */
+            void hex (const char *, size_t);
+
+            template<typename T>
+            void number (T);
+
+            void flush();
+    };
+
+}
+
+/******************************************************************************/
+
+template<typename T>
+void
+amqp::internal::scanner::
+BufferedWriter::number (T val_) {
+    // enough for any 64 bit integer or a double at full precision
+    reserve (32);
+
+    if constexpr (std::is_floating_point_v<T>) {
+        m_used += snprintf (m_buffer + m_used, 32, "%.17g", static_cast<double>(val_));
+    } else {
+        m_used = std::to_chars (
+            m_buffer + m_used, m_buffer + BUFFER_SIZE, val_).ptr - m_buffer;
+    }
+}
+
+/******************************************************************************/
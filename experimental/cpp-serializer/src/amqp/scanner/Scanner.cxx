@@ -0,0 +1,456 @@
+#include "Scanner.h"
+
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+/******************************************************************************/
+
+uint64_t
+amqp::internal::scanner::
+bigEndian (const char * bytes_, size_t width_) {
+    uint64_t rtn { 0 };
+    for (size_t i { 0 } ; i < width_ ; ++i) {
+        rtn = (rtn << 8) | static_cast<uint8_t>(bytes_[i]);
+    }
+    return rtn;
+}
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * How deeply arrays can nest within the descriptors of their
+     * elements, which nothing Corda writes does at all
+     */
+    const unsigned MAX_DEPTH = 32;
+
+    /**
+     * Whether [code_] is one the spec defines, the rest of each row
+     * being reserved and of no known width
+     */
+    bool
+    known (uint8_t code_) {
+        switch (code_) {
+            case 0x40 : case 0x41 : case 0x42 : case 0x43 : case 0x44 : case 0x45 :
+            case 0x50 : case 0x51 : case 0x52 : case 0x53 : case 0x54 : case 0x55 : case 0x56 :
+            case 0x60 : case 0x61 :
+            case 0x70 : case 0x71 : case 0x72 : case 0x73 : case 0x74 :
+            case 0x80 : case 0x81 : case 0x82 : case 0x83 : case 0x84 :
+            case 0x94 : case 0x98 :
+            case 0xa0 : case 0xa1 : case 0xa3 :
+            case 0xb0 : case 0xb1 : case 0xb3 :
+            case 0xc0 : case 0xc1 : case 0xd0 : case 0xd1 :
+            case 0xe0 : case 0xf0 :
+                return true;
+            default :
+                return false;
+        }
+    }
+
+    /**************************************************************************/
+
+    void
+    need (const char * from_, size_t size_, const char * end_) {
+        if (from_ > end_ || static_cast<size_t>(end_ - from_) < size_) {
+            throw std::runtime_error ("Truncated AMQP value");
+        }
+    }
+
+}
+
+/******************************************************************************
+ *
+ * class Value
+ *
+ ******************************************************************************/
+
+amqp::internal::scanner::
+Value::Value (const char * begin_, const char * end_)
+    : m_begin (begin_)
+    , m_count (0)
+    , m_elements (nullptr)
+    , m_elementDescriptor (nullptr)
+    , m_elementCode (0)
+{
+    need (begin_, 1, end_);
+
+    m_code = static_cast<uint8_t>(*begin_);
+
+    if (m_code == described_t) {
+        m_body = begin_ + 1;
+        m_end = skip (m_body, end_, 2, 0);
+        return;
+    }
+
+    scan (begin_ + 1, end_, 0, true);
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::
+Value::Value (uint8_t code_, const char * begin_, const char * end_)
+    : Value (code_, begin_, end_, 0)
+{ }
+
+/******************************************************************************/
+
+amqp::internal::scanner::
+Value::Value (
+    uint8_t code_,
+    const char * begin_,
+    const char * end_,
+    unsigned depth_,
+    bool whole_
+) : m_begin (begin_)
+    , m_code (code_)
+    , m_count (0)
+    , m_elements (nullptr)
+    , m_elementDescriptor (nullptr)
+    , m_elementCode (0)
+{
+    if (m_code == described_t) {
+        throw std::runtime_error ("Array elements can't themselves be described");
+    }
+
+    scan (begin_, end_, depth_, whole_);
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::Value
+amqp::internal::scanner::
+Value::header (const char * begin_, const char * end_) {
+    need (begin_, 1, end_);
+
+    Value rtn (static_cast<uint8_t>(*begin_), begin_ + 1, end_, 0, false);
+    rtn.m_begin = begin_;
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::Value
+amqp::internal::scanner::
+Value::header (uint8_t code_, const char * begin_, const char * end_) {
+    return Value (code_, begin_, end_, 0, false);
+}
+
+/******************************************************************************/
+
+/**
+ * A described value being a descriptor followed by a value, each of which
+ * can be described, every described constructor we meet just adds one
+ * more value to step over
+ */
+const char *
+amqp::internal::scanner::
+Value::skip (
+    const char * begin_,
+    const char * end_,
+    size_t count_,
+    unsigned depth_
+) {
+    auto at = begin_;
+
+    while (count_ > 0) {
+        need (at, 1, end_);
+
+        auto code = static_cast<uint8_t>(*at++);
+
+        if (code == described_t) {
+            ++count_;
+        } else {
+            at = Value (code, at, end_, depth_).end();
+            --count_;
+        }
+    }
+
+    return at;
+}
+
+/******************************************************************************/
+
+/**
+ * Everything following the constructor of a value that isn't described
+ */
+void
+amqp::internal::scanner::
+Value::scan (
+    const char * body_,
+    const char * end_,
+    unsigned depth_,
+    bool whole_
+) {
+    /*
+     * The width of the size and count of variable width and compound
+     * values, or of the value itself for fixed width ones
+     */
+    size_t width { 0 };
+    size_t size { 0 };
+
+    if (!known (m_code)) {
+        std::stringstream ss;
+        ss << "Unknown AMQP format code 0x" << std::hex
+           << static_cast<int>(m_code);
+        throw std::runtime_error (ss.str());
+    }
+
+    switch (m_code >> 4) {
+        case 0x4 : width = 0; break;
+        case 0x5 : width = 1; break;
+        case 0x6 : width = 2; break;
+        case 0x7 : width = 4; break;
+        case 0x8 : width = 8; break;
+        case 0x9 : width = 16; break;
+        case 0xa :
+        case 0xc :
+        case 0xe : width = 1; break;
+        case 0xb :
+        case 0xd :
+        case 0xf : width = 4; break;
+    }
+
+    m_body = body_;
+
+    if (m_code < 0xa0) {
+        size = width;
+    } else {
+        need (m_body, width, end_);
+        size = bigEndian (m_body, width);
+        m_body += width;
+
+        if (m_code >= 0xc0) {
+            // the size of a compound value includes its count
+            if (size < width) {
+                throw std::runtime_error ("Corrupt AMQP compound value");
+            }
+
+            need (m_body, width, end_);
+            m_count = static_cast<uint32_t>(bigEndian (m_body, width));
+            m_body += width;
+            size -= width;
+        }
+    }
+
+    if (whole_ || m_code < list8_t) {
+        need (m_body, size, end_);
+    }
+
+    m_end = m_body + size;
+
+    if (array()) {
+        auto limit = std::min (m_end, end_);
+        auto constructor = m_body;
+
+        if (constructor < limit && *constructor == described_t) {
+            if (depth_ >= MAX_DEPTH) {
+                throw std::runtime_error ("Corrupt AMQP value");
+            }
+
+            m_elementDescriptor = constructor + 1;
+            constructor = skip (m_elementDescriptor, limit, 1, depth_ + 1);
+        }
+
+        need (constructor, 1, limit);
+        m_elementCode = static_cast<uint8_t>(*constructor);
+        m_elements = constructor + 1;
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scanner::
+Value::list() const {
+    return m_code == list0_t || m_code == list8_t || m_code == list32_t;
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scanner::
+Value::map() const {
+    return m_code == map8_t || m_code == map32_t;
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scanner::
+Value::array() const {
+    return m_code == array8_t || m_code == array32_t;
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::Value
+amqp::internal::scanner::
+Value::descriptor() const {
+    if (!described()) {
+        throw std::runtime_error ("AMQP value is not described");
+    }
+
+    return Value (m_body, m_end);
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::Value
+amqp::internal::scanner::
+Value::value() const {
+    return Value (descriptor().end(), m_end);
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::Value
+amqp::internal::scanner::
+Value::elementDescriptor() const {
+    if (!m_elementDescriptor) {
+        throw std::runtime_error ("AMQP value is not an array of described values");
+    }
+
+    return Value (m_elementDescriptor, m_end);
+}
+
+/******************************************************************************/
+
+std::string_view
+amqp::internal::scanner::
+Value::bytes() const {
+    if ((m_code >> 4) != 0xa && (m_code >> 4) != 0xb) {
+        throw std::runtime_error ("AMQP value is not variable width");
+    }
+
+    return std::string_view (m_body, m_end - m_body);
+}
+
+/******************************************************************************/
+
+uint64_t
+amqp::internal::scanner::
+Value::ulong() const {
+    switch (m_code) {
+        case ulong0_t     : return 0;
+        case smallulong_t : return bigEndian (m_body, 1);
+        case ulong_t      : return bigEndian (m_body, 8);
+        default           : throw std::runtime_error ("AMQP value is not a ulong");
+    }
+}
+
+/******************************************************************************/
+
+int32_t
+amqp::internal::scanner::
+Value::int32() const {
+    switch (m_code) {
+        case 0x54 : return static_cast<int8_t>(*m_body);
+        case 0x71 : return static_cast<int32_t>(bigEndian (m_body, 4));
+        default   : throw std::runtime_error ("AMQP value is not an int");
+    }
+}
+
+/******************************************************************************/
+
+int64_t
+amqp::internal::scanner::
+Value::int64() const {
+    switch (m_code) {
+        case 0x55 : return static_cast<int8_t>(*m_body);
+        case 0x81 : return static_cast<int64_t>(bigEndian (m_body, 8));
+        default   : throw std::runtime_error ("AMQP value is not a long");
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::scanner::
+Value::boolean() const {
+    switch (m_code) {
+        case 0x41 : return true;
+        case 0x42 : return false;
+        case 0x56 : return *m_body != 0;
+        default   : throw std::runtime_error ("AMQP value is not a boolean");
+    }
+}
+
+/******************************************************************************/
+
+double
+amqp::internal::scanner::
+Value::float64() const {
+    if (m_code != 0x82) {
+        throw std::runtime_error ("AMQP value is not a double");
+    }
+
+    auto bits = bigEndian (m_body, 8);
+    double d;
+    memcpy (&d, &bits, sizeof (d));
+
+    return d;
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::Value
+amqp::internal::scanner::
+Value::first() const {
+    if (array()) {
+        return Value (m_elementCode, m_elements, m_end);
+    }
+
+    if (!list() && !map()) {
+        throw std::runtime_error ("AMQP value is not a list, map or array");
+    }
+
+    return Value (m_body, m_end);
+}
+
+/******************************************************************************/
+
+amqp::internal::scanner::Value
+amqp::internal::scanner::
+Value::next (const Value & element_) const {
+    if (array()) {
+        return Value (m_elementCode, element_.end(), m_end);
+    }
+
+    return Value (element_.end(), m_end);
+}
+
+/******************************************************************************/
+
+std::vector<amqp::internal::scanner::Value>
+amqp::internal::scanner::
+Value::elements() const {
+    if (!list() && !map() && !array()) {
+        throw std::runtime_error ("AMQP value is not a list, map or array");
+    }
+
+    std::vector<Value> rtn;
+
+    if (m_count == 0) {
+        return rtn;
+    }
+
+    // every element takes at least a byte, arrays of nulls aren't trusted either
+    if (m_count > static_cast<size_t>(m_end - m_body)) {
+        throw std::runtime_error ("Corrupt AMQP value");
+    }
+
+    rtn.reserve (m_count);
+    rtn.push_back (first());
+
+    while (rtn.size() < m_count) {
+        rtn.push_back (next (rtn.back()));
+    }
+
+    return rtn;
+}
+
+/******************************************************************************/
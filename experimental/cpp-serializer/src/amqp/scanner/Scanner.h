@@ -0,0 +1,203 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/******************************************************************************/
+
+namespace amqp::internal::scanner {
+
+    /**
+     * Read [width_] bytes as a big endian unsigned integer, AMQP's byte
+     * order throughout
+     */
+    uint64_t bigEndian (const char *, size_t width_);
+
+    /**
+     * AMQP 1.0 format codes, the first byte of every encoded value. The
+     * high nibble of all but the described constructor says how the size
+     * of the rest of the value is encoded
+     */
+    enum : uint8_t {
+        described_t  = 0x00,
+        null_t       = 0x40,
+        ulong0_t     = 0x44,
+        list0_t      = 0x45,
+        smallulong_t = 0x53,
+        ulong_t      = 0x80,
+        vbin8_t      = 0xa0,
+        str8_t       = 0xa1,
+        sym8_t       = 0xa3,
+        vbin32_t     = 0xb0,
+        str32_t      = 0xb1,
+        sym32_t      = 0xb3,
+        list8_t      = 0xc0,
+        map8_t       = 0xc1,
+        list32_t     = 0xd0,
+        map32_t      = 0xd1,
+        array8_t     = 0xe0,
+        array32_t    = 0xf0
+    };
+
+    /**
+     * A single AMQP encoded value found in a buffer by reading no more
+     * than its constructor and the width, size or count that follows it.
+     * Nothing inside it is decoded so stepping over a value, however
+     * large, costs the same as stepping over an int.
+     *
+     * Lists and maps carry the size of their encoding up front which is
+     * what lets us hop from one element to the next without looking
+     * inside them.
+     */
+    class Value {
+        private :
+            const char * m_begin;
+            const char * m_end;
+
+            /**
+             * For lists and maps the first element, for arrays their
+             * constructor, for described types the descriptor, otherwise
+             * the bytes of the value itself
+             */
+            const char * m_body;
+
+            uint8_t  m_code;
+            uint32_t m_count;
+
+            /**
+             * The elements of an array share a single constructor, which
+             * can itself be described
+             */
+            const char * m_elements;
+            const char * m_elementDescriptor;
+            uint8_t      m_elementCode;
+
+            Value (
+                uint8_t,
+                const char *,
+                const char *,
+                unsigned depth_,
+                bool whole_ = true);
+
+            /**
+             * The nesting of arrays within the descriptors of the
+             * elements of arrays, [depth_], being the only thing we
+             * recurse into to find where a value ends. Unless the
+             * [whole_] of a list, map or array is wanted its end isn't
+             * checked against the buffer's
+             */
+            void scan (const char *, const char *, unsigned depth_, bool whole_);
+
+            /**
+             * Where the [count_] values that follow [begin_] end,
+             * stepping along chains of described values rather than
+             * recursing through them so a run of described constructors
+             * costs no stack
+             */
+            static const char * skip (
+                const char * begin_,
+                const char * end_,
+                size_t count_,
+                unsigned depth_);
+
+        public :
+            /**
+             * Scan the value starting at [begin_], throwing if it's not
+             * a valid encoding or runs past [end_]
+             */
+            Value (const char * begin_, const char * end_);
+
+            /**
+             * Scan an element of an array, one whose constructor [code_]
+             * isn't part of its own encoding
+             */
+            Value (uint8_t code_, const char * begin_, const char * end_);
+
+            /**
+             * As the constructors but for a list, map or array only its
+             * constructor, size and count are scanned, and for an array
+             * the constructor of its elements. Its end is where its size
+             * says it is, which may be past [end_], so it's up to the
+             * caller to step through the elements from [firstElement]
+             * bounded by whichever end comes first.
+             */
+            static Value header (const char * begin_, const char * end_);
+            static Value header (uint8_t code_, const char * begin_, const char * end_);
+
+            const char * begin() const { return m_begin; }
+            const char * end() const { return m_end; }
+            size_t size() const { return m_end - m_begin; }
+
+            uint8_t code() const { return m_code; }
+
+            const char * body() const { return m_body; }
+
+            bool described() const { return m_code == described_t; }
+            bool list() const;
+            bool map() const;
+            bool array() const;
+
+            /**
+             * The number of elements of a list or array, for a map
+             * that's keys and values both
+             */
+            uint32_t count() const { return m_count; }
+
+            /**
+             * Where the first element of a list, map or array starts
+             */
+            const char * firstElement() const {
+                return m_elements ? m_elements : m_body;
+            }
+
+            /**
+             * Of a described value
+             */
+            Value descriptor() const;
+            Value value() const;
+
+            /**
+             * The format code every element of an array is encoded with
+             * and, if they're described, their shared descriptor
+             */
+            uint8_t elementCode() const { return m_elementCode; }
+            bool describedElements() const { return m_elementDescriptor != nullptr; }
+            Value elementDescriptor() const;
+
+            /**
+             * The bytes of a binary, string or symbol
+             */
+            std::string_view bytes() const;
+
+            uint64_t ulong() const;
+
+            /**
+             * Of a value encoded as the corresponding AMQP type, in any
+             * of its compact forms, throwing if it's anything else
+             */
+            int32_t int32() const;
+            int64_t int64() const;
+            bool boolean() const;
+            double float64() const;
+
+            /**
+             * Step through the elements of a list, map or array without
+             * collecting them, it's up to the caller to stop after [count]
+             */
+            Value first() const;
+            Value next (const Value &) const;
+
+            /**
+             * Every element of a list, map or array in order, throwing
+             * if there are more than there are bytes to hold them
+             */
+            std::vector<Value> elements() const;
+    };
+
+}
+
+/******************************************************************************/
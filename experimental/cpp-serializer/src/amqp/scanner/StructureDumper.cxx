@@ -0,0 +1,417 @@
+#include "StructureDumper.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#include "amqp/schema/Descriptors.h"
+#include "amqp/schema/descriptors/AMQPDescriptorRegistory.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const char *
+    typeName (uint8_t code_) {
+        using namespace amqp::internal::scanner;
+
+        switch (code_) {
+            case null_t : return "null";
+            case 0x41   :
+            case 0x42   :
+            case 0x56   : return "bool";
+            case 0x50   : return "ubyte";
+            case 0x51   : return "byte";
+            case 0x43   :
+            case 0x52   :
+            case 0x70   : return "uint";
+            case ulong0_t     :
+            case smallulong_t :
+            case ulong_t      : return "ulong";
+            case 0x54   :
+            case 0x71   : return "int";
+            case 0x55   :
+            case 0x81   : return "long";
+            case 0x60   : return "ushort";
+            case 0x61   : return "short";
+            case 0x72   : return "float";
+            case 0x73   : return "char";
+            case 0x74   : return "decimal32";
+            case 0x82   : return "double";
+            case 0x83   : return "timestamp";
+            case 0x84   : return "decimal64";
+            case 0x94   : return "decimal128";
+            case 0x98   : return "uuid";
+            case vbin8_t  :
+            case vbin32_t : return "binary";
+            case str8_t   :
+            case str32_t  : return "string";
+            case sym8_t   :
+            case sym32_t  : return "symbol";
+            case list0_t  :
+            case list8_t  :
+            case list32_t : return "list";
+            case map8_t   :
+            case map32_t  : return "map";
+            case array8_t  :
+            case array32_t : return "array";
+            default : return "unknown";
+        }
+    }
+
+    /**************************************************************************/
+
+    /**
+     * Sign extend a big endian integer [width_] bytes wide
+     */
+    int64_t
+    signedBigEndian (const char * bytes_, size_t width_) {
+        auto shift = 64 - (width_ * 8);
+        return static_cast<int64_t>(
+            amqp::internal::scanner::bigEndian (bytes_, width_) << shift) >> shift;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * class StructureDumper
+ *
+ ******************************************************************************/
+
+amqp::internal::scanner::
+StructureDumper::StructureDumper (BufferedWriter & out_)
+    : m_out (out_)
+    , m_base (nullptr)
+    , m_at (nullptr)
+{
+    for (size_t i { 1 } ; i < m_names.size() ; ++i) {
+        m_names[i] = amqp::describedToString (static_cast<uint32_t>(i));
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scanner::
+StructureDumper::dump (const char * begin_, const char * end_) {
+    m_base = begin_;
+    m_at = begin_;
+
+    try {
+        while (m_at < end_) {
+            m_stack.assign (1, Frame { m_at, end_, nullptr, 1, 0, 0, 0, 0 });
+
+            while (!m_stack.empty()) {
+                next();
+            }
+        }
+    } catch (const std::runtime_error & e) {
+        m_stack.clear();
+
+        m_out.write ("!! ");
+        m_out.write (e.what());
+        m_out.write (" at offset ");
+        m_out.number (m_at - m_base);
+        m_out.put ('\n');
+        m_out.flush();
+
+        throw;
+    }
+
+    m_out.flush();
+}
+
+/******************************************************************************/
+
+/**
+ * Write the next value of whatever's on top of the stack, pushing it if
+ * it's one with values of its own, or if there are none left pop it and
+ * carry on with its parent from where it ended
+ */
+void
+amqp::internal::scanner::
+StructureDumper::next() {
+    auto & top = m_stack.back();
+
+    if (top.remaining == 0) {
+        m_at = top.at;
+
+        if (top.close && top.close > top.end) {
+            m_at = top.end;
+            throw std::runtime_error ("Truncated AMQP value");
+        }
+
+        if (top.close && top.close != top.at) {
+            throw std::runtime_error (
+                std::string (typeName (top.code)) + " size doesn't match its elements");
+        }
+
+        auto end = top.at;
+        m_stack.pop_back();
+
+        if (!m_stack.empty()) {
+            m_stack.back().at = end;
+        }
+
+        return;
+    }
+
+    m_at = top.at;
+    --top.remaining;
+
+    auto map = top.code == map8_t || top.code == map32_t;
+    auto depth = top.depth + (map ? top.index % 2 : 0);
+    ++top.index;
+
+    // the elements of an array share a constructor, and can't be described
+    if (top.element == 0) {
+        if (top.at >= top.end) {
+            throw std::runtime_error ("Truncated AMQP value");
+        }
+
+        if (static_cast<uint8_t>(*top.at) == described_t) {
+            m_at = top.at + 1;
+            Value descriptor (m_at, top.end);
+
+            m_out.indent (depth);
+            described (descriptor);
+
+            auto end = top.end;
+            m_stack.push_back (Frame { descriptor.end(), end, nullptr, 1, 0, depth + 1, 0, 0 });
+            return;
+        }
+    }
+
+    auto value = top.element
+        ? Value::header (top.element, top.at, top.end)
+        : Value::header (top.at, top.end);
+
+    m_out.indent (depth);
+
+    if (value.list() || value.map() || value.array()) {
+        /*
+         * As Value::elements insists every element takes at least a byte
+         * of the compound's size, and since an array of nulls takes none
+         * of what's actually there its count is bounded by that as well
+         */
+        auto size = static_cast<size_t>(value.end() - value.body());
+        auto there = static_cast<size_t>(
+            std::max (std::min (value.end(), top.end), value.body()) - value.body());
+
+        if (value.count() > size
+            || (value.array() && (value.elementCode() >> 4) == 0x4 && value.count() > there))
+        {
+            throw std::runtime_error ("Corrupt AMQP value");
+        }
+
+        auto end = compound (value, top.end);
+        m_stack.push_back (Frame {
+            value.firstElement(), end, value.end(), value.count(), 0,
+            depth + 1, value.code(), value.array() ? value.elementCode() : uint8_t { 0 } });
+    } else {
+        primitive (value, top.end);
+        m_out.put ('\n');
+        top.at = value.end();
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::scanner::
+StructureDumper::described (const Value & descriptor_) {
+    m_out.write ("described ");
+
+    switch (descriptor_.code()) {
+        case ulong0_t :
+        case smallulong_t :
+        case ulong_t : {
+            auto key = descriptor_.ulong();
+            auto id = amqp::stripCorda (key);
+
+            if ((key & ~0xffffffffUL) == amqp::schema::descriptors::DESCRIPTOR_TOP_32BITS
+                && id < m_names.size() && id > 0)
+            {
+                m_out.number (id);
+                m_out.put (' ');
+                m_out.write (m_names[id]);
+            } else {
+                m_out.number (key);
+            }
+            break;
+        }
+        case sym8_t :
+        case sym32_t : {
+            m_out.write (descriptor_.bytes());
+            break;
+        }
+        default : {
+            primitive (descriptor_, descriptor_.end());
+        }
+    }
+
+    m_out.put ('\n');
+}
+
+/******************************************************************************/
+
+/**
+ * Lists and arrays have their elements printed beneath them. Map keys
+ * are too, each with its value beneath that.
+ *
+ * @return where the elements must end by, the compound's own end unless
+ * that's past the end of what it's in
+ */
+const char *
+amqp::internal::scanner::
+StructureDumper::compound (const Value & value_, const char * end_) {
+    auto end = std::min (value_.end(), end_);
+
+    m_out.write (typeName (value_.code()));
+    m_out.put (' ');
+    m_out.number (value_.map() ? value_.count() / 2 : value_.count());
+
+    if (value_.array()) {
+        m_out.write (" of ");
+        m_out.write (typeName (value_.elementCode()));
+
+        if (value_.describedElements()) {
+            m_out.write (" described ");
+
+            m_at = value_.body() + 1;
+            Value descriptor (m_at, end);
+
+            if (descriptor.code() == sym8_t || descriptor.code() == sym32_t) {
+                m_out.write (descriptor.bytes());
+            } else {
+                primitive (descriptor, end);
+            }
+        }
+    }
+
+    m_out.write (" (");
+    m_out.number (value_.size());
+    m_out.write (" bytes)\n");
+
+    return end;
+}
+
+/******************************************************************************/
+
+/**
+ * Nothing past [end_] is read, whatever the value's size claims
+ */
+void
+amqp::internal::scanner::
+StructureDumper::primitive (const Value & value_, const char * end_) {
+    auto body = value_.body();
+    auto width = static_cast<size_t>(std::max (std::min (value_.end(), end_), body) - body);
+
+    // fixed width values are only ever read whole
+    if (value_.code() < vbin8_t && width != static_cast<size_t>(value_.end() - body)) {
+        throw std::runtime_error ("Truncated AMQP value");
+    }
+
+    m_out.write (typeName (value_.code()));
+
+    switch (value_.code()) {
+        case null_t :
+            break;
+        case 0x41 :
+            m_out.write (" true");
+            break;
+        case 0x42 :
+            m_out.write (" false");
+            break;
+        case 0x56 :
+            m_out.write (*body ? " true" : " false");
+            break;
+        case 0x43 :
+        case ulong0_t :
+            m_out.write (" 0");
+            break;
+        case 0x50 :
+        case 0x52 :
+        case smallulong_t :
+        case 0x60 :
+        case 0x70 :
+        case ulong_t :
+            m_out.put (' ');
+            m_out.number (bigEndian (body, width));
+            break;
+        case 0x51 :
+        case 0x54 :
+        case 0x55 :
+        case 0x61 :
+        case 0x71 :
+        case 0x81 :
+        case 0x83 :
+            m_out.put (' ');
+            m_out.number (signedBigEndian (body, width));
+            break;
+        case 0x72 : {
+            auto bits = static_cast<uint32_t>(bigEndian (body, width));
+            float f;
+            memcpy (&f, &bits, sizeof (f));
+            m_out.put (' ');
+            m_out.number (f);
+            break;
+        }
+        case 0x82 : {
+            auto bits = bigEndian (body, width);
+            double d;
+            memcpy (&d, &bits, sizeof (d));
+            m_out.put (' ');
+            m_out.number (d);
+            break;
+        }
+        case vbin8_t :
+        case vbin32_t :
+            m_out.put (' ');
+            m_out.number (width);
+            m_out.write (" bytes");
+            break;
+        case str8_t :
+        case str32_t :
+        case sym8_t :
+        case sym32_t :
+            m_out.put (' ');
+            string (std::string_view (body, width));
+            break;
+        default :
+            // chars, decimals and uuids are shown as their raw bytes
+            m_out.write (" 0x");
+            m_out.hex (body, width);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Quoted, with anything unprintable escaped since we're most likely
+ * looking at something that's broken
+ */
+void
+amqp::internal::scanner::
+StructureDumper::string (std::string_view bytes_) {
+    m_out.put ('"');
+
+    for (auto c : bytes_) {
+        auto byte = static_cast<uint8_t>(c);
+
+        if (c == '"' || c == '\\') {
+            m_out.put ('\\');
+            m_out.put (c);
+        } else if (byte < 0x20 || byte == 0x7f) {
+            m_out.write ("\\x");
+            m_out.hex (&c, 1);
+        } else {
+            m_out.put (c);
+        }
+    }
+
+    m_out.put ('"');
+}
+
+/******************************************************************************/
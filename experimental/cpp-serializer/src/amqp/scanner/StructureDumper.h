@@ -0,0 +1,91 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <array>
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include "Scanner.h"
+#include "BufferedWriter.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::scanner {
+
+    /**
+     * Prints the structure of any AMQP encoded data, one line per value
+     * indented by how deeply it's nested, without needing to know
+     * anything about what it represents. Descriptors Corda assigns are
+     * named as they're found, anything else is printed as is.
+     *
+     * Values are stepped through straight from the encoded bytes and
+     * written out as they're reached so the size of what can be dumped
+     * is bounded only by the input, not by memory. When the encoding is
+     * broken everything up to that point has been written and where it
+     * broke is reported.
+     *
+     * Nothing is scanned ahead of being written, a list whose size runs
+     * past the end of what it's in having its elements written until
+     * the one that actually breaks, and what's being stepped through is
+     * kept on a stack of our own so however deeply the input nests
+     * it can't exhaust the real one.
+     */
+    class StructureDumper {
+        private :
+            BufferedWriter & m_out;
+
+            /**
+             * Where the bytes being dumped start and how far we'd got,
+             * to report the offset of anything malformed
+             */
+            const char * m_base;
+            const char * m_at;
+
+            /**
+             * describedToString for each of Corda's descriptors, looked
+             * up once rather than per value
+             */
+            std::array<std::string, 12> m_names;
+
+            /**
+             * A described value or a list, map or array we're part way
+             * through, [remaining] values from [at] to dump, ending no
+             * later than [end]. Compounds know where their size says
+             * they [close], their [code] and, for arrays, the [element]
+             * code their elements share
+             */
+            struct Frame {
+                const char * at;
+                const char * end;
+                const char * close;
+                uint32_t     remaining;
+                uint32_t     index;
+                size_t       depth;
+                uint8_t      code;
+                uint8_t      element;
+            };
+
+            std::vector<Frame> m_stack;
+
+            void next();
+            void described (const Value &);
+            const char * compound (const Value &, const char *);
+            void primitive (const Value &, const char *);
+            void string (std::string_view);
+
+        public :
+            explicit StructureDumper (BufferedWriter &);
+
+            /**
+             * Dump every value encoded between [begin_] and [end_],
+             * throwing on the first that can't be scanned once the
+             * error has been written out
+             */
+            void dump (const char * begin_, const char * end_);
+    };
+
+}
+
+/******************************************************************************/
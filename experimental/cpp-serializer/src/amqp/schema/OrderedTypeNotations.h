@@ -63,6 +63,13 @@ namespace amqp::internal::schema {
         public :
             void insert (uPtr<T> && ptr);
 
+            /**
+             * Append a level that's already known to be correctly ordered
+             * with respect to those before it, i.e. one taken from a set
+             * of notations that have previously been sorted
+             */
+            void insertLevel (std::list<uPtr<T>> &&);
+
             friend std::ostream & ::operator << <> (
                     std::ostream &,
                     const amqp::internal::schema::OrderedTypeNotations<T> &);
@@ -130,6 +137,15 @@ OrderedTypeNotations<T>::insertNewList(
 
 /******************************************************************************/
 
+template<class T>
+void
+amqp::internal::schema::
+OrderedTypeNotations<T>::insertLevel (std::list<uPtr<T>> && level_) {
+    m_schemas.emplace_back (std::move (level_));
+}
+
+/******************************************************************************/
+
 template<class T>
 void
 amqp::internal::schema::
@@ -70,6 +70,8 @@ namespace amqp::internal::schema {
 
             const std::vector<std::unique_ptr<Field>> & fields() const;
 
+            const decltype (m_provides) & provides() const { return m_provides; }
+
             Type type() const override;
 
             int dependsOn (const OrderedTypeNotation &) const override;
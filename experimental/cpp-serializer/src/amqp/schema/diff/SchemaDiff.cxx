@@ -0,0 +1,462 @@
+#include "SchemaDiff.h"
+
+#include <ostream>
+#include <unordered_map>
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Restricted.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::schema;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * Length prefixed so no two different sequences of strings can hash
+     * the same by running into each other
+     */
+    void
+    put (std::string & buf_, const std::string & s_) {
+        auto size = static_cast<uint32_t>(s_.size());
+
+        for (int i { 0 } ; i < 4 ; ++i) {
+            buf_ += static_cast<char>((size >> (8 * i)) & 0xff);
+        }
+
+        buf_ += s_;
+    }
+
+    void
+    put (std::string & buf_, const MerkleSchema::Digest & digest_) {
+        buf_.append (reinterpret_cast<const char *>(digest_.data()), digest_.size());
+    }
+
+    /**************************************************************************/
+
+    std::string
+    kind (const AMQPTypeNotation & type_) {
+        if (type_.type() == AMQPTypeNotation::composite_t) {
+            return "composite";
+        }
+
+        switch (dynamic_cast<const Restricted &> (type_).restrictedType()) {
+            case Restricted::list_t  : return "list";
+            case Restricted::map_t   : return "map";
+            case Restricted::enum_t  : return "enum";
+            case Restricted::array_t : return "array";
+        }
+
+        return "restricted";
+    }
+
+    /**************************************************************************/
+
+    std::vector<MerkleSchema::Member>
+    members (const AMQPTypeNotation & type_) {
+        std::vector<MerkleSchema::Member> rtn;
+
+        if (type_.type() == AMQPTypeNotation::composite_t) {
+            for (const auto & field : dynamic_cast<const Composite &> (type_)) {
+                rtn.push_back ({ field->name(), field->resolvedType(), field->mandatory() });
+            }
+
+            return rtn;
+        }
+
+        const auto & restricted = dynamic_cast<const Restricted &> (type_);
+
+        switch (restricted.restrictedType()) {
+            case Restricted::enum_t : {
+                for (auto & choice : dynamic_cast<const Enum &> (restricted).makeChoices()) {
+                    rtn.push_back ({ std::move (choice), "", true });
+                }
+                break;
+            }
+            case Restricted::map_t : {
+                auto of = restricted.begin();
+                rtn.push_back ({ "{key}", *of, true });
+                rtn.push_back ({ "{value}", *std::next (of), true });
+                break;
+            }
+            case Restricted::list_t :
+            case Restricted::array_t : {
+                rtn.push_back ({ "[]", *restricted.begin(), true });
+                break;
+            }
+        }
+
+        return rtn;
+    }
+
+    /**************************************************************************/
+
+    std::string
+    spell (const MerkleSchema::Member & member_) {
+        if (member_.type.empty()) {
+            return "";
+        }
+
+        return member_.type + (member_.mandatory ? "" : "?");
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::MerkleSchema
+ *
+ ******************************************************************************/
+
+amqp::internal::schema::
+MerkleSchema::MerkleSchema (const Schema & schema_) {
+    std::vector<Node *> order;
+
+    for (const auto & level : schema_) {
+        for (const auto & type : level) {
+            Node node;
+            node.type = type.get();
+            node.kind = kind (*type);
+            node.members = members (*type);
+
+            std::string buf;
+            put (buf, node.kind);
+            put (buf, type->name());
+
+            for (const auto & member : node.members) {
+                put (buf, member.name);
+                put (buf, member.type);
+                buf += member.mandatory ? '1' : '0';
+            }
+
+            node.local = Murmur3::hash (buf.data(), buf.size());
+
+            auto inserted = m_nodes.emplace (type->name(), std::move (node));
+
+            if (inserted.second) {
+                order.push_back (&inserted.first->second);
+            }
+        }
+    }
+
+    std::set<std::string> referenced;
+
+    for (auto & node : m_nodes) {
+        std::set<std::string> seen;
+
+        for (const auto & member : node.second.members) {
+            if (m_nodes.count (member.type) && seen.insert (member.type).second) {
+                node.second.children.push_back (member.type);
+
+                if (member.type != node.first) {
+                    referenced.insert (member.type);
+                }
+            }
+        }
+    }
+
+    /*
+     * The last level first, its types depending on nothing else
+     */
+    std::map<const Node *, bool> hashed;
+
+    for (auto node = order.rbegin() ; node != order.rend() ; ++node) {
+        if (!hashed.count (*node)) {
+            hash (**node, hashed);
+        }
+    }
+
+    for (const auto & node : m_nodes) {
+        if (!referenced.count (node.first)) {
+            m_roots.push_back (node.first);
+        }
+    }
+
+    /*
+     * Types that only refer to each other in a loop have nothing above
+     * them, one of each such loop stands in as a root so every type can
+     * be reached from them
+     */
+    std::set<std::string> reached;
+    std::vector<std::string> pending (m_roots);
+
+    auto reach = [&]() {
+        while (!pending.empty()) {
+            auto name = std::move (pending.back());
+            pending.pop_back();
+
+            if (reached.insert (name).second) {
+                for (const auto & child : m_nodes.at (name).children) {
+                    pending.push_back (child);
+                }
+            }
+        }
+    };
+
+    reach();
+
+    for (const auto & node : m_nodes) {
+        if (!reached.count (node.first)) {
+            m_roots.push_back (node.first);
+            pending.push_back (node.first);
+            reach();
+        }
+    }
+
+    std::string buf;
+    for (const auto & root : m_roots) {
+        put (buf, root);
+        put (buf, m_nodes.at (root).hash);
+    }
+
+    m_root = Murmur3::hash (buf.data(), buf.size());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::schema::
+MerkleSchema::hash (Node & node_, std::map<const Node *, bool> & hashed_) {
+    hashed_[&node_] = false;
+
+    std::string buf;
+    put (buf, node_.local);
+
+    for (const auto & name : node_.children) {
+        auto & child = m_nodes.at (name);
+        auto state = hashed_.find (&child);
+
+        if (state == hashed_.end()) {
+            hash (child, hashed_);
+            put (buf, child.hash);
+        } else if (state->second) {
+            put (buf, child.hash);
+        } else {
+            put (buf, name);
+        }
+    }
+
+    node_.hash = Murmur3::hash (buf.data(), buf.size());
+
+    hashed_[&node_] = true;
+}
+
+/******************************************************************************/
+
+const amqp::internal::schema::MerkleSchema::Node *
+amqp::internal::schema::
+MerkleSchema::find (const std::string & name_) const {
+    auto node = m_nodes.find (name_);
+
+    return node == m_nodes.end() ? nullptr : &node->second;
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::SchemaDiff
+ *
+ ******************************************************************************/
+
+amqp::internal::schema::
+SchemaDiff::SchemaDiff (
+        const MerkleSchema & from_,
+        const MerkleSchema & to_
+) : m_from (from_)
+  , m_to (to_)
+  , m_compared (0)
+{
+    if (from_.root() == to_.root()) {
+        return;
+    }
+
+    std::set<std::string> roots (from_.roots().begin(), from_.roots().end());
+    roots.insert (to_.roots().begin(), to_.roots().end());
+
+    for (const auto & root : roots) {
+        descend (root);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::schema::
+SchemaDiff::descend (const std::string & name_) {
+    if (!m_seen.insert (name_).second) {
+        return;
+    }
+
+    auto from = m_from.find (name_);
+    auto to = m_to.find (name_);
+
+    if (!from && !to) {
+        return;
+    }
+
+    ++m_compared;
+
+    if (!from) {
+        m_changes.push_back ({ type_added, name_, "", "", to->kind });
+
+        for (const auto & child : to->children) {
+            descend (child);
+        }
+
+        return;
+    }
+
+    if (!to) {
+        m_changes.push_back ({ type_removed, name_, "", from->kind, "" });
+
+        for (const auto & child : from->children) {
+            descend (child);
+        }
+
+        return;
+    }
+
+    if (from->hash == to->hash) {
+        return;
+    }
+
+    if (from->local != to->local) {
+        compare (*from, *to);
+    }
+
+    for (const auto & child : from->children) {
+        descend (child);
+    }
+
+    for (const auto & child : to->children) {
+        descend (child);
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::schema::
+SchemaDiff::compare (
+        const MerkleSchema::Node & from_,
+        const MerkleSchema::Node & to_
+) {
+    const auto & name = from_.type->name();
+
+    if (from_.kind != to_.kind) {
+        m_changes.push_back ({ kind_changed, name, "", from_.kind, to_.kind });
+        return;
+    }
+
+    std::unordered_map<std::string, size_t> was;
+    for (size_t i { 0 } ; i < from_.members.size() ; ++i) {
+        was.emplace (from_.members[i].name, i);
+    }
+
+    std::unordered_map<std::string, size_t> is;
+    for (size_t i { 0 } ; i < to_.members.size() ; ++i) {
+        is.emplace (to_.members[i].name, i);
+    }
+
+    for (const auto & member : to_.members) {
+        auto w = was.find (member.name);
+
+        if (w == was.end()) {
+            m_changes.push_back ({ field_added, name, member.name, "", spell (member) });
+            continue;
+        }
+
+        const auto & before = from_.members[w->second];
+
+        if (before.type != member.type || before.mandatory != member.mandatory) {
+            m_changes.push_back ({
+                field_retyped, name, member.name, spell (before), spell (member) });
+        }
+    }
+
+    std::vector<std::string> before;
+    for (const auto & member : from_.members) {
+        if (!is.count (member.name)) {
+            m_changes.push_back ({ field_removed, name, member.name, spell (member), "" });
+        } else {
+            before.push_back (member.name);
+        }
+    }
+
+    /*
+     * Fields are written in order, amongst those both versions have any
+     * that have changed places will be read as one another
+     */
+    std::unordered_map<std::string, size_t> position;
+    for (size_t i { 0 } ; i < before.size() ; ++i) {
+        position.emplace (before[i], i);
+    }
+
+    size_t after { 0 };
+    for (const auto & member : to_.members) {
+        auto p = position.find (member.name);
+
+        if (p == position.end()) {
+            continue;
+        }
+
+        if (p->second != after) {
+            m_changes.push_back ({
+                field_moved, name, member.name,
+                std::to_string (p->second), std::to_string (after) });
+        }
+
+        ++after;
+    }
+}
+
+/******************************************************************************/
+
+std::ostream &
+operator << (
+        std::ostream & out_,
+        const amqp::internal::schema::SchemaDiff::Change & change_
+) {
+    using amqp::internal::schema::SchemaDiff;
+
+    switch (change_.change) {
+        case SchemaDiff::type_added :
+            return out_ << "+ " << change_.type << " (" << change_.to << ")";
+        case SchemaDiff::type_removed :
+            return out_ << "- " << change_.type << " (" << change_.from << ")";
+        case SchemaDiff::kind_changed :
+            return out_ << "~ " << change_.type << " : "
+                        << change_.from << " -> " << change_.to;
+        default :
+            break;
+    }
+
+    out_ << (change_.change == SchemaDiff::field_added
+                ? "+ "
+                : change_.change == SchemaDiff::field_removed ? "- " : "~ ")
+         << change_.type << "." << change_.field;
+
+    switch (change_.change) {
+        case SchemaDiff::field_added :
+            if (!change_.to.empty()) out_ << " : " << change_.to;
+            break;
+        case SchemaDiff::field_removed :
+            if (!change_.from.empty()) out_ << " : " << change_.from;
+            break;
+        case SchemaDiff::field_retyped :
+            out_ << " : " << change_.from << " -> " << change_.to;
+            break;
+        case SchemaDiff::field_moved :
+            out_ << " : moved from " << change_.from << " to " << change_.to;
+            break;
+        default :
+            break;
+    }
+
+    return out_;
+}
+
+/******************************************************************************/
@@ -0,0 +1,181 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <set>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "amqp/schema/fingerprint/Murmur3.h"
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    class Schema;
+    class AMQPTypeNotation;
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::internal::schema::MerkleSchema
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    /**
+     * A schema as a Merkle tree of the types it holds. Each type hashes
+     * its own shape; for a Composite the names, types and nullability of
+     * its fields in order, for a Restricted type what it holds. Over that
+     * goes the hash of everything beneath it, so two types with the same
+     * hash are the same all the way down and need not be looked into.
+     *
+     * Types are hashed bottom up, walking the levels of the schema's
+     * [OrderedTypeNotations] from the last, whose types depend on nothing
+     * else, back to the first. Anything reached that isn't hashed yet is
+     * hashed there and then, and a type met again while it's still being
+     * hashed, a class that refers back to itself, is mixed in by name.
+     *
+     * Holds on to the schema's types, so mustn't outlive it.
+     */
+    class MerkleSchema {
+        public :
+            using Digest = Murmur3::Digest;
+
+            struct Member {
+                std::string name;
+                std::string type;
+                bool        mandatory;
+            };
+
+            struct Node {
+                const AMQPTypeNotation * type { nullptr };
+
+                /**
+                 * composite, list, map, array or enum
+                 */
+                std::string kind;
+
+                /**
+                 * The fields of a Composite, the constants of an enum,
+                 * or what a collection holds as "[]", "{key}" and
+                 * "{value}"
+                 */
+                std::vector<Member> members;
+
+                /**
+                 * The other types of the schema it refers to
+                 */
+                std::vector<std::string> children;
+
+                Digest local { };
+                Digest hash { };
+            };
+
+        private :
+            std::map<std::string, Node> m_nodes;
+
+            /**
+             * Types nothing else refers to, by name
+             */
+            std::vector<std::string> m_roots;
+
+            Digest m_root { };
+
+            /**
+             * [hashed_] maps each type reached to whether it's finished
+             * with or still being hashed
+             */
+            void hash (Node &, std::map<const Node *, bool> & hashed_);
+
+        public :
+            explicit MerkleSchema (const Schema &);
+
+            const Digest & root() const { return m_root; }
+            const std::vector<std::string> & roots() const { return m_roots; }
+
+            /**
+             * nullptr for a type the schema doesn't hold, which includes
+             * the primitives
+             */
+            const Node * find (const std::string & name_) const;
+
+            size_t size() const { return m_nodes.size(); }
+    };
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::internal::schema::SchemaDiff
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    /**
+     * What changed between two schemas, types matched by name. Starting
+     * from the roots of both it only goes down through types whose hashes
+     * differ so the work done follows the size of the change, not that of
+     * the schemas; two identical schemas cost no more than a comparison
+     * of their roots.
+     */
+    class SchemaDiff {
+        public :
+            enum change_t {
+                type_added, type_removed, kind_changed,
+                field_added, field_removed, field_retyped, field_moved
+            };
+
+            /**
+             * [from] and [to] are the type of a field, "?" after those
+             * that may be null, the kind of a type or the position of
+             * a field amongst those both versions have
+             */
+            struct Change {
+                change_t    change;
+                std::string type;
+                std::string field;
+                std::string from;
+                std::string to;
+            };
+
+        private :
+            const MerkleSchema & m_from;
+            const MerkleSchema & m_to;
+
+            std::vector<Change> m_changes;
+            std::set<std::string> m_seen;
+
+            size_t m_compared;
+
+            void descend (const std::string &);
+
+            void compare (const MerkleSchema::Node &, const MerkleSchema::Node &);
+
+        public :
+            SchemaDiff (const MerkleSchema & from_, const MerkleSchema & to_);
+
+            const std::vector<Change> & changes() const { return m_changes; }
+
+            bool empty() const { return m_changes.empty(); }
+
+            /**
+             * How many types were looked at to find the changes
+             */
+            size_t compared() const { return m_compared; }
+    };
+
+}
+
+/******************************************************************************/
+
+std::ostream & operator << (
+    std::ostream &,
+    const amqp::internal::schema::SchemaDiff::Change &);
+
+/******************************************************************************/
@@ -0,0 +1,150 @@
+#include "SchemaEvolver.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * A field's default as its type's reader would have dumped the value
+     * had the blob had it, the schema holding defaults as plain text
+     */
+    std::string
+    asDumped (const amqp::internal::schema::Field & field_) {
+        const auto & value = field_.defaultValue();
+        const auto & type = field_.type();
+
+        if (value.empty()) {
+            return "null";
+        }
+
+        try {
+            if (type == "string") {
+                return "\"" + value + "\"";
+            } else if (type == "int" || type == "long") {
+                return std::to_string (std::stoll (value));
+            } else if (type == "double") {
+                return std::to_string (std::stod (value));
+            } else if (type == "boolean") {
+                return std::to_string (value == "true");
+            }
+        } catch (const std::logic_error &) {
+            throw std::runtime_error (
+                "Default " + value + " of field " + field_.name()
+                    + " isn't a valid " + type);
+        }
+
+        return value;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::Evolution
+ *
+ ******************************************************************************/
+
+amqp::internal::schema::
+Evolution::Evolution (
+        const Composite & from_,
+        const Composite & to_
+) : m_targetOf (from_.fields().size(), DROPPED)
+{
+    std::unordered_map<std::string, size_t> sources;
+    for (size_t i { 0 } ; i < from_.fields().size() ; ++i) {
+        sources.emplace (from_.fields()[i]->name(), i);
+    }
+
+    m_names.reserve (to_.fields().size());
+
+    for (size_t i { 0 } ; i < to_.fields().size() ; ++i) {
+        const auto & field = *to_.fields()[i];
+
+        m_names.push_back (field.name());
+
+        auto source = sources.find (field.name());
+
+        if (source != sources.end()) {
+            const auto & was = *from_.fields()[source->second];
+
+            if (was.type() != field.type()) {
+                throw std::runtime_error (
+                    "Field " + field.name() + " of " + to_.name()
+                        + " changed type from " + was.type()
+                        + " to " + field.type());
+            }
+
+            m_targetOf[source->second] = i;
+        } else {
+            if (field.mandatory() && field.defaultValue().empty()) {
+                throw std::runtime_error (
+                    "Mandatory field " + field.name() + " of " + to_.name()
+                        + " is missing from the blob and has no default");
+            }
+
+            m_defaults.push_back ({ i, field.name(), asDumped (field) });
+        }
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::schema::
+Evolution::identity() const {
+    if (!m_defaults.empty() || m_targetOf.size() != m_names.size()) {
+        return false;
+    }
+
+    for (size_t i { 0 } ; i < m_targetOf.size() ; ++i) {
+        if (m_targetOf[i] != i) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::SchemaEvolver
+ *
+ ******************************************************************************/
+
+std::shared_ptr<const amqp::internal::schema::Evolution>
+amqp::internal::schema::
+SchemaEvolver::evolution (
+        const Composite & from_,
+        const Composite & to_
+) {
+    auto key = std::make_pair (from_.descriptor(), to_.descriptor());
+
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    auto it = m_evolutions.find (key);
+
+    if (it == m_evolutions.end()) {
+        it = m_evolutions.emplace (
+            std::move (key),
+            std::make_shared<const Evolution> (from_, to_)).first;
+    }
+
+    return it->second;
+}
+
+/******************************************************************************/
+
+size_t
+amqp::internal::schema::
+SchemaEvolver::size() const {
+    std::lock_guard<std::mutex> lock (m_lock);
+
+    return m_evolutions.size();
+}
+
+/******************************************************************************/
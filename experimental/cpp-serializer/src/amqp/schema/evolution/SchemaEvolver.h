@@ -0,0 +1,123 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <utility>
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    class Composite;
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::internal::schema::Evolution
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    /**
+     * How the fields of a Composite as it was serialised map onto the
+     * fields of the Composite we now expect. Fields are matched by name,
+     * those no longer wanted are dropped and those the blob doesn't have
+     * take their default. It's all worked out up front so reading an
+     * object through it is no more than an index per field.
+     *
+     * An Evolution is between two versions of a single Composite, the
+     * Composites its fields hold aren't evolved with it.
+     */
+    class Evolution {
+        public :
+            static constexpr size_t DROPPED { std::numeric_limits<size_t>::max() };
+
+            /**
+             * The [value] being formatted as a field of its type dumps
+             */
+            struct Default {
+                size_t      index;
+                std::string name;
+                std::string value;
+            };
+
+        private :
+            /**
+             * For each field of the blob's Composite the position it takes
+             * in the target, or [DROPPED]
+             */
+            std::vector<size_t> m_targetOf;
+
+            /**
+             * The target's fields the blob doesn't have
+             */
+            std::vector<Default> m_defaults;
+
+            std::vector<std::string> m_names;
+
+        public :
+            /**
+             * Throws if a field common to both has changed its type or the
+             * target has a mandatory field the blob lacks with nothing to
+             * default it to
+             */
+            Evolution (const Composite & from_, const Composite & to_);
+
+            size_t targetOf (size_t source_) const { return m_targetOf[source_]; }
+            size_t sourceFields() const { return m_targetOf.size(); }
+            size_t targetFields() const { return m_names.size(); }
+
+            const std::string & name (size_t target_) const { return m_names[target_]; }
+            const std::vector<Default> & defaults() const { return m_defaults; }
+
+            /**
+             * True when nothing has changed, every field maps onto itself
+             */
+            bool identity() const;
+    };
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::internal::schema::SchemaEvolver
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    /**
+     * Hands out the [Evolution] between two Composites, working each one
+     * out the first time that pair is seen and reusing it from then on.
+     *
+     * Pairs are keyed on the Composites' descriptors, being fingerprints
+     * of the types they describe, so the same evolution is found whichever
+     * blob the schemas were read from.
+     */
+    class SchemaEvolver {
+        private :
+            mutable std::mutex m_lock;
+
+            std::map<
+                std::pair<std::string, std::string>,
+                std::shared_ptr<const Evolution>> m_evolutions;
+
+        public :
+            std::shared_ptr<const Evolution> evolution (
+                const Composite & from_,
+                const Composite & to_);
+
+            size_t size() const;
+    };
+
+}
+
+/******************************************************************************/
@@ -151,3 +151,21 @@ Field::requires() const {
 
 /******************************************************************************/
 
+/**
+ * Empty when the field has no default, in which case it's null
+ */
+const std::string &
+amqp::internal::schema::
+Field::defaultValue() const {
+    return m_default;
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::schema::
+Field::mandatory() const {
+    return m_mandatory;
+}
+
+/******************************************************************************/
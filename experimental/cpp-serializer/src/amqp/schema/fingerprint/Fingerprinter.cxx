@@ -0,0 +1,460 @@
+#include "Fingerprinter.h"
+
+#include <cctype>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Murmur3.h"
+
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+#include "amqp/schema/restricted-types/Enum.h"
+#include "amqp/schema/restricted-types/Restricted.h"
+
+/******************************************************************************/
+
+namespace {
+
+    /*
+     * What the JVM mixes into the hash to mark out the shape of a type,
+     * these must match Corda's FingerprintWriter exactly
+     */
+    const std::string ARRAY ("Array = true");                // NOLINT
+    const std::string ENUM ("Enum = true");                  // NOLINT
+    const std::string ALREADY_SEEN ("Already seen = true");  // NOLINT
+    const std::string NULLABLE ("Nullable = true");          // NOLINT
+    const std::string NOT_NULLABLE ("Nullable = false");     // NOLINT
+
+    const std::string DOMAIN ("net.corda:");                 // NOLINT
+
+    struct Primitive {
+        std::string unboxed;
+        std::string boxed;
+    };
+
+    /**
+     * The schema only names primitives by their AMQP type, what the JVM
+     * hashed was the Java class; the primitive itself for a property
+     * with a default, its box for anything that could be null or was a
+     * type parameter.
+     */
+    const std::map<std::string, Primitive> primitives { // NOLINT
+        { "int",                 { "int",              "java.lang.Integer" } },
+        { "long",                { "long",             "java.lang.Long" } },
+        { "short",               { "short",            "java.lang.Short" } },
+        { "byte",                { "byte",             "java.lang.Byte" } },
+        { "char",                { "char",             "java.lang.Character" } },
+        { "float",               { "float",            "java.lang.Float" } },
+        { "double",              { "double",           "java.lang.Double" } },
+        { "boolean",             { "boolean",          "java.lang.Boolean" } },
+        { "string",              { "java.lang.String", "java.lang.String" } },
+        { "java.lang.Integer",   { "java.lang.Integer",   "java.lang.Integer" } },
+        { "java.lang.Long",      { "java.lang.Long",      "java.lang.Long" } },
+        { "java.lang.Short",     { "java.lang.Short",     "java.lang.Short" } },
+        { "java.lang.Byte",      { "java.lang.Byte",      "java.lang.Byte" } },
+        { "java.lang.Character", { "java.lang.Character", "java.lang.Character" } },
+        { "java.lang.Float",     { "java.lang.Float",     "java.lang.Float" } },
+        { "java.lang.Double",    { "java.lang.Double",    "java.lang.Double" } },
+        { "java.lang.Boolean",   { "java.lang.Boolean",   "java.lang.Boolean" } },
+        { "java.lang.String",    { "java.lang.String",    "java.lang.String" } }
+    };
+
+    bool
+    endsWith (const std::string & s_, const std::string & suffix_) {
+        return s_.size() >= suffix_.size()
+            && s_.compare (s_.size() - suffix_.size(), suffix_.size(), suffix_) == 0;
+    }
+
+    /**
+     * An array of objects ends [] whilst an array of unboxed primitives
+     * ends [p]
+     */
+    bool
+    array (const std::string & type_, std::string & component_, bool & boxed_) {
+        if (endsWith (type_, "[]")) {
+            component_ = type_.substr (0, type_.size() - 2);
+            boxed_ = true;
+            return true;
+        }
+
+        if (endsWith (type_, "[p]")) {
+            component_ = type_.substr (0, type_.size() - 3);
+            boxed_ = false;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Split a generic type into its raw type and its parameters,
+     *
+     *   java.util.Map<int, java.util.List<string>>
+     *
+     * being java.util.Map with parameters int and java.util.List<string>
+     */
+    std::string
+    generic (const std::string & type_, std::vector<std::string> & parameters_) {
+        auto open = type_.find ('<');
+
+        if (open == std::string::npos || type_.back() != '>') {
+            return type_;
+        }
+
+        int depth { 0 };
+        size_t start { open + 1 };
+
+        for (size_t i { open + 1 } ; i < type_.size() - 1 ; ++i) {
+            switch (type_[i]) {
+                case '<' : ++depth; break;
+                case '>' : --depth; break;
+                case ',' : {
+                    if (depth == 0) {
+                        parameters_.push_back (type_.substr (start, i - start));
+                        start = i + 1;
+                    }
+                    break;
+                }
+                default : break;
+            }
+        }
+
+        parameters_.push_back (type_.substr (start, type_.size() - 1 - start));
+
+        for (auto & parameter : parameters_) {
+            auto first = parameter.find_first_not_of (' ');
+            auto last = parameter.find_last_not_of (' ');
+            parameter = parameter.substr (first, last - first + 1);
+        }
+
+        return type_.substr (0, open);
+    }
+
+    /**
+     * The Java type a schema type name stands for, which is what the JVM
+     * remembers having seen
+     */
+    std::string
+    identifier (const std::string & type_, bool boxed_) {
+        std::string component;
+        bool boxedComponent;
+
+        if (array (type_, component, boxedComponent)) {
+            return identifier (component, boxedComponent) + "[]";
+        }
+
+        auto primitive = primitives.find (type_);
+        if (primitive != primitives.end()) {
+            return boxed_ ? primitive->second.boxed : primitive->second.unboxed;
+        }
+
+        std::vector<std::string> parameters;
+        auto raw = generic (type_, parameters);
+
+        if (parameters.empty()) {
+            return type_;
+        }
+
+        raw += "<";
+        for (size_t i { 0 } ; i < parameters.size() ; ++i) {
+            if (i) raw += ", ";
+            raw += identifier (parameters[i], true);
+        }
+
+        return raw + ">";
+    }
+
+    const char alphabet[] = // NOLINT
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string
+    base64 (const amqp::internal::schema::Murmur3::Digest & digest_) {
+        std::string rtn;
+
+        for (size_t i { 0 } ; i < digest_.size() ; i += 3) {
+            uint32_t n = digest_[i] << 16;
+            if (i + 1 < digest_.size()) n |= digest_[i + 1] << 8;
+            if (i + 2 < digest_.size()) n |= digest_[i + 2];
+
+            rtn += alphabet[(n >> 18) & 0x3f];
+            rtn += alphabet[(n >> 12) & 0x3f];
+            rtn += i + 1 < digest_.size() ? alphabet[(n >> 6) & 0x3f] : '=';
+            rtn += i + 2 < digest_.size() ? alphabet[n & 0x3f] : '=';
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::Fingerprinter::State
+ *
+ ******************************************************************************/
+
+/**
+ * A type is only ever hashed in full the first time it's met whilst
+ * fingerprinting, after that it's just marked as already seen
+ */
+struct amqp::internal::schema::Fingerprinter::State {
+    Murmur3 hasher;
+    std::set<std::string> seen;
+
+    void put (const std::string & chars_) { hasher.put (chars_); }
+};
+
+/******************************************************************************
+ *
+ * amqp::internal::schema::Fingerprinter
+ *
+ ******************************************************************************/
+
+amqp::internal::schema::
+Fingerprinter::Fingerprinter (const Schema & schema_) {
+    for (const auto & level : schema_) {
+        for (const auto & type : level) {
+            m_types[type->name()] = type.get();
+
+            if (type->type() == AMQPTypeNotation::composite_t) {
+                for (const auto & provides : dynamic_cast<const Composite &>(*type).provides()) {
+                    m_interfaces.insert (provides);
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
+std::string
+amqp::internal::schema::
+Fingerprinter::fingerprint (const AMQPTypeNotation & type_) const {
+    if (!fingerprinted (type_.descriptor())) {
+        return type_.descriptor();
+    }
+
+    State state;
+    type (type_.name(), false, state);
+
+    return DOMAIN + base64 (state.hasher.digest());
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::schema::
+Fingerprinter::verify() const {
+    for (const auto & type : m_types) {
+        auto fingerprint = this->fingerprint (*type.second);
+
+        if (fingerprint != type.second->descriptor()) {
+            throw std::runtime_error (
+                "Schema for " + type.first + " doesn't match its descriptor "
+                    + type.second->descriptor() + ", expected " + fingerprint);
+        }
+    }
+}
+
+/******************************************************************************/
+
+bool
+amqp::internal::schema::
+Fingerprinter::fingerprinted (const std::string & descriptor_) {
+    if (descriptor_.size() != DOMAIN.size() + 24
+        || descriptor_.compare (0, DOMAIN.size(), DOMAIN) != 0
+        || !endsWith (descriptor_, "=="))
+    {
+        return false;
+    }
+
+    return std::all_of (
+        descriptor_.begin() + DOMAIN.size(),
+        descriptor_.end() - 2,
+        [](unsigned char c) { return std::isalnum (c) || c == '+' || c == '/'; });
+}
+
+/******************************************************************************/
+
+void
+amqp::internal::schema::
+Fingerprinter::type (
+        const std::string & type_,
+        bool boxed_,
+        State & state_
+) const {
+    if (!state_.seen.insert (identifier (type_, boxed_)).second) {
+        state_.put (ALREADY_SEEN);
+        return;
+    }
+
+    std::string component;
+    bool boxedComponent;
+
+    if (array (type_, component, boxedComponent)) {
+        type (component, boxedComponent, state_);
+        state_.put (ARRAY);
+        return;
+    }
+
+    auto primitive = primitives.find (type_);
+    if (primitive != primitives.end()) {
+        state_.put (boxed_ ? primitive->second.boxed : primitive->second.unboxed);
+        return;
+    }
+
+    std::vector<std::string> parameters;
+    auto raw = generic (type_, parameters);
+
+    auto it = m_types.find (type_);
+
+    if (it != m_types.end()) {
+        const auto & notation = *it->second;
+
+        if (!fingerprinted (notation.descriptor())) {
+            state_.put (notation.descriptor());
+            return;
+        }
+
+        if (notation.type() == AMQPTypeNotation::composite_t) {
+            const auto & c = dynamic_cast<const Composite &>(notation);
+
+            if (c.fields().empty() && m_interfaces.count (type_)) {
+                interface (type_, state_);
+            } else {
+                composite (c, raw, parameters, state_);
+            }
+
+            return;
+        }
+
+        const auto & restricted = dynamic_cast<const Restricted &>(notation);
+
+        if (restricted.restrictedType() == Restricted::enum_t) {
+            std::string members;
+            for (const auto & choice : dynamic_cast<const Enum &>(restricted).makeChoices()) {
+                if (!members.empty()) members += ", ";
+                members += choice;
+            }
+
+            state_.put (members);
+            state_.put (type_);
+            state_.put (ENUM);
+            return;
+        }
+    }
+
+    /*
+     * Collections and maps, or anything the schema doesn't describe,
+     * are their raw type followed by whatever they're parameterised by
+     */
+    state_.put (raw);
+
+    for (const auto & parameter : parameters) {
+        type (parameter, true, state_);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Properties go in by name rather than the order they're serialised in,
+ * an unboxed char is always hashed as a nullable Character
+ */
+void
+amqp::internal::schema::
+Fingerprinter::composite (
+        const Composite & composite_,
+        const std::string & raw_,
+        const std::vector<std::string> & parameters_,
+        State & state_
+) const {
+    state_.put (raw_);
+
+    std::vector<const Field *> fields;
+    for (const auto & field : composite_.fields()) {
+        fields.push_back (field.get());
+    }
+
+    std::stable_sort (fields.begin(), fields.end(),
+        [](const Field * lhs_, const Field * rhs_) {
+            return lhs_->name() < rhs_->name();
+        });
+
+    for (const auto field : fields) {
+        const auto & name = field->type() == "*" && !field->requires().empty()
+                ? field->requires().front()
+                : field->type();
+
+        bool boxed = field->defaultValue().empty();
+        bool neverMandatory = name == "char" && !boxed;
+
+        type (name, boxed || neverMandatory, state_);
+
+        state_.put (field->name());
+        state_.put (field->mandatory() && !neverMandatory ? NOT_NULLABLE : NULLABLE);
+    }
+
+    interfaces (composite_.provides(), composite_.name(), state_);
+
+    for (const auto & parameter : parameters_) {
+        type (parameter, true, state_);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * The JVM marks interfaces as already seen straight after their name,
+ * a quirk it keeps for compatibility with its earlier fingerprints
+ */
+void
+amqp::internal::schema::
+Fingerprinter::interface (const std::string & type_, State & state_) const {
+    std::vector<std::string> parameters;
+
+    state_.put (generic (type_, parameters));
+    state_.put (ALREADY_SEEN);
+
+    auto it = m_types.find (type_);
+    if (it != m_types.end() && it->second->type() == AMQPTypeNotation::composite_t) {
+        interfaces (
+            dynamic_cast<const Composite &>(*it->second).provides(),
+            type_,
+            state_);
+    }
+
+    for (const auto & parameter : parameters) {
+        type (parameter, true, state_);
+    }
+}
+
+/******************************************************************************/
+
+/**
+ * Corda lists an interface amongst the interfaces it provides, which the
+ * JVM's own model of the type doesn't
+ */
+void
+amqp::internal::schema::
+Fingerprinter::interfaces (
+        const std::list<std::string> & provides_,
+        const std::string & self_,
+        State & state_
+) const {
+    for (const auto & provides : provides_) {
+        if (provides == self_) continue;
+
+        if (!state_.seen.insert (identifier (provides, false)).second) {
+            state_.put (ALREADY_SEEN);
+        } else if (m_types.count (provides)
+            && !fingerprinted (m_types.at (provides)->descriptor()))
+        {
+            state_.put (m_types.at (provides)->descriptor());
+        } else {
+            interface (provides, state_);
+        }
+    }
+}
+
+/******************************************************************************/
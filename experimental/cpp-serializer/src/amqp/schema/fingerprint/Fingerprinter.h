@@ -0,0 +1,96 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <set>
+#include <map>
+#include <list>
+#include <string>
+#include <vector>
+
+/******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    class Schema;
+    class Composite;
+    class AMQPTypeNotation;
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::internal::schema::Fingerprinter
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    /**
+     * Works out, from nothing more than the schema carried with a blob,
+     * the descriptor the JVM would have given each of its types. Corda
+     * names a type by a hash of its shape; its name, its properties and
+     * their types, the interfaces it implements and so on, all walked in
+     * the same order the JVM walks them.
+     *
+     * A descriptor that doesn't match what we work out means the schema
+     * isn't describing the type it claims to be, and nothing cached against
+     * that descriptor can be trusted to read it.
+     *
+     * Types written by custom serializers are named by the serializer
+     * rather than hashed, those descriptors are taken as they are.
+     */
+    class Fingerprinter {
+        private :
+            struct State;
+
+            /**
+             * Every type of the schema by name
+             */
+            std::map<std::string, const AMQPTypeNotation *> m_types;
+
+            /**
+             * The names of the interfaces implemented by the schema's
+             * types, Corda writes these as Composites with no fields
+             */
+            std::set<std::string> m_interfaces;
+
+            void type (const std::string &, bool boxed_, State &) const;
+
+            void composite (
+                const Composite &,
+                const std::string & raw_,
+                const std::vector<std::string> & parameters_,
+                State &) const;
+
+            void interface (const std::string &, State &) const;
+
+            void interfaces (
+                const std::list<std::string> &,
+                const std::string & self_,
+                State &) const;
+
+        public :
+            explicit Fingerprinter (const Schema &);
+
+            /**
+             * The descriptor the JVM would have given [type_]
+             */
+            std::string fingerprint (const AMQPTypeNotation & type_) const;
+
+            /**
+             * Throws if any type in the schema carries a descriptor other
+             * than its fingerprint
+             */
+            void verify() const;
+
+            /**
+             * False for descriptors chosen by custom serializers, which
+             * aren't fingerprints of anything
+             */
+            static bool fingerprinted (const std::string & descriptor_);
+    };
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,155 @@
+#include "Murmur3.h"
+
+/******************************************************************************/
+
+namespace {
+
+    constexpr uint64_t c1 { 0x87c37b91114253d5ULL };
+    constexpr uint64_t c2 { 0x4cf5ad432745937fULL };
+
+    inline uint64_t
+    rotl (uint64_t x_, int r_) {
+        return (x_ << r_) | (x_ >> (64 - r_));
+    }
+
+    inline uint64_t
+    fmix (uint64_t k_) {
+        k_ ^= k_ >> 33;
+        k_ *= 0xff51afd7ed558ccdULL;
+        k_ ^= k_ >> 33;
+        k_ *= 0xc4ceb9fe1a85ec53ULL;
+        k_ ^= k_ >> 33;
+
+        return k_;
+    }
+
+    /**
+     * Blocks are read little endian whatever the host
+     */
+    inline uint64_t
+    load (const unsigned char * bytes_, size_t n_ = 8) {
+        uint64_t k { 0 };
+        for (size_t i { n_ } ; i > 0 ; --i) {
+            k = (k << 8) | bytes_[i - 1];
+        }
+
+        return k;
+    }
+
+    inline void
+    store (uint64_t h_, uint8_t * out_) {
+        for (size_t i { 0 } ; i < 8 ; ++i) {
+            out_[i] = static_cast<uint8_t>(h_ >> (8 * i));
+        }
+    }
+
+    void
+    utf16 (uint32_t unit_, std::string & out_) {
+        out_ += static_cast<char>(unit_ & 0xff);
+        out_ += static_cast<char>((unit_ >> 8) & 0xff);
+    }
+
+}
+
+/******************************************************************************/
+
+amqp::internal::schema::Murmur3::Digest
+amqp::internal::schema::
+Murmur3::hash (const char * data_, size_t size_, uint32_t seed_) {
+    auto bytes = reinterpret_cast<const unsigned char *>(data_);
+    auto blocks = size_ / 16;
+
+    uint64_t h1 { seed_ };
+    uint64_t h2 { seed_ };
+
+    for (size_t i { 0 } ; i < blocks ; ++i) {
+        uint64_t k1 = load (bytes + i * 16);
+        uint64_t k2 = load (bytes + i * 16 + 8);
+
+        k1 *= c1; k1 = rotl (k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl (h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2; k2 = rotl (k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl (h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    auto tail = bytes + blocks * 16;
+    auto remaining = size_ & 15;
+
+    if (remaining > 8) {
+        uint64_t k2 = load (tail + 8, remaining - 8);
+        k2 *= c2; k2 = rotl (k2, 33); k2 *= c1; h2 ^= k2;
+    }
+
+    if (remaining > 0) {
+        uint64_t k1 = load (tail, remaining > 8 ? 8 : remaining);
+        k1 *= c1; k1 = rotl (k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= size_;
+    h2 ^= size_;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix (h1);
+    h2 = fmix (h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    Digest digest;
+    store (h1, digest.data());
+    store (h2, digest.data() + 8);
+
+    return digest;
+}
+
+/******************************************************************************/
+
+/**
+ * Decode the UTF-8 and append it as UTF-16, anything outside the basic
+ * multilingual plane becoming a surrogate pair just as it would in Java
+ */
+amqp::internal::schema::Murmur3 &
+amqp::internal::schema::
+Murmur3::put (std::string_view chars_) {
+    m_bytes.reserve (m_bytes.size() + 2 * chars_.size());
+
+    for (size_t i { 0 } ; i < chars_.size() ; ) {
+        auto c = static_cast<unsigned char>(chars_[i]);
+
+        size_t length { 1 };
+        uint32_t point { c };
+
+        if (c >= 0xf0)      { length = 4; point = c & 0x07; }
+        else if (c >= 0xe0) { length = 3; point = c & 0x0f; }
+        else if (c >= 0xc0) { length = 2; point = c & 0x1f; }
+
+        for (size_t j { 1 } ; j < length && i + j < chars_.size() ; ++j) {
+            point = (point << 6) | (static_cast<unsigned char>(chars_[i + j]) & 0x3f);
+        }
+
+        if (point > 0xffff) {
+            point -= 0x10000;
+            utf16 (0xd800 + (point >> 10), m_bytes);
+            utf16 (0xdc00 + (point & 0x3ff), m_bytes);
+        } else {
+            utf16 (point, m_bytes);
+        }
+
+        i += length;
+    }
+
+    return *this;
+}
+
+/******************************************************************************/
+
+amqp::internal::schema::Murmur3::Digest
+amqp::internal::schema::
+Murmur3::digest() const {
+    return hash (m_bytes.data(), m_bytes.size());
+}
+
+/******************************************************************************/
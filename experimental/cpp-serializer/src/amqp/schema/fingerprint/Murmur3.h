@@ -0,0 +1,47 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/******************************************************************************
+ *
+ * class amqp::internal::schema::Murmur3
+ *
+ ******************************************************************************/
+
+namespace amqp::internal::schema {
+
+    /**
+     * MurmurHash3, the x64 128 bit variant, which is what the JVM side
+     * hashes type fingerprints with (Guava's murmur3_128 with a zero seed).
+     *
+     * Strings are fed in the way Guava's putUnencodedChars does, as the
+     * little endian UTF-16 code units of a Java String, so whatever we put
+     * here must be converted from the UTF-8 we hold them as.
+     */
+    class Murmur3 {
+        public :
+            using Digest = std::array<uint8_t, 16>;
+
+            /**
+             * Hash [size_] bytes in one go
+             */
+            static Digest hash (const char *, size_t size_, uint32_t seed_ = 0);
+
+        private :
+            std::string m_bytes;
+
+        public :
+            Murmur3 & put (std::string_view);
+
+            Digest digest() const;
+    };
+
+}
+
+/******************************************************************************/
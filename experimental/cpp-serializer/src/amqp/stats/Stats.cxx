@@ -0,0 +1,311 @@
+#include "Stats.h"
+
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+#include <algorithm>
+
+#include <proton/codec.h>
+
+#include "amqp/util/PerThread.h"
+
+/******************************************************************************/
+
+namespace {
+
+    using Tables = amqp::util::PerThread<amqp::stats::Table>;
+
+    amqp::stats::Table
+    make (size_t) {
+        return amqp::stats::Table();
+    }
+
+    /**
+     * The innermost sample being taken on this thread
+     */
+    thread_local amqp::stats::Sample * current { nullptr }; // NOLINT
+
+    uint64_t
+    now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds> (
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * The size of the value [data_] points at if it's a single one,
+     * anything holding others counts nothing of its own
+     */
+    uint64_t
+    size (pn_data_t * data_) {
+        switch (pn_data_type (data_)) {
+            case PN_BOOL :
+            case PN_UBYTE :
+            case PN_BYTE : return 1;
+            case PN_USHORT :
+            case PN_SHORT : return 2;
+            case PN_UINT :
+            case PN_INT :
+            case PN_CHAR :
+            case PN_FLOAT :
+            case PN_DECIMAL32 : return 4;
+            case PN_ULONG :
+            case PN_LONG :
+            case PN_TIMESTAMP :
+            case PN_DOUBLE :
+            case PN_DECIMAL64 : return 8;
+            case PN_DECIMAL128 :
+            case PN_UUID : return 16;
+            case PN_BINARY :
+            case PN_STRING :
+            case PN_SYMBOL : return pn_data_get_bytes (data_).size;
+            default : return 0;
+        }
+    }
+
+    std::string
+    millis (uint64_t nanos_) {
+        char buf[32];
+        snprintf (buf, sizeof (buf), "%.3f", static_cast<double>(nanos_) / 1e6);
+
+        return buf;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::stats::Counters
+ *
+ ******************************************************************************/
+
+void
+amqp::stats::
+Counters::add (uint64_t nodes_, uint64_t bytes_, uint64_t nanos_, uint64_t self_) {
+    ++calls;
+    nodes += nodes_;
+    bytes += bytes_;
+    nanos += nanos_;
+    self += self_;
+
+    size_t bucket { 0 };
+    while (bucket < BUCKETS - 1 && (nanos_ >> bucket)) {
+        ++bucket;
+    }
+
+    ++latency[bucket];
+}
+
+/******************************************************************************/
+
+void
+amqp::stats::
+Counters::merge (const Counters & other_) {
+    calls += other_.calls;
+    nodes += other_.nodes;
+    bytes += other_.bytes;
+    nanos += other_.nanos;
+    self += other_.self;
+
+    for (size_t i { 0 } ; i < BUCKETS ; ++i) {
+        latency[i] += other_.latency[i];
+    }
+}
+
+/******************************************************************************/
+
+uint64_t
+amqp::stats::
+Counters::percentile (double p_) const {
+    if (!calls) {
+        return 0;
+    }
+
+    auto wanted = static_cast<uint64_t>(p_ * static_cast<double>(calls));
+    uint64_t seen { 0 };
+
+    for (size_t i { 0 } ; i < BUCKETS ; ++i) {
+        seen += latency[i];
+
+        if (seen > wanted || seen == calls) {
+            return uint64_t { 1 } << i;
+        }
+    }
+
+    return uint64_t { 1 } << (BUCKETS - 1);
+}
+
+/******************************************************************************
+ *
+ * amqp::stats::Table
+ *
+ ******************************************************************************/
+
+amqp::stats::Counters &
+amqp::stats::
+Table::at (kind_t kind_, const std::string & type_) {
+    auto & of = m_counters[kind_];
+    auto it = of.find (type_);
+
+    if (it == of.end()) {
+        it = of.emplace (type_, Counters()).first;
+    }
+
+    return it->second;
+}
+
+/******************************************************************************/
+
+void
+amqp::stats::
+Table::clear() {
+    for (auto & of : m_counters) {
+        of.clear();
+    }
+}
+
+/******************************************************************************
+ *
+ * amqp::stats::Stats
+ *
+ ******************************************************************************/
+
+std::atomic<bool> amqp::stats::Stats::s_enabled { false };
+
+/******************************************************************************/
+
+void
+amqp::stats::
+Stats::enable (bool on_) {
+    s_enabled.store (on_);
+}
+
+/******************************************************************************/
+
+void
+amqp::stats::
+Stats::count (
+    kind_t kind_,
+    const std::string & type_,
+    uint64_t nodes_,
+    uint64_t bytes_,
+    uint64_t nanos_,
+    uint64_t self_
+) {
+    Tables::with (make, [&](Table & table_) {
+        table_.at (kind_, type_).add (nodes_, bytes_, nanos_, self_);
+    });
+}
+
+/******************************************************************************/
+
+std::vector<amqp::stats::Stats::Entry>
+amqp::stats::
+Stats::collect() {
+    std::array<std::unordered_map<std::string, Counters>, KINDS> summed;
+
+    Tables::each ([&summed](const Table & table_) {
+        for (size_t kind { 0 } ; kind < KINDS ; ++kind) {
+            for (const auto & counters : table_.of (static_cast<kind_t>(kind))) {
+                summed[kind][counters.first].merge (counters.second);
+            }
+        }
+    });
+
+    std::vector<Entry> rtn;
+
+    for (size_t kind { 0 } ; kind < KINDS ; ++kind) {
+        for (auto & counters : summed[kind]) {
+            rtn.push_back ({ static_cast<kind_t>(kind), counters.first, counters.second });
+        }
+    }
+
+    std::sort (rtn.begin(), rtn.end(), [](const Entry & a_, const Entry & b_) {
+        if (a_.counters.self != b_.counters.self) {
+            return a_.counters.self > b_.counters.self;
+        }
+
+        return a_.kind != b_.kind ? a_.kind < b_.kind : a_.type < b_.type;
+    });
+
+    return rtn;
+}
+
+/******************************************************************************/
+
+void
+amqp::stats::
+Stats::write (std::ostream & out_) {
+    for (const auto & entry : collect()) {
+        const auto & c = entry.counters;
+
+        out_ << name (entry.kind) << " " << entry.type << std::endl
+             << "  calls   : " << c.calls << std::endl
+             << "  read    : " << c.nodes << " values, " << c.bytes << " bytes" << std::endl
+             << "  time    : " << millis (c.nanos) << " ms, "
+                               << millis (c.self) << " ms self" << std::endl
+             << "  latency : mean " << (c.calls ? c.nanos / c.calls : 0)
+                               << " ns, p50 < " << c.percentile (0.5)
+                               << " ns, p99 < " << c.percentile (0.99) << " ns" << std::endl;
+    }
+}
+
+/******************************************************************************/
+
+void
+amqp::stats::
+Stats::clear() {
+    Tables::each ([](Table & table_) { table_.clear(); });
+}
+
+/******************************************************************************/
+
+const char *
+amqp::stats::
+Stats::name (kind_t kind_) {
+    switch (kind_) {
+        case composite_t : return "composite";
+        case list_t      : return "list";
+        case map_t       : return "map";
+        case array_t     : return "array";
+        case enum_t      : return "enum";
+        case property_t  : return "property";
+    }
+
+    return "unknown";
+}
+
+/******************************************************************************
+ *
+ * amqp::stats::Sample
+ *
+ ******************************************************************************/
+
+void
+amqp::stats::
+Sample::start (pn_data_t * data_) {
+    m_parent = current;
+    current = this;
+
+    m_bytes = size (data_);
+    m_begin = now();
+}
+
+/******************************************************************************/
+
+void
+amqp::stats::
+Sample::stop() {
+    auto elapsed = now() - m_begin;
+
+    current = m_parent;
+
+    Stats::count (m_kind, *m_type, m_nodes, m_bytes, elapsed, elapsed - std::min (elapsed, m_nested));
+
+    if (m_parent) {
+        m_parent->m_nodes += m_nodes;
+        m_parent->m_bytes += m_bytes;
+        m_parent->m_nested += elapsed;
+    }
+}
+
+/******************************************************************************/
@@ -0,0 +1,232 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+/******************************************************************************/
+
+struct pn_data_t;
+
+/******************************************************************************
+ *
+ * amqp::stats::Counters
+ *
+ ******************************************************************************/
+
+namespace amqp::stats {
+
+    /**
+     * The kinds of reader counted, property covering each of the
+     * primitive readers which are told apart by their type
+     */
+    enum kind_t { composite_t, list_t, map_t, array_t, enum_t, property_t };
+
+    constexpr size_t KINDS { property_t + 1 };
+
+    /**
+     * What's been counted for one reader of one type. Everything but
+     * [self] includes what the readers beneath it did, so a Composite's
+     * bytes are those of all its fields.
+     */
+    struct Counters {
+        /**
+         * Invocations are sorted by how long they took into buckets a
+         * power of two nanoseconds wide, the nth holding those under 2^n
+         */
+        static constexpr size_t BUCKETS { 40 };
+
+        uint64_t calls { 0 };
+
+        /**
+         * The values read, itself and everything beneath it
+         */
+        uint64_t nodes { 0 };
+
+        /**
+         * Of the values' data, not counting the constructors and length
+         * prefixes of their encoding
+         */
+        uint64_t bytes { 0 };
+
+        uint64_t nanos { 0 };
+
+        /**
+         * Time spent in this reader and not in those it handed on to
+         */
+        uint64_t self { 0 };
+
+        std::array<uint64_t, BUCKETS> latency { };
+
+        void add (uint64_t nodes_, uint64_t bytes_, uint64_t nanos_, uint64_t self_);
+
+        void merge (const Counters &);
+
+        /**
+         * The upper bound of the bucket holding the [p_]th fraction of
+         * invocations, 0 if there weren't any
+         */
+        uint64_t percentile (double p_) const;
+    };
+
+    /**
+     * The counters of every reader one thread has run
+     */
+    class Table {
+        private :
+            std::array<std::unordered_map<std::string, Counters>, KINDS> m_counters;
+
+        public :
+            Counters & at (kind_t kind_, const std::string & type_);
+
+            const std::unordered_map<std::string, Counters> & of (kind_t kind_) const {
+                return m_counters[kind_];
+            }
+
+            void clear();
+    };
+
+}
+
+/******************************************************************************
+ *
+ * amqp::stats::Stats
+ *
+ ******************************************************************************/
+
+namespace amqp::stats {
+
+    /**
+     * Counts, per kind of reader and per type it reads, how often each
+     * was run, how much it read and how long it took. Costs a flag test
+     * per reader until [enable]d, after which each thread counts into a
+     * table of its own, see util/PerThread.h, so [collect] and [clear]
+     * can be called while other threads are still decoding.
+     */
+    class Stats {
+        private :
+            static std::atomic<bool> s_enabled;
+
+        public :
+            struct Entry {
+                kind_t      kind;
+                std::string type;
+                Counters    counters;
+            };
+
+            static void enable (bool on_ = true);
+
+            static bool enabled() {
+                return s_enabled.load (std::memory_order_relaxed);
+            }
+
+            /**
+             * A reader's run, into this thread's table
+             */
+            static void count (
+                kind_t kind_,
+                const std::string & type_,
+                uint64_t nodes_,
+                uint64_t bytes_,
+                uint64_t nanos_,
+                uint64_t self_);
+
+            /**
+             * Every thread's counters summed, the readers that took the
+             * most time of their own first
+             */
+            static std::vector<Entry> collect();
+
+            /**
+             * [collect]ed as a table
+             */
+            static void write (std::ostream &);
+
+            static void clear();
+
+            static const char * name (kind_t);
+    };
+
+}
+
+/******************************************************************************
+ *
+ * amqp::stats::Sample
+ *
+ ******************************************************************************/
+
+namespace amqp::stats {
+
+    /**
+     * Counts a reader's run from its construction to its destruction,
+     * if stats were enabled when it started. Made first thing by each
+     * reader, while [data_] still points at the value it's to read, and
+     * so outliving the reader's move onto the next. Samples nest, each
+     * passing what it read and how long it took up to the one it was
+     * made within. [type_] is held on to rather than copied so must
+     * outlive it, as a reader's own type does.
+     */
+    class Sample {
+        private :
+            Sample * m_parent;
+
+            kind_t              m_kind;
+            const std::string * m_type;
+
+            uint64_t m_begin;
+            uint64_t m_nodes;
+            uint64_t m_bytes;
+
+            /**
+             * Time spent in the samples made within this one
+             */
+            uint64_t m_nested;
+
+            bool m_on;
+
+            void start (pn_data_t *);
+            void stop();
+
+        public :
+            Sample (kind_t kind_, const std::string & type_, pn_data_t * data_)
+                : m_parent (nullptr)
+                , m_kind (kind_)
+                , m_type (&type_)
+                , m_begin (0)
+                , m_nodes (1)
+                , m_bytes (0)
+                , m_nested (0)
+                , m_on (Stats::enabled())
+            {
+                if (m_on) {
+                    start (data_);
+                }
+            }
+
+            ~Sample() {
+                if (m_on) {
+                    stop();
+                }
+            }
+
+            /**
+             * For readers that read more than the single value they're
+             * pointed at without handing it on to another
+             */
+            void consumed (uint64_t bytes_) {
+                m_bytes += bytes_;
+            }
+
+            Sample (const Sample &) = delete;
+            Sample & operator = (const Sample &) = delete;
+    };
+
+}
+
+/******************************************************************************/
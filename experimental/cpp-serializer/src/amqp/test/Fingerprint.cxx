@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "amqp/schema/fingerprint/Murmur3.h"
+#include "amqp/schema/fingerprint/Fingerprinter.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::schema;
+
+/******************************************************************************/
+
+namespace {
+
+    std::string
+    hex (const Murmur3::Digest & digest_) {
+        static const char digits[] = "0123456789abcdef";
+
+        std::string rtn;
+        for (auto b : digest_) {
+            rtn += digits[b >> 4];
+            rtn += digits[b & 0xf];
+        }
+
+        return rtn;
+    }
+
+    /**
+     * net.corda.blobwriter._i_ (val a : Int) as the JVM describes it
+     */
+    Schema
+    schema (const std::string & field_) {
+        std::vector<uPtr<Field>> fields;
+        fields.emplace_back (Field::make (field_, "int", { }, "0", "", true, false));
+
+        OrderedTypeNotations<AMQPTypeNotation> types;
+        types.insert (std::make_unique<Composite> (
+            "net.corda.blobwriter._i_", "", std::list<std::string> { },
+            std::make_unique<Descriptor> ("net.corda:kVmzZ65V8U/SY+oISDlD7g=="),
+            std::move (fields)));
+
+        return Schema (std::move (types));
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Murmur3, hash) { // NOLINT
+    auto hash = [](const std::string & s_) {
+        return hex (Murmur3::hash (s_.data(), s_.size()));
+    };
+
+    ASSERT_EQ ("00000000000000000000000000000000", hash (""));
+    ASSERT_EQ ("029bbd41b3a7d8cb191dae486a901e5b", hash ("hello"));
+    ASSERT_EQ (
+        "6c1b07bc7bbc4be347939ac4a93c437a",
+        hash ("The quick brown fox jumps over the lazy dog"));
+}
+
+/******************************************************************************/
+
+TEST (Murmur3, utf16) { // NOLINT
+    Murmur3 ascii;
+    ascii.put ("hello");
+
+    const std::string units ("h\0e\0l\0l\0o\0", 10);
+
+    ASSERT_EQ (
+        hex (Murmur3::hash (units.data(), units.size())),
+        hex (ascii.digest()));
+}
+
+/******************************************************************************/
+
+TEST (Fingerprint, fingerprinted) { // NOLINT
+    ASSERT_TRUE (Fingerprinter::fingerprinted ("net.corda:kVmzZ65V8U/SY+oISDlD7g=="));
+    ASSERT_FALSE (Fingerprinter::fingerprinted ("net.corda:java.math.BigDecimal"));
+    ASSERT_FALSE (Fingerprinter::fingerprinted ("kVmzZ65V8U/SY+oISDlD7g=="));
+}
+
+/******************************************************************************/
+
+TEST (Fingerprint, composite) { // NOLINT
+    auto s = schema ("a");
+    Fingerprinter fingerprinter (s);
+
+    const auto & type = *(s.fromType ("net.corda.blobwriter._i_")->second.get());
+
+    ASSERT_EQ ("net.corda:kVmzZ65V8U/SY+oISDlD7g==", fingerprinter.fingerprint (type));
+    ASSERT_NO_THROW (fingerprinter.verify());
+}
+
+/******************************************************************************/
+
+TEST (Fingerprint, tampered) { // NOLINT
+    auto s = schema ("b");
+
+    ASSERT_THROW (Fingerprinter (s).verify(), std::runtime_error);
+}
+
+/******************************************************************************/
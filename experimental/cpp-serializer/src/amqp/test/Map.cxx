@@ -7,6 +7,8 @@
 #include "restricted-types/List.h"
 #include "restricted-types/Enum.h"
 
+#include "reader/MapIndex.h"
+
 /******************************************************************************
  *
  * mapType Tests
@@ -210,3 +212,24 @@ TEST (Map, dependsOn2) {
 
 /******************************************************************************/
 
+
+TEST (MapIndex, lookup) { // NOLINT
+    std::vector<amqp::reader::MapKey> keys;
+    for (int32_t i { 0 } ; i < 1000 ; ++i) {
+        keys.emplace_back (i * 7);
+    }
+    keys.emplace_back (std::string ("key"));
+    keys.emplace_back (int64_t { 14 });
+
+    amqp::internal::reader::MapIndex index (std::move (keys));
+
+    ASSERT_EQ (1002, index.size());
+    ASSERT_EQ (2, index.find (int32_t { 14 }));
+    ASSERT_EQ (1001, index.find (int64_t { 14 }));
+    ASSERT_EQ (1000, index.find (std::string ("key")));
+    ASSERT_EQ (999, index.find (int32_t { 999 * 7 }));
+    ASSERT_EQ (amqp::internal::reader::MapIndex::NOT_FOUND, index.find (int32_t { 15 }));
+    ASSERT_EQ (amqp::internal::reader::MapIndex::NOT_FOUND, index.find (std::string ("nope")));
+}
+
+/******************************************************************************/
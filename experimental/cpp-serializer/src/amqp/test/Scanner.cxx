@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <cstdio>
+
+#include "scanner/Scanner.h"
+#include "scanner/BufferedWriter.h"
+#include "scanner/StructureDumper.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::scanner;
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * described (symbol "d") list8 [ int 1, str8 "ab", list32 [ ulong0 ] ]
+     */
+    const std::string encoded { // NOLINT
+        "\x00\xa3\x01" "d"
+        "\xc0\x14\x03"
+            "\x71\x00\x00\x00\x01"
+            "\xa1\x02" "ab"
+            "\xd0\x00\x00\x00\x05\x00\x00\x00\x01" "\x44",
+        26
+    };
+
+}
+
+/******************************************************************************/
+
+TEST (Scanner, described) { // NOLINT
+    Value v (encoded.data(), encoded.data() + encoded.size());
+
+    ASSERT_TRUE (v.described());
+    ASSERT_EQ (encoded.size(), v.size());
+    ASSERT_EQ ("d", v.descriptor().bytes());
+    ASSERT_TRUE (v.value().list());
+    ASSERT_EQ (3, v.value().count());
+}
+
+/******************************************************************************/
+
+TEST (Scanner, elements) { // NOLINT
+    Value v (encoded.data(), encoded.data() + encoded.size());
+
+    auto elements = v.value().elements();
+
+    ASSERT_EQ (3, elements.size());
+    ASSERT_EQ (0x71, elements[0].code());
+    ASSERT_EQ (5, elements[0].size());
+    ASSERT_EQ ("ab", elements[1].bytes());
+    ASSERT_TRUE (elements[2].list());
+    ASSERT_EQ (elements[2].end(), v.end());
+
+    auto inner = elements[2].elements();
+    ASSERT_EQ (1, inner.size());
+    ASSERT_EQ (0UL, inner[0].ulong());
+}
+
+/******************************************************************************/
+
+TEST (Scanner, truncated) { // NOLINT
+    EXPECT_THROW (
+        Value (encoded.data(), encoded.data() + encoded.size() - 1),
+        std::runtime_error);
+
+    const char unknown[] = { '\x30' };
+    EXPECT_THROW (Value (unknown, unknown + 1), std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (Scanner, array) { // NOLINT
+    // array8 of 3 smallints
+    const std::string array { "\xe0\x05\x03\x54\x01\x02\x03", 7 };
+
+    Value v (array.data(), array.data() + array.size());
+
+    ASSERT_TRUE (v.array());
+    ASSERT_EQ (0x54, v.elementCode());
+    ASSERT_FALSE (v.describedElements());
+
+    auto elements = v.elements();
+    ASSERT_EQ (3, elements.size());
+    ASSERT_EQ (1, elements[0].size());
+    ASSERT_EQ (3, *elements[2].body());
+}
+
+/******************************************************************************/
+
+TEST (Scanner, corrupt) { // NOLINT
+    // a long run of described constructors, each the descriptor of the last
+    const std::string zeros (1000000, '\0');
+    EXPECT_THROW (
+        Value (zeros.data(), zeros.data() + zeros.size()),
+        std::runtime_error);
+
+    // arrays nested in the descriptors of their elements, past our limit
+    std::string nested { "\x40", 1 };
+    for (int i { 0 } ; i < 40 ; ++i) {
+        // count 0 then a constructor described by the array so far
+        std::string body = std::string (5, '\0') + nested + "\x40";
+        auto size = body.size();
+
+        nested = "\xf0";
+        for (int j { 3 } ; j >= 0 ; --j) nested.push_back (static_cast<char>(size >> (8U * j)));
+        nested += body;
+    }
+    try {
+        Value (nested.data(), nested.data() + nested.size());
+        FAIL();
+    } catch (const std::runtime_error & e) {
+        ASSERT_STREQ ("Corrupt AMQP value", e.what());
+    }
+
+    // a list claiming far more elements than it has bytes for
+    const std::string list { "\xd0\x00\x00\x00\x05\x7f\xff\xff\xff\x44", 10 };
+    Value v (list.data(), list.data() + list.size());
+    EXPECT_THROW (v.elements(), std::runtime_error);
+}
+
+/******************************************************************************/
+
+namespace {
+
+    std::string
+    dump (const std::string & bytes_) {
+        auto file = tmpfile();
+
+        {
+            BufferedWriter out (fileno (file));
+            try {
+                StructureDumper (out).dump (bytes_.data(), bytes_.data() + bytes_.size());
+            } catch (const std::runtime_error &) { }
+        }
+
+        std::string rtn (ftell (file), '\0');
+        rewind (file);
+        fread (&rtn[0], 1, rtn.size(), file);
+        fclose (file);
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (StructureDumper, dump) { // NOLINT
+    ASSERT_EQ (
+        "described d\n"
+        "  list 3 (22 bytes)\n"
+        "    int 1\n"
+        "    string \"ab\"\n"
+        "    list 1 (10 bytes)\n"
+        "      ulong 0\n",
+        dump (encoded));
+}
+
+/******************************************************************************/
+
+TEST (StructureDumper, cordaDescriptor) { // NOLINT
+    // described (ulong 0x0000c562:1) map8 { sym "k" : str "a\"" }
+    const std::string map {
+        "\x00\x80\xc5\x62\x00\x00\x00\x00\x00\x01"
+        "\xc1\x08\x02\xa3\x01" "k" "\xa1\x02" "a\"",
+        20
+    };
+
+    ASSERT_EQ (
+        "described 1 ENVELOPE\n"
+        "  map 1 (10 bytes)\n"
+        "    symbol \"k\"\n"
+        "      string \"a\\\"\"\n",
+        dump (map));
+}
+
+/******************************************************************************/
+
+TEST (StructureDumper, malformed) { // NOLINT
+    // the string claims to run past the end of the list it's in
+    auto broken = encoded;
+    broken[13] = '\x20';
+
+    ASSERT_EQ (
+        "described d\n"
+        "  list 3 (22 bytes)\n"
+        "    int 1\n"
+        "!! Truncated AMQP value at offset 12\n",
+        dump (broken));
+
+    // the list runs past the end but everything before the break is there
+    ASSERT_EQ (
+        "described d\n"
+        "  list 3 (22 bytes)\n"
+        "    int 1\n"
+        "    string \"ab\"\n"
+        "!! Truncated AMQP value at offset 16\n",
+        dump (encoded.substr (0, 20)));
+
+    // as are all of its elements, what's missing is the rest of its size
+    auto longer = encoded;
+    longer[5] = '\x18';
+
+    ASSERT_EQ (
+        "described d\n"
+        "  list 3 (26 bytes)\n"
+        "    int 1\n"
+        "    string \"ab\"\n"
+        "    list 1 (10 bytes)\n"
+        "      ulong 0\n"
+        "!! Truncated AMQP value at offset 26\n",
+        dump (longer));
+
+    // described values nested in described values, missing the last value
+    std::string nested;
+    for (int i { 0 } ; i < 2000 ; ++i) {
+        nested += std::string { "\x00\x44", 2 };
+    }
+
+    auto deep = dump (nested);
+    ASSERT_EQ (0, deep.find ("described 0\n  described 0\n"));
+    ASSERT_NE (std::string::npos, deep.find ("described 0\n!! Truncated AMQP value at offset 4000\n"));
+}
+
+/******************************************************************************/
+
+/**
+ * Reserved format codes are rejected rather than read as whatever their
+ * row's width would be, and counts aren't trusted any further than the
+ * bytes they're for
+ */
+TEST (StructureDumper, corrupt) { // NOLINT
+    const std::string reserved { "\xd5\x00\x00\x10\x00\x00\x00\x00", 8 };
+
+    ASSERT_EQ ("!! Unknown AMQP format code 0xd5 at offset 0\n", dump (reserved));
+
+    EXPECT_THROW (
+        Value (reserved.data(), reserved.data() + reserved.size()),
+        std::runtime_error);
+
+    // array32 of nulls, more of them than it has bytes
+    const std::string nulls { "\xf0\x00\x00\x00\x05\xff\xff\xff\xff\x40", 10 };
+
+    ASSERT_EQ ("!! Corrupt AMQP value at offset 0\n", dump (nulls));
+
+    // or a size big enough for them but nothing actually there
+    const std::string claimed { "\xf0\xff\xff\xff\xff\xff\xff\xff\xf0\x40", 10 };
+
+    ASSERT_EQ ("!! Corrupt AMQP value at offset 0\n", dump (claimed));
+}
+
+/******************************************************************************/
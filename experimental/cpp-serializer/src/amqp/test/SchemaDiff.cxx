@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <functional>
+
+#include "amqp/schema/diff/SchemaDiff.h"
+#include "amqp/schema/described-types/Schema.h"
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::schema;
+
+/******************************************************************************/
+
+namespace {
+
+    struct F {
+        std::string name;
+        std::string type;
+        bool mandatory;
+    };
+
+    using Types = std::vector<std::pair<std::string, std::vector<F>>>;
+
+    Schema
+    schema (const Types & types_) {
+        OrderedTypeNotations<AMQPTypeNotation> types;
+
+        for (const auto & type : types_) {
+            std::vector<uPtr<Field>> fields;
+
+            for (const auto & f : type.second) {
+                fields.emplace_back (Field::make (
+                    f.name, f.type, { }, "", "", f.mandatory, false));
+            }
+
+            types.insert (std::make_unique<Composite> (
+                type.first, "", std::list<std::string> { },
+                std::make_unique<Descriptor> ("net.corda:" + type.first),
+                std::move (fields)));
+        }
+
+        return Schema (std::move (types));
+    }
+
+    /**
+     * A binary tree of Composites [depth_] deep, the leaves each holding
+     * an int, or for [changed_] a long
+     */
+    Types
+    tree (size_t depth_, const std::string & changed_ = "") {
+        Types rtn;
+
+        std::function<void (const std::string &, size_t)> node = [&](
+            const std::string & name_, size_t depth_
+        ) {
+            if (depth_ == 1) {
+                rtn.push_back ({ name_, { { "a", name_ == changed_ ? "long" : "int", true } } });
+                return;
+            }
+
+            rtn.push_back ({ name_, {
+                { "l", name_ + "l", true },
+                { "r", name_ + "r", true } } });
+
+            node (name_ + "l", depth_ - 1);
+            node (name_ + "r", depth_ - 1);
+        };
+
+        node ("t", depth_);
+
+        return rtn;
+    }
+
+    std::vector<std::string>
+    changes (const SchemaDiff & diff_) {
+        std::vector<std::string> rtn;
+
+        for (const auto & change : diff_.changes()) {
+            std::stringstream ss;
+            ss << change;
+            rtn.push_back (ss.str());
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (SchemaDiff, identical) { // NOLINT
+    auto a = schema (tree (5));
+    auto b = schema (tree (5));
+
+    MerkleSchema from (a);
+    MerkleSchema to (b);
+
+    ASSERT_EQ (31, from.size());
+    ASSERT_EQ (std::vector<std::string> { "t" }, from.roots());
+    ASSERT_EQ (from.root(), to.root());
+
+    SchemaDiff diff (from, to);
+
+    ASSERT_TRUE (diff.empty());
+    ASSERT_EQ (0, diff.compared());
+}
+
+/******************************************************************************/
+
+TEST (SchemaDiff, onlyChangedPath) { // NOLINT
+    const size_t depth { 8 };
+
+    auto a = schema (tree (depth));
+    auto b = schema (tree (depth, "tlrlrlrl"));
+
+    MerkleSchema from (a);
+    MerkleSchema to (b);
+
+    ASSERT_EQ (255, from.size());
+    ASSERT_NE (from.root(), to.root());
+
+    /*
+     * Only the leaf itself has changed shape, the types above it only in
+     * what's beneath them
+     */
+    ASSERT_EQ (from.find ("tlrlrlr")->local, to.find ("tlrlrlr")->local);
+    ASSERT_NE (from.find ("tlrlrlr")->hash, to.find ("tlrlrlr")->hash);
+    ASSERT_EQ (from.find ("tlrlrlrr")->hash, to.find ("tlrlrlrr")->hash);
+
+    SchemaDiff diff (from, to);
+
+    ASSERT_EQ (std::vector<std::string> { "~ tlrlrlrl.a : int -> long" }, changes (diff));
+
+    /*
+     * Down the one path and a look at the sibling at each step
+     */
+    ASSERT_EQ (2 * depth - 1, diff.compared());
+}
+
+/******************************************************************************/
+
+TEST (SchemaDiff, fields) { // NOLINT
+    auto a = schema ({
+        { "net.corda.A", {
+            { "a", "int", true },
+            { "b", "string", false },
+            { "c", "net.corda.B", true },
+            { "d", "long", true } } },
+        { "net.corda.B", { { "x", "int", true } } }
+    });
+
+    auto b = schema ({
+        { "net.corda.A", {
+            { "a", "int", false },
+            { "d", "long", true },
+            { "c", "net.corda.C", true },
+            { "e", "double", true } } },
+        { "net.corda.C", { { "y", "int", true } } }
+    });
+
+    MerkleSchema from (a);
+    MerkleSchema to (b);
+
+    SchemaDiff diff (from, to);
+
+    std::vector<std::string> expected {
+        "~ net.corda.A.a : int -> int?",
+        "~ net.corda.A.c : net.corda.B -> net.corda.C",
+        "+ net.corda.A.e : double",
+        "- net.corda.A.b : string?",
+        "~ net.corda.A.d : moved from 2 to 1",
+        "~ net.corda.A.c : moved from 1 to 2",
+        "- net.corda.B (composite)",
+        "+ net.corda.C (composite)"
+    };
+
+    ASSERT_EQ (expected, changes (diff));
+}
+
+/******************************************************************************/
+
+TEST (SchemaDiff, selfReference) { // NOLINT
+    auto a = schema ({
+        { "net.corda.Node", { { "v", "int", true }, { "next", "net.corda.Node", false } } }
+    });
+
+    auto b = schema ({
+        { "net.corda.Node", { { "v", "long", true }, { "next", "net.corda.Node", false } } }
+    });
+
+    MerkleSchema from (a);
+    MerkleSchema to (b);
+
+    ASSERT_EQ (std::vector<std::string> { "net.corda.Node" }, from.roots());
+
+    SchemaDiff diff (from, to);
+
+    ASSERT_EQ (std::vector<std::string> { "~ net.corda.Node.v : int -> long" }, changes (diff));
+    ASSERT_EQ (1, diff.compared());
+}
+
+/******************************************************************************/
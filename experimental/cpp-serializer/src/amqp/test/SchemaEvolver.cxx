@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include "amqp/schema/evolution/SchemaEvolver.h"
+#include "amqp/schema/described-types/Composite.h"
+
+/******************************************************************************/
+
+using namespace amqp::internal::schema;
+
+/******************************************************************************/
+
+namespace {
+
+    struct F {
+        std::string name;
+        std::string type;
+        std::string def;
+        bool mandatory;
+    };
+
+    uPtr<Composite>
+    composite (const std::string & descriptor_, const std::vector<F> & fields_) {
+        std::vector<uPtr<Field>> fields;
+
+        for (const auto & f : fields_) {
+            fields.emplace_back (Field::make (
+                f.name, f.type, { }, f.def, "", f.mandatory, false));
+        }
+
+        return std::make_unique<Composite> (
+            "test.Class", "", std::list<std::string> { },
+            std::make_unique<Descriptor> (descriptor_),
+            std::move (fields));
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (SchemaEvolver, unchanged) { // NOLINT
+    auto from = composite ("v1", { { "a", "int", "", true }, { "b", "string", "", false } });
+    auto to = composite ("v1", { { "a", "int", "", true }, { "b", "string", "", false } });
+
+    Evolution e (*from, *to);
+
+    ASSERT_TRUE (e.identity());
+    ASSERT_TRUE (e.defaults().empty());
+}
+
+/******************************************************************************/
+
+TEST (SchemaEvolver, reorderedAddedAndRemoved) { // NOLINT
+    auto from = composite ("v1", {
+        { "a", "int", "", true },
+        { "b", "string", "", false },
+        { "c", "long", "", true } });
+
+    auto to = composite ("v2", {
+        { "c", "long", "", true },
+        { "d", "int", "10", true },
+        { "a", "int", "", true },
+        { "e", "string", "", false } });
+
+    Evolution e (*from, *to);
+
+    ASSERT_FALSE (e.identity());
+    ASSERT_EQ (3, e.sourceFields());
+    ASSERT_EQ (4, e.targetFields());
+
+    EXPECT_EQ (2, e.targetOf (0));
+    EXPECT_EQ (Evolution::DROPPED, e.targetOf (1));
+    EXPECT_EQ (0, e.targetOf (2));
+
+    ASSERT_EQ (2, e.defaults().size());
+    EXPECT_EQ (1, e.defaults()[0].index);
+    EXPECT_EQ ("10", e.defaults()[0].value);
+    EXPECT_EQ (3, e.defaults()[1].index);
+    EXPECT_EQ ("null", e.defaults()[1].value);
+}
+
+/******************************************************************************/
+
+/**
+ * Defaults come out as the field's type would dump, strings quoted
+ */
+TEST (SchemaEvolver, typedDefaults) { // NOLINT
+    auto from = composite ("v1", { { "a", "int", "", true } });
+    auto to = composite ("v2", {
+        { "a", "int", "", true },
+        { "s", "string", "hello", true },
+        { "d", "double", "1.5", true },
+        { "b", "boolean", "true", true },
+        { "l", "long", "+7", true } });
+
+    Evolution e (*from, *to);
+
+    ASSERT_EQ (4, e.defaults().size());
+    EXPECT_EQ ("\"hello\"", e.defaults()[0].value);
+    EXPECT_EQ ("1.500000", e.defaults()[1].value);
+    EXPECT_EQ ("1", e.defaults()[2].value);
+    EXPECT_EQ ("7", e.defaults()[3].value);
+
+    auto bad = composite ("v3", { { "a", "int", "", true }, { "i", "int", "many", true } });
+    ASSERT_THROW (Evolution (*from, *bad), std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (SchemaEvolver, incompatible) { // NOLINT
+    auto from = composite ("v1", { { "a", "int", "", true } });
+
+    auto retyped = composite ("v2", { { "a", "string", "", true } });
+    EXPECT_THROW (Evolution (*from, *retyped), std::runtime_error);
+
+    auto mandatory = composite ("v3", { { "a", "int", "", true }, { "b", "int", "", true } });
+    EXPECT_THROW (Evolution (*from, *mandatory), std::runtime_error);
+}
+
+/******************************************************************************/
+
+TEST (SchemaEvolver, cached) { // NOLINT
+    auto from = composite ("v1", { { "a", "int", "", true } });
+    auto to = composite ("v2", { { "b", "int", "1", true }, { "a", "int", "", true } });
+    auto again = composite ("v2", { { "b", "int", "1", true }, { "a", "int", "", true } });
+
+    SchemaEvolver evolver;
+
+    auto e1 = evolver.evolution (*from, *to);
+    auto e2 = evolver.evolution (*from, *again);
+
+    ASSERT_EQ (e1.get(), e2.get());
+    ASSERT_EQ (1, evolver.size());
+
+    evolver.evolution (*to, *from);
+    ASSERT_EQ (2, evolver.size());
+}
+
+/******************************************************************************/
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <sstream>
+
+#include <proton/codec.h>
+
+#include "amqp/stats/Stats.h"
+
+/******************************************************************************/
+
+using namespace amqp::stats;
+
+/******************************************************************************/
+
+namespace {
+
+    const Counters *
+    find (const std::vector<Stats::Entry> & entries_, kind_t kind_, const std::string & type_) {
+        for (const auto & entry : entries_) {
+            if (entry.kind == kind_ && entry.type == type_) {
+                return &entry.counters;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * A list holding an int and a string, as a reader would find it
+     */
+    pn_data_t *
+    list() {
+        static const char encoded[] = {
+            '\xc0', 0x0d, 0x02,
+            0x71, 0x00, 0x00, 0x00, 0x2a,
+            '\xa1', 0x05, 'h', 'e', 'l', 'l', 'o'
+        };
+
+        auto data = pn_data (0);
+        pn_data_decode (data, encoded, sizeof (encoded));
+
+        pn_data_rewind (data);
+        pn_data_next (data);
+
+        return data;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Stats, disabled) { // NOLINT
+    Stats::clear();
+    Stats::enable (false);
+
+    const std::string type { "nothing" };
+
+    auto data = list();
+    {
+        Sample sample (list_t, type, data);
+    }
+    pn_data_free (data);
+
+    ASSERT_EQ (nullptr, find (Stats::collect(), list_t, type));
+}
+
+/******************************************************************************/
+
+TEST (Stats, nested) { // NOLINT
+    Stats::clear();
+    Stats::enable();
+
+    const std::string listOf { "list<?>" };
+    const std::string int_ { "int" };
+    const std::string string { "string" };
+
+    auto data = list();
+    {
+        Sample outer (list_t, listOf, data);
+
+        pn_data_enter (data);
+        pn_data_next (data);
+        {
+            Sample inner (property_t, int_, data);
+        }
+        pn_data_next (data);
+        {
+            Sample inner (property_t, string, data);
+        }
+        pn_data_exit (data);
+    }
+    pn_data_free (data);
+
+    Stats::enable (false);
+
+    auto entries = Stats::collect();
+
+    auto l = find (entries, list_t, listOf);
+    auto i = find (entries, property_t, int_);
+    auto s = find (entries, property_t, string);
+
+    ASSERT_NE (nullptr, l);
+    ASSERT_NE (nullptr, i);
+    ASSERT_NE (nullptr, s);
+
+    ASSERT_EQ (1, i->calls);
+    ASSERT_EQ (1, i->nodes);
+    ASSERT_EQ (4, i->bytes);
+    ASSERT_EQ (5, s->bytes);
+
+    /*
+     * The list counts what its elements read as well as itself but
+     * not their time as its own
+     */
+    ASSERT_EQ (3, l->nodes);
+    ASSERT_EQ (9, l->bytes);
+    ASSERT_GE (l->nanos, i->nanos + s->nanos);
+    ASSERT_EQ (l->nanos - i->nanos - s->nanos, l->self);
+
+    std::stringstream ss;
+    Stats::write (ss);
+
+    ASSERT_NE (std::string::npos, ss.str().find ("list list<?>\n  calls   : 1\n"));
+    ASSERT_NE (std::string::npos, ss.str().find ("  read    : 3 values, 9 bytes\n"));
+}
+
+/******************************************************************************/
+
+TEST (Stats, threads) { // NOLINT
+    Stats::clear();
+    Stats::enable();
+
+    const std::string type { "threaded" };
+
+    auto count = [&type]() {
+        auto data = list();
+        for (int i { 0 } ; i < 5 ; ++i) {
+            Sample sample (composite_t, type, data);
+        }
+        pn_data_free (data);
+    };
+
+    std::thread a (count);
+    std::thread b (count);
+
+    a.join();
+    b.join();
+
+    Stats::enable (false);
+
+    auto counters = find (Stats::collect(), composite_t, type);
+
+    ASSERT_NE (nullptr, counters);
+    ASSERT_EQ (10, counters->calls);
+}
+
+/******************************************************************************/
+
+/**
+ * Tables can be collected and cleared while other threads are still
+ * counting into them
+ */
+TEST (Stats, whileDecoding) { // NOLINT
+    Stats::clear();
+    Stats::enable();
+
+    const std::string type { "busy" };
+    std::atomic<bool> done { false };
+
+    auto count = [&type, &done]() {
+        auto data = list();
+        while (!done) {
+            Sample sample (composite_t, type, data);
+        }
+        pn_data_free (data);
+    };
+
+    std::thread a (count);
+    std::thread b (count);
+
+    for (int i { 0 } ; i < 200 ; ++i) {
+        Stats::collect();
+        Stats::clear();
+    }
+
+    done = true;
+
+    a.join();
+    b.join();
+
+    Stats::enable (false);
+    Stats::clear();
+
+    ASSERT_EQ (nullptr, find (Stats::collect(), composite_t, type));
+}
+
+/******************************************************************************/
+
+TEST (Stats, percentile) { // NOLINT
+    Counters counters;
+
+    for (int i { 0 } ; i < 99 ; ++i) {
+        counters.add (1, 0, 100, 100);
+    }
+
+    counters.add (1, 0, 5000, 5000);
+
+    ASSERT_EQ (100, counters.calls);
+    ASSERT_EQ (128, counters.percentile (0.5));
+    ASSERT_EQ (8192, counters.percentile (0.995));
+    ASSERT_EQ (0, Counters().percentile (0.5));
+}
+
+/******************************************************************************/
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <sstream>
+
+#include "amqp/trace/Tracer.h"
+
+/******************************************************************************/
+
+using namespace amqp::trace;
+
+/******************************************************************************/
+
+namespace {
+
+    size_t
+    occurrences (const std::string & s_, const std::string & of_) {
+        size_t rtn { 0 };
+
+        for (auto i = s_.find (of_) ; i != std::string::npos ; i = s_.find (of_, i + 1)) {
+            ++rtn;
+        }
+
+        return rtn;
+    }
+
+}
+
+/******************************************************************************/
+
+TEST (Tracer, disabled) { // NOLINT
+    Tracer::clear();
+    Tracer::enable (false);
+
+    {
+        Span span ("nothing");
+    }
+
+    std::stringstream ss;
+    Tracer::write (ss);
+
+    ASSERT_EQ (0, occurrences (ss.str(), R"("name":"nothing")"));
+}
+
+/******************************************************************************/
+
+TEST (Tracer, threads) { // NOLINT
+    Tracer::clear();
+    Tracer::enable();
+
+    {
+        Span outer ("outer", "detail \"quoted\"");
+        Span inner ("inner");
+    }
+
+    std::thread worker ([]() {
+        for (int i { 0 } ; i < 3 ; ++i) {
+            Span span ("worker");
+        }
+    });
+
+    worker.join();
+
+    Tracer::enable (false);
+
+    std::stringstream ss;
+    Tracer::write (ss);
+
+    auto json = ss.str();
+
+    ASSERT_EQ (0, json.find (R"({"displayTimeUnit":"ns","traceEvents":[)"));
+    ASSERT_EQ (1, occurrences (json, R"("name":"outer")"));
+    ASSERT_EQ (1, occurrences (json, R"("name":"inner")"));
+    ASSERT_EQ (3, occurrences (json, R"("name":"worker")"));
+    ASSERT_EQ (1, occurrences (json, R"("args":{"detail":"detail \"quoted\""})"));
+
+    /*
+     * The worker has a track of its own
+     */
+    auto main = Tracer::thread();
+    ASSERT_EQ (1, occurrences (json, R"("name":"inner","cat":"amqp","ph":"X","pid":1,"tid":)"
+        + std::to_string (main) + ","));
+    ASSERT_EQ (0, occurrences (json, R"("name":"worker","cat":"amqp","ph":"X","pid":1,"tid":)"
+        + std::to_string (main) + ","));
+}
+
+/******************************************************************************/
+
+TEST (Tracer, ring) { // NOLINT
+    Buffer buffer (4, 1);
+
+    for (uint64_t i { 0 } ; i < 6 ; ++i) {
+        buffer.record ("span", "", i, i + 1);
+    }
+
+    auto events = buffer.events();
+
+    ASSERT_EQ (6, buffer.recorded());
+    ASSERT_EQ (4, events.size());
+    ASSERT_EQ (2, events.front().begin);
+    ASSERT_EQ (5, events.back().begin);
+}
+
+/******************************************************************************/
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <mutex>
+#include <thread>
+#include <sstream>
+#include <stdexcept>
+
+#include "amqp/util/Json.h"
+#include "amqp/util/Parallel.h"
+
+/******************************************************************************/
+
+using namespace amqp::util;
+
+/******************************************************************************/
+
+TEST (Util, jsonString) { // NOLINT
+    std::string s;
+    jsonString ("a\"b\\c\n\r\t\x01 é", s);
+
+    ASSERT_EQ (R"("a\"b\\c\n\r\t\u0001 é")", s);
+
+    std::stringstream ss;
+    jsonString ("a\"b\\c\n\r\t\x01 é", ss);
+
+    ASSERT_EQ (s, ss.str());
+}
+
+/******************************************************************************/
+
+/**
+ * Every item is seen once, in contiguous ascending chunks, with no more
+ * chunks than items and never none
+ */
+TEST (Util, parallel) { // NOLINT
+    ASSERT_EQ (1, chunks (0, 4));
+    ASSERT_EQ (1, chunks (10, 0));
+    ASSERT_EQ (3, chunks (3, 8));
+    ASSERT_EQ (4, chunks (10, 4));
+
+    std::vector<size_t> seen (10, 0);
+    std::set<std::thread::id> threads;
+    std::mutex lock;
+
+    parallel (seen.size(), 4, [&](size_t chunk_, size_t begin_, size_t end_) {
+        ASSERT_LT (chunk_, 4);
+        ASSERT_LE (begin_, end_);
+
+        for (auto i = begin_ ; i < end_ ; ++i) {
+            ++seen[i];
+        }
+
+        std::lock_guard<std::mutex> guard (lock);
+        threads.insert (std::this_thread::get_id());
+    });
+
+    ASSERT_EQ (std::vector<size_t> (10, 1), seen);
+    ASSERT_EQ (4, threads.size());
+
+    size_t calls { 0 };
+    parallel (0, 4, [&](size_t, size_t begin_, size_t end_) {
+        ASSERT_EQ (begin_, end_);
+        ++calls;
+    });
+
+    ASSERT_EQ (1, calls);
+}
+
+/******************************************************************************/
+
+/**
+ * A chunk that throws doesn't stop the others, its exception coming out
+ * once they're done
+ */
+TEST (Util, parallelThrows) { // NOLINT
+    std::vector<size_t> seen (8, 0);
+
+    try {
+        parallel (seen.size(), 4, [&](size_t chunk_, size_t begin_, size_t end_) {
+            for (auto i = begin_ ; i < end_ ; ++i) {
+                ++seen[i];
+            }
+
+            if (chunk_ == 2) {
+                throw std::runtime_error ("chunk 2");
+            }
+        });
+
+        FAIL() << "didn't throw";
+    } catch (const std::runtime_error & e) {
+        ASSERT_STREQ ("chunk 2", e.what());
+    }
+
+    ASSERT_EQ (std::vector<size_t> (8, 1), seen);
+}
+
+/******************************************************************************/
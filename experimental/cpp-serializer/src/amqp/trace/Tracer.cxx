@@ -0,0 +1,181 @@
+#include "Tracer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <ostream>
+
+#include "amqp/util/Json.h"
+#include "amqp/util/PerThread.h"
+
+/******************************************************************************/
+
+namespace {
+
+    const auto epoch = std::chrono::steady_clock::now(); // NOLINT
+
+    using Buffers = amqp::util::PerThread<amqp::trace::Buffer>;
+
+    /**
+     * Threads' tracks are numbered from 1 in the order they first record
+     */
+    amqp::trace::Buffer
+    make (size_t before_) {
+        return amqp::trace::Buffer (
+            amqp::trace::Tracer::CAPACITY, static_cast<uint32_t>(before_ + 1));
+    }
+
+    /**
+     * Chrome wants microseconds
+     */
+    std::string
+    micros (uint64_t nanos_) {
+        char buf[32];
+        snprintf (buf, sizeof (buf), "%.3f", static_cast<double>(nanos_) / 1000.0);
+
+        return buf;
+    }
+
+}
+
+/******************************************************************************
+ *
+ * amqp::trace::Buffer
+ *
+ ******************************************************************************/
+
+amqp::trace::
+Buffer::Buffer (size_t capacity_, uint32_t thread_)
+    : m_events (capacity_)
+    , m_recorded (0)
+    , m_thread (thread_)
+{
+}
+
+/******************************************************************************/
+
+std::vector<amqp::trace::Event>
+amqp::trace::
+Buffer::events() const {
+    auto held = std::min<uint64_t> (m_recorded, m_events.size());
+
+    std::vector<Event> rtn;
+    rtn.reserve (held);
+
+    for (auto i = m_recorded - held ; i < m_recorded ; ++i) {
+        rtn.push_back (m_events[i % m_events.size()]);
+    }
+
+    return rtn;
+}
+
+/******************************************************************************
+ *
+ * amqp::trace::Tracer
+ *
+ ******************************************************************************/
+
+std::atomic<bool> amqp::trace::Tracer::s_enabled { false };
+
+/******************************************************************************/
+
+void
+amqp::trace::
+Tracer::enable (bool on_) {
+    s_enabled.store (on_);
+}
+
+/******************************************************************************/
+
+uint64_t
+amqp::trace::
+Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now() - epoch).count();
+}
+
+/******************************************************************************/
+
+void
+amqp::trace::
+Tracer::record (const char * name_, std::string detail_, uint64_t begin_, uint64_t end_) {
+    Buffers::with (make, [&](Buffer & buffer_) {
+        buffer_.record (name_, std::move (detail_), begin_, end_);
+    });
+}
+
+/******************************************************************************/
+
+uint32_t
+amqp::trace::
+Tracer::thread() {
+    return Buffers::with (make, [](Buffer & buffer_) { return buffer_.thread(); });
+}
+
+/******************************************************************************/
+
+void
+amqp::trace::
+Tracer::write (std::ostream & out_) {
+    struct Track {
+        uint32_t           thread;
+        uint64_t           dropped;
+        std::vector<Event> events;
+    };
+
+    // copied out so no thread's held up while they're written
+    std::vector<Track> tracks;
+
+    Buffers::each ([&tracks](const Buffer & buffer_) {
+        auto events = buffer_.events();
+        auto dropped = buffer_.recorded() - events.size();
+
+        tracks.push_back ({ buffer_.thread(), dropped, std::move (events) });
+    });
+
+    out_ << R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+    const char * sep = "";
+
+    for (const auto & track : tracks) {
+        std::string name = "thread " + std::to_string (track.thread);
+        if (track.dropped) {
+            name += " (" + std::to_string (track.dropped) + " earlier spans dropped)";
+        }
+
+        out_ << sep << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << track.thread
+             << R"(,"args":{"name":)";
+        amqp::util::jsonString (name, out_);
+        out_ << "}}";
+
+        sep = ",\n";
+
+        for (const auto & event : track.events) {
+            out_ << sep << R"({"name":)";
+            amqp::util::jsonString (event.name, out_);
+            out_ << R"(,"cat":"amqp","ph":"X","pid":1,"tid":)" << track.thread
+                 << R"(,"ts":)" << micros (event.begin)
+                 << R"(,"dur":)" << micros (event.end - event.begin);
+
+            if (!event.detail.empty()) {
+                out_ << R"(,"args":{"detail":)";
+                amqp::util::jsonString (event.detail, out_);
+                out_ << "}";
+            }
+
+            out_ << "}";
+        }
+    }
+
+    out_ << "]}" << std::endl;
+}
+
+/******************************************************************************/
+
+void
+amqp::trace::
+Tracer::clear() {
+    Buffers::each ([](Buffer & buffer_) { buffer_.clear(); });
+}
+
+/******************************************************************************/
@@ -0,0 +1,178 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/******************************************************************************
+ *
+ * class amqp::trace::Tracer
+ *
+ ******************************************************************************/
+
+namespace amqp::trace {
+
+    /**
+     * A span as recorded, times in nanoseconds since the first was
+     */
+    struct Event {
+        const char * name { nullptr };
+        std::string  detail;
+        uint64_t     begin { 0 };
+        uint64_t     end { 0 };
+    };
+
+    /**
+     * The spans of a single thread, only ever written by that thread.
+     * Once full the oldest are written over so a long run keeps its most
+     * recent spans in a fixed amount of memory.
+     */
+    class Buffer {
+        private :
+            std::vector<Event> m_events;
+
+            /**
+             * How many spans have ever been recorded here
+             */
+            uint64_t m_recorded;
+
+            uint32_t m_thread;
+
+        public :
+            Buffer (size_t capacity_, uint32_t thread_);
+
+            void record (const char * name_, std::string detail_, uint64_t begin_, uint64_t end_) {
+                auto & event = m_events[m_recorded++ % m_events.size()];
+
+                event.name = name_;
+                event.detail = std::move (detail_);
+                event.begin = begin_;
+                event.end = end_;
+            }
+
+            void clear() { m_recorded = 0; }
+
+            uint32_t thread() const { return m_thread; }
+            uint64_t recorded() const { return m_recorded; }
+
+            /**
+             * What's still held, oldest first
+             */
+            std::vector<Event> events() const;
+    };
+
+    /**
+     * Collects the spans of every thread and writes them as Chrome's
+     * trace event JSON, each thread its own track, to be loaded into
+     * chrome://tracing or Perfetto.
+     *
+     * Recording is off until [enable]d so a build with the spans compiled
+     * in costs no more than a flag test per span when it isn't wanted.
+     * Each thread records into a buffer of its own, see util/PerThread.h.
+     */
+    class Tracer {
+        public :
+            /**
+             * Spans held per thread
+             */
+            static constexpr size_t CAPACITY { 1 << 16 };
+
+        private :
+            static std::atomic<bool> s_enabled;
+
+        public :
+            static void enable (bool on_ = true);
+
+            static bool enabled() {
+                return s_enabled.load (std::memory_order_relaxed);
+            }
+
+            /**
+             * Nanoseconds since tracing started
+             */
+            static uint64_t now();
+
+            /**
+             * Into this thread's buffer
+             */
+            static void record (const char * name_, std::string detail_, uint64_t begin_, uint64_t end_);
+
+            /**
+             * This thread's track in what's written
+             */
+            static uint32_t thread();
+
+            static void write (std::ostream &);
+
+            /**
+             * Forget everything recorded so far
+             */
+            static void clear();
+    };
+
+}
+
+/******************************************************************************
+ *
+ * class amqp::trace::Span
+ *
+ ******************************************************************************/
+
+namespace amqp::trace {
+
+    /**
+     * Records the time between its construction and destruction, if the
+     * tracer was enabled when it started. Use the TRACE macros from
+     * trace.h rather than this directly so builds without tracing don't
+     * carry them at all.
+     */
+    class Span {
+        private :
+            const char * m_name;
+            std::string  m_detail;
+            uint64_t     m_begin;
+            bool         m_on;
+
+        public :
+            explicit Span (const char * name_)
+                : m_name (name_)
+                , m_begin (0)
+                , m_on (Tracer::enabled())
+            {
+                if (m_on) {
+                    m_begin = Tracer::now();
+                }
+            }
+
+            /**
+             * [detail_] is only copied when the span's being recorded
+             */
+            Span (const char * name_, const std::string & detail_)
+                : m_name (name_)
+                , m_begin (0)
+                , m_on (Tracer::enabled())
+            {
+                if (m_on) {
+                    m_detail = detail_;
+                    m_begin = Tracer::now();
+                }
+            }
+
+            ~Span() {
+                if (m_on) {
+                    auto end = Tracer::now();
+                    Tracer::record (m_name, std::move (m_detail), m_begin, end);
+                }
+            }
+
+            Span (const Span &) = delete;
+            Span & operator = (const Span &) = delete;
+    };
+
+}
+
+/******************************************************************************/
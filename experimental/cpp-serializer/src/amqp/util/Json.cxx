@@ -0,0 +1,70 @@
+#include "Json.h"
+
+#include <cstdio>
+#include <ostream>
+
+/******************************************************************************/
+
+namespace {
+
+    /**
+     * The escape for [c_], or nullptr if it's written as itself
+     */
+    const char *
+    escape (unsigned char c_, char (& buf_)[8]) {
+        switch (c_) {
+            case '"'  : return "\\\"";
+            case '\\' : return "\\\\";
+            case '\n' : return "\\n";
+            case '\r' : return "\\r";
+            case '\t' : return "\\t";
+            default : {
+                if (c_ < 0x20) {
+                    snprintf (buf_, sizeof (buf_), "\\u%04x", c_);
+                    return buf_;
+                }
+
+                return nullptr;
+            }
+        }
+    }
+
+}
+
+/******************************************************************************/
+
+void
+amqp::util::
+jsonString (std::string_view s_, std::ostream & out_) {
+    char buf[8];
+
+    out_ << '"';
+    for (auto c : s_) {
+        if (auto e = escape (static_cast<unsigned char>(c), buf)) {
+            out_ << e;
+        } else {
+            out_ << c;
+        }
+    }
+    out_ << '"';
+}
+
+/******************************************************************************/
+
+void
+amqp::util::
+jsonString (std::string_view s_, std::string & out_) {
+    char buf[8];
+
+    out_.push_back ('"');
+    for (auto c : s_) {
+        if (auto e = escape (static_cast<unsigned char>(c), buf)) {
+            out_ += e;
+        } else {
+            out_.push_back (c);
+        }
+    }
+    out_.push_back ('"');
+}
+
+/******************************************************************************/
@@ -0,0 +1,27 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+/******************************************************************************
+ *
+ * JSON output shared by everything that writes it
+ *
+ ******************************************************************************/
+
+namespace amqp::util {
+
+    /**
+     * Write [s_] as a quoted JSON string, escaping quotes, backslashes
+     * and control characters. Anything else, UTF-8 included, is passed
+     * through as is.
+     */
+    void jsonString (std::string_view s_, std::ostream & out_);
+    void jsonString (std::string_view s_, std::string & out_);
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,52 @@
+#include "Parallel.h"
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <exception>
+
+/******************************************************************************/
+
+size_t
+amqp::util::
+chunks (size_t n_, size_t threads_) {
+    return std::max<size_t> (std::min (std::max<size_t> (threads_, 1), n_), 1);
+}
+
+/******************************************************************************/
+
+void
+amqp::util::
+parallel (
+    size_t n_,
+    size_t threads_,
+    const std::function<void (size_t, size_t, size_t)> & f_
+) {
+    auto chunks = util::chunks (n_, threads_);
+    auto per = (n_ + chunks - 1) / chunks;
+
+    std::vector<std::exception_ptr> errors (chunks);
+    std::vector<std::thread> workers;
+
+    for (size_t i { 0 } ; i < chunks ; ++i) {
+        workers.emplace_back ([&, i]() {
+            try {
+                f_ (i, std::min (n_, i * per), std::min (n_, (i + 1) * per));
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto & worker : workers) {
+        worker.join();
+    }
+
+    for (const auto & error : errors) {
+        if (error) {
+            std::rethrow_exception (error);
+        }
+    }
+}
+
+/******************************************************************************/
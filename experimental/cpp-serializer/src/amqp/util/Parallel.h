@@ -0,0 +1,36 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <cstddef>
+#include <functional>
+
+/******************************************************************************
+ *
+ * Fanning work out across threads
+ *
+ ******************************************************************************/
+
+namespace amqp::util {
+
+    /**
+     * How many contiguous chunks [parallel] splits [n_] items into for
+     * [threads_] threads, never more than there are items but always at
+     * least one so there's somewhere to put the results of none
+     */
+    size_t chunks (size_t n_, size_t threads_);
+
+    /**
+     * Call [f_] with (chunk, begin, end) for each of [chunks] chunks of
+     * [n_] items, each on a thread of its own. Once every thread's done
+     * the exception of the first chunk to throw, if any, is rethrown so
+     * nothing is left running when it propagates.
+     */
+    void parallel (
+        size_t n_,
+        size_t threads_,
+        const std::function<void (size_t, size_t, size_t)> & f_);
+
+}
+
+/******************************************************************************/
@@ -0,0 +1,105 @@
+#pragma once
+
+/******************************************************************************/
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+/******************************************************************************
+ *
+ * class amqp::util::PerThread
+ *
+ ******************************************************************************/
+
+namespace amqp::util {
+
+    /**
+     * One [T] per thread, for the tracer and stats to record into
+     * without contending with each other.
+     *
+     * Each thread's [T] is made the first time it's asked for and held
+     * here as well as by the thread, so what was recorded outlives the
+     * thread. Each has a lock of its own, taken by its thread to write to
+     * it and by [each] to read or reset it. That lock is only contended
+     * while [each] is running, so other threads can be read or cleared
+     * while they're still recording. There is one registry per [T].
+     */
+    template<typename T>
+    class PerThread {
+        private :
+            struct Slot {
+                std::mutex lock;
+                T          value;
+
+                explicit Slot (T value_) : value (std::move (value_)) { }
+            };
+
+            static std::mutex & lock() {
+                static std::mutex rtn;
+                return rtn;
+            }
+
+            static std::vector<std::shared_ptr<Slot>> & slots() {
+                static std::vector<std::shared_ptr<Slot>> rtn;
+                return rtn;
+            }
+
+            static std::shared_ptr<Slot> & current() {
+                thread_local std::shared_ptr<Slot> rtn;
+                return rtn;
+            }
+
+            /**
+             * This thread's slot, made by [make_] given how many threads
+             * came before it
+             */
+            template<typename M>
+            static Slot & local (M make_) {
+                auto & slot = current();
+
+                if (!slot) {
+                    std::lock_guard<std::mutex> guard (lock());
+
+                    slot = std::make_shared<Slot> (make_ (slots().size()));
+                    slots().push_back (slot);
+                }
+
+                return *slot;
+            }
+
+        public :
+            /**
+             * Call [f_] with this thread's [T] under its lock
+             */
+            template<typename M, typename F>
+            static auto with (M make_, F f_) {
+                auto & slot = local (make_);
+                std::lock_guard<std::mutex> guard (slot.lock);
+
+                return f_ (slot.value);
+            }
+
+            /**
+             * Call [f_] with every thread's [T] in turn, oldest first,
+             * each under its lock
+             */
+            template<typename F>
+            static void each (F f_) {
+                std::vector<std::shared_ptr<Slot>> all;
+                {
+                    std::lock_guard<std::mutex> guard (lock());
+                    all = slots();
+                }
+
+                for (const auto & slot : all) {
+                    std::lock_guard<std::mutex> guard (slot->lock);
+                    f_ (slot->value);
+                }
+            }
+    };
+
+}
+
+/******************************************************************************/
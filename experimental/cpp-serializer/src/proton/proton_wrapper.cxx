@@ -287,10 +287,14 @@ readAndNext<int32_t> (
 
 /******************************************************************************/
 
+/**
+ * A view of the string held by the tree rather than a copy, only valid
+ * for as long as the tree is
+ */
 template<>
-std::string
+std::string_view
 proton::
-readAndNext<std::string> (
+readAndNext<std::string_view> (
     pn_data_t * data_,
     bool tolerateDeviance_
 ) {
@@ -298,12 +302,12 @@ readAndNext<std::string> (
 
     if (pn_data_type(data_) == PN_STRING) {
         auto str = pn_data_get_string(data_);
-        return std::string(str.start, str.size);
+        return std::string_view (str.start, str.size);
     } else if (pn_data_type(data_) == PN_SYMBOL) {
         auto symbol = pn_data_get_symbol(data_);
-        return std::string(symbol.start, symbol.size);
+        return std::string_view (symbol.start, symbol.size);
     } else  if (tolerateDeviance_ && pn_data_type(data_) == PN_NULL) {
-        return "";
+        return std::string_view();
     }
     std::stringstream ss;
     ss << "Expected a String but found [" << data_ << "]";
@@ -312,6 +316,18 @@ readAndNext<std::string> (
 
 /******************************************************************************/
 
+template<>
+std::string
+proton::
+readAndNext<std::string> (
+    pn_data_t * data_,
+    bool tolerateDeviance_
+) {
+    return std::string (readAndNext<std::string_view> (data_, tolerateDeviance_));
+}
+
+/******************************************************************************/
+
 template<>
 bool
 proton::